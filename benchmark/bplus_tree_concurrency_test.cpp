@@ -18,6 +18,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 #include "common/math/integer_generator.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/field/field_meta.h"
 #include "storage/index/bplus_tree.h"
 #include "storage/clog/vacuous_log_handler.h"
 #include "storage/buffer/double_write_buffer.h"
@@ -26,6 +27,23 @@ using namespace std;
 using namespace common;
 using namespace benchmark;
 
+/**
+ * 索引使用的记录格式，与表中的记录一样，第一个字段是NULL位图
+ */
+struct TestRecord
+{
+  char     null_bitmap[4];
+  uint32_t value;
+};
+
+static TestRecord make_record(uint32_t value)
+{
+  TestRecord record;
+  memset(&record, 0, sizeof(record));
+  record.value = value;
+  return record;
+}
+
 struct Stat
 {
   int64_t insert_success_count = 0;
@@ -40,6 +58,9 @@ struct Stat
   int64_t scan_open_failed_count = 0;
   int64_t mismatch_count         = 0;
   int64_t scan_other_count       = 0;
+
+  int64_t lookup_found_count     = 0;
+  int64_t lookup_not_found_count = 0;
 };
 
 class BenchmarkBase : public Fixture
@@ -61,7 +82,7 @@ public:
 
     string log_name       = this->Name() + ".log";
     string btree_filename = this->Name() + ".btree";
-    LoggerFactory::init_default(log_name.c_str(), LOG_LEVEL_TRACE);
+    LoggerFactory::init_default(log_name.c_str(), LOG_LEVEL_INFO);
 
     ::remove(btree_filename.c_str());
 
@@ -70,8 +91,12 @@ public:
 
     const char *filename = btree_filename.c_str();
 
+    null_field_ = FieldMeta("__null", AttrType::CHARS, 0, sizeof(TestRecord::null_bitmap), false, false, 0);
+    value_field_ = FieldMeta("value", AttrType::INTS, offsetof(TestRecord, value), sizeof(uint32_t), true, false, 1);
+    vector<const FieldMeta *> fields{&null_field_, &value_field_};
+
     RC rc = handler_.create(
-        log_handler_, bpm_, filename, AttrType::INTS, sizeof(int32_t) /*attr_len*/, internal_max_size, leaf_max_size);
+        log_handler_, bpm_, filename, fields, false /*is_unique*/, internal_max_size, leaf_max_size);
     if (rc != RC::SUCCESS) {
       throw runtime_error("failed to create btree handler");
     }
@@ -95,7 +120,8 @@ public:
   void FillUp(uint32_t min, uint32_t max)
   {
     for (uint32_t value = min; value < max; ++value) {
-      const char *key = reinterpret_cast<const char *>(&value);
+      TestRecord  record = make_record(value);
+      const char *key    = reinterpret_cast<const char *>(&record);
       RID         rid(value, value);
 
       [[maybe_unused]] RC rc = handler_.insert_entry(key, &rid);
@@ -114,7 +140,8 @@ public:
 
   void Insert(uint32_t value, Stat &stat)
   {
-    const char *key = reinterpret_cast<const char *>(&value);
+    TestRecord  record = make_record(value);
+    const char *key    = reinterpret_cast<const char *>(&record);
     RID         rid(value, value);
 
     RC rc = handler_.insert_entry(key, &rid);
@@ -133,7 +160,8 @@ public:
 
   void Delete(uint32_t value, Stat &stat)
   {
-    const char *key = reinterpret_cast<const char *>(&value);
+    TestRecord  record = make_record(value);
+    const char *key    = reinterpret_cast<const char *>(&record);
     RID         rid(value, value);
 
     RC rc = handler_.delete_entry(key, &rid);
@@ -152,13 +180,15 @@ public:
 
   void Scan(uint32_t begin, uint32_t end, Stat &stat)
   {
-    const char *begin_key = reinterpret_cast<const char *>(&begin);
-    const char *end_key   = reinterpret_cast<const char *>(&end);
+    TestRecord  begin_record = make_record(begin);
+    TestRecord  end_record   = make_record(end);
+    const char *begin_key    = reinterpret_cast<const char *>(&begin_record);
+    const char *end_key      = reinterpret_cast<const char *>(&end_record);
 
     BplusTreeScanner scanner(handler_);
 
-    RC rc =
-        scanner.open(begin_key, sizeof(begin_key), true /*inclusive*/, end_key, sizeof(end_key), true /*inclusive*/);
+    RC rc = scanner.open(
+        begin_key, sizeof(begin_record), true /*inclusive*/, end_key, sizeof(end_record), true /*inclusive*/);
     if (rc != RC::SUCCESS) {
       stat.scan_open_failed_count++;
     } else {
@@ -180,10 +210,26 @@ public:
     }
   }
 
+  void Lookup(uint32_t value, Stat &stat)
+  {
+    TestRecord record = make_record(value);
+    list<RID>  rids;
+
+    RC rc = handler_.get_entry(reinterpret_cast<const char *>(&record), sizeof(record), rids);
+    if (rc == RC::SUCCESS && !rids.empty()) {
+      stat.lookup_found_count++;
+    } else {
+      stat.lookup_not_found_count++;
+    }
+  }
+
 protected:
   BufferPoolManager bpm_{512};
   BplusTreeHandler  handler_;
   VacuousLogHandler log_handler_;
+
+  FieldMeta null_field_;
+  FieldMeta value_field_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -294,6 +340,47 @@ BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->Threads(10)->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * 只读的等值查找，观察线程数增加时，查找过程中加锁的开销
+ */
+class LookupBenchmark : public BenchmarkBase
+{
+public:
+  string Name() const override { return "lookup"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    BenchmarkBase::SetUp(state);
+
+    uint32_t max = GetRangeMax(state);
+    ASSERT(max > 0, "invalid argument count. %ld", state.range(0));
+    FillUp(0, max);
+  }
+};
+
+BENCHMARK_DEFINE_F(LookupBenchmark, Lookup)(State &state)
+{
+  uint32_t         max = GetRangeMax(state);
+  IntegerGenerator generator(0, max - 1);
+  Stat             stat;
+
+  for (auto _ : state) {
+    uint32_t value = static_cast<uint32_t>(generator.next());
+    Lookup(value, stat);
+  }
+
+  state.counters["found"]     = Counter(stat.lookup_found_count, Counter::kIsRate);
+  state.counters["not_found"] = Counter(stat.lookup_not_found_count, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(LookupBenchmark, Lookup)->Threads(1)->Threads(8)->Threads(32)->Arg(4 * 10000);
+
+////////////////////////////////////////////////////////////////////////////////
+
 struct MixtureBenchmark : public BenchmarkBase
 {
   string Name() const override { return "mixture"; }
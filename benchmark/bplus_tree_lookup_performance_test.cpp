@@ -0,0 +1,159 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "common/math/integer_generator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/field/field_meta.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * 测试B+树等值查找的性能，主要用来观察键值比较的开销
+ * 参数是索引的类型：
+ * 0: 一个int字段
+ * 1: int和char(16)两个字段组成的联合索引，int字段只有少量不同的值，大部分比较要继续比较后面的字符串
+ * 记录的格式与表中的一样，第一个字段是NULL位图。
+ * BatchLookup 测试 get_entries 批量查找的性能，第二个参数是每批查找的键值个数，吞吐量按照键值个数计算。
+ * 第一个字段是CHARS类型时，BplusTreeScanner::fix_user_key 要求传入单独的字段值，不能使用记录查找，所以没有测试。
+ */
+
+struct TestRecord
+{
+  char    null_bitmap[4];
+  int32_t int_field;
+  char    chars_field[16];
+};
+
+class BplusTreeLookupBenchmark : public Fixture
+{
+public:
+  static constexpr int KEY_NUM = 100000;
+
+  static constexpr const char *FILE_NAME = "bplus_tree_lookup_benchmark.btree";
+
+  void SetUp(const State &state) override
+  {
+    LoggerFactory::init_default("bplus_tree_lookup_benchmark.log", LOG_LEVEL_INFO);
+
+    null_field_  = FieldMeta("__null", AttrType::CHARS, 0, sizeof(TestRecord::null_bitmap), false, false, 0);
+    int_field_   = FieldMeta("i", AttrType::INTS, offsetof(TestRecord, int_field), sizeof(int32_t), true, false, 1);
+    chars_field_ = FieldMeta("c", AttrType::CHARS, offsetof(TestRecord, chars_field), sizeof(TestRecord::chars_field), true, false, 2);
+
+    const bool composite = state.range(0) > 0;
+
+    vector<const FieldMeta *> fields{&null_field_, &int_field_};
+    if (composite) {
+      fields.push_back(&chars_field_);
+    }
+
+    ::remove(FILE_NAME);
+    bpm_.init(make_unique<VacuousDoubleWriteBuffer>());
+    handler_ = make_unique<BplusTreeHandler>();
+    if (OB_FAIL(handler_->create(log_handler_, bpm_, FILE_NAME, fields, false /*is_unique*/))) {
+      throw runtime_error("failed to create btree");
+    }
+
+    for (int i = 0; i < KEY_NUM; i++) {
+      TestRecord record = make_record(i, composite);
+      RID        rid(i / 100 + 1, i % 100);
+      if (OB_FAIL(handler_->insert_entry(reinterpret_cast<const char *>(&record), &rid))) {
+        throw runtime_error("failed to insert entry");
+      }
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    handler_->close();
+    handler_.reset();
+    bpm_.close_file(FILE_NAME);
+    ::remove(FILE_NAME);
+  }
+
+  static TestRecord make_record(int i, bool composite)
+  {
+    TestRecord record;
+    memset(&record, 0, sizeof(record));
+    record.int_field = composite ? i % 16 : i;
+    snprintf(record.chars_field, sizeof(record.chars_field), "key-%010d", i);
+    return record;
+  }
+
+protected:
+  BufferPoolManager            bpm_;
+  VacuousLogHandler            log_handler_;
+  unique_ptr<BplusTreeHandler> handler_;
+
+  FieldMeta null_field_;
+  FieldMeta int_field_;
+  FieldMeta chars_field_;
+};
+
+BENCHMARK_DEFINE_F(BplusTreeLookupBenchmark, Lookup)(State &state)
+{
+  IntegerGenerator generator(0, KEY_NUM - 1);
+  const bool       composite = state.range(0) > 0;
+
+  list<RID> rids;
+  int64_t   found = 0;
+  for (auto _ : state) {
+    TestRecord record = make_record(generator.next(), composite);
+    rids.clear();
+    handler_->get_entry(reinterpret_cast<const char *>(&record), sizeof(record), rids);
+    found += rids.size();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["found"] = Counter(found, Counter::kAvgIterations);
+}
+
+BENCHMARK_REGISTER_F(BplusTreeLookupBenchmark, Lookup)->Arg(0)->Arg(1);
+
+BENCHMARK_DEFINE_F(BplusTreeLookupBenchmark, BatchLookup)(State &state)
+{
+  IntegerGenerator generator(0, KEY_NUM - 1);
+  const bool       composite  = state.range(0) > 0;
+  const int        batch_size = static_cast<int>(state.range(1));
+
+  vector<TestRecord>   records(batch_size);
+  vector<const char *> keys(batch_size);
+  vector<list<RID>>    rids;
+  int64_t              found = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < batch_size; i++) {
+      records[i] = make_record(generator.next(), composite);
+      keys[i]    = reinterpret_cast<const char *>(&records[i]);
+    }
+    handler_->get_entries(keys, sizeof(TestRecord), rids);
+    for (const list<RID> &key_rids : rids) {
+      found += key_rids.size();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * batch_size);
+  state.counters["found"] = Counter(found, Counter::kAvgIterations);
+}
+
+BENCHMARK_REGISTER_F(BplusTreeLookupBenchmark, BatchLookup)->ArgsProduct({{0, 1}, {16, 256, 4096}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,156 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/20
+//
+
+#include <benchmark/benchmark.h>
+#include <thread>
+
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "common/math/integer_generator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+struct Stat
+{
+  int64_t get_success_count = 0;
+  int64_t get_other_count   = 0;
+};
+
+/**
+ * @brief 测试 DiskBufferPool::get_this_page 在多线程下的扩展性
+ * @details 第一个参数是文件中的页面数，第二个参数是 BufferPoolManager 可以使用的页帧数。
+ * 页面数小于页帧数时，所有的访问都会命中缓存，只测试页帧表的并发；
+ * 页面数大于页帧数时，会不断地淘汰和加载页面。
+ */
+class BufferPoolBenchmark : public Fixture
+{
+public:
+  string Name() const { return "buffer_pool"; }
+
+  string bp_filename() const { return Name() + ".bp"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      while (!setup_done_) {
+        this_thread::sleep_for(chrono::milliseconds(100));
+      }
+      return;
+    }
+
+    string log_name = Name() + ".log";
+    LoggerFactory::init_default(log_name.c_str(), LOG_LEVEL_WARN);
+
+    page_count_ = static_cast<int32_t>(state.range(0));
+    bpm_        = make_unique<BufferPoolManager>(static_cast<int>(state.range(1) * BP_PAGE_SIZE));
+    bpm_->init(make_unique<VacuousDoubleWriteBuffer>());
+
+    ::remove(bp_filename().c_str());
+    RC rc = bpm_->create_file(bp_filename().c_str());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to create buffer pool file. filename=%s, rc=%s", bp_filename().c_str(), strrc(rc));
+      throw runtime_error("failed to create buffer pool file");
+    }
+
+    rc = bpm_->open_file(log_handler_, bp_filename().c_str(), buffer_pool_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to open buffer pool file. filename=%s, rc=%s", bp_filename().c_str(), strrc(rc));
+      throw runtime_error("failed to open buffer pool file");
+    }
+
+    for (int32_t i = 1; i < page_count_; i++) {
+      Frame *frame = nullptr;
+      rc           = buffer_pool_->allocate_page(&frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to allocate page. rc=%s", strrc(rc));
+        throw runtime_error("failed to allocate page");
+      }
+      frame->mark_dirty();
+      buffer_pool_->unpin_page(frame);
+    }
+
+    setup_done_ = true;
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    buffer_pool_->close_file();
+    buffer_pool_ = nullptr;
+    bpm_.reset();
+    ::remove(bp_filename().c_str());
+    setup_done_ = false;
+  }
+
+  void GetPage(PageNum page_num, Stat &stat)
+  {
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_SUCC(rc)) {
+      frame->read_latch();
+      DoNotOptimize(frame->data()[0]);
+      frame->read_unlatch();
+      buffer_pool_->unpin_page(frame);
+      stat.get_success_count++;
+    } else {
+      stat.get_other_count++;
+    }
+  }
+
+protected:
+  volatile bool                 setup_done_ = false;
+  int32_t                       page_count_ = 0;
+  unique_ptr<BufferPoolManager> bpm_;
+  DiskBufferPool               *buffer_pool_ = nullptr;
+  VacuousLogHandler             log_handler_;
+};
+
+BENCHMARK_DEFINE_F(BufferPoolBenchmark, GetThisPage)(State &state)
+{
+  IntegerGenerator generator(1, page_count_ - 1);
+  Stat             stat;
+
+  for (auto _ : state) {
+    GetPage(generator.next(), stat);
+  }
+
+  state.counters["success"] = Counter(stat.get_success_count, Counter::kIsRate);
+  state.counters["other"]   = Counter(stat.get_other_count, Counter::kIsRate);
+}
+
+static const int MAX_BENCHMARK_THREADS = max(static_cast<int>(thread::hardware_concurrency()), 1);
+
+// 全部命中
+BENCHMARK_REGISTER_F(BufferPoolBenchmark, GetThisPage)
+    ->Args({1000, 2048})
+    ->ThreadRange(1, MAX_BENCHMARK_THREADS)
+    ->UseRealTime();
+
+// 工作集是内存的4倍
+BENCHMARK_REGISTER_F(BufferPoolBenchmark, GetThisPage)
+    ->Args({4000, 1024})
+    ->ThreadRange(1, MAX_BENCHMARK_THREADS)
+    ->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////////////
+
+BENCHMARK_MAIN();
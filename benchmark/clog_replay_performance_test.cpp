@@ -0,0 +1,187 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/26.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/filesystem.h"
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/clog/integrated_log_replayer.h"
+#include "storage/clog/parallel_log_replayer.h"
+#include "storage/record/record_manager.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * 测试日志回放(恢复)的性能
+ * 先使用 DiskLogHandler 生成一份真实的clog日志(可以用 tools/clog_dump 查看)：
+ * 1. 插入 RECORD_NUM 条记录后关闭数据文件，把数据文件保存一份作为恢复的起点；
+ * 2. 再打开数据文件，删除所有的记录，再插入同样多的记录，这部分日志就是需要回放的日志。
+ * 每轮测试把数据文件恢复成第1步的样子，然后从第1步结束时的LSN开始回放日志。
+ * 参数是回放的线程数，1表示串行回放。并行回放需要使用CONCURRENCY编译。
+ */
+
+class NoopLogReplayer : public LogReplayer
+{
+public:
+  RC replay(const LogEntry &) override { return RC::SUCCESS; }
+};
+
+struct TestRecord
+{
+  int32_t int_fields[15];
+};
+
+class ClogReplayBenchmark : public Fixture
+{
+public:
+  static constexpr int RECORD_NUM = 200000;
+
+  static constexpr const char *WORK_DIR = "clog_replay_benchmark";
+
+  string data_file() const { return string(WORK_DIR) + "/data.record"; }
+  string base_data_file() const { return string(WORK_DIR) + "/data.record.base"; }
+  string clog_dir() const { return string(WORK_DIR) + "/clog"; }
+
+  void SetUp(const State &state) override
+  {
+    if (generated_) {
+      return;
+    }
+
+    LoggerFactory::init_default("clog_replay_benchmark.log", LOG_LEVEL_INFO);
+
+    filesystem::remove_all(WORK_DIR);
+    filesystem::create_directories(WORK_DIR);
+
+    BufferPoolManager bpm;
+    bpm.init(make_unique<VacuousDoubleWriteBuffer>());
+
+    DiskLogHandler log_handler;
+    NoopLogReplayer noop_replayer;
+    check(log_handler.init(clog_dir().c_str()), "init log handler");
+    check(log_handler.replay(noop_replayer, 0), "replay empty log");
+    check(log_handler.start(), "start log handler");
+
+    check(bpm.create_file(data_file().c_str()), "create data file");
+
+    vector<RID> rids;
+    write_records(bpm, log_handler, rids, false /*delete_first*/);
+
+    filesystem::copy_file(data_file(), base_data_file(), filesystem::copy_options::overwrite_existing);
+    check(log_handler.wait_lsn(log_handler.current_lsn()), "wait log");
+    start_lsn_ = log_handler.current_lsn() + 1;
+
+    write_records(bpm, log_handler, rids, true /*delete_first*/);
+
+    check(log_handler.wait_lsn(log_handler.current_lsn()), "wait log");
+    replay_entries_ = log_handler.current_lsn() - start_lsn_ + 1;
+    log_handler.stop();
+    log_handler.await_termination();
+
+    generated_ = true;
+    LOG_INFO("clog generated. start lsn=%ld, entries to replay=%ld", start_lsn_, replay_entries_);
+  }
+
+  void TearDown(const State &state) override {}
+
+protected:
+  static void check(RC rc, const char *what)
+  {
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to %s. rc=%s", what, strrc(rc));
+      throw runtime_error(what);
+    }
+  }
+
+  void write_records(BufferPoolManager &bpm, LogHandler &log_handler, vector<RID> &rids, bool delete_first)
+  {
+    DiskBufferPool *buffer_pool = nullptr;
+    check(bpm.open_file(log_handler, data_file().c_str(), buffer_pool), "open data file");
+
+    RecordFileHandler handler(StorageFormat::ROW_FORMAT);
+    check(handler.init(*buffer_pool, log_handler, nullptr), "init record file handler");
+
+    if (delete_first) {
+      for (const RID &rid : rids) {
+        check(handler.delete_record(&rid), "delete record");
+      }
+      rids.clear();
+    }
+
+    TestRecord record;
+    RID        rid;
+    for (int i = 0; i < RECORD_NUM; i++) {
+      record.int_fields[0] = i;
+      check(handler.insert_record(reinterpret_cast<const char *>(&record), sizeof(record), &rid), "insert record");
+      rids.push_back(rid);
+    }
+
+    handler.close();
+    buffer_pool->close_file();
+    bpm.close_file(data_file().c_str());
+  }
+
+protected:
+  static inline bool generated_      = false;
+  static inline LSN  start_lsn_      = 0;
+  static inline LSN  replay_entries_ = 0;
+};
+
+BENCHMARK_DEFINE_F(ClogReplayBenchmark, Replay)(State &state)
+{
+  const int thread_num = static_cast<int>(state.range(0));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    filesystem::copy_file(base_data_file(), data_file(), filesystem::copy_options::overwrite_existing);
+
+    BufferPoolManager bpm;
+    bpm.init(make_unique<VacuousDoubleWriteBuffer>());
+
+    DiskLogHandler  log_handler;
+    DiskBufferPool *buffer_pool = nullptr;
+    check(log_handler.init(clog_dir().c_str()), "init log handler");
+    check(bpm.open_file(log_handler, data_file().c_str(), buffer_pool), "open data file");
+    state.ResumeTiming();
+
+    IntegratedLogReplayer integrated_replayer(bpm);
+    ParallelLogReplayer   replayer(integrated_replayer, thread_num);
+    check(log_handler.replay(replayer, start_lsn_), "replay");
+    check(replayer.on_done(), "finish replay");
+
+    state.PauseTiming();
+    buffer_pool->close_file();
+    bpm.close_file(data_file().c_str());
+    state.ResumeTiming();
+  }
+
+  state.counters["entries"] = Counter(replay_entries_ * state.iterations(), Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(ClogReplayBenchmark, Replay)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Iterations(3)
+    ->Unit(kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,207 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/algorithm.h"
+#include "common/lang/random.h"
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/field/field_meta.h"
+#include "storage/index/index_meta.h"
+#include "storage/index/hnsw_index.h"
+#include "storage/index/vector_distance.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * 测试 hnsw 向量索引近似查找的性能和召回率
+ * 数据与 ivfflat_performance_test 一样，是围绕若干个随机中心的高斯分布，可以直接对比两种索引。
+ * 参数是查询时的 ef_search，0 表示不使用索引，直接计算所有向量的距离，作为对比的基准。
+ * recall 是与精确结果相比，前 TOP_K 个结果的平均召回率。
+ */
+
+static constexpr int DIMENSION = 64;
+
+struct TestRecord
+{
+  char  null_bitmap[4];
+  float vec[DIMENSION];
+};
+
+class HnswBenchmark : public Fixture
+{
+public:
+  static constexpr int VECTOR_NUM  = 20000;
+  static constexpr int CLUSTER_NUM = 200;
+  static constexpr int M           = 16;
+  static constexpr int QUERY_NUM   = 64;
+  static constexpr int TOP_K       = 10;
+
+  static constexpr const char *FILE_NAME = "hnsw_benchmark.index";
+
+  void SetUp(const State &state) override
+  {
+    LoggerFactory::init_default("hnsw_benchmark.log", LOG_LEVEL_INFO);
+
+    null_field_ = FieldMeta("__null", AttrType::CHARS, 0, sizeof(TestRecord::null_bitmap), false, false, 0);
+    vec_field_  = FieldMeta("v", AttrType::VECTORS, offsetof(TestRecord, vec), sizeof(TestRecord::vec), true, false, 1);
+    vector<const FieldMeta *> fields{&null_field_, &vec_field_};
+
+    generate_data();
+
+    IndexMeta index_meta;
+    if (OB_FAIL(index_meta.init("hnsw_benchmark", fields, false /*is_unique*/))) {
+      throw runtime_error("failed to init index meta");
+    }
+    VectorIndexParams params;
+    params.distance        = VectorDistanceType::L2;
+    params.m               = M;
+    params.ef_construction = 64;
+    index_meta.set_vector_index(IndexType::HNSW, params);
+
+    ::remove(FILE_NAME);
+    bpm_.init(make_unique<VacuousDoubleWriteBuffer>());
+    index_ = make_unique<HnswIndex>();
+    if (OB_FAIL(index_->create(log_handler_, bpm_, FILE_NAME, index_meta, fields))) {
+      throw runtime_error("failed to create hnsw index");
+    }
+
+    for (int i = 0; i < VECTOR_NUM; i++) {
+      RID rid(i / 100 + 1, i % 100);
+      if (OB_FAIL(index_->insert_entry(reinterpret_cast<const char *>(&records_[i]), &rid))) {
+        throw runtime_error("failed to insert entry");
+      }
+    }
+
+    if (state.range(0) > 0) {
+      index_->set_ef_search(static_cast<int>(state.range(0)));
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    index_->close();
+    index_.reset();
+    ::remove(FILE_NAME);
+  }
+
+  /// 直接计算所有向量的距离，找到最近的 TOP_K 个
+  void brute_force_search(const vector<float> &query, vector<RID> &rids) const
+  {
+    vector<pair<float, int>> distances(VECTOR_NUM);
+    for (int i = 0; i < VECTOR_NUM; i++) {
+      distances[i] = {vector_rank_distance(VectorDistanceType::L2, query.data(), records_[i].vec, DIMENSION), i};
+    }
+    partial_sort(distances.begin(), distances.begin() + TOP_K, distances.end());
+
+    rids.clear();
+    for (int i = 0; i < TOP_K; i++) {
+      const int index = distances[i].second;
+      rids.emplace_back(index / 100 + 1, index % 100);
+    }
+  }
+
+  double recall(int query_index, const vector<RID> &rids) const
+  {
+    const vector<RID> &expected = expected_[query_index];
+
+    int hit = 0;
+    for (const RID &rid : rids) {
+      if (find(expected.begin(), expected.end(), rid) != expected.end()) {
+        hit++;
+      }
+    }
+    return static_cast<double>(hit) / TOP_K;
+  }
+
+private:
+  void generate_data()
+  {
+    mt19937                          engine(2024);
+    uniform_real_distribution<float> center_distribution(-10.0f, 10.0f);
+    normal_distribution<float>       noise_distribution(0.0f, 4.0f);
+    uniform_int_distribution<int>    cluster_distribution(0, CLUSTER_NUM - 1);
+
+    vector<float> centers(CLUSTER_NUM * DIMENSION);
+    for (float &value : centers) {
+      value = center_distribution(engine);
+    }
+
+    auto generate = [&](float *vec) {
+      const float *center = centers.data() + cluster_distribution(engine) * DIMENSION;
+      for (int d = 0; d < DIMENSION; d++) {
+        vec[d] = center[d] + noise_distribution(engine);
+      }
+    };
+
+    records_.resize(VECTOR_NUM);
+    for (TestRecord &record : records_) {
+      memset(record.null_bitmap, 0, sizeof(record.null_bitmap));
+      generate(record.vec);
+    }
+
+    queries_.assign(QUERY_NUM, vector<float>(DIMENSION));
+    expected_.resize(QUERY_NUM);
+    for (int i = 0; i < QUERY_NUM; i++) {
+      generate(queries_[i].data());
+      brute_force_search(queries_[i], expected_[i]);
+    }
+  }
+
+protected:
+  BufferPoolManager        bpm_;
+  VacuousLogHandler        log_handler_;
+  unique_ptr<HnswIndex>     index_;
+
+  FieldMeta null_field_;
+  FieldMeta vec_field_;
+
+  vector<TestRecord>    records_;
+  vector<vector<float>> queries_;
+  vector<vector<RID>>   expected_;  ///< 每个查询的精确结果
+};
+
+BENCHMARK_DEFINE_F(HnswBenchmark, Search)(State &state)
+{
+  const bool brute_force = state.range(0) == 0;
+
+  vector<RID> rids;
+  double      total_recall = 0;
+  int         query_index  = 0;
+  for (auto _ : state) {
+    const vector<float> &query = queries_[query_index];
+    if (brute_force) {
+      brute_force_search(query, rids);
+    } else if (OB_FAIL(index_->ann_search(query, TOP_K, rids))) {
+      state.SkipWithError("failed to search");
+      break;
+    }
+
+    total_recall += recall(query_index, rids);
+    query_index = (query_index + 1) % QUERY_NUM;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["recall"] = Counter(total_recall, Counter::kAvgIterations);
+}
+
+BENCHMARK_REGISTER_F(HnswBenchmark, Search)->Arg(0)->Arg(10)->Arg(40)->Arg(100);
+
+BENCHMARK_MAIN();
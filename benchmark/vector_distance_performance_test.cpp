@@ -0,0 +1,101 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/random.h"
+#include "common/type/vector_type.h"
+#include "common/value.h"
+#include "storage/common/column.h"
+
+using namespace std;
+using namespace benchmark;
+
+/**
+ * 测试向量距离的计算性能，参数是向量的维度
+ * Value: 每次对两个 Value 计算 l2_distance，与表达式按行计算的方式一样
+ * Batch: 使用 VectorType::l2_distance_batch 计算一个查询向量与一整列向量的距离
+ * 编译时打开 USE_SIMD 可以对比 AVX2 与标量实现的差异。吞吐量按照向量个数计算。
+ */
+class VectorDistanceBenchmark : public Fixture
+{
+public:
+  static constexpr int VECTOR_NUM = 1024;
+
+  void SetUp(const State &state) override
+  {
+    const int dim = static_cast<int>(state.range(0));
+
+    mt19937                          engine(2024);
+    uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    vector<float> data(static_cast<size_t>(VECTOR_NUM) * dim);
+    for (float &value : data) {
+      value = distribution(engine);
+    }
+    vector<float> query(dim);
+    for (float &value : query) {
+      value = distribution(engine);
+    }
+
+    column_.init(AttrType::VECTORS, dim * sizeof(float), VECTOR_NUM);
+    column_.append(reinterpret_cast<char *>(data.data()), VECTOR_NUM);
+
+    values_.resize(VECTOR_NUM);
+    for (int i = 0; i < VECTOR_NUM; i++) {
+      values_[i] = column_.get_value(i);
+    }
+    query_.set_vector(query);
+  }
+
+  void TearDown(const State &state) override
+  {
+    values_.clear();
+    column_.reset();
+  }
+
+protected:
+  Column        column_;
+  vector<Value> values_;
+  Value         query_;
+};
+
+BENCHMARK_DEFINE_F(VectorDistanceBenchmark, Value)(State &state)
+{
+  VectorType type;
+  Value      result;
+  for (auto _ : state) {
+    for (const Value &value : values_) {
+      type.l2_distance(value, query_, result);
+      DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * VECTOR_NUM);
+}
+
+BENCHMARK_REGISTER_F(VectorDistanceBenchmark, Value)->Arg(16)->Arg(128)->Arg(1024);
+
+BENCHMARK_DEFINE_F(VectorDistanceBenchmark, Batch)(State &state)
+{
+  Column result;
+  for (auto _ : state) {
+    VectorType::l2_distance_batch(column_, query_, result);
+    DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * VECTOR_NUM);
+}
+
+BENCHMARK_REGISTER_F(VectorDistanceBenchmark, Batch)->Arg(16)->Arg(128)->Arg(1024);
+
+BENCHMARK_MAIN();
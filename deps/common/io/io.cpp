@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <dirent.h>
 #include <iostream>
+#include <limits.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -386,4 +387,112 @@ int readn(int fd, void *buf, int size)
   }
   return 0;
 }
+
+int pwriten(int fd, const void *buf, int size, off_t offset)
+{
+  const char *tmp = (const char *)buf;
+  while (size > 0) {
+    const ssize_t ret = ::pwrite(fd, tmp, size, offset);
+    if (ret >= 0) {
+      tmp += ret;
+      size -= ret;
+      offset += ret;
+      continue;
+    }
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err)
+      return err;
+  }
+  return 0;
+}
+
+int preadn(int fd, void *buf, int size, off_t offset)
+{
+  char *tmp = (char *)buf;
+  while (size > 0) {
+    const ssize_t ret = ::pread(fd, tmp, size, offset);
+    if (ret > 0) {
+      tmp += ret;
+      size -= ret;
+      offset += ret;
+      continue;
+    }
+    if (0 == ret)
+      return -1;  // end of file
+
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err)
+      return err;
+  }
+  return 0;
+}
+
+/**
+ * @brief 跳过iov中已经处理过的数据
+ * @return 返回剩余的iov段数
+ */
+static int advance_iovec(struct iovec *&iov, int iovcnt, size_t done)
+{
+  while (iovcnt > 0 && done >= iov->iov_len) {
+    done -= iov->iov_len;
+    iov++;
+    iovcnt--;
+  }
+
+  if (iovcnt > 0 && done > 0) {
+    iov->iov_base = (char *)iov->iov_base + done;
+    iov->iov_len -= done;
+  }
+  return iovcnt;
+}
+
+int writevn(int fd, struct iovec *iov, int iovcnt)
+{
+  while (iovcnt > 0) {
+    const ssize_t ret = ::writev(fd, iov, iovcnt > IOV_MAX ? IOV_MAX : iovcnt);
+    if (ret >= 0) {
+      iovcnt = advance_iovec(iov, iovcnt, ret);
+      continue;
+    }
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err)
+      return err;
+  }
+  return 0;
+}
+
+int pwritevn(int fd, struct iovec *iov, int iovcnt, off_t offset)
+{
+  while (iovcnt > 0) {
+    const ssize_t ret = ::pwritev(fd, iov, iovcnt > IOV_MAX ? IOV_MAX : iovcnt, offset);
+    if (ret >= 0) {
+      offset += ret;
+      iovcnt = advance_iovec(iov, iovcnt, ret);
+      continue;
+    }
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err)
+      return err;
+  }
+  return 0;
+}
+
+int preadvn(int fd, struct iovec *iov, int iovcnt, off_t offset)
+{
+  while (iovcnt > 0) {
+    const ssize_t ret = ::preadv(fd, iov, iovcnt > IOV_MAX ? IOV_MAX : iovcnt, offset);
+    if (ret > 0) {
+      offset += ret;
+      iovcnt = advance_iovec(iov, iovcnt, ret);
+      continue;
+    }
+    if (0 == ret)
+      return -1;  // end of file
+
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err)
+      return err;
+  }
+  return 0;
+}
 }  // namespace common
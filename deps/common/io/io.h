@@ -14,6 +14,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <sys/types.h>
+#include <sys/uio.h>
 #include <vector>
 
 #include "common/defs.h"
@@ -77,4 +79,39 @@ int writen(int fd, const void *buf, int size);
  */
 int readn(int fd, void *buf, int size);
 
+/**
+ * @brief 在指定位置一次性写入所有数据，不会修改文件描述符的偏移量
+ * @details 多个线程可以同时使用同一个描述符在不同的位置写入
+ * @return int 0 表示成功，否则返回errno
+ */
+int pwriten(int fd, const void *buf, int size, off_t offset);
+
+/**
+ * @brief 从指定位置一次性读取指定长度的数据，不会修改文件描述符的偏移量
+ * @return int 返回0表示成功。-1 表示读取到文件尾，并且没有读到size大小数据，其它表示errno
+ */
+int preadn(int fd, void *buf, int size, off_t offset);
+
+/**
+ * @brief 将多段内存数据一次性写入文件当前的位置
+ * @details 与 pwritevn 相同，可能会修改iov中的内容。通常用于以O_APPEND方式打开的文件
+ * @return int 0 表示成功，否则返回errno
+ */
+int writevn(int fd, struct iovec *iov, int iovcnt);
+
+/**
+ * @brief 将多段内存数据写入文件中从offset开始的连续区域
+ * @details 一次系统调用最多写入IOV_MAX段，超过时会拆分成多次调用。
+ * 发生部分写入时会修改iov中的内容，调用方不应再使用iov。
+ * @return int 0 表示成功，否则返回errno
+ */
+int pwritevn(int fd, struct iovec *iov, int iovcnt, off_t offset);
+
+/**
+ * @brief 将文件中从offset开始的连续区域读取到多段内存中
+ * @details 与 pwritevn 相同，可能会修改iov中的内容
+ * @return int 返回0表示成功。-1 表示读取到文件尾，并且没有读满所有数据，其它表示errno
+ */
+int preadvn(int fd, struct iovec *iov, int iovcnt, off_t offset);
+
 }  // namespace common
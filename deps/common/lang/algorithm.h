@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 
 #include <algorithm>
 
+using std::clamp;
 using std::max;
 using std::min;
+using std::sort;
 using std::transform;
\ No newline at end of file
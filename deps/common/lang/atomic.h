@@ -13,4 +13,11 @@ See the Mulan PSL v2 for more details. */
 #include <atomic>
 
 using std::atomic;
-using std::atomic_bool;
\ No newline at end of file
+using std::atomic_bool;
+using std::memory_order;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::memory_order_acq_rel;
+using std::memory_order_seq_cst;
+using std::atomic_thread_fence;
\ No newline at end of file
@@ -12,4 +12,5 @@ See the Mulan PSL v2 for more details. */
 
 #include <set>
 
-using std::set;
\ No newline at end of file
+using std::set;
+using std::multiset;
\ No newline at end of file
@@ -8,6 +8,7 @@ EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
 MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
+#include <math.h>
 #include <stdint.h>
 #include "common/math/simd_util.h"
 
@@ -54,4 +55,106 @@ template void selective_load<uint32_t>(uint32_t *memory, int offset, uint32_t *v
 template void selective_load<int>(int *memory, int offset, int *vec, __m256i &inv);
 template void selective_load<float>(float *memory, int offset, float *vec, __m256i &inv);
 
-#endif
\ No newline at end of file
+#endif
+
+#if defined(USE_SIMD)
+
+/// 把8个float加起来
+static inline float mm256_reduce_add_ps(__m256 values)
+{
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(values), _mm256_extractf128_ps(values, 1));
+  sum        = _mm_hadd_ps(sum, sum);
+  sum        = _mm_hadd_ps(sum, sum);
+  return _mm_cvtss_f32(sum);
+}
+
+float vector_l2_squared_distance(const float *left, const float *right, int size)
+{
+  __m256 sum = _mm256_setzero_ps();
+  int    i   = 0;
+  for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH) {
+    __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(left + i), _mm256_loadu_ps(right + i));
+    sum         = _mm256_add_ps(sum, _mm256_mul_ps(diff, diff));
+  }
+
+  float result = mm256_reduce_add_ps(sum);
+  for (; i < size; i++) {
+    const float diff = left[i] - right[i];
+    result += diff * diff;
+  }
+  return result;
+}
+
+float vector_inner_product(const float *left, const float *right, int size)
+{
+  __m256 sum = _mm256_setzero_ps();
+  int    i   = 0;
+  for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH) {
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(left + i), _mm256_loadu_ps(right + i)));
+  }
+
+  float result = mm256_reduce_add_ps(sum);
+  for (; i < size; i++) {
+    result += left[i] * right[i];
+  }
+  return result;
+}
+
+float vector_cosine_distance(const float *left, const float *right, int size)
+{
+  __m256 product    = _mm256_setzero_ps();
+  __m256 left_norm  = _mm256_setzero_ps();
+  __m256 right_norm = _mm256_setzero_ps();
+  int    i          = 0;
+  for (; i + SIMD_WIDTH <= size; i += SIMD_WIDTH) {
+    __m256 l   = _mm256_loadu_ps(left + i);
+    __m256 r   = _mm256_loadu_ps(right + i);
+    product    = _mm256_add_ps(product, _mm256_mul_ps(l, r));
+    left_norm  = _mm256_add_ps(left_norm, _mm256_mul_ps(l, l));
+    right_norm = _mm256_add_ps(right_norm, _mm256_mul_ps(r, r));
+  }
+
+  float product_sum    = mm256_reduce_add_ps(product);
+  float left_norm_sum  = mm256_reduce_add_ps(left_norm);
+  float right_norm_sum = mm256_reduce_add_ps(right_norm);
+  for (; i < size; i++) {
+    product_sum += left[i] * right[i];
+    left_norm_sum += left[i] * left[i];
+    right_norm_sum += right[i] * right[i];
+  }
+  return 1 - product_sum / (sqrtf(left_norm_sum) * sqrtf(right_norm_sum));
+}
+
+#else
+
+float vector_l2_squared_distance(const float *left, const float *right, int size)
+{
+  float result = 0;
+  for (int i = 0; i < size; i++) {
+    const float diff = left[i] - right[i];
+    result += diff * diff;
+  }
+  return result;
+}
+
+float vector_inner_product(const float *left, const float *right, int size)
+{
+  float result = 0;
+  for (int i = 0; i < size; i++) {
+    result += left[i] * right[i];
+  }
+  return result;
+}
+
+float vector_cosine_distance(const float *left, const float *right, int size)
+{
+  float product = 0, left_norm = 0, right_norm = 0;
+  for (int i = 0; i < size; i++) {
+    product += left[i] * right[i];
+    left_norm += left[i] * left[i];
+    right_norm += right[i] * right[i];
+  }
+  return 1 - product / (sqrtf(left_norm) * sqrtf(right_norm));
+}
+
+#endif
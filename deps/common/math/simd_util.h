@@ -25,4 +25,12 @@ float mm256_sum_ps(const float *values, int size);
 /// @brief selective load 的标量实现
 template <typename V>
 void selective_load(V *memory, int offset, V *vec, __m256i &inv);
-#endif
\ No newline at end of file
+#endif
+
+/**
+ * @brief 向量距离的计算，定义了 USE_SIMD 时使用 AVX2 指令，否则使用标量实现
+ * @details 直接在float数组上计算，size 是数组的长度
+ */
+float vector_l2_squared_distance(const float *left, const float *right, int size);  ///< 欧氏距离的平方
+float vector_inner_product(const float *left, const float *right, int size);
+float vector_cosine_distance(const float *left, const float *right, int size);  ///< 1 - 余弦相似度
@@ -25,3 +25,27 @@ See the Mulan PSL v2 for more details. */
 #define SOCKET_BUFFER_SIZE 8192
 
 #define SESSION_STAGE_NAME "SessionStage"
+
+// buffer pool section
+#define BUFFER_POOL "BUFFER_POOL"
+#define BUFFER_POOL_EVICTION_POLICY "EVICTION_POLICY"
+#define BUFFER_POOL_EVICTION_POLICY_DEFAULT "lru"
+#define BUFFER_POOL_IO_ENGINE "IO_ENGINE"
+#define BUFFER_POOL_IO_ENGINE_DEFAULT "sync"
+#define BUFFER_POOL_READ_AHEAD_PAGES "READ_AHEAD_PAGES"
+#define BUFFER_POOL_READ_AHEAD_PAGES_DEFAULT 16
+#define BUFFER_POOL_DIRTY_HIGH_WATERMARK "DIRTY_PAGE_HIGH_WATERMARK"
+#define BUFFER_POOL_DIRTY_LOW_WATERMARK "DIRTY_PAGE_LOW_WATERMARK"
+#define BUFFER_POOL_PAGE_CLEANER_INTERVAL_MS "PAGE_CLEANER_INTERVAL_MS"
+
+// clog section
+#define CLOG "CLOG"
+#define CLOG_CHECKPOINT_INTERVAL_SEC "CHECKPOINT_INTERVAL_SEC"
+#define CLOG_CHECKPOINT_INTERVAL_SEC_DEFAULT 30
+#define CLOG_REPLAY_THREADS "REPLAY_THREADS"
+#define CLOG_REPLAY_THREADS_DEFAULT 4
+
+// index section. INDEX is a token of the sql parser
+#define INDEX_SECTION "INDEX"
+#define INDEX_BULK_LOAD_FILL_FACTOR "BULK_LOAD_FILL_FACTOR"
+#define INDEX_BULK_LOAD_SORT_MEMORY_MB "BULK_LOAD_SORT_MEMORY_MB"
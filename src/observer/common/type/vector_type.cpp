@@ -14,17 +14,101 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/comparator.h"
 #include "common/lang/sstream.h"
 #include "common/log/log.h"
+#include "common/math/simd_util.h"
 #include "common/type/vector_type.h"
 #include "common/value.h"
+#include "storage/common/column.h"
+
+/**
+ * @brief 取向量值中的float数组
+ * @details 向量类型的值直接使用值中的内存，不复制。其他类型(比如 '[1,2,3]' 这样的字符串常量)需要先转换，
+ * 转换的结果放在 buffer 中。
+ */
+static const float *vector_data(const Value &value, vector<float> &buffer, int &size)
+{
+    if (value.attr_type() == AttrType::VECTORS) {
+        size = value.length() / sizeof(float);
+        return reinterpret_cast<const float *>(value.data());
+    }
+    buffer = value.get_vector();
+    size   = static_cast<int>(buffer.size());
+    return buffer.data();
+}
+
+/// 两个向量逐个元素计算
+template <typename Operator>
+static RC element_wise(const Value &left, const Value &right, vector<float> &res, Operator op)
+{
+    vector<float> left_buffer, right_buffer;
+    int           left_size = 0, right_size = 0;
+    const float  *l = vector_data(left, left_buffer, left_size);
+    const float  *r = vector_data(right, right_buffer, right_size);
+    if (left_size != right_size) {
+        LOG_ERROR("The size of two vectors is not equal");
+        return RC::INTERNAL;
+    }
+    res.resize(left_size);
+    for (int i = 0; i < left_size; i++) {
+        res[i] = op(l[i], r[i]);
+    }
+    return RC::SUCCESS;
+}
+
+/// 计算两个向量的距离，distance 的参数是两个float数组和数组长度
+template <typename Distance>
+static RC vector_distance(const Value &left, const Value &right, float &result, Distance distance)
+{
+    vector<float> left_buffer, right_buffer;
+    int           left_size = 0, right_size = 0;
+    const float  *l = vector_data(left, left_buffer, left_size);
+    const float  *r = vector_data(right, right_buffer, right_size);
+    if (left_size != right_size) {
+        LOG_ERROR("The size of two vectors is not equal");
+        return RC::INTERNAL;
+    }
+    result = distance(l, r, left_size);
+    return RC::SUCCESS;
+}
+
+/// 计算一列向量与查询向量的距离
+template <typename Distance>
+static RC vector_distance_batch(const Column &vectors, const Value &query, Column &result, Distance distance)
+{
+    vector<float> query_buffer;
+    int           dim = 0;
+    const float  *q   = vector_data(query, query_buffer, dim);
+    if (vectors.attr_type() != AttrType::VECTORS || vectors.attr_len() != static_cast<int>(dim * sizeof(float))) {
+        LOG_WARN("vector column does not match the query. column type=%s, column len=%d, query dim=%d",
+            attr_type_to_string(vectors.attr_type()), vectors.attr_len(), dim);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    const int count = vectors.count();
+    result.init(AttrType::FLOATS, sizeof(float), count);
+    const float *data   = reinterpret_cast<const float *>(vectors.data());
+    float       *scores = reinterpret_cast<float *>(result.data());
+    for (int i = 0; i < count; i++) {
+        scores[i] = distance(q, data + static_cast<size_t>(i) * dim, dim);
+    }
+    result.set_count(count);
+    return RC::SUCCESS;
+}
+
+static float l2_distance_of(const float *left, const float *right, int size)
+{
+    return sqrtf(vector_l2_squared_distance(left, right, size));
+}
 
 int VectorType::compare(const Value &left, const Value &right)const{
-    vector<float> l = left.get_vector();
-    vector<float> r = right.get_vector();
-    if(l.size() != r.size()){
+    vector<float> left_buffer, right_buffer;
+    int           left_size = 0, right_size = 0;
+    const float  *l = vector_data(left, left_buffer, left_size);
+    const float  *r = vector_data(right, right_buffer, right_size);
+    if(left_size != right_size){
         LOG_ERROR("The size of two vectors is not equal");
         return INT32_MAX;
     }
-    for(int i = 0; i < l.size(); i++){
+    for(int i = 0; i < left_size; i++){
         if(l[i] < r[i]){
             return -1;
         }else if(l[i] > r[i]){
@@ -36,47 +120,29 @@ int VectorType::compare(const Value &left, const Value &right)const{
 
 RC VectorType::add(const Value &left, const Value &right, Value &result) const {
     vector<float> res;
-    vector<float> l = left.get_vector();
-    vector<float> r = right.get_vector();
-    if(l.size() != r.size()){
-        LOG_ERROR("The size of two vectors is not equal");
-        return RC::INTERNAL;
-    }
-    for(int i = 0; i < l.size(); i++){
-        res.push_back(l[i] + r[i]);
+    RC            rc = element_wise(left, right, res, [](float l, float r) { return l + r; });
+    if (OB_SUCC(rc)) {
+        result.set_vec(res.data(), res.size() * sizeof(float));
     }
-    result.set_vector(res);
-    return RC::SUCCESS;
+    return rc;
 }
 
 RC VectorType::subtract(const Value &left, const Value &right, Value &result)const{
     vector<float> res;
-    vector<float> l = left.get_vector();
-    vector<float> r = right.get_vector();
-    if(l.size() != r.size()){
-        LOG_ERROR("The size of two vectors is not equal");
-        return RC::INTERNAL;
+    RC            rc = element_wise(left, right, res, [](float l, float r) { return l - r; });
+    if (OB_SUCC(rc)) {
+        result.set_vec(res.data(), res.size() * sizeof(float));
     }
-    for(int i = 0; i < l.size(); i++){
-        res.push_back(l[i] - r[i]);
-    }
-    result.set_vector(res);
-    return RC::SUCCESS;
+    return rc;
 }
 
 RC VectorType::multiply(const Value &left, const Value &right, Value &result)const{
     vector<float> res;
-    vector<float> l = left.get_vector();
-    vector<float> r = right.get_vector();
-    if(l.size() != r.size()){
-        LOG_ERROR("The size of two vectors is not equal");
-        return RC::INTERNAL;
-    }
-    for(int i = 0; i < l.size(); i++){
-        res.push_back(l[i] * r[i]);
+    RC            rc = element_wise(left, right, res, [](float l, float r) { return l * r; });
+    if (OB_SUCC(rc)) {
+        result.set_vec(res.data(), res.size() * sizeof(float));
     }
-    result.set_vector(res);
-    return RC::SUCCESS;
+    return rc;
 }
 
 RC VectorType::to_string(const Value &val, string &result) const {
@@ -96,54 +162,43 @@ RC VectorType::to_string(const Value &val, string &result) const {
 }
 
 RC VectorType::inner_product(const Value &left, const Value &right, Value &result) const {
-    vector<float> l = left.get_vector();
-    vector<float> r = right.get_vector();
-    if(l.size() != r.size()){
-        LOG_ERROR("The size of two vectors is not equal");
-        return RC::INTERNAL;
+    float distance = 0;
+    RC    rc       = vector_distance(left, right, distance, vector_inner_product);
+    if (OB_SUCC(rc)) {
+        result.set_float(distance);
     }
-    float res = 0;
-    for(int i = 0; i < l.size(); i++){
-        res += l[i] * r[i];
-    }
-    result.set_float(res);
-    return RC::SUCCESS;
+    return rc;
 }
 
 RC VectorType::cosine_distance(const Value &left, const Value &right, Value &result) const {
-    vector<float> l = left.get_vector();
-    vector<float> r = right.get_vector();
-    if(l.size() != r.size()){
-        LOG_ERROR("The size of two vectors is not equal");
-        return RC::INTERNAL;
+    float distance = 0;
+    RC    rc       = vector_distance(left, right, distance, vector_cosine_distance);
+    if (OB_SUCC(rc)) {
+        result.set_float(distance);
     }
-    float inner_product = 0;
-    float l_norm = 0;
-    float r_norm = 0;
-    for(int i = 0; i < l.size(); i++){
-        inner_product += l[i] * r[i];
-        l_norm += l[i] * l[i];
-        r_norm += r[i] * r[i];
-    }
-    l_norm = sqrt(l_norm);
-    r_norm = sqrt(r_norm);
-    float res = 1 - inner_product / (l_norm * r_norm);
-    result.set_float(res);
-    return RC::SUCCESS;
+    return rc;
 }
 
 RC VectorType::l2_distance(const Value &left, const Value &right, Value &result) const {
-    vector<float> l = left.get_vector();
-    vector<float> r = right.get_vector();
-    if(l.size() != r.size()){
-        LOG_ERROR("The size of two vectors is not equal");
-        return RC::INTERNAL;
+    float distance = 0;
+    RC    rc       = vector_distance(left, right, distance, l2_distance_of);
+    if (OB_SUCC(rc)) {
+        result.set_float(distance);
     }
-    float res = 0;
-    for(int i = 0; i < l.size(); i++){
-        res += (l[i] - r[i]) * (l[i] - r[i]);
-    }
-    res = sqrt(res);
-    result.set_float(res);
-    return RC::SUCCESS;
-}
\ No newline at end of file
+    return rc;
+}
+
+RC VectorType::l2_distance_batch(const Column &vectors, const Value &query, Column &result)
+{
+    return vector_distance_batch(vectors, query, result, l2_distance_of);
+}
+
+RC VectorType::inner_product_batch(const Column &vectors, const Value &query, Column &result)
+{
+    return vector_distance_batch(vectors, query, result, vector_inner_product);
+}
+
+RC VectorType::cosine_distance_batch(const Column &vectors, const Value &query, Column &result)
+{
+    return vector_distance_batch(vectors, query, result, vector_cosine_distance);
+}
@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/type/data_type.h"
 
+class Column;
+
 /**
  * @brief 向量类型
  * @ingroup DataType
@@ -32,4 +34,13 @@ public:
   RC l2_distance(const Value &left, const Value &right, Value &result) const override;
 
   RC to_string(const Value &val, string &result) const override;
+
+  /**
+   * @brief 计算一列向量与查询向量的距离
+   * @details 直接在列的内存上计算，不会为每个向量创建 Value。结果是 FLOATS 类型的列，与 vectors 的行一一对应
+   * @param query 查询向量，也可以是 '[1,2,3]' 这样的字符串
+   */
+  static RC l2_distance_batch(const Column &vectors, const Value &query, Column &result);
+  static RC inner_product_batch(const Column &vectors, const Value &query, Column &result);
+  static RC cosine_distance_batch(const Column &vectors, const Value &query, Column &result);
 };
\ No newline at end of file
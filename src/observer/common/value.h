@@ -113,10 +113,12 @@ public:
   void set_date(int y,int m,int d){
     value_.int_value_=y*10000+m*100+d;
     attr_type_ = AttrType::DATES;
+    length_ = sizeof(int);
   }
   void set_date(int dat){
     value_.int_value_=dat;
     attr_type_ = AttrType::DATES;
+    length_ = sizeof(int);
   }
   void set_text(int tid){
     value_.int_value_=tid;
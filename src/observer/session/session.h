@@ -83,6 +83,11 @@ public:
   void          set_execution_mode(const ExecutionMode mode) { execution_mode_ = mode; }
   ExecutionMode get_execution_mode() const { return execution_mode_; }
 
+  static constexpr int64_t DEFAULT_JOIN_BUFFER_SIZE = 16 * 1024 * 1024;
+
+  void    set_join_buffer_size(int64_t size) { join_buffer_size_ = size; }
+  int64_t join_buffer_size() const { return join_buffer_size_; }
+
   bool used_chunk_mode() { return used_chunk_mode_; }
 
   void set_used_chunk_mode(bool used_chunk_mode) { used_chunk_mode_ = used_chunk_mode; }
@@ -113,4 +118,6 @@ private:
   bool used_chunk_mode_ = false;
 
   ExecutionMode execution_mode_ = ExecutionMode::TUPLE_ITERATOR;
+
+  int64_t join_buffer_size_ = DEFAULT_JOIN_BUFFER_SIZE;  ///< 连接算子缓存数据使用的内存，超过以后写到临时文件中
 };
@@ -32,5 +32,12 @@ RC CreateIndexExecutor::execute(SQLStageEvent *sql_event)
 
   Trx   *trx   = session->current_trx();
   Table *table = create_index_stmt->table();
+  if (create_index_stmt->index_type() != IndexType::BPLUS_TREE) {
+    return table->create_vector_index(trx,
+        create_index_stmt->field_meta(),
+        create_index_stmt->index_name().c_str(),
+        create_index_stmt->index_type(),
+        create_index_stmt->vector_params());
+  }
   return table->create_index(trx, create_index_stmt->field_meta(), create_index_stmt->index_name().c_str(),create_index_stmt->is_unique());
 }
\ No newline at end of file
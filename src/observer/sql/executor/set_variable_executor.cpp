@@ -34,6 +34,13 @@ RC SetVariableExecutor::execute(SQLStageEvent *sql_event)
       } else {
         rc = RC::INVALID_ARGUMENT;
       }
+    } else if (strcasecmp(var_name, "join_buffer_size") == 0) {
+      if (var_value.attr_type() == AttrType::INTS && var_value.get_int() > 0) {
+        session->set_join_buffer_size(var_value.get_int());
+        LOG_TRACE("set join_buffer_size to %d", var_value.get_int());
+      } else {
+        rc = RC::VARIABLE_NOT_VALID;
+      }
     } else {
       rc = RC::VARIABLE_NOT_EXISTS;
     }
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/expr/tuple.h"
 #include <regex>
 #include "sql/expr/arithmetic_operator.hpp"
+#include "common/type/vector_type.h"
 
 using namespace std;
 
@@ -566,6 +567,11 @@ RC ArithmeticExpr::calc_column(const Column &left_column, const Column &right_co
   LOG_INFO("calc_column");
   RC rc = RC::SUCCESS;
 
+  if (arithmetic_type_ == Type::L2DISTANCE || arithmetic_type_ == Type::COSINEDISTANCE ||
+      arithmetic_type_ == Type::INNERPRODUCT) {
+    return calc_distance_column(left_column, right_column, column);
+  }
+
   const AttrType target_type = value_type();
   column.init(target_type, left_column.attr_len(), std::max(left_column.count(), right_column.count()));
   bool left_const  = left_column.column_type() == Column::Type::CONSTANT_COLUMN;
@@ -586,6 +592,31 @@ RC ArithmeticExpr::calc_column(const Column &left_column, const Column &right_co
   return rc;
 }
 
+RC ArithmeticExpr::calc_distance_column(const Column &left_column, const Column &right_column, Column &column) const
+{
+  const bool left_const  = left_column.column_type() == Column::Type::CONSTANT_COLUMN;
+  const bool right_const = right_column.column_type() == Column::Type::CONSTANT_COLUMN;
+  if (left_const == right_const) {
+    LOG_WARN("vector distance on columns requires exactly one constant side");
+    return RC::UNIMPLEMENTED;
+  }
+
+  const Column &vectors = left_const ? right_column : left_column;
+  const Value   query   = left_const ? left_column.get_value(0) : right_column.get_value(0);
+
+  RC rc = RC::SUCCESS;
+  switch (arithmetic_type_) {
+    case Type::L2DISTANCE: rc = VectorType::l2_distance_batch(vectors, query, column); break;
+    case Type::COSINEDISTANCE: rc = VectorType::cosine_distance_batch(vectors, query, column); break;
+    case Type::INNERPRODUCT: rc = VectorType::inner_product_batch(vectors, query, column); break;
+    default: rc = RC::INTERNAL; break;
+  }
+  if (OB_SUCC(rc)) {
+    column.set_column_type(Column::Type::NORMAL_COLUMN);
+  }
+  return rc;
+}
+
 RC ArithmeticExpr::try_get_value(Value &value) const
 {
   LOG_INFO("try_get_value");
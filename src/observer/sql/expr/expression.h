@@ -403,6 +403,9 @@ private:
 
   RC calc_column(const Column &left_column, const Column &right_column, Column &column) const;
 
+  /// 向量距离，一边是一列向量，另一边是常量
+  RC calc_distance_column(const Column &left_column, const Column &right_column, Column &column) const;
+
   template <bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
   RC execute_calc(const Column &left, const Column &right, Column &result, Type type, AttrType attr_type) const;
 
@@ -0,0 +1,448 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include "sql/operator/hash_join_physical_operator.h"
+#include "common/lang/functional.h"
+#include "common/lang/string_view.h"
+#include "common/log/log.h"
+
+/// 连接键的哈希值。参与比较的两边类型相同，所以相等的值哈希值也相同
+static size_t hash_keys(const vector<Value> &keys)
+{
+  size_t hash = 0;
+  for (const Value &key : keys) {
+    size_t value_hash = 0;
+    switch (key.attr_type()) {
+      case AttrType::CHARS:
+      case AttrType::VECTORS: {
+        value_hash = std::hash<string_view>()(string_view(key.data(), key.length()));
+      } break;
+      case AttrType::FLOATS: {
+        const float value = key.get_float();
+        value_hash        = std::hash<float>()(value == 0 ? 0.0f : value);  // 0.0 与 -0.0 相等
+      } break;
+      case AttrType::BOOLEANS: {
+        value_hash = std::hash<bool>()(key.get_boolean());
+      } break;
+      default: {
+        value_hash = std::hash<int>()(*reinterpret_cast<const int *>(key.data()));
+      } break;
+    }
+    hash ^= value_hash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+/// 分区使用哈希值的高位，与哈希表使用的低位错开
+static int partition_of(size_t hash)
+{
+  return static_cast<int>(((hash * 0x9E3779B97F4A7C15ULL) >> 32) % HashJoinPhysicalOperator::PARTITION_NUM);
+}
+
+HashJoinPhysicalOperator::HashJoinPhysicalOperator(
+    vector<unique_ptr<Expression>> &&left_keys, vector<unique_ptr<Expression>> &&right_keys, int64_t memory_limit)
+    : memory_limit_(memory_limit)
+{
+  ASSERT(left_keys.size() == right_keys.size() && !left_keys.empty(), "invalid join keys");
+  sides_[0].keys = std::move(left_keys);
+  sides_[1].keys = std::move(right_keys);
+}
+
+std::string HashJoinPhysicalOperator::param() const
+{
+  std::string param;
+  for (size_t i = 0; i < sides_[0].keys.size(); i++) {
+    if (i > 0) {
+      param += " AND ";
+    }
+    param += sides_[0].keys[i]->name();
+    param += "=";
+    param += sides_[1].keys[i]->name();
+  }
+  return param;
+}
+
+RC HashJoinPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 2) {
+    LOG_WARN("hash join operator should have 2 children");
+    return RC::INTERNAL;
+  }
+
+  spilled_            = false;
+  probe_buffer_index_ = 0;
+  partition_index_    = -1;
+  probe_tuple_        = nullptr;
+  build_rows_.clear();
+  build_keys_.clear();
+  hash_table_.clear();
+  match_iter_ = match_end_ = hash_table_.end();
+
+  for (int i = 0; i < 2; i++) {
+    Side &side = sides_[i];
+    side.child = children_[i];
+    side.eof   = false;
+    side.rows.clear();
+    side.partitions.clear();
+
+    RC rc = side.child->open(trx);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to open child of hash join. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  // 交替读取两边的数据，先读完的一边更小，用来建立哈希表
+  int64_t memory_size = 0;
+  while (!sides_[0].eof && !sides_[1].eof) {
+    for (Side &side : sides_) {
+      RC rc = read_child_row(side, memory_size);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+
+    if (memory_size > memory_limit_ && !sides_[0].eof && !sides_[1].eof) {
+      LOG_INFO("hash join exceeds memory limit, switch to partition mode. memory size=%ld, limit=%ld",
+          memory_size, memory_limit_);
+      return spill();
+    }
+  }
+
+  if (sides_[0].eof && sides_[1].eof) {
+    build_side_ = sides_[0].rows.size() <= sides_[1].rows.size() ? 0 : 1;
+  } else {
+    build_side_ = sides_[0].eof ? 0 : 1;
+  }
+
+  LOG_TRACE("hash join build on %s side. rows=%d", build_side_ == 0 ? "left" : "right", (int)sides_[build_side_].rows.size());
+  return build_hash_table(sides_[build_side_], sides_[build_side_].rows);
+}
+
+RC HashJoinPhysicalOperator::next()
+{
+  while (true) {
+    while (match_iter_ != match_end_) {
+      const int index = match_iter_->second;
+      ++match_iter_;
+      if (!keys_equal(build_keys_[index])) {
+        continue;  // 哈希冲突
+      }
+
+      Side &build = sides_[build_side_];
+      build.tuple.set_cells(build_rows_[index]);
+      if (build_side_ == 0) {
+        joined_tuple_.set_left(&build.tuple);
+        joined_tuple_.set_right(probe_tuple_);
+      } else {
+        joined_tuple_.set_left(probe_tuple_);
+        joined_tuple_.set_right(&build.tuple);
+      }
+      return RC::SUCCESS;
+    }
+
+    RC rc = next_probe_row();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+}
+
+RC HashJoinPhysicalOperator::close()
+{
+  build_rows_.clear();
+  build_keys_.clear();
+  hash_table_.clear();
+
+  RC rc = RC::SUCCESS;
+  for (Side &side : sides_) {
+    side.rows.clear();
+    side.partitions.clear();
+    if (side.child != nullptr) {
+      RC child_rc = side.child->close();
+      if (OB_FAIL(child_rc)) {
+        LOG_WARN("failed to close child of hash join. rc=%s", strrc(child_rc));
+        rc = child_rc;
+      }
+    }
+  }
+  return rc;
+}
+
+void HashJoinPhysicalOperator::init_specs(Side &side, const Tuple &tuple)
+{
+  const int cell_num = tuple.cell_num();
+  side.specs.resize(cell_num);
+  for (int i = 0; i < cell_num; i++) {
+    tuple.spec_at(i, side.specs[i]);
+  }
+  side.tuple.set_names(side.specs);
+}
+
+RC HashJoinPhysicalOperator::read_child_row(Side &side, int64_t &memory_size)
+{
+  if (side.eof) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = side.child->next();
+  if (rc == RC::RECORD_EOF) {
+    side.eof = true;
+    return RC::SUCCESS;
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to read child of hash join. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  Tuple *tuple = side.child->current_tuple();
+  if (side.specs.empty()) {
+    init_specs(side, *tuple);
+  }
+
+  Row row(tuple->cell_num());
+  for (int i = 0; i < static_cast<int>(row.size()); i++) {
+    rc = tuple->cell_at(i, row[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get cell of tuple. index=%d, rc=%s", i, strrc(rc));
+      return rc;
+    }
+  }
+
+  memory_size += SpillFile::memory_size(row);
+  side.rows.push_back(std::move(row));
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::compute_keys(Side &side, const Tuple &tuple, Row &keys, bool &has_null)
+{
+  has_null = false;
+  keys.resize(side.keys.size());
+  for (size_t i = 0; i < side.keys.size(); i++) {
+    RC rc = side.keys[i]->get_value(tuple, keys[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to compute join key. rc=%s", strrc(rc));
+      return rc;
+    }
+    if (keys[i].is_null()) {
+      has_null = true;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+bool HashJoinPhysicalOperator::keys_equal(const Row &build_keys) const
+{
+  for (size_t i = 0; i < build_keys.size(); i++) {
+    if (build_keys[i].compare(probe_keys_[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC HashJoinPhysicalOperator::build_hash_table(Side &side, vector<Row> &rows)
+{
+  build_rows_.clear();
+  build_keys_.clear();
+  hash_table_.clear();
+  hash_table_.reserve(rows.size());
+
+  Row keys;
+  for (Row &row : rows) {
+    bool has_null = false;
+    side.tuple.set_cells(row);
+    RC rc = compute_keys(side, side.tuple, keys, has_null);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (has_null) {
+      continue;
+    }
+
+    hash_table_.emplace(hash_keys(keys), static_cast<int>(build_rows_.size()));
+    build_keys_.push_back(std::move(keys));
+    build_rows_.push_back(std::move(row));
+  }
+  rows.clear();
+
+  match_iter_ = match_end_ = hash_table_.end();
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::spill_row(Side &side, const Row &row)
+{
+  bool has_null = false;
+  side.tuple.set_cells(row);
+  RC rc = compute_keys(side, side.tuple, probe_keys_, has_null);
+  if (OB_FAIL(rc) || has_null) {
+    return rc;
+  }
+  return side.partitions[partition_of(hash_keys(probe_keys_))]->write(row);
+}
+
+RC HashJoinPhysicalOperator::spill()
+{
+  spilled_ = true;
+
+  RC rc = RC::SUCCESS;
+  for (Side &side : sides_) {
+    side.partitions.clear();
+    for (int i = 0; i < PARTITION_NUM; i++) {
+      side.partitions.push_back(make_unique<SpillFile>());
+      rc = side.partitions.back()->open();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+
+    for (const Row &row : side.rows) {
+      rc = spill_row(side, row);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    side.rows.clear();
+    side.rows.shrink_to_fit();
+
+    // 剩下的数据直接写到分区中
+    int64_t memory_size = 0;
+    while (OB_SUCC(rc)) {
+      rc = read_child_row(side, memory_size);
+      if (OB_FAIL(rc) || side.eof) {
+        break;
+      }
+      rc = spill_row(side, side.rows.back());
+      side.rows.clear();
+    }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    for (unique_ptr<SpillFile> &partition : side.partitions) {
+      rc = partition->rewind();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+  }
+
+  partition_index_ = -1;
+  return load_next_partition();
+}
+
+RC HashJoinPhysicalOperator::load_next_partition()
+{
+  build_rows_.clear();
+  build_keys_.clear();
+  hash_table_.clear();
+  match_iter_ = match_end_ = hash_table_.end();
+
+  while (++partition_index_ < PARTITION_NUM) {
+    SpillFile &left  = *sides_[0].partitions[partition_index_];
+    SpillFile &right = *sides_[1].partitions[partition_index_];
+    if (left.row_count() == 0 || right.row_count() == 0) {
+      left.close();
+      right.close();
+      continue;
+    }
+
+    build_side_      = left.size() <= right.size() ? 0 : 1;
+    Side      &build = sides_[build_side_];
+    SpillFile &file  = *build.partitions[partition_index_];
+
+    vector<Row> rows;
+    rows.reserve(file.row_count());
+    Row row;
+    RC  rc = RC::SUCCESS;
+    while (OB_SUCC(rc = file.read(row))) {
+      rows.push_back(std::move(row));
+    }
+    if (rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to read partition of hash join. partition=%d, rc=%s", partition_index_, strrc(rc));
+      return rc;
+    }
+
+    if (file.size() > memory_limit_) {
+      LOG_WARN("partition of hash join still exceeds memory limit. partition=%d, size=%ld, limit=%ld",
+          partition_index_, file.size(), memory_limit_);
+    }
+    file.close();
+    return build_hash_table(build, rows);
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::next_probe_row()
+{
+  while (true) {
+    Side &probe = sides_[1 - build_side_];
+    RC    rc    = RC::SUCCESS;
+    if (!spilled_) {
+      if (hash_table_.empty()) {
+        return RC::RECORD_EOF;
+      }
+
+      if (probe_buffer_index_ < probe.rows.size()) {
+        probe.tuple.set_cells(probe.rows[probe_buffer_index_++]);
+        probe_tuple_ = &probe.tuple;
+      } else if (probe.eof) {
+        return RC::RECORD_EOF;
+      } else {
+        rc = probe.child->next();
+        if (rc == RC::RECORD_EOF) {
+          probe.eof = true;
+        }
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        probe_tuple_ = probe.child->current_tuple();
+      }
+    } else {
+      if (partition_index_ >= PARTITION_NUM) {
+        return RC::RECORD_EOF;
+      }
+
+      SpillFile &file = *probe.partitions[partition_index_];
+      rc              = file.read(probe_row_);
+      if (rc == RC::RECORD_EOF) {
+        file.close();
+        rc = load_next_partition();
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        continue;
+      }
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      probe.tuple.set_cells(probe_row_);
+      probe_tuple_ = &probe.tuple;
+    }
+
+    bool has_null = false;
+    rc            = compute_keys(probe, *probe_tuple_, probe_keys_, has_null);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (has_null) {
+      continue;
+    }
+
+    auto range  = hash_table_.equal_range(hash_keys(probe_keys_));
+    match_iter_ = range.first;
+    match_end_  = range.second;
+    return RC::SUCCESS;
+  }
+}
@@ -0,0 +1,124 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#pragma once
+
+#include "common/lang/memory.h"
+#include "common/lang/unordered_map.h"
+#include "common/lang/vector.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/physical_operator.h"
+#include "sql/operator/spill_file.h"
+
+/**
+ * @brief 等值连接的 hash join 算子
+ * @ingroup PhysicalOperator
+ * @details 连接条件是若干个 left_key = right_key，左右两边分别只引用左右子算子的字段。
+ * 执行时交替从左右两个子算子读取数据，先读完的一边更小，用它建立哈希表(build)，另一边逐行查找(probe)，
+ * 已经读到内存中的另一边的数据先参与查找，剩下的直接从子算子中流式读取。
+ * 如果两边都还没有读完，缓存的数据就超过了内存的限制，就切换到分区模式(grace hash join)：
+ * 按照连接键的哈希值把两边的数据都写到若干个临时文件中，相同的键一定落在同一个分区，
+ * 然后对每个分区，用较小的一边建立哈希表，再读取另一边查找。
+ * 连接键中有 NULL 的行不会与任何行匹配，直接丢弃。
+ */
+class HashJoinPhysicalOperator : public PhysicalOperator
+{
+public:
+  /// 分区模式下的分区个数
+  static constexpr int PARTITION_NUM = 16;
+
+  /**
+   * @param left_keys 在左边子算子上计算的连接键
+   * @param right_keys 在右边子算子上计算的连接键，与 left_keys 一一对应
+   * @param memory_limit 缓存数据的内存限制，单位是字节
+   */
+  HashJoinPhysicalOperator(
+      vector<unique_ptr<Expression>> &&left_keys, vector<unique_ptr<Expression>> &&right_keys, int64_t memory_limit);
+  virtual ~HashJoinPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::HASH_JOIN; }
+
+  std::string param() const override;
+
+  RC     open(Trx *trx) override;
+  RC     next() override;
+  RC     close() override;
+  Tuple *current_tuple() override { return &joined_tuple_; }
+
+  /// 是否使用了分区模式，测试使用
+  bool spilled() const { return spilled_; }
+
+private:
+  using Row = vector<Value>;
+
+  /// 一边的输入
+  struct Side
+  {
+    PhysicalOperator              *child = nullptr;
+    vector<unique_ptr<Expression>> keys;
+    vector<TupleCellSpec>          specs;          ///< 每一列的名字，从第一行获取
+    vector<Row>                    rows;           ///< 已经读到内存中的行
+    bool                           eof   = false;  ///< 子算子是否已经读完
+    ValueListTuple                 tuple;          ///< 从内存或文件中读出的行
+    vector<unique_ptr<SpillFile>>  partitions;     ///< 分区模式下每个分区的临时文件
+  };
+
+  /// 从子算子读取一行，复制到内存中
+  RC read_child_row(Side &side, int64_t &memory_size);
+
+  /**
+   * @brief 计算一行的连接键
+   * @param[out] has_null 连接键中有没有 NULL
+   */
+  RC   compute_keys(Side &side, const Tuple &tuple, Row &keys, bool &has_null);
+  void init_specs(Side &side, const Tuple &tuple);
+
+  RC build_hash_table(Side &side, vector<Row> &rows);
+
+  /// 把缓存的行和子算子剩下的行都写到分区文件中
+  RC spill();
+  RC spill_row(Side &side, const Row &row);
+
+  /// 分区模式下加载下一个分区，没有分区时返回 RECORD_EOF
+  RC load_next_partition();
+
+  /// 准备下一行 probe 的数据，放在 probe_tuple_ 中
+  RC next_probe_row();
+
+  /// 当前的 probe 行是否与 build 一边的某一行匹配
+  bool keys_equal(const Row &build_keys) const;
+
+private:
+  Side    sides_[2];  ///< 0 是左边，1 是右边
+  int64_t memory_limit_ = 0;
+  bool    spilled_      = false;
+
+  int build_side_ = 1;  ///< 用来建立哈希表的是哪一边
+
+  vector<Row>                     build_rows_;
+  vector<Row>                     build_keys_;  ///< build_rows_ 每一行的连接键
+  unordered_multimap<size_t, int> hash_table_;  ///< 连接键的哈希值到 build_rows_ 下标的映射
+
+  size_t probe_buffer_index_ = 0;  ///< 内存模式下，probe 一边已经缓存的行处理到了哪里
+  int    partition_index_    = -1;
+
+  Tuple *probe_tuple_ = nullptr;
+  Row    probe_keys_;
+  Row    probe_row_;
+
+  unordered_multimap<size_t, int>::iterator match_iter_;
+  unordered_multimap<size_t, int>::iterator match_end_;
+
+  JoinedTuple joined_tuple_;
+};
@@ -0,0 +1,90 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include "sql/operator/index_only_scan_physical_operator.h"
+#include "storage/index/index.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+RC IndexOnlyScanPhysicalOperator::open(Trx *trx)
+{
+  RC rc = IndexScanPhysicalOperator::open(trx);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  fetch_record_ = trx->need_record_for_visibility();
+  if (fetch_record_) {
+    LOG_TRACE("transaction needs record to check visibility, fall back to index scan");
+    return RC::SUCCESS;
+  }
+
+  // 键值中的字段按照创建索引时的顺序排列，最后是RID
+  field_copies_.clear();
+  int key_offset = 0;
+  for (const FieldMeta &field_meta : index_->field_metas()) {
+    field_copies_.push_back(FieldCopy{key_offset, field_meta.offset(), field_meta.len()});
+    key_offset += field_meta.len();
+  }
+
+  const int record_size = table_->table_meta().record_size();
+  rc                    = current_record_.new_record(record_size);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate record. size=%d, rc=%s", record_size, strrc(rc));
+    return rc;
+  }
+  memset(current_record_.data(), 0, record_size);
+  return RC::SUCCESS;
+}
+
+RC IndexOnlyScanPhysicalOperator::next()
+{
+  if (fetch_record_) {
+    return IndexScanPhysicalOperator::next();
+  }
+
+  RID         rid;
+  const char *key = nullptr;
+  RC          rc  = RC::SUCCESS;
+
+  bool filter_result = false;
+  while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid, key))) {
+    for (const FieldCopy &field_copy : field_copies_) {
+      memcpy(current_record_.data() + field_copy.record_offset, key + field_copy.key_offset, field_copy.length);
+    }
+    current_record_.set_rid(rid);
+
+    tuple_.set_record(&current_record_);
+    rc = filter(tuple_, filter_result);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("failed to filter record. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    if (!filter_result) {
+      LOG_TRACE("record filtered");
+      continue;
+    }
+
+    rc = trx_->visit_record(table_, current_record_, mode_);
+    if (rc == RC::RECORD_INVISIBLE) {
+      LOG_TRACE("record invisible");
+      continue;
+    } else {
+      return rc;
+    }
+  }
+
+  return rc;
+}
@@ -0,0 +1,49 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#pragma once
+
+#include "sql/operator/index_scan_physical_operator.h"
+
+/**
+ * @brief 只扫描索引的物理算子
+ * @ingroup PhysicalOperator
+ * @details 查询用到的字段都在索引中时(覆盖索引)，直接从索引的键值中取出字段的值，不再去读取记录。
+ * 把键值中的字段拷贝到一条与表中记录格式相同的记录上，上层算子按照普通记录的方式访问，其它字段的值是无效的。
+ * 事务判断可见性需要记录的数据时(比如MVCC)，退化成普通的索引扫描。
+ */
+class IndexOnlyScanPhysicalOperator : public IndexScanPhysicalOperator
+{
+public:
+  using IndexScanPhysicalOperator::IndexScanPhysicalOperator;
+
+  virtual ~IndexOnlyScanPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::INDEX_ONLY_SCAN; }
+
+  RC open(Trx *trx) override;
+  RC next() override;
+
+private:
+  /// 索引中的一个字段在键值和记录中的位置
+  struct FieldCopy
+  {
+    int key_offset    = 0;
+    int record_offset = 0;
+    int length        = 0;
+  };
+
+  bool              fetch_record_ = true;  ///< 是否需要读取记录
+  vector<FieldCopy> field_copies_;
+};
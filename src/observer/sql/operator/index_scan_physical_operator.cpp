@@ -13,7 +13,9 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/index_scan_physical_operator.h"
+#include "common/lang/algorithm.h"
 #include "storage/index/index.h"
+#include "storage/table/table.h"
 #include "storage/trx/trx.h"
 
 IndexScanPhysicalOperator::IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const Value *left_value,
@@ -59,6 +61,18 @@ RC IndexScanPhysicalOperator::check_valid(){
 }
 
 
+const char *IndexScanPhysicalOperator::make_key(const Value &value, vector<char> &key_buffer) const
+{
+  if (value.attr_type() == AttrType::UNDEFINED) {
+    return nullptr;
+  }
+
+  const FieldMeta &field = index_->field_metas()[1];
+  key_buffer.assign(table_->table_meta().record_size(), 0);
+  memcpy(key_buffer.data() + field.offset(), value.data(), min(value.length(), field.len()));
+  return key_buffer.data();
+}
+
 RC IndexScanPhysicalOperator::open(Trx *trx)
 {
   if (nullptr == table_ || nullptr == index_) {
@@ -87,11 +101,16 @@ RC IndexScanPhysicalOperator::open(Trx *trx)
     }
   }
 
-  IndexScanner *index_scanner = index_->create_scanner(left_value_.data(),
-      left_value_.length(),
+  // 索引按照记录的格式取键值，所以把查找的值放到字段在记录中的位置上
+  const char *left_key  = make_key(left_value_, left_key_);
+  const char *right_key = make_key(right_value_, right_key_);
+  const int   key_len   = table_->table_meta().record_size();
+
+  IndexScanner *index_scanner = index_->create_scanner(left_key,
+      key_len,
       left_inclusive_,
-      right_value_.data(),
-      right_value_.length(),
+      right_key,
+      key_len,
       right_inclusive_);
   if (nullptr == index_scanner) {
     LOG_WARN("failed to create index scanner");
@@ -43,11 +43,14 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
-private:
+protected:
   // 与TableScanPhysicalOperator代码相同，可以优化
   RC filter(RowTuple &tuple, bool &result);
 
-private:
+  /// 把查找的值编码成记录格式的键值，值为空时没有边界，返回nullptr
+  const char *make_key(const Value &value, vector<char> &key_buffer) const;
+
+protected:
   Trx               *trx_            = nullptr;
   Table             *table_          = nullptr;
   Index             *index_          = nullptr;
@@ -58,8 +61,10 @@ private:
   Record   current_record_;
   RowTuple tuple_;
 
-  Value left_value_;
-  Value right_value_;
+  Value        left_value_;
+  Value        right_value_;
+  vector<char> left_key_;   ///< 按照记录格式编码的左边界
+  vector<char> right_key_;  ///< 按照记录格式编码的右边界
   bool  left_inclusive_  = false;
   bool  right_inclusive_ = false;
 
@@ -20,6 +20,7 @@ See the Mulan PSL v2 for more details. */
  * @brief 连接算子
  * @ingroup LogicalOperator
  * @details 连接算子，用于连接两个表。对应的物理算子或者实现，可能有NestedLoopJoin，HashJoin等等。
+ * 表达式是等值连接的条件，参考 PredicateToJoinRewriter。
  */
 class JoinLogicalOperator : public LogicalOperator
 {
@@ -0,0 +1,36 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+
+#pragma once
+
+#include "sql/operator/logical_operator.h"
+
+/**
+ * @brief 只输出子算子的前 limit 行
+ * @ingroup LogicalOperator
+ */
+class LimitLogicalOperator : public LogicalOperator
+{
+public:
+  LimitLogicalOperator(int limit) : limit_(limit) {}
+  virtual ~LimitLogicalOperator() = default;
+
+  LogicalOperatorType type() const override { return LogicalOperatorType::LIMIT; }
+
+  int limit() const { return limit_; }
+
+private:
+  int limit_ = -1;
+};
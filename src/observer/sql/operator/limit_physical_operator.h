@@ -0,0 +1,45 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+
+#pragma once
+
+#include "sql/operator/physical_operator.h"
+
+/**
+ * @brief 只输出子算子的前 limit 行
+ * @ingroup PhysicalOperator
+ */
+class LimitPhysicalOperator : public PhysicalOperator
+{
+public:
+  LimitPhysicalOperator(int limit) : limit_(limit) {}
+  virtual ~LimitPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::LIMIT; }
+
+  std::string param() const override { return std::to_string(limit_); }
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override;
+
+  RC tuple_schema(TupleSchema &schema) const override;
+
+private:
+  int limit_    = 0;
+  int returned_ = 0;  ///< 已经输出的行数
+};
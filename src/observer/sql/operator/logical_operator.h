@@ -43,6 +43,7 @@ enum class LogicalOperatorType
   EXPLAIN,     ///< 查看执行计划
   GROUP_BY,    ///< 分组
   ORDER_BY,    ///< 排序
+  LIMIT,       ///< 只输出前面若干行
 };
 
 /**
@@ -21,7 +21,10 @@ std::string physical_operator_type_name(PhysicalOperatorType type)
   switch (type) {
     case PhysicalOperatorType::TABLE_SCAN: return "TABLE_SCAN";
     case PhysicalOperatorType::INDEX_SCAN: return "INDEX_SCAN";
+    case PhysicalOperatorType::INDEX_ONLY_SCAN: return "INDEX_ONLY_SCAN";
+    case PhysicalOperatorType::VECTOR_INDEX_SCAN: return "VECTOR_INDEX_SCAN";
     case PhysicalOperatorType::NESTED_LOOP_JOIN: return "NESTED_LOOP_JOIN";
+    case PhysicalOperatorType::HASH_JOIN: return "HASH_JOIN";
     case PhysicalOperatorType::EXPLAIN: return "EXPLAIN";
     case PhysicalOperatorType::PREDICATE: return "PREDICATE";
     case PhysicalOperatorType::INSERT: return "INSERT";
@@ -36,6 +39,7 @@ std::string physical_operator_type_name(PhysicalOperatorType type)
     case PhysicalOperatorType::PROJECT_VEC: return "PROJECT_VEC";
     case PhysicalOperatorType::TABLE_SCAN_VEC: return "TABLE_SCAN_VEC";
     case PhysicalOperatorType::EXPR_VEC: return "EXPR_VEC";
+    case PhysicalOperatorType::LIMIT: return "LIMIT";
     default: return "UNKNOWN";
   }
 }
@@ -40,7 +40,10 @@ enum class PhysicalOperatorType
   TABLE_SCAN,
   TABLE_SCAN_VEC,
   INDEX_SCAN,
+  INDEX_ONLY_SCAN,
+  VECTOR_INDEX_SCAN,
   NESTED_LOOP_JOIN,
+  HASH_JOIN,
   EXPLAIN,
   PREDICATE,
   PREDICATE_VEC,
@@ -55,6 +58,7 @@ enum class PhysicalOperatorType
   HASH_GROUP_BY,
   GROUP_BY_VEC,
   ORDER_BY,
+  LIMIT,
   AGGREGATE_VEC,
   EXPR_VEC,
 };
@@ -0,0 +1,200 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include <errno.h>
+#include <string.h>
+
+#include "sql/operator/spill_file.h"
+#include "common/log/log.h"
+
+SpillFile::~SpillFile() { close(); }
+
+RC SpillFile::open()
+{
+  close();
+
+  file_ = tmpfile();
+  if (nullptr == file_) {
+    LOG_WARN("failed to create temporary file. error=%s", strerror(errno));
+    return RC::FILE_CREATE;
+  }
+  return RC::SUCCESS;
+}
+
+void SpillFile::close()
+{
+  if (file_ != nullptr) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+  row_count_ = 0;
+  size_      = 0;
+  read_rows_ = 0;
+}
+
+RC SpillFile::write_bytes(const void *data, size_t size)
+{
+  if (size > 0 && fwrite(data, size, 1, file_) != 1) {
+    LOG_WARN("failed to write temporary file. size=%zu, error=%s", size, strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  size_ += size;
+  return RC::SUCCESS;
+}
+
+RC SpillFile::read_bytes(void *data, size_t size)
+{
+  if (size > 0 && fread(data, size, 1, file_) != 1) {
+    LOG_WARN("failed to read temporary file. size=%zu, error=%s", size, strerror(errno));
+    return RC::IOERR_READ;
+  }
+  return RC::SUCCESS;
+}
+
+RC SpillFile::write(const vector<Value> &row)
+{
+  if (nullptr == file_) {
+    return RC::FILE_NOT_OPENED;
+  }
+
+  const int32_t cell_num = static_cast<int32_t>(row.size());
+  RC            rc       = write_bytes(&cell_num, sizeof(cell_num));
+  for (const Value &value : row) {
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    const int32_t type = static_cast<int32_t>(value.attr_type());
+    rc                 = write_bytes(&type, sizeof(type));
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    switch (value.attr_type()) {
+      case AttrType::NULLS: break;
+      case AttrType::CHARS:
+      case AttrType::VECTORS: {
+        const int32_t length = value.length();
+        rc                   = write_bytes(&length, sizeof(length));
+        if (OB_SUCC(rc)) {
+          rc = write_bytes(value.data(), length);
+        }
+      } break;
+      case AttrType::BOOLEANS: {
+        const int32_t bool_value = value.get_boolean() ? 1 : 0;
+        rc                       = write_bytes(&bool_value, sizeof(bool_value));
+      } break;
+      default: {
+        // INTS FLOATS DATES TEXT 都是4个字节
+        rc = write_bytes(value.data(), sizeof(int32_t));
+      } break;
+    }
+  }
+
+  if (OB_SUCC(rc)) {
+    row_count_++;
+  }
+  return rc;
+}
+
+RC SpillFile::rewind()
+{
+  if (nullptr == file_) {
+    return RC::FILE_NOT_OPENED;
+  }
+
+  if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0) {
+    LOG_WARN("failed to rewind temporary file. error=%s", strerror(errno));
+    return RC::IOERR_SEEK;
+  }
+  read_rows_ = 0;
+  return RC::SUCCESS;
+}
+
+RC SpillFile::read(vector<Value> &row)
+{
+  if (nullptr == file_) {
+    return RC::FILE_NOT_OPENED;
+  }
+  if (read_rows_ >= row_count_) {
+    return RC::RECORD_EOF;
+  }
+
+  int32_t cell_num = 0;
+  RC      rc       = read_bytes(&cell_num, sizeof(cell_num));
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  row.resize(cell_num);
+  for (Value &value : row) {
+    int32_t type = 0;
+    rc           = read_bytes(&type, sizeof(type));
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    const AttrType attr_type = static_cast<AttrType>(type);
+    switch (attr_type) {
+      case AttrType::NULLS: {
+        value.set_null();
+      } break;
+      case AttrType::CHARS:
+      case AttrType::VECTORS: {
+        int32_t length = 0;
+        rc             = read_bytes(&length, sizeof(length));
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        buffer_.resize(length + 1);
+        rc = read_bytes(buffer_.data(), length);
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        buffer_[length] = '\0';
+        value           = Value(attr_type, buffer_.data(), length);
+      } break;
+      case AttrType::BOOLEANS: {
+        int32_t bool_value = 0;
+        rc                 = read_bytes(&bool_value, sizeof(bool_value));
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        value = Value(bool_value != 0);
+      } break;
+      default: {
+        char data[sizeof(int32_t)];
+        rc = read_bytes(data, sizeof(data));
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        value = Value(attr_type, data, sizeof(data));
+      } break;
+    }
+  }
+
+  read_rows_++;
+  return RC::SUCCESS;
+}
+
+int64_t SpillFile::memory_size(const vector<Value> &row)
+{
+  int64_t size = sizeof(row) + row.size() * sizeof(Value);
+  for (const Value &value : row) {
+    if (value.attr_type() == AttrType::CHARS || value.attr_type() == AttrType::VECTORS) {
+      size += value.length();
+    }
+  }
+  return size;
+}
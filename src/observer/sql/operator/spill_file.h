@@ -0,0 +1,70 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#pragma once
+
+#include <stdio.h>
+
+#include "common/lang/vector.h"
+#include "common/rc.h"
+#include "common/value.h"
+
+/**
+ * @brief 算子使用的临时文件
+ * @ingroup PhysicalOperator
+ * @details 内存放不下中间结果时，比如 hash join 的分区，算子把一行行的数据按顺序写到临时文件中，
+ * 写完以后再从头顺序读出来。文件使用 tmpfile 创建，关闭或者进程退出时自动删除。
+ * 每个 Value 保存为类型加上数据，字符串和向量额外保存长度，NULL 只保存类型。
+ */
+class SpillFile
+{
+public:
+  SpillFile() = default;
+  ~SpillFile();
+
+  SpillFile(const SpillFile &)            = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  RC open();
+  void close();
+
+  RC write(const vector<Value> &row);
+
+  /// 写完以后调用，之后可以从第一行开始读
+  RC rewind();
+
+  /**
+   * @brief 读取下一行
+   * @return 读完时返回 RECORD_EOF
+   */
+  RC read(vector<Value> &row);
+
+  int64_t row_count() const { return row_count_; }
+  int64_t size() const { return size_; }
+
+  /// 一行数据在内存中大概占用的空间，用来判断是否超出了内存的限制
+  static int64_t memory_size(const vector<Value> &row);
+
+private:
+  RC write_bytes(const void *data, size_t size);
+  RC read_bytes(void *data, size_t size);
+
+private:
+  FILE   *file_      = nullptr;
+  int64_t row_count_ = 0;
+  int64_t size_      = 0;  ///< 写入的字节数
+  int64_t read_rows_ = 0;
+
+  vector<char> buffer_;  ///< 读取字符串和向量时使用
+};
@@ -24,3 +24,9 @@ void TableGetLogicalOperator::set_predicates(std::vector<std::unique_ptr<Express
 {
   predicates_ = std::move(exprs);
 }
+
+void TableGetLogicalOperator::set_referenced_fields(const std::vector<const FieldMeta *> &fields)
+{
+  referenced_fields_       = fields;
+  referenced_fields_known_ = true;
+}
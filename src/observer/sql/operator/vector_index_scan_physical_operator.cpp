@@ -0,0 +1,90 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+
+#include "sql/operator/vector_index_scan_physical_operator.h"
+#include "storage/index/vector_index.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+VectorIndexScanPhysicalOperator::VectorIndexScanPhysicalOperator(
+    Table *table, VectorIndex *index, std::vector<float> query, int limit)
+    : table_(table), index_(index), query_(std::move(query)), limit_(limit)
+{}
+
+RC VectorIndexScanPhysicalOperator::open(Trx *trx)
+{
+  if (nullptr == table_ || nullptr == index_) {
+    return RC::INTERNAL;
+  }
+
+  record_handler_ = table_->record_handler();
+  if (nullptr == record_handler_) {
+    LOG_WARN("invalid record handler");
+    return RC::INTERNAL;
+  }
+
+  rids_.clear();
+  rid_index_ = 0;
+  RC rc      = index_->ann_search(query_, static_cast<size_t>(limit_), rids_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to search vector index. index=%s, rc=%s", index_->index_meta().name(), strrc(rc));
+    return rc;
+  }
+
+  tuple_.set_schema(table_, table_->table_meta().field_metas());
+
+  trx_ = trx;
+  return RC::SUCCESS;
+}
+
+RC VectorIndexScanPhysicalOperator::next()
+{
+  while (rid_index_ < rids_.size()) {
+    const RID &rid = rids_[rid_index_++];
+
+    RC rc = record_handler_->get_record(rid, current_record_);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("failed to get record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+
+    rc = trx_->visit_record(table_, current_record_, ReadWriteMode::READ_ONLY);
+    if (rc == RC::RECORD_INVISIBLE) {
+      LOG_TRACE("record invisible");
+      continue;
+    }
+    return rc;
+  }
+
+  return RC::RECORD_EOF;
+}
+
+RC VectorIndexScanPhysicalOperator::close()
+{
+  rids_.clear();
+  rid_index_ = 0;
+  return RC::SUCCESS;
+}
+
+Tuple *VectorIndexScanPhysicalOperator::current_tuple()
+{
+  tuple_.set_record(&current_record_);
+  return &tuple_;
+}
+
+std::string VectorIndexScanPhysicalOperator::param() const
+{
+  return std::string(index_->index_meta().name()) + " ON " + table_->name() + " LIMIT " + std::to_string(limit_);
+}
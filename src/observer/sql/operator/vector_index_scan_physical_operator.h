@@ -0,0 +1,60 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+
+#pragma once
+
+#include "sql/expr/tuple.h"
+#include "sql/operator/physical_operator.h"
+#include "storage/record/record_manager.h"
+
+class VectorIndex;
+
+/**
+ * @brief 使用向量索引查找最近的若干行
+ * @ingroup PhysicalOperator
+ * @details 对应 ORDER BY distance(field, 常量) LIMIT n，索引按照距离从近到远给出RID，
+ * 所以这个算子可以同时代替排序和 LIMIT。结果是近似的，由索引的参数(ivfflat 的 probes，hnsw 的 ef_search)决定召回率。
+ */
+class VectorIndexScanPhysicalOperator : public PhysicalOperator
+{
+public:
+  VectorIndexScanPhysicalOperator(Table *table, VectorIndex *index, std::vector<float> query, int limit);
+  virtual ~VectorIndexScanPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::VECTOR_INDEX_SCAN; }
+
+  std::string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override;
+
+private:
+  Trx          *trx_   = nullptr;
+  Table        *table_ = nullptr;
+  VectorIndex  *index_ = nullptr;
+
+  std::vector<float> query_;
+  int                limit_ = 0;
+
+  std::vector<RID> rids_;  ///< 索引返回的结果，按照距离从近到远排列
+  size_t           rid_index_ = 0;
+
+  RecordFileHandler *record_handler_ = nullptr;
+  Record             current_record_;
+  RowTuple           tuple_;
+};
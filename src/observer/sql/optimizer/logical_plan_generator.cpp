@@ -16,12 +16,18 @@ See the Mulan PSL v2 for more details. */
 
 #include <common/log/log.h>
 
+#include "common/lang/algorithm.h"
+#include "common/lang/functional.h"
+#include "common/lang/unordered_map.h"
+#include "sql/expr/expression_iterator.h"
+
 #include "sql/operator/calc_logical_operator.h"
 #include "sql/operator/delete_logical_operator.h"
 #include "sql/operator/explain_logical_operator.h"
 #include "sql/operator/insert_logical_operator.h"
 #include "sql/operator/update_logical_operator.h"
 #include "sql/operator/join_logical_operator.h"
+#include "sql/operator/limit_logical_operator.h"
 #include "sql/operator/logical_operator.h"
 #include "sql/operator/predicate_logical_operator.h"
 #include "sql/operator/project_logical_operator.h"
@@ -211,6 +217,16 @@ RC LogicalPlanGenerator::create_plan(SelectStmt *select_stmt, unique_ptr<Logical
 
     last_oper = &order_by_oper;
   }
+
+  unique_ptr<LogicalOperator> limit_oper;
+  if (select_stmt->limit() >= 0) {
+    limit_oper = make_unique<LimitLogicalOperator>(select_stmt->limit());
+    if (*last_oper) {
+      limit_oper->add_child(std::move(*last_oper));
+    }
+    last_oper = &limit_oper;
+  }
+
   LOG_DEBUG("project begin");
   auto project_oper = make_unique<ProjectLogicalOperator>(std::move(select_stmt->query_expressions()));
   if (*last_oper) {
@@ -218,10 +234,95 @@ RC LogicalPlanGenerator::create_plan(SelectStmt *select_stmt, unique_ptr<Logical
   }
   LOG_DEBUG("project end");
 
+  mark_referenced_fields(*project_oper);
+
   logical_operator = std::move(project_oper);
   return RC::SUCCESS;
 }
 
+void LogicalPlanGenerator::mark_referenced_fields(LogicalOperator &root)
+{
+  unordered_map<const Table *, vector<const FieldMeta *>> table_fields;
+  vector<TableGetLogicalOperator *>                       table_get_opers;
+
+  bool all_fields = false;  // 遇到没有绑定到具体字段的表达式时，不能确定用到了哪些字段
+
+  function<void(Expression *)> visit_expr = [&](Expression *expr) {
+    if (nullptr == expr) {
+      return;
+    }
+
+    switch (expr->type()) {
+      case ExprType::FIELD: {
+        const Field &field  = static_cast<FieldExpr *>(expr)->field();
+        auto        &fields = table_fields[field.table()];
+        if (find(fields.begin(), fields.end(), field.meta()) == fields.end()) {
+          fields.push_back(field.meta());
+        }
+      } break;
+      case ExprType::STAR:
+      case ExprType::UNBOUND_FIELD:
+      case ExprType::UNBOUND_AGGREGATION: {
+        all_fields = true;
+      } break;
+      default: {
+        ExpressionIterator::iterate_child_expr(*expr, [&](unique_ptr<Expression> &child) {
+          visit_expr(child.get());
+          return RC::SUCCESS;
+        });
+      } break;
+    }
+  };
+
+  function<void(LogicalOperator &)> visit_oper = [&](LogicalOperator &oper) {
+    for (unique_ptr<Expression> &expr : oper.expressions()) {
+      visit_expr(expr.get());
+    }
+
+    switch (oper.type()) {
+      case LogicalOperatorType::TABLE_GET: {
+        auto &table_get_oper = static_cast<TableGetLogicalOperator &>(oper);
+        for (unique_ptr<Expression> &expr : table_get_oper.predicates()) {
+          visit_expr(expr.get());
+        }
+        table_get_opers.push_back(&table_get_oper);
+      } break;
+      case LogicalOperatorType::GROUP_BY: {
+        auto &group_by_oper = static_cast<GroupByLogicalOperator &>(oper);
+        for (unique_ptr<Expression> &expr : group_by_oper.group_by_expressions()) {
+          visit_expr(expr.get());
+        }
+        for (Expression *expr : group_by_oper.aggregate_expressions()) {
+          visit_expr(expr);
+        }
+      } break;
+      case LogicalOperatorType::ORDER_BY: {
+        auto &order_by_oper = static_cast<OrderByLogicalOperator &>(oper);
+        for (auto &order_by_expr : order_by_oper.order_by_expressions()) {
+          visit_expr(order_by_expr.second.get());
+        }
+        for (Expression *expr : order_by_oper.query_exprressions()) {
+          visit_expr(expr);
+        }
+      } break;
+      default: break;
+    }
+
+    for (unique_ptr<LogicalOperator> &child : oper.children()) {
+      visit_oper(*child);
+    }
+  };
+
+  visit_oper(root);
+  if (all_fields) {
+    return;
+  }
+
+  for (TableGetLogicalOperator *table_get_oper : table_get_opers) {
+    table_get_oper->set_referenced_fields(table_fields[table_get_oper->table()]);
+  }
+}
+
 RC LogicalPlanGenerator::create_plan(FilterStmt *filter_stmt, unique_ptr<LogicalOperator> &logical_operator)
 {
   RC                                  rc = RC::SUCCESS;
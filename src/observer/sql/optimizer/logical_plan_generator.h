@@ -52,4 +52,10 @@ private:
   RC create_order_by_plan(SelectStmt *select_stmt, std::vector<Expression*> my_query_expressions, std::unique_ptr<LogicalOperator> &logical_operator);
 
   int implicit_cast_cost(AttrType from, AttrType to);
+
+  /**
+   * @brief 把查询中用到的每个表的字段记录到对应的 TableGetLogicalOperator 上
+   * @details 物理计划生成时据此判断能不能只扫描索引
+   */
+  void mark_referenced_fields(LogicalOperator &root);
 };
\ No newline at end of file
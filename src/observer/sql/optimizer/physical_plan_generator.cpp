@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include <utility>
 
 #include "common/log/log.h"
+#include "session/session.h"
 #include "sql/expr/expression.h"
 #include "sql/operator/aggregate_vec_physical_operator.h"
 #include "sql/operator/calc_logical_operator.h"
@@ -27,11 +28,18 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/explain_physical_operator.h"
 #include "sql/operator/expr_vec_physical_operator.h"
 #include "sql/operator/group_by_vec_physical_operator.h"
+#include "sql/operator/index_only_scan_physical_operator.h"
+#include "storage/index/index.h"
+#include "storage/index/vector_index.h"
+#include "storage/table/table.h"
 #include "sql/operator/index_scan_physical_operator.h"
 #include "sql/operator/insert_logical_operator.h"
 #include "sql/operator/insert_physical_operator.h"
 #include "sql/operator/join_logical_operator.h"
+#include "sql/operator/hash_join_physical_operator.h"
 #include "sql/operator/join_physical_operator.h"
+#include "sql/operator/limit_logical_operator.h"
+#include "sql/operator/limit_physical_operator.h"
 #include "sql/operator/predicate_logical_operator.h"
 #include "sql/operator/predicate_physical_operator.h"
 #include "sql/operator/project_logical_operator.h"
@@ -46,6 +54,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/hash_group_by_physical_operator.h"
 #include "sql/operator/scalar_group_by_physical_operator.h"
 #include "sql/operator/table_scan_vec_physical_operator.h"
+#include "sql/operator/vector_index_scan_physical_operator.h"
 #include "sql/optimizer/physical_plan_generator.h"
 
 using namespace std;
@@ -99,6 +108,10 @@ RC PhysicalPlanGenerator::create(LogicalOperator &logical_operator, unique_ptr<P
       return create_plan(static_cast<OrderByLogicalOperator &>(logical_operator), oper);
     } break;
 
+    case LogicalOperatorType::LIMIT: {
+      return create_plan(static_cast<LimitLogicalOperator &>(logical_operator), oper);
+    } break;
+
     default: {
       ASSERT(false, "unknown logical operator type");
       return RC::INVALID_ARGUMENT;
@@ -133,6 +146,48 @@ RC PhysicalPlanGenerator::create_vec(LogicalOperator &logical_operator, unique_p
 
 
 
+/**
+ * @brief 查询用到的表的字段是否都在索引中
+ * @details 只读的查询才考虑，更新和删除需要完整的记录
+ */
+static bool index_covers_referenced_fields(TableGetLogicalOperator &table_get_oper, Index &index)
+{
+  if (table_get_oper.read_write_mode() != ReadWriteMode::READ_ONLY || !table_get_oper.referenced_fields_known() ||
+      index.is_vector_index()) {
+    return false;
+  }
+
+  const vector<FieldMeta> &index_fields = index.field_metas();
+  for (const FieldMeta *field : table_get_oper.referenced_fields()) {
+    auto iter = find_if(index_fields.begin(), index_fields.end(), [field](const FieldMeta &index_field) {
+      return 0 == strcmp(index_field.name(), field->name());
+    });
+    if (iter == index_fields.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 索引能不能用来查找指定的值
+ * @details IndexScanPhysicalOperator 把查找的值按照记录的格式放到字段的位置上作为键值。
+ * 多个字段的索引需要按照前缀查找，CHARS 类型的值需要 BplusTreeScanner::fix_user_key 调整长度，当前都不支持
+ */
+static bool index_supports_lookup(Index &index, const Value &value)
+{
+  const vector<FieldMeta> &index_fields = index.field_metas();
+  if (index.is_vector_index() || index_fields.size() != 2) {  // 第一个字段是NULL位图
+    return false;
+  }
+
+  const AttrType field_type = index_fields[1].type();
+  if (field_type != AttrType::INTS && field_type != AttrType::FLOATS && field_type != AttrType::DATES) {
+    return false;
+  }
+  return value.attr_type() == field_type || (field_type == AttrType::DATES && value.attr_type() == AttrType::CHARS);
+}
+
 RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper)
 {
   vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
@@ -142,6 +197,11 @@ RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, u
   Index     *index      = nullptr;
   ValueExpr *value_expr = nullptr;
   for (auto &expr : predicates) {
+    // 边遍历索引边修改数据会使扫描器失效，只有只读的查询使用索引
+    if (table_get_oper.read_write_mode() != ReadWriteMode::READ_ONLY) {
+      break;
+    }
+
     if (expr->type() == ExprType::COMPARISON) {
       auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
       // 简单处理，就找等值查询
@@ -181,9 +241,10 @@ RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, u
 
       const Field &field = field_expr->field();
       index              = table->find_index_by_field(field.field_name());
-      if (nullptr != index) {
+      if (nullptr != index && index_supports_lookup(*index, value_expr->get_value())) {
         break;
       }
+      index = nullptr;
     }
   }
 
@@ -191,13 +252,25 @@ RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, u
     ASSERT(value_expr != nullptr, "got an index but value expr is null ?");
     LOG_INFO("create plan");
     const Value               &value           = value_expr->get_value();
-    IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(table,
-        index,
-        table_get_oper.read_write_mode(),
-        &value,
-        true /*left_inclusive*/,
-        &value,
-        true /*right_inclusive*/);
+    IndexScanPhysicalOperator *index_scan_oper = nullptr;
+    if (index_covers_referenced_fields(table_get_oper, *index)) {
+      index_scan_oper = new IndexOnlyScanPhysicalOperator(table,
+          index,
+          table_get_oper.read_write_mode(),
+          &value,
+          true /*left_inclusive*/,
+          &value,
+          true /*right_inclusive*/);
+      LOG_TRACE("use index only scan");
+    } else {
+      index_scan_oper = new IndexScanPhysicalOperator(table,
+          index,
+          table_get_oper.read_write_mode(),
+          &value,
+          true /*left_inclusive*/,
+          &value,
+          true /*right_inclusive*/);
+    }
     RC rc = index_scan_oper->check_valid();
     if(OB_FAIL(rc)){
       return rc;
@@ -366,7 +439,25 @@ RC PhysicalPlanGenerator::create_plan(JoinLogicalOperator &join_oper, unique_ptr
     return RC::INTERNAL;
   }
 
-  unique_ptr<PhysicalOperator> join_physical_oper(new NestedLoopJoinPhysicalOperator);
+  unique_ptr<PhysicalOperator> join_physical_oper;
+  if (!join_oper.expressions().empty()) {
+    // 有等值连接条件时使用 hash join，条件的左边在左子算子上计算，右边在右子算子上计算
+    vector<unique_ptr<Expression>> left_keys;
+    vector<unique_ptr<Expression>> right_keys;
+    for (unique_ptr<Expression> &expr : join_oper.expressions()) {
+      auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
+      left_keys.push_back(std::move(comparison_expr->left()));
+      right_keys.push_back(std::move(comparison_expr->right()));
+    }
+    join_oper.expressions().clear();
+
+    Session *session      = Session::current_session();
+    int64_t  memory_limit = session != nullptr ? session->join_buffer_size() : Session::DEFAULT_JOIN_BUFFER_SIZE;
+    join_physical_oper    = make_unique<HashJoinPhysicalOperator>(std::move(left_keys), std::move(right_keys), memory_limit);
+  } else {
+    join_physical_oper = make_unique<NestedLoopJoinPhysicalOperator>();
+  }
+
   for (auto &child_oper : child_opers) {
     unique_ptr<PhysicalOperator> child_physical_oper;
     rc = create(*child_oper, child_physical_oper);
@@ -455,6 +546,167 @@ RC PhysicalPlanGenerator::create_plan(OrderByLogicalOperator &logical_oper, std:
   return rc;
 }
 
+RC PhysicalPlanGenerator::create_plan(LimitLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper)
+{
+  RC rc = create_vector_index_scan_plan(logical_oper, oper);
+  if (OB_FAIL(rc) || oper) {
+    return rc;
+  }
+
+  vector<unique_ptr<LogicalOperator>> &child_opers = logical_oper.children();
+  if (child_opers.size() != 1) {
+    LOG_WARN("limit operator should have one child, but got %d", child_opers.size());
+    return RC::INTERNAL;
+  }
+
+  unique_ptr<PhysicalOperator> child_physical_oper;
+  rc = create(*child_opers.front(), child_physical_oper);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create child physical operator of limit. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  auto limit_oper = make_unique<LimitPhysicalOperator>(logical_oper.limit());
+  limit_oper->add_child(child_physical_oper.release());
+  oper = std::move(limit_oper);
+  return rc;
+}
+
+/**
+ * @brief 从排序表达式中取出向量索引使用的距离函数
+ * @details 升序的 l2_distance/cosine_distance 或者降序的 inner_product 才能用索引，
+ * 表达式的一边是向量字段，另一边是常量
+ */
+static bool get_vector_distance(
+    bool asc, ArithmeticExpr &expr, VectorDistanceType &distance, FieldExpr *&field_expr, ValueExpr *&value_expr)
+{
+  switch (expr.arithmetic_type()) {
+    case ArithmeticExpr::Type::L2DISTANCE: distance = VectorDistanceType::L2; break;
+    case ArithmeticExpr::Type::COSINEDISTANCE: distance = VectorDistanceType::COSINE; break;
+    case ArithmeticExpr::Type::INNERPRODUCT: distance = VectorDistanceType::INNER_PRODUCT; break;
+    default: return false;
+  }
+  if (asc != (distance != VectorDistanceType::INNER_PRODUCT)) {
+    return false;
+  }
+
+  Expression *left  = expr.left().get();
+  Expression *right = expr.right().get();
+  if (left == nullptr || right == nullptr) {
+    return false;
+  }
+  if (left->type() == ExprType::VALUE) {
+    std::swap(left, right);
+  }
+  if (left->type() != ExprType::FIELD || right->type() != ExprType::VALUE) {
+    return false;
+  }
+
+  field_expr = static_cast<FieldExpr *>(left);
+  value_expr = static_cast<ValueExpr *>(right);
+  return field_expr->field().meta()->type() == AttrType::VECTORS;
+}
+
+/**
+ * @brief 没有 WHERE 条件时，逻辑计划中也会有一个恒为真的谓词算子
+ */
+static bool is_always_true_predicate(LogicalOperator &oper)
+{
+  if (oper.type() != LogicalOperatorType::PREDICATE || oper.expressions().size() != 1) {
+    return false;
+  }
+
+  Expression *expr = oper.expressions().front().get();
+  if (expr == nullptr) {
+    return true;
+  }
+  if (expr->type() == ExprType::VALUE) {
+    Value value;
+    return OB_SUCC(expr->try_get_value(value)) && value.get_boolean();
+  }
+  if (expr->type() == ExprType::CONJUNCTION) {
+    auto &conjunction_expr = static_cast<ConjunctionExpr &>(*expr);
+    return conjunction_expr.conjunction_type() == ConjunctionExpr::Type::AND &&
+           all_of(conjunction_expr.children().begin(),
+               conjunction_expr.children().end(),
+               [](const unique_ptr<Expression> &child) { return child == nullptr; });
+  }
+  return false;
+}
+
+RC PhysicalPlanGenerator::create_vector_index_scan_plan(
+    LimitLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper)
+{
+  // 只处理 LIMIT -> ORDER BY -> TABLE_GET 这种最简单的计划，有过滤条件时索引给出的结果可能不够
+  if (logical_oper.children().size() != 1 || logical_oper.limit() <= 0) {
+    return RC::SUCCESS;
+  }
+  LogicalOperator *child = logical_oper.children().front().get();
+  if (child->type() != LogicalOperatorType::ORDER_BY || child->children().size() != 1) {
+    return RC::SUCCESS;
+  }
+  auto &order_by_oper = static_cast<OrderByLogicalOperator &>(*child);
+  auto &order_by_exprs = order_by_oper.order_by_expressions();
+  if (order_by_exprs.size() != 1 || order_by_exprs[0].second->type() != ExprType::ARITHMETIC) {
+    return RC::SUCCESS;
+  }
+  LogicalOperator *grand_child = child->children().front().get();
+  if (is_always_true_predicate(*grand_child) && grand_child->children().size() == 1) {
+    grand_child = grand_child->children().front().get();
+  }
+  if (grand_child->type() != LogicalOperatorType::TABLE_GET) {
+    return RC::SUCCESS;
+  }
+  auto &table_get_oper = static_cast<TableGetLogicalOperator &>(*grand_child);
+  if (!table_get_oper.predicates().empty() || table_get_oper.read_write_mode() != ReadWriteMode::READ_ONLY) {
+    return RC::SUCCESS;
+  }
+
+  VectorDistanceType distance;
+  FieldExpr         *field_expr = nullptr;
+  ValueExpr         *value_expr = nullptr;
+  if (!get_vector_distance(order_by_exprs[0].first,
+          static_cast<ArithmeticExpr &>(*order_by_exprs[0].second),
+          distance,
+          field_expr,
+          value_expr)) {
+    return RC::SUCCESS;
+  }
+
+  Table           *table      = table_get_oper.table();
+  const TableMeta &table_meta = table->table_meta();
+  VectorIndex     *index      = nullptr;
+  for (int i = 0; i < table_meta.index_num() && index == nullptr; i++) {
+    const IndexMeta *index_meta = table_meta.index(i);
+    vector<string>   fields     = index_meta->field();
+    if (index_meta->is_vector_index() && index_meta->vector_params().distance == distance &&
+        fields.size() == 2 && fields[1] == field_expr->field_name()) {
+      index = static_cast<VectorIndex *>(table->find_index(index_meta->name()));
+    }
+  }
+  if (index == nullptr) {
+    return RC::SUCCESS;
+  }
+
+  Value query = value_expr->get_value();
+  if (query.attr_type() == AttrType::CHARS) {
+    Value tmp;
+    RC    rc = DataType::type_instance(AttrType::CHARS)->cast_to(query, AttrType::VECTORS, tmp);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to cast query vector. value=%s, rc=%s", query.to_string().c_str(), strrc(rc));
+      return RC::SUCCESS;  // 交给普通的执行计划报错
+    }
+    query = tmp;
+  }
+  if (query.attr_type() != AttrType::VECTORS || static_cast<int>(query.get_vector().size()) != index->dimension()) {
+    return RC::SUCCESS;
+  }
+
+  LOG_TRACE("use vector index. index=%s, limit=%d", index->index_meta().name(), logical_oper.limit());
+  oper = make_unique<VectorIndexScanPhysicalOperator>(table, index, query.get_vector(), logical_oper.limit());
+  return RC::SUCCESS;
+}
+
 RC PhysicalPlanGenerator::create_vec_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper)
 {
   vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
@@ -0,0 +1,147 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include "sql/optimizer/predicate_to_join_rule.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/expr/expression_iterator.h"
+#include "sql/operator/logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+
+/// 收集逻辑算子树中所有的表名
+static void collect_tables(LogicalOperator &oper, set<string> &tables)
+{
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    tables.insert(static_cast<TableGetLogicalOperator &>(oper).table()->name());
+  }
+  for (std::unique_ptr<LogicalOperator> &child : oper.children()) {
+    collect_tables(*child, tables);
+  }
+}
+
+/**
+ * @brief 收集表达式引用的所有表
+ * @return 表达式中有没有不能在一行数据上计算的部分，比如聚合
+ */
+static bool collect_expr_tables(Expression &expr, set<string> &tables)
+{
+  if (expr.type() == ExprType::FIELD) {
+    tables.insert(static_cast<FieldExpr &>(expr).table_name());
+    return true;
+  }
+  if (expr.type() == ExprType::AGGREGATION) {
+    return false;
+  }
+
+  bool ok = true;
+  ExpressionIterator::iterate_child_expr(expr, [&](std::unique_ptr<Expression> &child) {
+    ok = ok && collect_expr_tables(*child, tables);
+    return RC::SUCCESS;
+  });
+  return ok;
+}
+
+static bool is_subset(const set<string> &tables, const set<string> &all_tables)
+{
+  for (const string &table : tables) {
+    if (all_tables.count(table) == 0) {
+      return false;
+    }
+  }
+  return !tables.empty();
+}
+
+bool PredicateToJoinRewriter::is_equi_join_condition(
+    ComparisonExpr &expr, const set<string> &left_tables, const set<string> &right_tables)
+{
+  if (expr.comp() != EQUAL_TO || expr.left()->value_type() != expr.right()->value_type()) {
+    return false;
+  }
+
+  set<string> tables[2];
+  if (!collect_expr_tables(*expr.left(), tables[0]) || !collect_expr_tables(*expr.right(), tables[1])) {
+    return false;
+  }
+
+  if (is_subset(tables[0], left_tables) && is_subset(tables[1], right_tables)) {
+    return true;
+  }
+  if (is_subset(tables[0], right_tables) && is_subset(tables[1], left_tables)) {
+    std::swap(expr.left(), expr.right());
+    return true;
+  }
+  return false;
+}
+
+RC PredicateToJoinRewriter::rewrite(std::unique_ptr<LogicalOperator> &oper, bool &change_made)
+{
+  if (oper->type() != LogicalOperatorType::PREDICATE || oper->children().size() != 1 ||
+      oper->expressions().size() != 1) {
+    return RC::SUCCESS;
+  }
+
+  LogicalOperator &join_oper = *oper->children().front();
+  if (join_oper.type() != LogicalOperatorType::JOIN || join_oper.children().size() != 2) {
+    return RC::SUCCESS;
+  }
+
+  set<string> left_tables;
+  set<string> right_tables;
+  collect_tables(*join_oper.children()[0], left_tables);
+  collect_tables(*join_oper.children()[1], right_tables);
+  for (const string &table : left_tables) {
+    if (right_tables.count(table) != 0) {
+      // 同一个表出现在两边时，无法根据表名区分字段属于哪一边
+      return RC::SUCCESS;
+    }
+  }
+
+  std::unique_ptr<Expression> &predicate = oper->expressions().front();
+  if (predicate->type() == ExprType::COMPARISON) {
+    if (is_equi_join_condition(static_cast<ComparisonExpr &>(*predicate), left_tables, right_tables)) {
+      join_oper.expressions().push_back(std::move(predicate));
+      predicate   = std::make_unique<ValueExpr>(Value(true));
+      change_made = true;
+    }
+    return RC::SUCCESS;
+  }
+
+  if (predicate->type() != ExprType::CONJUNCTION) {
+    return RC::SUCCESS;
+  }
+
+  auto conjunction_expr = static_cast<ConjunctionExpr *>(predicate.get());
+  if (conjunction_expr->conjunction_type() != ConjunctionExpr::Type::AND) {
+    return RC::SUCCESS;
+  }
+
+  std::vector<std::unique_ptr<Expression>> &children = conjunction_expr->children();
+  for (auto iter = children.begin(); iter != children.end();) {
+    Expression *child = iter->get();
+    if (child != nullptr && child->type() == ExprType::COMPARISON &&
+        is_equi_join_condition(static_cast<ComparisonExpr &>(*child), left_tables, right_tables)) {
+      join_oper.expressions().push_back(std::move(*iter));
+      iter        = children.erase(iter);
+      change_made = true;
+    } else {
+      ++iter;
+    }
+  }
+
+  if (change_made && children.empty()) {
+    // 所有的条件都移动到了连接算子中，谓词算子恒为真，会被 PredicateRewriteRule 删除
+    predicate = std::make_unique<ValueExpr>(Value(true));
+  }
+  return RC::SUCCESS;
+}
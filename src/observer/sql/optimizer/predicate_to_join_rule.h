@@ -0,0 +1,45 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#pragma once
+
+#include "common/lang/set.h"
+#include "common/lang/string.h"
+#include "sql/optimizer/rewrite_rule.h"
+
+class ComparisonExpr;
+
+/**
+ * @brief 把连接条件从谓词算子移动到连接算子中
+ * @ingroup Rewriter
+ * @details 连接的条件，不管是 JOIN ... ON 还是 WHERE 中的，在逻辑计划中都是连接算子上面的谓词算子。
+ * 如果某个 AND 条件是 left = right，两边分别只引用连接算子左右两个子算子中的表，并且类型相同，
+ * 就把它移动到连接算子的表达式中，物理计划可以据此使用 hash join，而不是嵌套循环连接。
+ * 连接算子的每个表达式都是 ComparisonExpr，左边引用左子算子，右边引用右子算子。
+ */
+class PredicateToJoinRewriter : public RewriteRule
+{
+public:
+  PredicateToJoinRewriter()          = default;
+  virtual ~PredicateToJoinRewriter() = default;
+
+  RC rewrite(std::unique_ptr<LogicalOperator> &oper, bool &change_made) override;
+
+private:
+  /**
+   * @brief 判断是否是两个子算子之间的等值连接条件
+   * @details 如果左边引用右子算子，右边引用左子算子，会交换比较的两边
+   */
+  bool is_equi_join_condition(ComparisonExpr &expr, const set<string> &left_tables, const set<string> &right_tables);
+};
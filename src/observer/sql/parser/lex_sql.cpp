@@ -799,6 +799,7 @@ static const flex_int16_t yy_chk[1115] =
 
 #line 28 "lex_sql.l"
 #include<string.h>
+#include<strings.h>
 #include<stdio.h>
 
 /**
@@ -820,7 +821,30 @@ extern int atoi();
 extern double atof();
 
 #define RETURN_TOKEN(token) LOG_DEBUG("%s", #token);return token
-#line 824 "lex_sql.cpp"
+
+/**
+ * 没有单独词法规则的关键字，先按照标识符匹配，再查这个表
+ */
+static int keyword_or_id(const char *text, YYSTYPE *yylval)
+{
+  static const struct
+  {
+    const char *name;
+    int         token;
+  } keywords[] = {
+      {"LIMIT", LIMIT},
+      {"WITH", WITH},
+  };
+
+  for (const auto &keyword : keywords) {
+    if (0 == strcasecmp(text, keyword.name)) {
+      return keyword.token;
+    }
+  }
+  yylval->string = strdup(text);
+  return ID;
+}
+#line 848 "lex_sql.cpp"
 /* Prevent the need for linking with -lfl */
 #define YY_NO_INPUT 1
 /* 不区分大小写 */
@@ -829,7 +853,7 @@ extern double atof();
 /* 1. 匹配的规则长的优先 */
 /* 2. 写在最前面的优先 */
 /* yylval 就可以认为是 yacc 中 %union 定义的结构体(union 结构) */
-#line 833 "lex_sql.cpp"
+#line 857 "lex_sql.cpp"
 
 #define INITIAL 0
 #define STR 1
@@ -1112,10 +1136,10 @@ YY_DECL
 		}
 
 	{
-#line 75 "lex_sql.l"
+#line 99 "lex_sql.l"
 
 
-#line 1119 "lex_sql.cpp"
+#line 1143 "lex_sql.cpp"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -1174,384 +1198,384 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 77 "lex_sql.l"
+#line 101 "lex_sql.l"
 // ignore whitespace
 	YY_BREAK
 case 2:
 /* rule 2 can match eol */
 YY_RULE_SETUP
-#line 78 "lex_sql.l"
+#line 102 "lex_sql.l"
 ;
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 80 "lex_sql.l"
+#line 104 "lex_sql.l"
 yylval->number=atoi(yytext); RETURN_TOKEN(NUMBER);
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 81 "lex_sql.l"
+#line 105 "lex_sql.l"
 yylval->floats=(float)(atof(yytext)); RETURN_TOKEN(FLOAT);
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 83 "lex_sql.l"
+#line 107 "lex_sql.l"
 RETURN_TOKEN(SEMICOLON);
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 84 "lex_sql.l"
+#line 108 "lex_sql.l"
 RETURN_TOKEN(DOT);
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 85 "lex_sql.l"
+#line 109 "lex_sql.l"
 RETURN_TOKEN(EXIT);
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 86 "lex_sql.l"
+#line 110 "lex_sql.l"
 RETURN_TOKEN(HELP);
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 87 "lex_sql.l"
+#line 111 "lex_sql.l"
 RETURN_TOKEN(DESC);
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 88 "lex_sql.l"
+#line 112 "lex_sql.l"
 RETURN_TOKEN(CREATE);
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 89 "lex_sql.l"
+#line 113 "lex_sql.l"
 RETURN_TOKEN(DROP);
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 90 "lex_sql.l"
+#line 114 "lex_sql.l"
 RETURN_TOKEN(TABLE);
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 91 "lex_sql.l"
+#line 115 "lex_sql.l"
 RETURN_TOKEN(TABLES);
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 92 "lex_sql.l"
+#line 116 "lex_sql.l"
 RETURN_TOKEN(INDEX);
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 93 "lex_sql.l"
+#line 117 "lex_sql.l"
 RETURN_TOKEN(ON);
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 94 "lex_sql.l"
+#line 118 "lex_sql.l"
 RETURN_TOKEN(SHOW);
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 95 "lex_sql.l"
+#line 119 "lex_sql.l"
 RETURN_TOKEN(SYNC);
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 96 "lex_sql.l"
+#line 120 "lex_sql.l"
 RETURN_TOKEN(SELECT);
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 97 "lex_sql.l"
+#line 121 "lex_sql.l"
 RETURN_TOKEN(CALC);
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 98 "lex_sql.l"
+#line 122 "lex_sql.l"
 RETURN_TOKEN(FROM);
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 99 "lex_sql.l"
+#line 123 "lex_sql.l"
 RETURN_TOKEN(WHERE);
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 100 "lex_sql.l"
+#line 124 "lex_sql.l"
 RETURN_TOKEN(AND);
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 101 "lex_sql.l"
+#line 125 "lex_sql.l"
 RETURN_TOKEN(INSERT);
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 102 "lex_sql.l"
+#line 126 "lex_sql.l"
 RETURN_TOKEN(INTO);
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 103 "lex_sql.l"
+#line 127 "lex_sql.l"
 RETURN_TOKEN(VALUES);
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 104 "lex_sql.l"
+#line 128 "lex_sql.l"
 RETURN_TOKEN(DELETE);
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 105 "lex_sql.l"
+#line 129 "lex_sql.l"
 RETURN_TOKEN(UPDATE);
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 106 "lex_sql.l"
+#line 130 "lex_sql.l"
 RETURN_TOKEN(SET);
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 107 "lex_sql.l"
+#line 131 "lex_sql.l"
 RETURN_TOKEN(TRX_BEGIN);
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 108 "lex_sql.l"
+#line 132 "lex_sql.l"
 RETURN_TOKEN(TRX_COMMIT);
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 109 "lex_sql.l"
+#line 133 "lex_sql.l"
 RETURN_TOKEN(TRX_ROLLBACK);
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
-#line 110 "lex_sql.l"
+#line 134 "lex_sql.l"
 RETURN_TOKEN(INT_T);
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
-#line 111 "lex_sql.l"
+#line 135 "lex_sql.l"
 RETURN_TOKEN(STRING_T);
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 112 "lex_sql.l"
+#line 136 "lex_sql.l"
 RETURN_TOKEN(DATE_T);
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 113 "lex_sql.l"
+#line 137 "lex_sql.l"
 RETURN_TOKEN(FLOAT_T);
 	YY_BREAK
 case 36:
 YY_RULE_SETUP
-#line 114 "lex_sql.l"
+#line 138 "lex_sql.l"
 RETURN_TOKEN(VECTOR_T);
 	YY_BREAK
 case 37:
 YY_RULE_SETUP
-#line 115 "lex_sql.l"
+#line 139 "lex_sql.l"
 RETURN_TOKEN(LOAD);
 	YY_BREAK
 case 38:
 YY_RULE_SETUP
-#line 116 "lex_sql.l"
+#line 140 "lex_sql.l"
 RETURN_TOKEN(DATA);
 	YY_BREAK
 case 39:
 YY_RULE_SETUP
-#line 117 "lex_sql.l"
+#line 141 "lex_sql.l"
 RETURN_TOKEN(INFILE);
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 118 "lex_sql.l"
+#line 142 "lex_sql.l"
 RETURN_TOKEN(EXPLAIN);
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 119 "lex_sql.l"
+#line 143 "lex_sql.l"
 RETURN_TOKEN(GROUP);
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
-#line 120 "lex_sql.l"
+#line 144 "lex_sql.l"
 RETURN_TOKEN(BY);
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 121 "lex_sql.l"
+#line 145 "lex_sql.l"
 RETURN_TOKEN(HAVING);
 	YY_BREAK
 case 44:
 YY_RULE_SETUP
-#line 122 "lex_sql.l"
+#line 146 "lex_sql.l"
 RETURN_TOKEN(UNIQUE);
 	YY_BREAK
 case 45:
 YY_RULE_SETUP
-#line 123 "lex_sql.l"
+#line 147 "lex_sql.l"
 RETURN_TOKEN(INNER);
 	YY_BREAK
 case 46:
 YY_RULE_SETUP
-#line 124 "lex_sql.l"
+#line 148 "lex_sql.l"
 RETURN_TOKEN(JOIN);
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 125 "lex_sql.l"
+#line 149 "lex_sql.l"
 RETURN_TOKEN(STORAGE);
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 126 "lex_sql.l"
+#line 150 "lex_sql.l"
 RETURN_TOKEN(FORMAT);
 	YY_BREAK
 case 49:
 YY_RULE_SETUP
-#line 127 "lex_sql.l"
+#line 151 "lex_sql.l"
 RETURN_TOKEN(NOT);
 	YY_BREAK
 case 50:
 YY_RULE_SETUP
-#line 128 "lex_sql.l"
+#line 152 "lex_sql.l"
 RETURN_TOKEN(LIKE);
 	YY_BREAK
 case 51:
 YY_RULE_SETUP
-#line 129 "lex_sql.l"
+#line 153 "lex_sql.l"
 RETURN_TOKEN(NULL_T);
 	YY_BREAK
 case 52:
 YY_RULE_SETUP
-#line 130 "lex_sql.l"
+#line 154 "lex_sql.l"
 RETURN_TOKEN(IS);
 	YY_BREAK
 case 53:
 YY_RULE_SETUP
-#line 131 "lex_sql.l"
+#line 155 "lex_sql.l"
 RETURN_TOKEN(ORDER);
 	YY_BREAK
 case 54:
 YY_RULE_SETUP
-#line 132 "lex_sql.l"
+#line 156 "lex_sql.l"
 RETURN_TOKEN(ASC);
 	YY_BREAK
 case 55:
 YY_RULE_SETUP
-#line 133 "lex_sql.l"
+#line 157 "lex_sql.l"
 RETURN_TOKEN(TEXT_T);
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 134 "lex_sql.l"
+#line 158 "lex_sql.l"
 RETURN_TOKEN(INNER_PRODUCT);
 	YY_BREAK
 case 57:
 YY_RULE_SETUP
-#line 135 "lex_sql.l"
+#line 159 "lex_sql.l"
 RETURN_TOKEN(COSINE_DISTANCE);
 	YY_BREAK
 case 58:
 YY_RULE_SETUP
-#line 136 "lex_sql.l"
+#line 160 "lex_sql.l"
 RETURN_TOKEN(L2_DISTANCE);
 	YY_BREAK
 case 59:
 YY_RULE_SETUP
-#line 137 "lex_sql.l"
-yylval->string=strdup(yytext); RETURN_TOKEN(ID);
+#line 161 "lex_sql.l"
+RETURN_TOKEN(keyword_or_id(yytext, yylval));
 	YY_BREAK
 case 60:
 YY_RULE_SETUP
-#line 138 "lex_sql.l"
+#line 162 "lex_sql.l"
 RETURN_TOKEN(LBRACE);
 	YY_BREAK
 case 61:
 YY_RULE_SETUP
-#line 139 "lex_sql.l"
+#line 163 "lex_sql.l"
 RETURN_TOKEN(RBRACE);
 	YY_BREAK
 case 62:
 YY_RULE_SETUP
-#line 141 "lex_sql.l"
+#line 165 "lex_sql.l"
 RETURN_TOKEN(COMMA);
 	YY_BREAK
 case 63:
 YY_RULE_SETUP
-#line 142 "lex_sql.l"
+#line 166 "lex_sql.l"
 RETURN_TOKEN(EQ);
 	YY_BREAK
 case 64:
 YY_RULE_SETUP
-#line 143 "lex_sql.l"
+#line 167 "lex_sql.l"
 RETURN_TOKEN(LE);
 	YY_BREAK
 case 65:
 YY_RULE_SETUP
-#line 144 "lex_sql.l"
+#line 168 "lex_sql.l"
 RETURN_TOKEN(NE);
 	YY_BREAK
 case 66:
 YY_RULE_SETUP
-#line 145 "lex_sql.l"
+#line 169 "lex_sql.l"
 RETURN_TOKEN(NE);
 	YY_BREAK
 case 67:
 YY_RULE_SETUP
-#line 146 "lex_sql.l"
+#line 170 "lex_sql.l"
 RETURN_TOKEN(LT);
 	YY_BREAK
 case 68:
 YY_RULE_SETUP
-#line 147 "lex_sql.l"
+#line 171 "lex_sql.l"
 RETURN_TOKEN(GE);
 	YY_BREAK
 case 69:
 YY_RULE_SETUP
-#line 148 "lex_sql.l"
+#line 172 "lex_sql.l"
 RETURN_TOKEN(GT);
 	YY_BREAK
 case 70:
-#line 151 "lex_sql.l"
+#line 175 "lex_sql.l"
 case 71:
-#line 152 "lex_sql.l"
+#line 176 "lex_sql.l"
 case 72:
-#line 153 "lex_sql.l"
+#line 177 "lex_sql.l"
 case 73:
 YY_RULE_SETUP
-#line 153 "lex_sql.l"
+#line 177 "lex_sql.l"
 { return yytext[0]; }
 	YY_BREAK
 case 74:
 /* rule 74 can match eol */
 YY_RULE_SETUP
-#line 154 "lex_sql.l"
+#line 178 "lex_sql.l"
 yylval->string = strdup(yytext); RETURN_TOKEN(SSS);
 	YY_BREAK
 case 75:
 /* rule 75 can match eol */
 YY_RULE_SETUP
-#line 155 "lex_sql.l"
+#line 179 "lex_sql.l"
 yylval->string = strdup(yytext); RETURN_TOKEN(SSS);
 	YY_BREAK
 case 76:
 YY_RULE_SETUP
-#line 157 "lex_sql.l"
+#line 181 "lex_sql.l"
 LOG_DEBUG("Unknown character [%c]",yytext[0]); return yytext[0];
 	YY_BREAK
 case 77:
 YY_RULE_SETUP
-#line 158 "lex_sql.l"
+#line 182 "lex_sql.l"
 ECHO;
 	YY_BREAK
-#line 1555 "lex_sql.cpp"
+#line 1579 "lex_sql.cpp"
 case YY_STATE_EOF(INITIAL):
 case YY_STATE_EOF(STR):
 	yyterminate();
@@ -2707,7 +2731,7 @@ void yyfree (void * ptr , yyscan_t yyscanner)
 
 #define YYTABLES_NAME "yytables"
 
-#line 158 "lex_sql.l"
+#line 182 "lex_sql.l"
 
 
 void scan_string(const char *str, yyscan_t scanner) {
@@ -111,6 +111,7 @@ struct SelectSqlNode
   std::vector<std::unique_ptr<Expression>> group_by;     ///< group by clause
   Expression*                              having = nullptr;     ///< having clause
   std::vector<std::pair<bool,Expression*>> order_by;     ///< order by clause 
+  int                                      limit = -1;   ///< limit clause，-1 表示没有
 };
 
 /**
@@ -197,9 +198,11 @@ struct DropTableSqlNode
 struct CreateIndexSqlNode
 {
   bool isunique;
+  bool is_vector = false;      ///< create vector index
   std::string index_name;      ///< Index name
   std::string relation_name;   ///< Relation name
   std::vector<string> attribute_names;  ///< Attribute name
+  std::vector<std::pair<std::string, std::string>> options;  ///< 向量索引 with 子句中的参数，比如 lists=10
 };
 
 /**
@@ -215,65 +215,70 @@ enum yysymbol_kind_t
   YYSYMBOL_INNER_PRODUCT = 63,             /* INNER_PRODUCT  */
   YYSYMBOL_COSINE_DISTANCE = 64,           /* COSINE_DISTANCE  */
   YYSYMBOL_L2_DISTANCE = 65,               /* L2_DISTANCE  */
-  YYSYMBOL_NUMBER = 66,                    /* NUMBER  */
-  YYSYMBOL_FLOAT = 67,                     /* FLOAT  */
-  YYSYMBOL_ID = 68,                        /* ID  */
-  YYSYMBOL_SSS = 69,                       /* SSS  */
-  YYSYMBOL_70_ = 70,                       /* '+'  */
-  YYSYMBOL_71_ = 71,                       /* '-'  */
-  YYSYMBOL_72_ = 72,                       /* '*'  */
-  YYSYMBOL_73_ = 73,                       /* '/'  */
-  YYSYMBOL_UMINUS = 74,                    /* UMINUS  */
-  YYSYMBOL_YYACCEPT = 75,                  /* $accept  */
-  YYSYMBOL_commands = 76,                  /* commands  */
-  YYSYMBOL_command_wrapper = 77,           /* command_wrapper  */
-  YYSYMBOL_exit_stmt = 78,                 /* exit_stmt  */
-  YYSYMBOL_help_stmt = 79,                 /* help_stmt  */
-  YYSYMBOL_sync_stmt = 80,                 /* sync_stmt  */
-  YYSYMBOL_begin_stmt = 81,                /* begin_stmt  */
-  YYSYMBOL_commit_stmt = 82,               /* commit_stmt  */
-  YYSYMBOL_rollback_stmt = 83,             /* rollback_stmt  */
-  YYSYMBOL_drop_table_stmt = 84,           /* drop_table_stmt  */
-  YYSYMBOL_show_tables_stmt = 85,          /* show_tables_stmt  */
-  YYSYMBOL_desc_table_stmt = 86,           /* desc_table_stmt  */
-  YYSYMBOL_create_index_stmt = 87,         /* create_index_stmt  */
-  YYSYMBOL_is_unique = 88,                 /* is_unique  */
-  YYSYMBOL_index_list = 89,                /* index_list  */
-  YYSYMBOL_drop_index_stmt = 90,           /* drop_index_stmt  */
-  YYSYMBOL_create_table_stmt = 91,         /* create_table_stmt  */
-  YYSYMBOL_attr_def_list = 92,             /* attr_def_list  */
-  YYSYMBOL_attr_def = 93,                  /* attr_def  */
-  YYSYMBOL_null_option = 94,               /* null_option  */
-  YYSYMBOL_number = 95,                    /* number  */
-  YYSYMBOL_type = 96,                      /* type  */
-  YYSYMBOL_insert_stmt = 97,               /* insert_stmt  */
-  YYSYMBOL_value_list = 98,                /* value_list  */
-  YYSYMBOL_value = 99,                     /* value  */
-  YYSYMBOL_storage_format = 100,           /* storage_format  */
-  YYSYMBOL_delete_stmt = 101,              /* delete_stmt  */
-  YYSYMBOL_update_stmt = 102,              /* update_stmt  */
-  YYSYMBOL_update_list = 103,              /* update_list  */
-  YYSYMBOL_select_stmt = 104,              /* select_stmt  */
-  YYSYMBOL_calc_stmt = 105,                /* calc_stmt  */
-  YYSYMBOL_expression_list = 106,          /* expression_list  */
-  YYSYMBOL_expression = 107,               /* expression  */
-  YYSYMBOL_aggr_expr = 108,                /* aggr_expr  */
-  YYSYMBOL_rel_attr = 109,                 /* rel_attr  */
-  YYSYMBOL_join_list = 110,                /* join_list  */
-  YYSYMBOL_join_chain = 111,               /* join_chain  */
-  YYSYMBOL_where = 112,                    /* where  */
-  YYSYMBOL_is_null_comp = 113,             /* is_null_comp  */
-  YYSYMBOL_condition = 114,                /* condition  */
-  YYSYMBOL_comp_op = 115,                  /* comp_op  */
-  YYSYMBOL_group_by = 116,                 /* group_by  */
-  YYSYMBOL_having = 117,                   /* having  */
-  YYSYMBOL_order_node = 118,               /* order_node  */
-  YYSYMBOL_order_by_list = 119,            /* order_by_list  */
-  YYSYMBOL_order_by = 120,                 /* order_by  */
-  YYSYMBOL_load_data_stmt = 121,           /* load_data_stmt  */
-  YYSYMBOL_explain_stmt = 122,             /* explain_stmt  */
-  YYSYMBOL_set_variable_stmt = 123,        /* set_variable_stmt  */
-  YYSYMBOL_opt_semicolon = 124             /* opt_semicolon  */
+  YYSYMBOL_LIMIT = 66,                     /* LIMIT  */
+  YYSYMBOL_WITH = 67,                      /* WITH  */
+  YYSYMBOL_NUMBER = 68,                    /* NUMBER  */
+  YYSYMBOL_FLOAT = 69,                     /* FLOAT  */
+  YYSYMBOL_ID = 70,                        /* ID  */
+  YYSYMBOL_SSS = 71,                       /* SSS  */
+  YYSYMBOL_72_ = 72,                       /* '+'  */
+  YYSYMBOL_73_ = 73,                       /* '-'  */
+  YYSYMBOL_74_ = 74,                       /* '*'  */
+  YYSYMBOL_75_ = 75,                       /* '/'  */
+  YYSYMBOL_UMINUS = 76,                    /* UMINUS  */
+  YYSYMBOL_YYACCEPT = 77,                  /* $accept  */
+  YYSYMBOL_commands = 78,                  /* commands  */
+  YYSYMBOL_command_wrapper = 79,           /* command_wrapper  */
+  YYSYMBOL_exit_stmt = 80,                 /* exit_stmt  */
+  YYSYMBOL_help_stmt = 81,                 /* help_stmt  */
+  YYSYMBOL_sync_stmt = 82,                 /* sync_stmt  */
+  YYSYMBOL_begin_stmt = 83,                /* begin_stmt  */
+  YYSYMBOL_commit_stmt = 84,               /* commit_stmt  */
+  YYSYMBOL_rollback_stmt = 85,             /* rollback_stmt  */
+  YYSYMBOL_drop_table_stmt = 86,           /* drop_table_stmt  */
+  YYSYMBOL_show_tables_stmt = 87,          /* show_tables_stmt  */
+  YYSYMBOL_desc_table_stmt = 88,           /* desc_table_stmt  */
+  YYSYMBOL_create_index_stmt = 89,         /* create_index_stmt  */
+  YYSYMBOL_index_option_list = 90,         /* index_option_list  */
+  YYSYMBOL_index_option = 91,              /* index_option  */
+  YYSYMBOL_is_unique = 92,                 /* is_unique  */
+  YYSYMBOL_index_list = 93,                /* index_list  */
+  YYSYMBOL_drop_index_stmt = 94,           /* drop_index_stmt  */
+  YYSYMBOL_create_table_stmt = 95,         /* create_table_stmt  */
+  YYSYMBOL_attr_def_list = 96,             /* attr_def_list  */
+  YYSYMBOL_attr_def = 97,                  /* attr_def  */
+  YYSYMBOL_null_option = 98,               /* null_option  */
+  YYSYMBOL_number = 99,                    /* number  */
+  YYSYMBOL_type = 100,                     /* type  */
+  YYSYMBOL_insert_stmt = 101,              /* insert_stmt  */
+  YYSYMBOL_value_list = 102,               /* value_list  */
+  YYSYMBOL_value = 103,                    /* value  */
+  YYSYMBOL_storage_format = 104,           /* storage_format  */
+  YYSYMBOL_delete_stmt = 105,              /* delete_stmt  */
+  YYSYMBOL_update_stmt = 106,              /* update_stmt  */
+  YYSYMBOL_update_list = 107,              /* update_list  */
+  YYSYMBOL_select_stmt = 108,              /* select_stmt  */
+  YYSYMBOL_calc_stmt = 109,                /* calc_stmt  */
+  YYSYMBOL_expression_list = 110,          /* expression_list  */
+  YYSYMBOL_expression = 111,               /* expression  */
+  YYSYMBOL_aggr_expr = 112,                /* aggr_expr  */
+  YYSYMBOL_rel_attr = 113,                 /* rel_attr  */
+  YYSYMBOL_join_list = 114,                /* join_list  */
+  YYSYMBOL_join_chain = 115,               /* join_chain  */
+  YYSYMBOL_where = 116,                    /* where  */
+  YYSYMBOL_is_null_comp = 117,             /* is_null_comp  */
+  YYSYMBOL_condition = 118,                /* condition  */
+  YYSYMBOL_comp_op = 119,                  /* comp_op  */
+  YYSYMBOL_group_by = 120,                 /* group_by  */
+  YYSYMBOL_having = 121,                   /* having  */
+  YYSYMBOL_order_node = 122,               /* order_node  */
+  YYSYMBOL_order_by_list = 123,            /* order_by_list  */
+  YYSYMBOL_order_by = 124,                 /* order_by  */
+  YYSYMBOL_limit = 125,                    /* limit  */
+  YYSYMBOL_load_data_stmt = 126,           /* load_data_stmt  */
+  YYSYMBOL_explain_stmt = 127,             /* explain_stmt  */
+  YYSYMBOL_set_variable_stmt = 128,        /* set_variable_stmt  */
+  YYSYMBOL_opt_semicolon = 129             /* opt_semicolon  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -602,21 +607,21 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  71
+#define YYFINAL  72
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   236
+#define YYLAST   261
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  75
+#define YYNTOKENS  77
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  50
+#define YYNNTS  53
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  120
+#define YYNRULES  130
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  229
+#define YYNSTATES  254
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   325
+#define YYMAXUTOK   327
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -634,7 +639,7 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,    72,    70,     2,    71,     2,    73,     2,     2,
+       2,     2,    74,    72,     2,    73,     2,    75,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -662,26 +667,27 @@ static const yytype_int8 yytranslate[] =
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
       45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
       55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
-      65,    66,    67,    68,    69,    74
+      65,    66,    67,    68,    69,    70,    71,    76
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   219,   219,   227,   228,   229,   230,   231,   232,   233,
-     234,   235,   236,   237,   238,   239,   240,   241,   242,   243,
-     244,   245,   246,   250,   256,   261,   267,   273,   279,   285,
-     292,   298,   306,   320,   323,   329,   334,   348,   358,   382,
-     385,   397,   409,   420,   423,   427,   433,   436,   437,   438,
-     439,   440,   441,   444,   461,   464,   475,   479,   483,   489,
-     496,   499,   506,   517,   529,   534,   547,   579,   588,   593,
-     604,   607,   610,   613,   616,   619,   622,   625,   629,   632,
-     637,   643,   646,   652,   674,   679,   689,   693,   704,   708,
-     721,   724,   729,   733,   740,   744,   748,   760,   761,   762,
-     763,   764,   765,   766,   767,   773,   776,   782,   785,   790,
-     794,   798,   804,   810,   818,   821,   827,   840,   848,   858,
-     859
+       0,   226,   226,   234,   235,   236,   237,   238,   239,   240,
+     241,   242,   243,   244,   245,   246,   247,   248,   249,   250,
+     251,   252,   253,   257,   263,   268,   274,   280,   286,   292,
+     299,   305,   313,   324,   341,   347,   355,   361,   366,   371,
+     376,   384,   387,   393,   398,   412,   422,   446,   449,   461,
+     473,   484,   487,   491,   497,   500,   501,   502,   503,   504,
+     505,   508,   525,   528,   539,   543,   547,   553,   560,   563,
+     570,   581,   593,   598,   611,   645,   654,   659,   670,   673,
+     676,   679,   682,   685,   688,   691,   695,   698,   703,   709,
+     712,   718,   740,   745,   755,   759,   770,   774,   787,   790,
+     795,   799,   806,   810,   814,   826,   827,   828,   829,   830,
+     831,   832,   833,   839,   842,   848,   851,   856,   860,   864,
+     870,   876,   884,   887,   894,   897,   903,   916,   924,   934,
+     935
 };
 #endif
 
@@ -705,18 +711,19 @@ static const char *const yytname[] =
   "FROM", "WHERE", "AND", "SET", "ON", "LOAD", "DATA", "INFILE", "EXPLAIN",
   "STORAGE", "FORMAT", "EQ", "LT", "GT", "LE", "GE", "NE", "LIKE", "NOT",
   "NULL_T", "IS", "HAVING", "INNER", "JOIN", "ORDER", "ASC", "UNIQUE",
-  "TEXT_T", "INNER_PRODUCT", "COSINE_DISTANCE", "L2_DISTANCE", "NUMBER",
-  "FLOAT", "ID", "SSS", "'+'", "'-'", "'*'", "'/'", "UMINUS", "$accept",
-  "commands", "command_wrapper", "exit_stmt", "help_stmt", "sync_stmt",
-  "begin_stmt", "commit_stmt", "rollback_stmt", "drop_table_stmt",
-  "show_tables_stmt", "desc_table_stmt", "create_index_stmt", "is_unique",
+  "TEXT_T", "INNER_PRODUCT", "COSINE_DISTANCE", "L2_DISTANCE", "LIMIT",
+  "WITH", "NUMBER", "FLOAT", "ID", "SSS", "'+'", "'-'", "'*'", "'/'",
+  "UMINUS", "$accept", "commands", "command_wrapper", "exit_stmt",
+  "help_stmt", "sync_stmt", "begin_stmt", "commit_stmt", "rollback_stmt",
+  "drop_table_stmt", "show_tables_stmt", "desc_table_stmt",
+  "create_index_stmt", "index_option_list", "index_option", "is_unique",
   "index_list", "drop_index_stmt", "create_table_stmt", "attr_def_list",
   "attr_def", "null_option", "number", "type", "insert_stmt", "value_list",
   "value", "storage_format", "delete_stmt", "update_stmt", "update_list",
   "select_stmt", "calc_stmt", "expression_list", "expression", "aggr_expr",
   "rel_attr", "join_list", "join_chain", "where", "is_null_comp",
   "condition", "comp_op", "group_by", "having", "order_node",
-  "order_by_list", "order_by", "load_data_stmt", "explain_stmt",
+  "order_by_list", "order_by", "limit", "load_data_stmt", "explain_stmt",
   "set_variable_stmt", "opt_semicolon", YY_NULLPTR
 };
 
@@ -727,7 +734,7 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-156)
+#define YYPACT_NINF (-163)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -741,79 +748,87 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-     132,     6,    -2,    20,    20,   -52,    39,  -156,    13,    55,
-     -16,  -156,  -156,  -156,  -156,  -156,    25,    63,   132,   111,
-     114,  -156,  -156,  -156,  -156,  -156,  -156,  -156,  -156,  -156,
-    -156,  -156,  -156,  -156,  -156,  -156,  -156,  -156,  -156,  -156,
-    -156,    50,  -156,   109,    66,    67,    20,  -156,   120,   123,
-     133,  -156,  -156,    80,  -156,    20,  -156,  -156,  -156,    24,
-    -156,  -156,   116,  -156,  -156,    85,    89,   121,   112,   119,
-    -156,  -156,  -156,  -156,   145,    97,  -156,   127,   -17,    20,
-      20,    20,    20,    99,  -156,    20,    20,    20,    20,    20,
-     100,   137,   138,   105,   -49,   107,   122,   140,   124,  -156,
-      52,    56,    60,    -7,  -156,  -156,   -44,   -44,  -156,  -156,
-    -156,   -10,   139,   158,    20,  -156,   134,    -6,  -156,   160,
-      -4,   173,   129,  -156,    20,    20,    20,  -156,   100,   188,
-     141,   -49,   136,   161,   -49,   135,  -156,   192,  -156,  -156,
-    -156,  -156,  -156,  -156,    87,   122,   181,   183,    -1,    30,
-      37,   139,   200,   149,   142,   190,  -156,  -156,  -156,  -156,
-    -156,  -156,  -156,   162,   -22,  -156,    20,    20,  -156,   166,
-     147,   150,   159,  -156,  -156,   173,   174,   151,  -156,  -156,
-    -156,    20,    20,   163,   178,   -49,   201,  -156,   169,  -156,
-      43,  -156,   -49,  -156,  -156,   204,  -156,  -156,   175,  -156,
-    -156,    17,  -156,   161,   221,  -156,    20,   190,  -156,  -156,
-    -156,    22,   180,  -156,   164,    20,   161,  -156,  -156,   165,
-    -156,   -11,  -156,   206,  -156,  -156,  -156,    20,  -156
+     147,    -5,    70,     3,     3,   -66,    12,  -163,    -1,    20,
+     -23,  -163,  -163,  -163,  -163,  -163,    19,    28,   147,   109,
+     113,  -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,
+    -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,  -163,
+    -163,    51,   112,  -163,   124,    68,    69,     3,  -163,   104,
+     125,   130,  -163,  -163,   -12,  -163,     3,  -163,  -163,  -163,
+      25,  -163,  -163,   108,  -163,  -163,    80,    81,   129,   122,
+     131,  -163,  -163,  -163,  -163,   153,   105,   110,  -163,   135,
+      13,     3,     3,     3,     3,   111,  -163,     3,     3,     3,
+       3,     3,   116,   145,   146,   118,   -41,   120,   119,   144,
+     163,   134,  -163,    54,    58,    73,    18,  -163,  -163,   -63,
+     -63,  -163,  -163,  -163,   -13,   149,   173,     3,  -163,   159,
+      -7,  -163,   174,   -10,   187,   139,   140,  -163,     3,     3,
+       3,  -163,   116,   204,   154,   -41,   148,   176,   -41,   155,
+    -163,   206,  -163,  -163,  -163,  -163,  -163,  -163,   -14,   119,
+     195,   197,   198,    30,    38,    45,   149,   214,   168,   156,
+     207,  -163,  -163,  -163,  -163,  -163,  -163,  -163,   167,     0,
+    -163,     3,     3,  -163,   181,   160,   161,   177,  -163,  -163,
+     187,   188,   164,   164,  -163,  -163,  -163,     3,     3,   178,
+     194,   -41,   215,  -163,   182,  -163,    82,  -163,   -41,  -163,
+    -163,   218,  -163,  -163,   196,  -163,  -163,    39,    75,  -163,
+     176,   235,   179,     3,   207,  -163,  -163,  -163,    53,   200,
+     175,   170,  -163,     3,   180,  -163,   176,  -163,  -163,   183,
+     224,  -163,   -11,  -163,   223,  -163,  -163,   184,  -163,  -163,
+       3,   201,    94,  -163,  -163,    72,  -163,   184,  -163,  -163,
+    -163,  -163,  -163,  -163
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
    Performed when YYTABLE does not specify something else to do.  Zero
    means the default is an error.  */
-static const yytype_int8 yydefact[] =
+static const yytype_uint8 yydefact[] =
 {
-       0,    33,     0,     0,     0,     0,     0,    25,     0,     0,
+       0,    41,     0,     0,     0,     0,     0,    25,     0,     0,
        0,    26,    27,    28,    24,    23,     0,     0,     0,     0,
-     119,    22,    21,    14,    15,    16,    17,     9,    10,    11,
+     129,    22,    21,    14,    15,    16,    17,     9,    10,    11,
       12,    13,     8,     5,     7,     6,     4,     3,    18,    19,
-      20,     0,    34,     0,     0,     0,     0,    59,     0,     0,
-       0,    56,    57,    84,    58,     0,    81,    79,    67,    68,
-      82,    80,     0,    31,    30,     0,     0,     0,     0,     0,
-     117,     1,   120,     2,     0,     0,    29,     0,     0,     0,
-       0,     0,     0,     0,    78,     0,     0,     0,     0,     0,
-       0,     0,    90,     0,     0,     0,     0,     0,     0,    77,
-       0,     0,     0,     0,    85,    69,    70,    71,    72,    73,
-      88,    90,    86,     0,     0,    62,     0,    90,   118,     0,
-       0,    39,     0,    37,     0,     0,     0,    83,     0,   105,
-       0,     0,     0,    91,     0,     0,    63,     0,    47,    48,
-      49,    51,    52,    50,    43,     0,     0,     0,     0,     0,
-       0,    87,     0,   107,     0,    54,    97,    98,    99,   100,
-     101,   102,   103,     0,     0,    95,     0,     0,    64,     0,
-       0,     0,     0,    44,    42,    39,    60,     0,    74,    75,
-      76,     0,     0,   114,     0,     0,     0,   104,     0,    92,
-      94,    96,     0,   116,    46,     0,    45,    40,     0,    38,
-      35,     0,   106,   108,     0,    66,     0,    54,    53,    93,
-      65,    43,     0,    32,     0,     0,    89,    55,    41,     0,
-      36,   109,   112,   115,    61,   111,   110,     0,   113
+      20,     0,     0,    42,     0,     0,     0,     0,    67,     0,
+       0,     0,    64,    65,    92,    66,     0,    89,    87,    75,
+      76,    90,    88,     0,    31,    30,     0,     0,     0,     0,
+       0,   127,     1,   130,     2,     0,     0,     0,    29,     0,
+       0,     0,     0,     0,     0,     0,    86,     0,     0,     0,
+       0,     0,     0,     0,    98,     0,     0,     0,     0,     0,
+       0,     0,    85,     0,     0,     0,     0,    93,    77,    78,
+      79,    80,    81,    96,    98,    94,     0,     0,    70,     0,
+      98,   128,     0,     0,    47,     0,     0,    45,     0,     0,
+       0,    91,     0,   113,     0,     0,     0,    99,     0,     0,
+      71,     0,    55,    56,    57,    59,    60,    58,    51,     0,
+       0,     0,     0,     0,     0,     0,    95,     0,   115,     0,
+      62,   105,   106,   107,   108,   109,   110,   111,     0,     0,
+     103,     0,     0,    72,     0,     0,     0,     0,    52,    50,
+      47,    68,     0,     0,    82,    83,    84,     0,     0,   122,
+       0,     0,     0,   112,     0,   100,   102,   104,     0,   126,
+      54,     0,    53,    48,     0,    46,    43,     0,     0,   114,
+     116,     0,   124,     0,    62,    61,   101,    73,    51,     0,
+       0,     0,    32,     0,     0,    74,    97,    63,    49,     0,
+       0,    44,   117,   120,   123,   125,    69,     0,   119,   118,
+       0,     0,     0,    34,   121,     0,    33,     0,    40,    39,
+      38,    37,    36,    35
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -156,  -156,   210,  -156,  -156,  -156,  -156,  -156,  -156,  -156,
-    -156,  -156,  -156,  -156,  -156,  -156,  -156,    54,    86,    19,
-    -156,  -156,  -156,    27,   -87,  -156,  -156,  -156,  -156,  -156,
-    -156,    -3,   -46,  -156,  -156,  -156,   108,  -107,  -156,  -155,
-    -156,  -156,  -156,     8,  -156,  -156,  -156,  -156,  -156,  -156
+    -163,  -163,   231,  -163,  -163,  -163,  -163,  -163,  -163,  -163,
+    -163,  -163,  -163,  -163,     4,  -163,    67,  -163,  -163,    76,
+     103,    37,  -163,  -163,  -163,    43,   -90,  -163,  -163,  -163,
+    -163,  -163,  -163,    -3,   -47,  -163,  -163,  -163,   126,   -89,
+    -163,  -162,  -163,  -163,  -163,    21,  -163,  -163,  -163,  -163,
+    -163,  -163,  -163
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_uint8 yydefgoto[] =
 {
        0,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-      28,    29,    30,    43,   201,    31,    32,   146,   121,   174,
-     195,   144,    33,   186,    57,   199,    34,    35,   117,    36,
-      37,    58,    59,    60,    61,   111,   112,   115,   165,   133,
-     166,   153,   183,   222,   223,   205,    38,    39,    40,    73
+      28,    29,    30,   242,   243,    44,   207,    31,    32,   150,
+     124,   179,   201,   148,    33,   192,    58,   205,    34,    35,
+     120,    36,    37,    59,    60,    61,    62,   114,   115,   118,
+     170,   137,   171,   158,   189,   233,   234,   212,   225,    38,
+      39,    40,    74
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -821,105 +836,115 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
-      78,    62,   225,    99,   129,    47,    44,   118,    45,    84,
-     136,   128,   191,   127,    41,   135,    63,    51,    52,   178,
-      54,   138,   139,   140,   141,   142,   114,   203,    88,    89,
-     114,   188,   189,   100,   101,   102,   103,   213,   214,    46,
-     106,   107,   108,   109,   155,    85,    65,   168,    64,   226,
-     179,   216,    67,    86,    87,    88,    89,   180,   143,    86,
-      87,    88,    89,    86,    87,    88,    89,    42,   132,    86,
-      87,    88,    89,   124,    47,   172,   173,   125,   148,   149,
-     150,   126,   105,    48,    49,    50,    51,    52,    53,    54,
-      66,    55,    56,    68,    86,    87,    88,    89,   207,    82,
-      86,    87,    88,    89,    69,   210,   171,    86,    87,    88,
-      89,    71,    83,    86,    87,    88,    89,    72,    74,    75,
-     190,   132,    86,    87,    88,    89,    86,    87,    88,    89,
-      86,    87,    88,    89,    76,    77,   132,     1,     2,    79,
-     172,   173,    80,     3,     4,     5,     6,     7,     8,     9,
-      10,    90,    81,    91,    11,    12,    13,    92,    94,    93,
-     132,    95,    14,    15,    96,    97,    98,   104,   110,   221,
-      16,   113,    17,   116,   114,    18,   119,   131,   202,   122,
-     134,   221,   156,   157,   158,   159,   160,   161,   162,   163,
-     120,   164,   123,   137,   145,   152,   130,   147,   167,   154,
-     170,   176,   177,   169,   181,   182,    86,    87,    88,    89,
-     184,   185,   192,   196,   187,   193,   194,   206,   198,   200,
-     212,   208,   204,   209,   211,   215,   219,   227,    70,   197,
-     218,   175,   220,   224,   217,   228,   151
+      80,    63,   238,    41,    64,   176,   121,    84,   132,    86,
+     197,    90,    91,    48,   139,   142,   143,   144,   145,   146,
+      85,    65,    47,   117,    42,   133,   210,    52,    53,   117,
+      55,   140,    66,   102,   103,   104,   105,   106,   131,   177,
+     178,   109,   110,   111,   112,   160,    87,    68,   173,   239,
+     184,   226,   147,   194,   195,    67,    43,    48,   185,   220,
+     221,    88,    89,    90,    91,   186,    49,    50,    51,    70,
+     136,    52,    53,    54,    55,   128,    56,    57,    45,   129,
+      46,   153,   154,   155,   108,    88,    89,    90,    91,    69,
+      88,    89,    90,    91,   130,   222,   221,    88,    89,    90,
+      91,   214,    88,    89,    90,    91,   177,   178,   217,    72,
+      88,    89,    90,    91,   246,   247,    73,    88,    89,    90,
+      91,    75,    76,    81,   196,   136,    88,    89,    90,    91,
+      88,    89,    90,    91,    77,   248,   249,   250,    78,    79,
+     251,   136,   252,    92,    82,    88,    89,    90,    91,    83,
+      93,    94,     1,     2,    88,    89,    90,    91,     3,     4,
+       5,     6,     7,     8,     9,    10,   136,    95,    96,    11,
+      12,    13,    98,    97,   101,    99,   232,    14,    15,   116,
+     100,   107,   117,   125,   209,    16,   113,    17,   119,   123,
+      18,   122,   135,   232,   161,   162,   163,   164,   165,   166,
+     167,   168,   126,   169,   127,   138,   134,   141,   149,   151,
+     152,   157,   159,   172,   175,   181,   182,   183,   187,   193,
+      88,    89,    90,    91,   188,   174,   190,   198,   191,   200,
+     199,   202,   204,   213,   206,   215,   216,   211,   218,   223,
+     231,   219,   230,   237,   240,   224,   229,   245,   235,    71,
+     208,   253,   180,   236,   241,   228,   203,   227,   156,     0,
+       0,   244
 };
 
-static const yytype_uint8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-      46,     4,    13,    20,   111,    54,     8,    94,    10,    55,
-     117,    21,   167,    20,     8,    21,    68,    66,    67,    20,
-      69,    25,    26,    27,    28,    29,    36,   182,    72,    73,
-      36,    53,    54,    79,    80,    81,    82,    20,    21,    19,
-      86,    87,    88,    89,   131,    21,    33,   134,     9,    60,
-      20,   206,    68,    70,    71,    72,    73,    20,    62,    70,
-      71,    72,    73,    70,    71,    72,    73,    61,   114,    70,
-      71,    72,    73,    21,    54,    53,    54,    21,   124,   125,
-     126,    21,    85,    63,    64,    65,    66,    67,    68,    69,
-      35,    71,    72,    68,    70,    71,    72,    73,   185,    19,
-      70,    71,    72,    73,    41,   192,    19,    70,    71,    72,
-      73,     0,    32,    70,    71,    72,    73,     3,    68,    10,
-     166,   167,    70,    71,    72,    73,    70,    71,    72,    73,
-      70,    71,    72,    73,    68,    68,   182,     5,     6,    19,
-      53,    54,    19,    11,    12,    13,    14,    15,    16,    17,
-      18,    35,    19,    68,    22,    23,    24,    68,    46,    38,
-     206,    42,    30,    31,    19,    68,    39,    68,    68,   215,
-      38,    34,    40,    68,    36,    43,    69,    19,   181,    39,
-      46,   227,    46,    47,    48,    49,    50,    51,    52,    53,
-      68,    55,    68,    33,    21,     7,    57,    68,    37,    58,
-       8,    20,    19,    68,     4,    56,    70,    71,    72,    73,
-      68,    21,    46,    54,    52,    68,    66,    39,    44,    68,
-      45,    20,    59,    54,    20,     4,    46,    21,    18,   175,
-     211,   145,    68,    68,   207,   227,   128
+      47,     4,    13,     8,    70,    19,    96,    19,    21,    56,
+     172,    74,    75,    54,    21,    25,    26,    27,    28,    29,
+      32,     9,    19,    36,    29,   114,   188,    68,    69,    36,
+      71,   120,    33,    20,    81,    82,    83,    84,    20,    53,
+      54,    88,    89,    90,    91,   135,    21,    70,   138,    60,
+      20,   213,    62,    53,    54,    35,    61,    54,    20,    20,
+      21,    72,    73,    74,    75,    20,    63,    64,    65,    41,
+     117,    68,    69,    70,    71,    21,    73,    74,     8,    21,
+      10,   128,   129,   130,    87,    72,    73,    74,    75,    70,
+      72,    73,    74,    75,    21,    20,    21,    72,    73,    74,
+      75,   191,    72,    73,    74,    75,    53,    54,   198,     0,
+      72,    73,    74,    75,    20,    21,     3,    72,    73,    74,
+      75,    70,    10,    19,   171,   172,    72,    73,    74,    75,
+      72,    73,    74,    75,    10,    63,    64,    65,    70,    70,
+      68,   188,    70,    35,    19,    72,    73,    74,    75,    19,
+      70,    70,     5,     6,    72,    73,    74,    75,    11,    12,
+      13,    14,    15,    16,    17,    18,   213,    38,    46,    22,
+      23,    24,    19,    42,    39,    70,   223,    30,    31,    34,
+      70,    70,    36,    39,   187,    38,    70,    40,    70,    70,
+      43,    71,    19,   240,    46,    47,    48,    49,    50,    51,
+      52,    53,    39,    55,    70,    46,    57,    33,    21,    70,
+      70,     7,    58,    37,     8,    20,    19,    19,     4,    52,
+      72,    73,    74,    75,    56,    70,    70,    46,    21,    68,
+      70,    54,    44,    39,    70,    20,    54,    59,    20,     4,
+      70,    45,    67,    19,    21,    66,    46,    46,    68,    18,
+     183,   247,   149,    70,    70,   218,   180,   214,   132,    -1,
+      -1,   240
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
    state STATE-NUM.  */
-static const yytype_int8 yystos[] =
+static const yytype_uint8 yystos[] =
 {
        0,     5,     6,    11,    12,    13,    14,    15,    16,    17,
-      18,    22,    23,    24,    30,    31,    38,    40,    43,    76,
-      77,    78,    79,    80,    81,    82,    83,    84,    85,    86,
-      87,    90,    91,    97,   101,   102,   104,   105,   121,   122,
-     123,     8,    61,    88,     8,    10,    19,    54,    63,    64,
-      65,    66,    67,    68,    69,    71,    72,    99,   106,   107,
-     108,   109,   106,    68,     9,    33,    35,    68,    68,    41,
-      77,     0,     3,   124,    68,    10,    68,    68,   107,    19,
-      19,    19,    19,    32,   107,    21,    70,    71,    72,    73,
-      35,    68,    68,    38,    46,    42,    19,    68,    39,    20,
-     107,   107,   107,   107,    68,   106,   107,   107,   107,   107,
-      68,   110,   111,    34,    36,   112,    68,   103,    99,    69,
-      68,    93,    39,    68,    21,    21,    21,    20,    21,   112,
-      57,    19,   107,   114,    46,    21,   112,    33,    25,    26,
-      27,    28,    29,    62,    96,    21,    92,    68,   107,   107,
-     107,   111,     7,   116,    58,    99,    46,    47,    48,    49,
-      50,    51,    52,    53,    55,   113,   115,    37,    99,    68,
-       8,    19,    53,    54,    94,    93,    20,    19,    20,    20,
-      20,     4,    56,   117,    68,    21,    98,    52,    53,    54,
-     107,   114,    46,    68,    66,    95,    54,    92,    44,   100,
-      68,    89,   106,   114,    59,   120,    39,    99,    20,    54,
-      99,    20,    45,    20,    21,     4,   114,    98,    94,    46,
-      68,   107,   118,   119,    68,    13,    60,    21,   118
+      18,    22,    23,    24,    30,    31,    38,    40,    43,    78,
+      79,    80,    81,    82,    83,    84,    85,    86,    87,    88,
+      89,    94,    95,   101,   105,   106,   108,   109,   126,   127,
+     128,     8,    29,    61,    92,     8,    10,    19,    54,    63,
+      64,    65,    68,    69,    70,    71,    73,    74,   103,   110,
+     111,   112,   113,   110,    70,     9,    33,    35,    70,    70,
+      41,    79,     0,     3,   129,    70,    10,    10,    70,    70,
+     111,    19,    19,    19,    19,    32,   111,    21,    72,    73,
+      74,    75,    35,    70,    70,    38,    46,    42,    19,    70,
+      70,    39,    20,   111,   111,   111,   111,    70,   110,   111,
+     111,   111,   111,    70,   114,   115,    34,    36,   116,    70,
+     107,   103,    71,    70,    97,    39,    39,    70,    21,    21,
+      21,    20,    21,   116,    57,    19,   111,   118,    46,    21,
+     116,    33,    25,    26,    27,    28,    29,    62,   100,    21,
+      96,    70,    70,   111,   111,   111,   115,     7,   120,    58,
+     103,    46,    47,    48,    49,    50,    51,    52,    53,    55,
+     117,   119,    37,   103,    70,     8,    19,    53,    54,    98,
+      97,    20,    19,    19,    20,    20,    20,     4,    56,   121,
+      70,    21,   102,    52,    53,    54,   111,   118,    46,    70,
+      68,    99,    54,    96,    44,   104,    70,    93,    93,   110,
+     118,    59,   124,    39,   103,    20,    54,   103,    20,    45,
+      20,    21,    20,     4,    66,   125,   118,   102,    98,    46,
+      67,    70,   111,   122,   123,    68,    70,    19,    13,    60,
+      21,    70,    90,    91,   122,    46,    20,    21,    63,    64,
+      65,    68,    70,    91
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
-static const yytype_int8 yyr1[] =
+static const yytype_uint8 yyr1[] =
 {
-       0,    75,    76,    77,    77,    77,    77,    77,    77,    77,
-      77,    77,    77,    77,    77,    77,    77,    77,    77,    77,
-      77,    77,    77,    78,    79,    80,    81,    82,    83,    84,
-      85,    86,    87,    88,    88,    89,    89,    90,    91,    92,
-      92,    93,    93,    94,    94,    94,    95,    96,    96,    96,
-      96,    96,    96,    97,    98,    98,    99,    99,    99,    99,
-     100,   100,   101,   102,   103,   103,   104,   105,   106,   106,
-     107,   107,   107,   107,   107,   107,   107,   107,   107,   107,
-     107,   107,   107,   108,   109,   109,   110,   110,   111,   111,
-     112,   112,   113,   113,   114,   114,   114,   115,   115,   115,
-     115,   115,   115,   115,   115,   116,   116,   117,   117,   118,
-     118,   118,   119,   119,   120,   120,   121,   122,   123,   124,
-     124
+       0,    77,    78,    79,    79,    79,    79,    79,    79,    79,
+      79,    79,    79,    79,    79,    79,    79,    79,    79,    79,
+      79,    79,    79,    80,    81,    82,    83,    84,    85,    86,
+      87,    88,    89,    89,    90,    90,    91,    91,    91,    91,
+      91,    92,    92,    93,    93,    94,    95,    96,    96,    97,
+      97,    98,    98,    98,    99,   100,   100,   100,   100,   100,
+     100,   101,   102,   102,   103,   103,   103,   103,   104,   104,
+     105,   106,   107,   107,   108,   109,   110,   110,   111,   111,
+     111,   111,   111,   111,   111,   111,   111,   111,   111,   111,
+     111,   112,   113,   113,   114,   114,   115,   115,   116,   116,
+     117,   117,   118,   118,   118,   119,   119,   119,   119,   119,
+     119,   119,   119,   120,   120,   121,   121,   122,   122,   122,
+     123,   123,   124,   124,   125,   125,   126,   127,   128,   129,
+     129
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
@@ -928,15 +953,16 @@ static const yytype_int8 yyr2[] =
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     3,
-       2,     2,     9,     0,     1,     1,     3,     5,     8,     0,
-       3,     6,     3,     0,     1,     2,     1,     1,     1,     1,
-       1,     1,     1,     8,     0,     3,     1,     1,     1,     1,
-       0,     4,     4,     5,     3,     5,     8,     2,     1,     3,
-       3,     3,     3,     3,     6,     6,     6,     3,     2,     1,
-       1,     1,     1,     4,     1,     3,     1,     3,     1,     6,
-       0,     2,     2,     3,     3,     2,     3,     1,     1,     1,
-       1,     1,     1,     1,     2,     0,     3,     0,     2,     1,
-       2,     2,     1,     3,     0,     3,     7,     2,     4,     0,
+       2,     2,     9,    13,     1,     3,     3,     3,     3,     3,
+       3,     0,     1,     1,     3,     5,     8,     0,     3,     6,
+       3,     0,     1,     2,     1,     1,     1,     1,     1,     1,
+       1,     8,     0,     3,     1,     1,     1,     1,     0,     4,
+       4,     5,     3,     5,     9,     2,     1,     3,     3,     3,
+       3,     3,     6,     6,     6,     3,     2,     1,     1,     1,
+       1,     4,     1,     3,     1,     3,     1,     6,     0,     2,
+       2,     3,     3,     2,     3,     1,     1,     1,     1,     1,
+       1,     1,     2,     0,     3,     0,     2,     1,     2,     2,
+       1,     3,     0,     3,     0,     2,     7,     2,     4,     0,
        1
 };
 
@@ -1799,93 +1825,93 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* commands: command_wrapper opt_semicolon  */
-#line 220 "yacc_sql.y"
+#line 227 "yacc_sql.y"
   {
     std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[-1].sql_node));
     sql_result->add_sql_node(std::move(sql_node));
   }
-#line 1808 "yacc_sql.cpp"
+#line 1834 "yacc_sql.cpp"
     break;
 
   case 23: /* exit_stmt: EXIT  */
-#line 250 "yacc_sql.y"
+#line 257 "yacc_sql.y"
          {
       (void)yynerrs;  // 这么写为了消除yynerrs未使用的告警。如果你有更好的方法欢迎提PR
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXIT);
     }
-#line 1817 "yacc_sql.cpp"
+#line 1843 "yacc_sql.cpp"
     break;
 
   case 24: /* help_stmt: HELP  */
-#line 256 "yacc_sql.y"
+#line 263 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_HELP);
     }
-#line 1825 "yacc_sql.cpp"
+#line 1851 "yacc_sql.cpp"
     break;
 
   case 25: /* sync_stmt: SYNC  */
-#line 261 "yacc_sql.y"
+#line 268 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SYNC);
     }
-#line 1833 "yacc_sql.cpp"
+#line 1859 "yacc_sql.cpp"
     break;
 
   case 26: /* begin_stmt: TRX_BEGIN  */
-#line 267 "yacc_sql.y"
+#line 274 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_BEGIN);
     }
-#line 1841 "yacc_sql.cpp"
+#line 1867 "yacc_sql.cpp"
     break;
 
   case 27: /* commit_stmt: TRX_COMMIT  */
-#line 273 "yacc_sql.y"
+#line 280 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_COMMIT);
     }
-#line 1849 "yacc_sql.cpp"
+#line 1875 "yacc_sql.cpp"
     break;
 
   case 28: /* rollback_stmt: TRX_ROLLBACK  */
-#line 279 "yacc_sql.y"
+#line 286 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_ROLLBACK);
     }
-#line 1857 "yacc_sql.cpp"
+#line 1883 "yacc_sql.cpp"
     break;
 
   case 29: /* drop_table_stmt: DROP TABLE ID  */
-#line 285 "yacc_sql.y"
+#line 292 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_TABLE);
       (yyval.sql_node)->drop_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1867 "yacc_sql.cpp"
+#line 1893 "yacc_sql.cpp"
     break;
 
   case 30: /* show_tables_stmt: SHOW TABLES  */
-#line 292 "yacc_sql.y"
+#line 299 "yacc_sql.y"
                 {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_TABLES);
     }
-#line 1875 "yacc_sql.cpp"
+#line 1901 "yacc_sql.cpp"
     break;
 
   case 31: /* desc_table_stmt: DESC ID  */
-#line 298 "yacc_sql.y"
+#line 305 "yacc_sql.y"
              {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DESC_TABLE);
       (yyval.sql_node)->desc_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1885 "yacc_sql.cpp"
+#line 1911 "yacc_sql.cpp"
     break;
 
   case 32: /* create_index_stmt: CREATE is_unique INDEX ID ON ID LBRACE index_list RBRACE  */
-#line 307 "yacc_sql.y"
+#line 314 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
@@ -1896,37 +1922,122 @@ yyreduce:
       free((yyvsp[-5].string));
       free((yyvsp[-3].string));
     }
-#line 1900 "yacc_sql.cpp"
+#line 1926 "yacc_sql.cpp"
+    break;
+
+  case 33: /* create_index_stmt: CREATE VECTOR_T INDEX ID ON ID LBRACE index_list RBRACE WITH LBRACE index_option_list RBRACE  */
+#line 325 "yacc_sql.y"
+    {
+      (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
+      CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
+      create_index.isunique = false;
+      create_index.is_vector = true;
+      create_index.index_name = (yyvsp[-9].string);
+      create_index.relation_name = (yyvsp[-7].string);
+      create_index.attribute_names.swap(*(yyvsp[-5].relation_list));
+      create_index.options.swap(*(yyvsp[-1].index_option_list));
+      free((yyvsp[-9].string));
+      free((yyvsp[-7].string));
+      delete (yyvsp[-5].relation_list);
+      delete (yyvsp[-1].index_option_list);
+    }
+#line 1945 "yacc_sql.cpp"
+    break;
+
+  case 34: /* index_option_list: index_option  */
+#line 342 "yacc_sql.y"
+    {
+      (yyval.index_option_list) = new std::vector<std::pair<std::string, std::string>>;
+      (yyval.index_option_list)->emplace_back(std::move(*(yyvsp[0].index_option)));
+      delete (yyvsp[0].index_option);
+    }
+#line 1955 "yacc_sql.cpp"
+    break;
+
+  case 35: /* index_option_list: index_option_list COMMA index_option  */
+#line 348 "yacc_sql.y"
+    {
+      (yyval.index_option_list) = (yyvsp[-2].index_option_list);
+      (yyval.index_option_list)->emplace_back(std::move(*(yyvsp[0].index_option)));
+      delete (yyvsp[0].index_option);
+    }
+#line 1965 "yacc_sql.cpp"
+    break;
+
+  case 36: /* index_option: ID EQ ID  */
+#line 356 "yacc_sql.y"
+    {
+      (yyval.index_option) = new std::pair<std::string, std::string>((yyvsp[-2].string), (yyvsp[0].string));
+      free((yyvsp[-2].string));
+      free((yyvsp[0].string));
+    }
+#line 1975 "yacc_sql.cpp"
+    break;
+
+  case 37: /* index_option: ID EQ NUMBER  */
+#line 362 "yacc_sql.y"
+    {
+      (yyval.index_option) = new std::pair<std::string, std::string>((yyvsp[-2].string), std::to_string((yyvsp[0].number)));
+      free((yyvsp[-2].string));
+    }
+#line 1984 "yacc_sql.cpp"
+    break;
+
+  case 38: /* index_option: ID EQ L2_DISTANCE  */
+#line 367 "yacc_sql.y"
+    {
+      (yyval.index_option) = new std::pair<std::string, std::string>((yyvsp[-2].string), "l2_distance");
+      free((yyvsp[-2].string));
+    }
+#line 1993 "yacc_sql.cpp"
+    break;
+
+  case 39: /* index_option: ID EQ COSINE_DISTANCE  */
+#line 372 "yacc_sql.y"
+    {
+      (yyval.index_option) = new std::pair<std::string, std::string>((yyvsp[-2].string), "cosine_distance");
+      free((yyvsp[-2].string));
+    }
+#line 2002 "yacc_sql.cpp"
+    break;
+
+  case 40: /* index_option: ID EQ INNER_PRODUCT  */
+#line 377 "yacc_sql.y"
+    {
+      (yyval.index_option) = new std::pair<std::string, std::string>((yyvsp[-2].string), "inner_product");
+      free((yyvsp[-2].string));
+    }
+#line 2011 "yacc_sql.cpp"
     break;
 
-  case 33: /* is_unique: %empty  */
-#line 320 "yacc_sql.y"
+  case 41: /* is_unique: %empty  */
+#line 384 "yacc_sql.y"
     {
       (yyval.boolean) = false;
     }
-#line 1908 "yacc_sql.cpp"
+#line 2019 "yacc_sql.cpp"
     break;
 
-  case 34: /* is_unique: UNIQUE  */
-#line 324 "yacc_sql.y"
+  case 42: /* is_unique: UNIQUE  */
+#line 388 "yacc_sql.y"
     {
       (yyval.boolean) = true;
     }
-#line 1916 "yacc_sql.cpp"
+#line 2027 "yacc_sql.cpp"
     break;
 
-  case 35: /* index_list: ID  */
-#line 329 "yacc_sql.y"
+  case 43: /* index_list: ID  */
+#line 393 "yacc_sql.y"
        {
       (yyval.relation_list) = new std::vector<std::string>;
       (yyval.relation_list)->emplace_back((yyvsp[0].string));
       free((yyvsp[0].string));
     }
-#line 1926 "yacc_sql.cpp"
+#line 2037 "yacc_sql.cpp"
     break;
 
-  case 36: /* index_list: index_list COMMA ID  */
-#line 335 "yacc_sql.y"
+  case 44: /* index_list: index_list COMMA ID  */
+#line 399 "yacc_sql.y"
     {
       if ((yyvsp[-2].relation_list) != nullptr) {
         (yyval.relation_list) = (yyvsp[-2].relation_list);
@@ -1937,11 +2048,11 @@ yyreduce:
       }
       free((yyvsp[0].string));
     }
-#line 1941 "yacc_sql.cpp"
+#line 2052 "yacc_sql.cpp"
     break;
 
-  case 37: /* drop_index_stmt: DROP INDEX ID ON ID  */
-#line 349 "yacc_sql.y"
+  case 45: /* drop_index_stmt: DROP INDEX ID ON ID  */
+#line 413 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_INDEX);
       (yyval.sql_node)->drop_index.index_name = (yyvsp[-2].string);
@@ -1949,11 +2060,11 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 1953 "yacc_sql.cpp"
+#line 2064 "yacc_sql.cpp"
     break;
 
-  case 38: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE storage_format  */
-#line 359 "yacc_sql.y"
+  case 46: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE storage_format  */
+#line 423 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = (yyval.sql_node)->create_table;
@@ -1974,19 +2085,19 @@ yyreduce:
         free((yyvsp[0].string));
       }
     }
-#line 1978 "yacc_sql.cpp"
+#line 2089 "yacc_sql.cpp"
     break;
 
-  case 39: /* attr_def_list: %empty  */
-#line 382 "yacc_sql.y"
+  case 47: /* attr_def_list: %empty  */
+#line 446 "yacc_sql.y"
     {
       (yyval.attr_infos) = nullptr;
     }
-#line 1986 "yacc_sql.cpp"
+#line 2097 "yacc_sql.cpp"
     break;
 
-  case 40: /* attr_def_list: COMMA attr_def attr_def_list  */
-#line 386 "yacc_sql.y"
+  case 48: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 450 "yacc_sql.y"
     {
       if ((yyvsp[0].attr_infos) != nullptr) {
         (yyval.attr_infos) = (yyvsp[0].attr_infos);
@@ -1996,11 +2107,11 @@ yyreduce:
       (yyval.attr_infos)->emplace_back(*(yyvsp[-1].attr_info));
       delete (yyvsp[-1].attr_info);
     }
-#line 2000 "yacc_sql.cpp"
+#line 2111 "yacc_sql.cpp"
     break;
 
-  case 41: /* attr_def: ID type LBRACE number RBRACE null_option  */
-#line 398 "yacc_sql.y"
+  case 49: /* attr_def: ID type LBRACE number RBRACE null_option  */
+#line 462 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-4].number);
@@ -2012,11 +2123,11 @@ yyreduce:
       (yyval.attr_info)->nullable = (yyvsp[0].boolean);
       free((yyvsp[-5].string));
     }
-#line 2016 "yacc_sql.cpp"
+#line 2127 "yacc_sql.cpp"
     break;
 
-  case 42: /* attr_def: ID type null_option  */
-#line 410 "yacc_sql.y"
+  case 50: /* attr_def: ID type null_option  */
+#line 474 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-1].number);
@@ -2025,77 +2136,77 @@ yyreduce:
       (yyval.attr_info)->nullable = (yyvsp[0].boolean);
       free((yyvsp[-2].string));
     }
-#line 2029 "yacc_sql.cpp"
+#line 2140 "yacc_sql.cpp"
     break;
 
-  case 43: /* null_option: %empty  */
-#line 420 "yacc_sql.y"
+  case 51: /* null_option: %empty  */
+#line 484 "yacc_sql.y"
     {
       (yyval.boolean) = true;
     }
-#line 2037 "yacc_sql.cpp"
+#line 2148 "yacc_sql.cpp"
     break;
 
-  case 44: /* null_option: NULL_T  */
-#line 424 "yacc_sql.y"
+  case 52: /* null_option: NULL_T  */
+#line 488 "yacc_sql.y"
     {
       (yyval.boolean) = true;
     }
-#line 2045 "yacc_sql.cpp"
+#line 2156 "yacc_sql.cpp"
     break;
 
-  case 45: /* null_option: NOT NULL_T  */
-#line 428 "yacc_sql.y"
+  case 53: /* null_option: NOT NULL_T  */
+#line 492 "yacc_sql.y"
     {
       (yyval.boolean) = false;
     }
-#line 2053 "yacc_sql.cpp"
+#line 2164 "yacc_sql.cpp"
     break;
 
-  case 46: /* number: NUMBER  */
-#line 433 "yacc_sql.y"
+  case 54: /* number: NUMBER  */
+#line 497 "yacc_sql.y"
            {(yyval.number) = (yyvsp[0].number);}
-#line 2059 "yacc_sql.cpp"
+#line 2170 "yacc_sql.cpp"
     break;
 
-  case 47: /* type: INT_T  */
-#line 436 "yacc_sql.y"
+  case 55: /* type: INT_T  */
+#line 500 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::INTS); }
-#line 2065 "yacc_sql.cpp"
+#line 2176 "yacc_sql.cpp"
     break;
 
-  case 48: /* type: STRING_T  */
-#line 437 "yacc_sql.y"
+  case 56: /* type: STRING_T  */
+#line 501 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::CHARS); }
-#line 2071 "yacc_sql.cpp"
+#line 2182 "yacc_sql.cpp"
     break;
 
-  case 49: /* type: DATE_T  */
-#line 438 "yacc_sql.y"
+  case 57: /* type: DATE_T  */
+#line 502 "yacc_sql.y"
              { (yyval.number) = static_cast<int>(AttrType::DATES); }
-#line 2077 "yacc_sql.cpp"
+#line 2188 "yacc_sql.cpp"
     break;
 
-  case 50: /* type: TEXT_T  */
-#line 439 "yacc_sql.y"
+  case 58: /* type: TEXT_T  */
+#line 503 "yacc_sql.y"
              { (yyval.number) = static_cast<int>(AttrType::TEXT); }
-#line 2083 "yacc_sql.cpp"
+#line 2194 "yacc_sql.cpp"
     break;
 
-  case 51: /* type: FLOAT_T  */
-#line 440 "yacc_sql.y"
+  case 59: /* type: FLOAT_T  */
+#line 504 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::FLOATS); }
-#line 2089 "yacc_sql.cpp"
+#line 2200 "yacc_sql.cpp"
     break;
 
-  case 52: /* type: VECTOR_T  */
-#line 441 "yacc_sql.y"
+  case 60: /* type: VECTOR_T  */
+#line 505 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::VECTORS); }
-#line 2095 "yacc_sql.cpp"
+#line 2206 "yacc_sql.cpp"
     break;
 
-  case 53: /* insert_stmt: INSERT INTO ID VALUES LBRACE value value_list RBRACE  */
-#line 445 "yacc_sql.y"
+  case 61: /* insert_stmt: INSERT INTO ID VALUES LBRACE value value_list RBRACE  */
+#line 509 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_INSERT);
       (yyval.sql_node)->insertion.relation_name = (yyvsp[-5].string);
@@ -2108,19 +2219,19 @@ yyreduce:
       delete (yyvsp[-2].value);
       free((yyvsp[-5].string));
     }
-#line 2112 "yacc_sql.cpp"
+#line 2223 "yacc_sql.cpp"
     break;
 
-  case 54: /* value_list: %empty  */
-#line 461 "yacc_sql.y"
+  case 62: /* value_list: %empty  */
+#line 525 "yacc_sql.y"
     {
       (yyval.value_list) = nullptr;
     }
-#line 2120 "yacc_sql.cpp"
+#line 2231 "yacc_sql.cpp"
     break;
 
-  case 55: /* value_list: COMMA value value_list  */
-#line 464 "yacc_sql.y"
+  case 63: /* value_list: COMMA value value_list  */
+#line 528 "yacc_sql.y"
                               { 
       if ((yyvsp[0].value_list) != nullptr) {
         (yyval.value_list) = (yyvsp[0].value_list);
@@ -2130,65 +2241,65 @@ yyreduce:
       (yyval.value_list)->emplace_back(*(yyvsp[-1].value));
       delete (yyvsp[-1].value);
     }
-#line 2134 "yacc_sql.cpp"
+#line 2245 "yacc_sql.cpp"
     break;
 
-  case 56: /* value: NUMBER  */
-#line 475 "yacc_sql.y"
+  case 64: /* value: NUMBER  */
+#line 539 "yacc_sql.y"
            {
       (yyval.value) = new Value((int)(yyvsp[0].number));
       (yyloc) = (yylsp[0]);
     }
-#line 2143 "yacc_sql.cpp"
+#line 2254 "yacc_sql.cpp"
     break;
 
-  case 57: /* value: FLOAT  */
-#line 479 "yacc_sql.y"
+  case 65: /* value: FLOAT  */
+#line 543 "yacc_sql.y"
            {
       (yyval.value) = new Value((float)(yyvsp[0].floats));
       (yyloc) = (yylsp[0]);
     }
-#line 2152 "yacc_sql.cpp"
+#line 2263 "yacc_sql.cpp"
     break;
 
-  case 58: /* value: SSS  */
-#line 483 "yacc_sql.y"
+  case 66: /* value: SSS  */
+#line 547 "yacc_sql.y"
          {
       char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
       (yyval.value) = new Value(tmp);
       free(tmp);
       free((yyvsp[0].string));
     }
-#line 2163 "yacc_sql.cpp"
+#line 2274 "yacc_sql.cpp"
     break;
 
-  case 59: /* value: NULL_T  */
-#line 489 "yacc_sql.y"
+  case 67: /* value: NULL_T  */
+#line 553 "yacc_sql.y"
              {
       (yyval.value) = new Value();
       (yyval.value)->set_null();
     }
-#line 2172 "yacc_sql.cpp"
+#line 2283 "yacc_sql.cpp"
     break;
 
-  case 60: /* storage_format: %empty  */
-#line 496 "yacc_sql.y"
+  case 68: /* storage_format: %empty  */
+#line 560 "yacc_sql.y"
     {
       (yyval.string) = nullptr;
     }
-#line 2180 "yacc_sql.cpp"
+#line 2291 "yacc_sql.cpp"
     break;
 
-  case 61: /* storage_format: STORAGE FORMAT EQ ID  */
-#line 500 "yacc_sql.y"
+  case 69: /* storage_format: STORAGE FORMAT EQ ID  */
+#line 564 "yacc_sql.y"
     {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 2188 "yacc_sql.cpp"
+#line 2299 "yacc_sql.cpp"
     break;
 
-  case 62: /* delete_stmt: DELETE FROM ID where  */
-#line 507 "yacc_sql.y"
+  case 70: /* delete_stmt: DELETE FROM ID where  */
+#line 571 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DELETE);
       (yyval.sql_node)->deletion.relation_name = (yyvsp[-1].string);
@@ -2197,11 +2308,11 @@ yyreduce:
       }
       free((yyvsp[-1].string));
     }
-#line 2201 "yacc_sql.cpp"
+#line 2312 "yacc_sql.cpp"
     break;
 
-  case 63: /* update_stmt: UPDATE ID SET update_list where  */
-#line 518 "yacc_sql.y"
+  case 71: /* update_stmt: UPDATE ID SET update_list where  */
+#line 582 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_UPDATE);
       (yyval.sql_node)->update.relation_name = (yyvsp[-3].string);
@@ -2211,20 +2322,20 @@ yyreduce:
       }
       free((yyvsp[-3].string));
     }
-#line 2215 "yacc_sql.cpp"
+#line 2326 "yacc_sql.cpp"
     break;
 
-  case 64: /* update_list: ID EQ value  */
-#line 530 "yacc_sql.y"
+  case 72: /* update_list: ID EQ value  */
+#line 594 "yacc_sql.y"
     {
       (yyval.update_c_list) = new std::vector<pair<std::string,Value>>;
       (yyval.update_c_list)->push_back({(yyvsp[-2].string),*(yyvsp[0].value)});
     }
-#line 2224 "yacc_sql.cpp"
+#line 2335 "yacc_sql.cpp"
     break;
 
-  case 65: /* update_list: update_list COMMA ID EQ value  */
-#line 535 "yacc_sql.y"
+  case 73: /* update_list: update_list COMMA ID EQ value  */
+#line 599 "yacc_sql.y"
     {
       if((yyvsp[-4].update_c_list) != nullptr){
         (yyval.update_c_list) = (yyvsp[-4].update_c_list);
@@ -2234,64 +2345,66 @@ yyreduce:
       }
       (yyval.update_c_list)->push_back({(yyvsp[-2].string),*(yyvsp[0].value)});
     }
-#line 2238 "yacc_sql.cpp"
+#line 2349 "yacc_sql.cpp"
     break;
 
-  case 66: /* select_stmt: SELECT expression_list FROM join_list where group_by having order_by  */
-#line 548 "yacc_sql.y"
+  case 74: /* select_stmt: SELECT expression_list FROM join_list where group_by having order_by limit  */
+#line 612 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
-      if ((yyvsp[-6].expression_list) != nullptr) {
-        (yyval.sql_node)->selection.expressions.swap(*(yyvsp[-6].expression_list));
-        delete (yyvsp[-6].expression_list);
+      if ((yyvsp[-7].expression_list) != nullptr) {
+        (yyval.sql_node)->selection.expressions.swap(*(yyvsp[-7].expression_list));
+        delete (yyvsp[-7].expression_list);
       }
 
-      if ((yyvsp[-4].inner_join_list) != nullptr) {
-        (yyval.sql_node)->selection.relations.swap(*(yyvsp[-4].inner_join_list));
-        delete (yyvsp[-4].inner_join_list);
+      if ((yyvsp[-5].inner_join_list) != nullptr) {
+        (yyval.sql_node)->selection.relations.swap(*(yyvsp[-5].inner_join_list));
+        delete (yyvsp[-5].inner_join_list);
       }
 
-      if ((yyvsp[-3].expression) != nullptr) {
-        (yyval.sql_node)->selection.conditions = (yyvsp[-3].expression);
+      if ((yyvsp[-4].expression) != nullptr) {
+        (yyval.sql_node)->selection.conditions = (yyvsp[-4].expression);
       }
 
-      if ((yyvsp[-2].expression_list) != nullptr) {
-        (yyval.sql_node)->selection.group_by.swap(*(yyvsp[-2].expression_list));
-        delete (yyvsp[-2].expression_list);
+      if ((yyvsp[-3].expression_list) != nullptr) {
+        (yyval.sql_node)->selection.group_by.swap(*(yyvsp[-3].expression_list));
+        delete (yyvsp[-3].expression_list);
       }
 
-      if ((yyvsp[-1].expression) != nullptr) {
-        (yyval.sql_node)->selection.having = (yyvsp[-1].expression);
+      if ((yyvsp[-2].expression) != nullptr) {
+        (yyval.sql_node)->selection.having = (yyvsp[-2].expression);
       }
 
-      if ((yyvsp[0].order_key_list) != nullptr) {
-        (yyval.sql_node)->selection.order_by.swap(*(yyvsp[0].order_key_list));
+      if ((yyvsp[-1].order_key_list) != nullptr) {
+        (yyval.sql_node)->selection.order_by.swap(*(yyvsp[-1].order_key_list));
       }
+
+      (yyval.sql_node)->selection.limit = (yyvsp[0].number);
     }
-#line 2272 "yacc_sql.cpp"
+#line 2385 "yacc_sql.cpp"
     break;
 
-  case 67: /* calc_stmt: CALC expression_list  */
-#line 580 "yacc_sql.y"
+  case 75: /* calc_stmt: CALC expression_list  */
+#line 646 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CALC);
       (yyval.sql_node)->calc.expressions.swap(*(yyvsp[0].expression_list));
       delete (yyvsp[0].expression_list);
     }
-#line 2282 "yacc_sql.cpp"
+#line 2395 "yacc_sql.cpp"
     break;
 
-  case 68: /* expression_list: expression  */
-#line 589 "yacc_sql.y"
+  case 76: /* expression_list: expression  */
+#line 655 "yacc_sql.y"
     {
       (yyval.expression_list) = new std::vector<std::unique_ptr<Expression>>;
       (yyval.expression_list)->emplace_back((yyvsp[0].expression));
     }
-#line 2291 "yacc_sql.cpp"
+#line 2404 "yacc_sql.cpp"
     break;
 
-  case 69: /* expression_list: expression COMMA expression_list  */
-#line 594 "yacc_sql.y"
+  case 77: /* expression_list: expression COMMA expression_list  */
+#line 660 "yacc_sql.y"
     {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2300,121 +2413,121 @@ yyreduce:
       }
       (yyval.expression_list)->emplace((yyval.expression_list)->begin(), (yyvsp[-2].expression));
     }
-#line 2304 "yacc_sql.cpp"
+#line 2417 "yacc_sql.cpp"
     break;
 
-  case 70: /* expression: expression '+' expression  */
-#line 604 "yacc_sql.y"
+  case 78: /* expression: expression '+' expression  */
+#line 670 "yacc_sql.y"
                               {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::ADD, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2312 "yacc_sql.cpp"
+#line 2425 "yacc_sql.cpp"
     break;
 
-  case 71: /* expression: expression '-' expression  */
-#line 607 "yacc_sql.y"
+  case 79: /* expression: expression '-' expression  */
+#line 673 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::SUB, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2320 "yacc_sql.cpp"
+#line 2433 "yacc_sql.cpp"
     break;
 
-  case 72: /* expression: expression '*' expression  */
-#line 610 "yacc_sql.y"
+  case 80: /* expression: expression '*' expression  */
+#line 676 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::MUL, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2328 "yacc_sql.cpp"
+#line 2441 "yacc_sql.cpp"
     break;
 
-  case 73: /* expression: expression '/' expression  */
-#line 613 "yacc_sql.y"
+  case 81: /* expression: expression '/' expression  */
+#line 679 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::DIV, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2336 "yacc_sql.cpp"
+#line 2449 "yacc_sql.cpp"
     break;
 
-  case 74: /* expression: INNER_PRODUCT LBRACE expression COMMA expression RBRACE  */
-#line 616 "yacc_sql.y"
+  case 82: /* expression: INNER_PRODUCT LBRACE expression COMMA expression RBRACE  */
+#line 682 "yacc_sql.y"
                                                               {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::INNERPRODUCT, (yyvsp[-3].expression), (yyvsp[-1].expression), sql_string, &(yyloc));
     }
-#line 2344 "yacc_sql.cpp"
+#line 2457 "yacc_sql.cpp"
     break;
 
-  case 75: /* expression: COSINE_DISTANCE LBRACE expression COMMA expression RBRACE  */
-#line 619 "yacc_sql.y"
+  case 83: /* expression: COSINE_DISTANCE LBRACE expression COMMA expression RBRACE  */
+#line 685 "yacc_sql.y"
                                                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::COSINEDISTANCE, (yyvsp[-3].expression), (yyvsp[-1].expression), sql_string, &(yyloc));
     }
-#line 2352 "yacc_sql.cpp"
+#line 2465 "yacc_sql.cpp"
     break;
 
-  case 76: /* expression: L2_DISTANCE LBRACE expression COMMA expression RBRACE  */
-#line 622 "yacc_sql.y"
+  case 84: /* expression: L2_DISTANCE LBRACE expression COMMA expression RBRACE  */
+#line 688 "yacc_sql.y"
                                                             {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::L2DISTANCE, (yyvsp[-3].expression), (yyvsp[-1].expression), sql_string, &(yyloc));
     }
-#line 2360 "yacc_sql.cpp"
+#line 2473 "yacc_sql.cpp"
     break;
 
-  case 77: /* expression: LBRACE expression RBRACE  */
-#line 625 "yacc_sql.y"
+  case 85: /* expression: LBRACE expression RBRACE  */
+#line 691 "yacc_sql.y"
                                {
       (yyval.expression) = (yyvsp[-1].expression);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 2369 "yacc_sql.cpp"
+#line 2482 "yacc_sql.cpp"
     break;
 
-  case 78: /* expression: '-' expression  */
-#line 629 "yacc_sql.y"
+  case 86: /* expression: '-' expression  */
+#line 695 "yacc_sql.y"
                                   {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::NEGATIVE, (yyvsp[0].expression), nullptr, sql_string, &(yyloc));
     }
-#line 2377 "yacc_sql.cpp"
+#line 2490 "yacc_sql.cpp"
     break;
 
-  case 79: /* expression: value  */
-#line 632 "yacc_sql.y"
+  case 87: /* expression: value  */
+#line 698 "yacc_sql.y"
             {
       (yyval.expression) = new ValueExpr(*(yyvsp[0].value));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].value);
     }
-#line 2387 "yacc_sql.cpp"
+#line 2500 "yacc_sql.cpp"
     break;
 
-  case 80: /* expression: rel_attr  */
-#line 637 "yacc_sql.y"
+  case 88: /* expression: rel_attr  */
+#line 703 "yacc_sql.y"
                {
       RelAttrSqlNode *node = (yyvsp[0].rel_attr);
       (yyval.expression) = new UnboundFieldExpr(node->relation_name, node->attribute_name);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].rel_attr);
     }
-#line 2398 "yacc_sql.cpp"
+#line 2511 "yacc_sql.cpp"
     break;
 
-  case 81: /* expression: '*'  */
-#line 643 "yacc_sql.y"
+  case 89: /* expression: '*'  */
+#line 709 "yacc_sql.y"
           {
       (yyval.expression) = new StarExpr();
     }
-#line 2406 "yacc_sql.cpp"
+#line 2519 "yacc_sql.cpp"
     break;
 
-  case 82: /* expression: aggr_expr  */
-#line 646 "yacc_sql.y"
+  case 90: /* expression: aggr_expr  */
+#line 712 "yacc_sql.y"
                 {
       (yyval.expression) = (yyvsp[0].expression);
     }
-#line 2414 "yacc_sql.cpp"
+#line 2527 "yacc_sql.cpp"
     break;
 
-  case 83: /* aggr_expr: ID LBRACE expression RBRACE  */
-#line 653 "yacc_sql.y"
+  case 91: /* aggr_expr: ID LBRACE expression RBRACE  */
+#line 719 "yacc_sql.y"
     {
       Expression* aggexpr = (yyvsp[-1].expression);
       if ((yyvsp[-1].expression)->type() == ExprType::FIELD) {
@@ -2433,21 +2546,21 @@ yyreduce:
       }
       (yyval.expression) = create_aggregate_expression((yyvsp[-3].string), aggexpr, sql_string, &(yyloc));
     }
-#line 2437 "yacc_sql.cpp"
+#line 2550 "yacc_sql.cpp"
     break;
 
-  case 84: /* rel_attr: ID  */
-#line 674 "yacc_sql.y"
+  case 92: /* rel_attr: ID  */
+#line 740 "yacc_sql.y"
        {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->attribute_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 2447 "yacc_sql.cpp"
+#line 2560 "yacc_sql.cpp"
     break;
 
-  case 85: /* rel_attr: ID DOT ID  */
-#line 679 "yacc_sql.y"
+  case 93: /* rel_attr: ID DOT ID  */
+#line 745 "yacc_sql.y"
                 {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = (yyvsp[-2].string);
@@ -2455,20 +2568,20 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 2459 "yacc_sql.cpp"
+#line 2572 "yacc_sql.cpp"
     break;
 
-  case 86: /* join_list: join_chain  */
-#line 689 "yacc_sql.y"
+  case 94: /* join_list: join_chain  */
+#line 755 "yacc_sql.y"
                {
       (yyval.inner_join_list) = new std::vector<InnerJoinSqlNode>;
       (yyval.inner_join_list)->emplace_back(*(yyvsp[0].inner_join));
     }
-#line 2468 "yacc_sql.cpp"
+#line 2581 "yacc_sql.cpp"
     break;
 
-  case 87: /* join_list: join_list COMMA join_chain  */
-#line 693 "yacc_sql.y"
+  case 95: /* join_list: join_list COMMA join_chain  */
+#line 759 "yacc_sql.y"
                                  {
       if (nullptr != (yyvsp[-2].inner_join_list)) {
         (yyval.inner_join_list) = (yyvsp[-2].inner_join_list);
@@ -2477,20 +2590,20 @@ yyreduce:
       }
       (yyval.inner_join_list)->emplace_back(*(yyvsp[0].inner_join));
     }
-#line 2481 "yacc_sql.cpp"
+#line 2594 "yacc_sql.cpp"
     break;
 
-  case 88: /* join_chain: ID  */
-#line 704 "yacc_sql.y"
+  case 96: /* join_chain: ID  */
+#line 770 "yacc_sql.y"
        {
       (yyval.inner_join) = new InnerJoinSqlNode;
       (yyval.inner_join)->relations.emplace_back((yyvsp[0].string));
     }
-#line 2490 "yacc_sql.cpp"
+#line 2603 "yacc_sql.cpp"
     break;
 
-  case 89: /* join_chain: join_chain INNER JOIN ID ON condition  */
-#line 708 "yacc_sql.y"
+  case 97: /* join_chain: join_chain INNER JOIN ID ON condition  */
+#line 774 "yacc_sql.y"
                                             {
       if (nullptr != (yyvsp[-5].inner_join)) {
         (yyval.inner_join) = (yyvsp[-5].inner_join);
@@ -2500,59 +2613,59 @@ yyreduce:
       (yyval.inner_join)->relations.emplace_back((yyvsp[-2].string));
       (yyval.inner_join)->conditions.emplace_back((yyvsp[0].condition));
     }
-#line 2504 "yacc_sql.cpp"
+#line 2617 "yacc_sql.cpp"
     break;
 
-  case 90: /* where: %empty  */
-#line 721 "yacc_sql.y"
+  case 98: /* where: %empty  */
+#line 787 "yacc_sql.y"
     {
       (yyval.expression) = nullptr;
     }
-#line 2512 "yacc_sql.cpp"
+#line 2625 "yacc_sql.cpp"
     break;
 
-  case 91: /* where: WHERE condition  */
-#line 724 "yacc_sql.y"
+  case 99: /* where: WHERE condition  */
+#line 790 "yacc_sql.y"
                       {
       (yyval.expression) = (yyvsp[0].condition);  
     }
-#line 2520 "yacc_sql.cpp"
+#line 2633 "yacc_sql.cpp"
     break;
 
-  case 92: /* is_null_comp: IS NULL_T  */
-#line 730 "yacc_sql.y"
+  case 100: /* is_null_comp: IS NULL_T  */
+#line 796 "yacc_sql.y"
     {
       (yyval.boolean) = true;
     }
-#line 2528 "yacc_sql.cpp"
+#line 2641 "yacc_sql.cpp"
     break;
 
-  case 93: /* is_null_comp: IS NOT NULL_T  */
-#line 734 "yacc_sql.y"
+  case 101: /* is_null_comp: IS NOT NULL_T  */
+#line 800 "yacc_sql.y"
     {
       (yyval.boolean) = false;
     }
-#line 2536 "yacc_sql.cpp"
+#line 2649 "yacc_sql.cpp"
     break;
 
-  case 94: /* condition: expression comp_op expression  */
-#line 741 "yacc_sql.y"
+  case 102: /* condition: expression comp_op expression  */
+#line 807 "yacc_sql.y"
     {
       (yyval.condition) = new ComparisonExpr((yyvsp[-1].comp), (yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 2544 "yacc_sql.cpp"
+#line 2657 "yacc_sql.cpp"
     break;
 
-  case 95: /* condition: expression is_null_comp  */
-#line 745 "yacc_sql.y"
+  case 103: /* condition: expression is_null_comp  */
+#line 811 "yacc_sql.y"
     {
       (yyval.condition) = new ComparisonExpr( ((yyvsp[0].boolean) ? IS_NULL : IS_NOT_NULL), (yyvsp[-1].expression), (yyvsp[-1].expression));
     }
-#line 2552 "yacc_sql.cpp"
+#line 2665 "yacc_sql.cpp"
     break;
 
-  case 96: /* condition: condition AND condition  */
-#line 749 "yacc_sql.y"
+  case 104: /* condition: condition AND condition  */
+#line 815 "yacc_sql.y"
     {
       vector<std::unique_ptr<Expression>> paras;
       std::unique_ptr<Expression> s1((yyvsp[-2].condition));
@@ -2561,149 +2674,165 @@ yyreduce:
       paras.emplace_back(std::move(s2));
       (yyval.condition) = new ConjunctionExpr(ConjunctionExpr::Type::AND, paras);
     }
-#line 2565 "yacc_sql.cpp"
+#line 2678 "yacc_sql.cpp"
     break;
 
-  case 97: /* comp_op: EQ  */
-#line 760 "yacc_sql.y"
+  case 105: /* comp_op: EQ  */
+#line 826 "yacc_sql.y"
          { (yyval.comp) = EQUAL_TO; }
-#line 2571 "yacc_sql.cpp"
+#line 2684 "yacc_sql.cpp"
     break;
 
-  case 98: /* comp_op: LT  */
-#line 761 "yacc_sql.y"
+  case 106: /* comp_op: LT  */
+#line 827 "yacc_sql.y"
          { (yyval.comp) = LESS_THAN; }
-#line 2577 "yacc_sql.cpp"
+#line 2690 "yacc_sql.cpp"
     break;
 
-  case 99: /* comp_op: GT  */
-#line 762 "yacc_sql.y"
+  case 107: /* comp_op: GT  */
+#line 828 "yacc_sql.y"
          { (yyval.comp) = GREAT_THAN; }
-#line 2583 "yacc_sql.cpp"
+#line 2696 "yacc_sql.cpp"
     break;
 
-  case 100: /* comp_op: LE  */
-#line 763 "yacc_sql.y"
+  case 108: /* comp_op: LE  */
+#line 829 "yacc_sql.y"
          { (yyval.comp) = LESS_EQUAL; }
-#line 2589 "yacc_sql.cpp"
+#line 2702 "yacc_sql.cpp"
     break;
 
-  case 101: /* comp_op: GE  */
-#line 764 "yacc_sql.y"
+  case 109: /* comp_op: GE  */
+#line 830 "yacc_sql.y"
          { (yyval.comp) = GREAT_EQUAL; }
-#line 2595 "yacc_sql.cpp"
+#line 2708 "yacc_sql.cpp"
     break;
 
-  case 102: /* comp_op: NE  */
-#line 765 "yacc_sql.y"
+  case 110: /* comp_op: NE  */
+#line 831 "yacc_sql.y"
          { (yyval.comp) = NOT_EQUAL; }
-#line 2601 "yacc_sql.cpp"
+#line 2714 "yacc_sql.cpp"
     break;
 
-  case 103: /* comp_op: LIKE  */
-#line 766 "yacc_sql.y"
+  case 111: /* comp_op: LIKE  */
+#line 832 "yacc_sql.y"
            { (yyval.comp) = LIKE_OP;}
-#line 2607 "yacc_sql.cpp"
+#line 2720 "yacc_sql.cpp"
     break;
 
-  case 104: /* comp_op: NOT LIKE  */
-#line 767 "yacc_sql.y"
+  case 112: /* comp_op: NOT LIKE  */
+#line 833 "yacc_sql.y"
                {(yyval.comp) = NOT_LIKE_OP;}
-#line 2613 "yacc_sql.cpp"
+#line 2726 "yacc_sql.cpp"
     break;
 
-  case 105: /* group_by: %empty  */
-#line 773 "yacc_sql.y"
+  case 113: /* group_by: %empty  */
+#line 839 "yacc_sql.y"
     {
       (yyval.expression_list) = nullptr;
     }
-#line 2621 "yacc_sql.cpp"
+#line 2734 "yacc_sql.cpp"
     break;
 
-  case 106: /* group_by: GROUP BY expression_list  */
-#line 776 "yacc_sql.y"
+  case 114: /* group_by: GROUP BY expression_list  */
+#line 842 "yacc_sql.y"
                                {
       (yyval.expression_list) = (yyvsp[0].expression_list);  
     }
-#line 2629 "yacc_sql.cpp"
+#line 2742 "yacc_sql.cpp"
     break;
 
-  case 107: /* having: %empty  */
-#line 782 "yacc_sql.y"
+  case 115: /* having: %empty  */
+#line 848 "yacc_sql.y"
     {
       (yyval.expression) = nullptr;
     }
-#line 2637 "yacc_sql.cpp"
+#line 2750 "yacc_sql.cpp"
     break;
 
-  case 108: /* having: HAVING condition  */
-#line 785 "yacc_sql.y"
+  case 116: /* having: HAVING condition  */
+#line 851 "yacc_sql.y"
                        {
       (yyval.expression) = (yyvsp[0].condition);
     }
-#line 2645 "yacc_sql.cpp"
+#line 2758 "yacc_sql.cpp"
     break;
 
-  case 109: /* order_node: expression  */
-#line 791 "yacc_sql.y"
+  case 117: /* order_node: expression  */
+#line 857 "yacc_sql.y"
   {
     (yyval.order_key) = new std::pair<bool,Expression*>(true, (yyvsp[0].expression));
   }
-#line 2653 "yacc_sql.cpp"
+#line 2766 "yacc_sql.cpp"
     break;
 
-  case 110: /* order_node: expression ASC  */
-#line 795 "yacc_sql.y"
+  case 118: /* order_node: expression ASC  */
+#line 861 "yacc_sql.y"
   {
     (yyval.order_key) = new std::pair<bool,Expression*>(true, (yyvsp[-1].expression));
   }
-#line 2661 "yacc_sql.cpp"
+#line 2774 "yacc_sql.cpp"
     break;
 
-  case 111: /* order_node: expression DESC  */
-#line 799 "yacc_sql.y"
+  case 119: /* order_node: expression DESC  */
+#line 865 "yacc_sql.y"
   {
     (yyval.order_key) = new std::pair<bool,Expression*>(false, (yyvsp[-1].expression));
   }
-#line 2669 "yacc_sql.cpp"
+#line 2782 "yacc_sql.cpp"
     break;
 
-  case 112: /* order_by_list: order_node  */
-#line 805 "yacc_sql.y"
+  case 120: /* order_by_list: order_node  */
+#line 871 "yacc_sql.y"
         {
     (yyval.order_key_list) = new std::vector<pair<bool,Expression*>>;
     (yyval.order_key_list)->emplace_back(*(yyvsp[0].order_key));
 	}
-#line 2678 "yacc_sql.cpp"
+#line 2791 "yacc_sql.cpp"
     break;
 
-  case 113: /* order_by_list: order_by_list COMMA order_node  */
-#line 811 "yacc_sql.y"
+  case 121: /* order_by_list: order_by_list COMMA order_node  */
+#line 877 "yacc_sql.y"
         {
     (yyval.order_key_list) = (yyvsp[-2].order_key_list);
     (yyval.order_key_list)->emplace_back(*(yyvsp[0].order_key));
 	}
-#line 2687 "yacc_sql.cpp"
+#line 2800 "yacc_sql.cpp"
     break;
 
-  case 114: /* order_by: %empty  */
-#line 818 "yacc_sql.y"
+  case 122: /* order_by: %empty  */
+#line 884 "yacc_sql.y"
     {
       (yyval.order_key_list) = nullptr;
     }
-#line 2695 "yacc_sql.cpp"
+#line 2808 "yacc_sql.cpp"
     break;
 
-  case 115: /* order_by: ORDER BY order_by_list  */
-#line 821 "yacc_sql.y"
+  case 123: /* order_by: ORDER BY order_by_list  */
+#line 887 "yacc_sql.y"
                              {
       (yyval.order_key_list) = (yyvsp[0].order_key_list);  
     }
-#line 2703 "yacc_sql.cpp"
+#line 2816 "yacc_sql.cpp"
     break;
 
-  case 116: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
-#line 828 "yacc_sql.y"
+  case 124: /* limit: %empty  */
+#line 894 "yacc_sql.y"
+    {
+      (yyval.number) = -1;
+    }
+#line 2824 "yacc_sql.cpp"
+    break;
+
+  case 125: /* limit: LIMIT NUMBER  */
+#line 897 "yacc_sql.y"
+                   {
+      (yyval.number) = (yyvsp[0].number);
+    }
+#line 2832 "yacc_sql.cpp"
+    break;
+
+  case 126: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
+#line 904 "yacc_sql.y"
     {
       char *tmp_file_name = common::substr((yyvsp[-3].string), 1, strlen((yyvsp[-3].string)) - 2);
       
@@ -2713,20 +2842,20 @@ yyreduce:
       free((yyvsp[0].string));
       free(tmp_file_name);
     }
-#line 2717 "yacc_sql.cpp"
+#line 2846 "yacc_sql.cpp"
     break;
 
-  case 117: /* explain_stmt: EXPLAIN command_wrapper  */
-#line 841 "yacc_sql.y"
+  case 127: /* explain_stmt: EXPLAIN command_wrapper  */
+#line 917 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXPLAIN);
       (yyval.sql_node)->explain.sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[0].sql_node));
     }
-#line 2726 "yacc_sql.cpp"
+#line 2855 "yacc_sql.cpp"
     break;
 
-  case 118: /* set_variable_stmt: SET ID EQ value  */
-#line 849 "yacc_sql.y"
+  case 128: /* set_variable_stmt: SET ID EQ value  */
+#line 925 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SET_VARIABLE);
       (yyval.sql_node)->set_variable.name  = (yyvsp[-2].string);
@@ -2734,11 +2863,11 @@ yyreduce:
       free((yyvsp[-2].string));
       delete (yyvsp[0].value);
     }
-#line 2738 "yacc_sql.cpp"
+#line 2867 "yacc_sql.cpp"
     break;
 
 
-#line 2742 "yacc_sql.cpp"
+#line 2871 "yacc_sql.cpp"
 
       default: break;
     }
@@ -2967,7 +3096,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 861 "yacc_sql.y"
+#line 937 "yacc_sql.y"
 
 //_____________________________________________________________________
 extern void scan_string(const char *str, yyscan_t scanner);
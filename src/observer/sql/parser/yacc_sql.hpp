@@ -117,11 +117,13 @@ extern int yydebug;
     INNER_PRODUCT = 318,           /* INNER_PRODUCT  */
     COSINE_DISTANCE = 319,         /* COSINE_DISTANCE  */
     L2_DISTANCE = 320,             /* L2_DISTANCE  */
-    NUMBER = 321,                  /* NUMBER  */
-    FLOAT = 322,                   /* FLOAT  */
-    ID = 323,                      /* ID  */
-    SSS = 324,                     /* SSS  */
-    UMINUS = 325                   /* UMINUS  */
+    LIMIT = 321,                   /* LIMIT  */
+    WITH = 322,                    /* WITH  */
+    NUMBER = 323,                  /* NUMBER  */
+    FLOAT = 324,                   /* FLOAT  */
+    ID = 325,                      /* ID  */
+    SSS = 326,                     /* SSS  */
+    UMINUS = 327                   /* UMINUS  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -130,7 +132,7 @@ extern int yydebug;
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 132 "yacc_sql.y"
+#line 134 "yacc_sql.y"
 
   ParsedSqlNode *                            sql_node;
   Expression *                               condition;
@@ -146,6 +148,8 @@ union YYSTYPE
   std::vector<Value> *                       value_list;
   std::vector<RelAttrSqlNode> *              rel_attr_list;
   std::vector<std::string> *                 relation_list;
+  std::vector<std::pair<std::string, std::string>> * index_option_list;
+  std::pair<std::string, std::string> *      index_option;
   std::vector<pair<std::string,Value>> *     update_c_list;
   char *                                     string;
   int                                        number;
@@ -154,7 +158,7 @@ union YYSTYPE
   std::pair<bool,Expression*> *              order_key;
   std::vector<pair<bool,Expression*>> *      order_key_list;
 
-#line 158 "yacc_sql.hpp"
+#line 162 "yacc_sql.hpp"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -127,6 +127,8 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
         INNER_PRODUCT
         COSINE_DISTANCE
         L2_DISTANCE
+        LIMIT
+        WITH
 
 /** union 中定义各种数据类型，真实生成的代码也是union类型，所以不能有非POD类型的数据 **/
 %union {
@@ -144,6 +146,8 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
   std::vector<Value> *                       value_list;
   std::vector<RelAttrSqlNode> *              rel_attr_list;
   std::vector<std::string> *                 relation_list;
+  std::vector<std::pair<std::string, std::string>> * index_option_list;
+  std::pair<std::string, std::string> *      index_option;
   std::vector<pair<std::string,Value>> *     update_c_list;
   char *                                     string;
   int                                        number;
@@ -208,6 +212,9 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
 // commands should be a list but I use a single command instead
 %type <sql_node>            commands
 %type <relation_list>       index_list
+%type <index_option_list>   index_option_list
+%type <index_option>        index_option
+%type <number>              limit
 %type <update_c_list>       update_list
 
 %left AND
@@ -314,6 +321,63 @@ create_index_stmt:    /*create index 语句的语法解析树*/
       free($4);
       free($6);
     }
+    | CREATE VECTOR_T INDEX ID ON ID LBRACE index_list RBRACE WITH LBRACE index_option_list RBRACE
+    {
+      $$ = new ParsedSqlNode(SCF_CREATE_INDEX);
+      CreateIndexSqlNode &create_index = $$->create_index;
+      create_index.isunique = false;
+      create_index.is_vector = true;
+      create_index.index_name = $4;
+      create_index.relation_name = $6;
+      create_index.attribute_names.swap(*$8);
+      create_index.options.swap(*$12);
+      free($4);
+      free($6);
+      delete $8;
+      delete $12;
+    }
+    ;
+index_option_list:
+    index_option
+    {
+      $$ = new std::vector<std::pair<std::string, std::string>>;
+      $$->emplace_back(std::move(*$1));
+      delete $1;
+    }
+    | index_option_list COMMA index_option
+    {
+      $$ = $1;
+      $$->emplace_back(std::move(*$3));
+      delete $3;
+    }
+    ;
+index_option:
+    ID EQ ID
+    {
+      $$ = new std::pair<std::string, std::string>($1, $3);
+      free($1);
+      free($3);
+    }
+    | ID EQ NUMBER
+    {
+      $$ = new std::pair<std::string, std::string>($1, std::to_string($3));
+      free($1);
+    }
+    | ID EQ L2_DISTANCE
+    {
+      $$ = new std::pair<std::string, std::string>($1, "l2_distance");
+      free($1);
+    }
+    | ID EQ COSINE_DISTANCE
+    {
+      $$ = new std::pair<std::string, std::string>($1, "cosine_distance");
+      free($1);
+    }
+    | ID EQ INNER_PRODUCT
+    {
+      $$ = new std::pair<std::string, std::string>($1, "inner_product");
+      free($1);
+    }
     ;
 is_unique:
     /* empty */
@@ -544,7 +608,7 @@ update_list:
     ;
 
 select_stmt:        /*  select 语句的语法解析树*/
-    SELECT expression_list FROM join_list where group_by having order_by
+    SELECT expression_list FROM join_list where group_by having order_by limit
     {
       $$ = new ParsedSqlNode(SCF_SELECT);
       if ($2 != nullptr) {
@@ -573,6 +637,8 @@ select_stmt:        /*  select 语句的语法解析树*/
       if ($8 != nullptr) {
         $$->selection.order_by.swap(*$8);
       }
+
+      $$->selection.limit = $9;
     }
     ;
 calc_stmt:
@@ -823,6 +889,16 @@ order_by:
     }
     ;
 
+limit:
+    /* empty */
+    {
+      $$ = -1;
+    }
+    | LIMIT NUMBER {
+      $$ = $2;
+    }
+    ;
+
 load_data_stmt:
     LOAD DATA INFILE SSS INTO TABLE ID 
     {
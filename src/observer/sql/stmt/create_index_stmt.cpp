@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2023/4/25.
 //
 
+#include <strings.h>
+
 #include "sql/stmt/create_index_stmt.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
@@ -58,6 +60,65 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
     return RC::SCHEMA_INDEX_NAME_REPEAT;
   }
 
-  stmt = new CreateIndexStmt(table, fields, create_index.index_name, create_index.isunique);
+  auto create_index_stmt = new CreateIndexStmt(table, fields, create_index.index_name, create_index.isunique);
+  if (create_index.is_vector) {
+    RC rc = create_index_stmt->init_vector_index(create_index);
+    if (OB_FAIL(rc)) {
+      delete create_index_stmt;
+      return rc;
+    }
+  }
+
+  stmt = create_index_stmt;
+  return RC::SUCCESS;
+}
+
+RC CreateIndexStmt::init_vector_index(const CreateIndexSqlNode &create_index)
+{
+  // field_meta_ 的第一个字段是NULL位图
+  if (field_meta_.size() != 2 || field_meta_[1]->type() != AttrType::VECTORS) {
+    LOG_WARN("vector index can only be created on one vector field. index=%s", index_name_.c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  bool has_type     = false;
+  bool has_distance = false;
+  for (const auto &[name, value] : create_index.options) {
+    RC rc = RC::SUCCESS;
+    if (0 == strcasecmp(name.c_str(), "type")) {
+      rc       = index_type_from_string(value, index_type_);
+      has_type = true;
+    } else if (0 == strcasecmp(name.c_str(), "distance")) {
+      rc           = vector_distance_from_string(value, vector_params_.distance);
+      has_distance = true;
+    } else if (0 == strcasecmp(name.c_str(), "lists")) {
+      vector_params_.lists = atoi(value.c_str());
+      rc                   = vector_params_.lists > 0 ? RC::SUCCESS : RC::INVALID_ARGUMENT;
+    } else if (0 == strcasecmp(name.c_str(), "probes")) {
+      vector_params_.probes = atoi(value.c_str());
+      rc                    = vector_params_.probes > 0 ? RC::SUCCESS : RC::INVALID_ARGUMENT;
+    } else if (0 == strcasecmp(name.c_str(), "m")) {
+      vector_params_.m = atoi(value.c_str());
+      rc               = vector_params_.m > 1 ? RC::SUCCESS : RC::INVALID_ARGUMENT;
+    } else if (0 == strcasecmp(name.c_str(), "ef_construction")) {
+      vector_params_.ef_construction = atoi(value.c_str());
+      rc                             = vector_params_.ef_construction > 0 ? RC::SUCCESS : RC::INVALID_ARGUMENT;
+    } else if (0 == strcasecmp(name.c_str(), "ef_search")) {
+      vector_params_.ef_search = atoi(value.c_str());
+      rc                       = vector_params_.ef_search > 0 ? RC::SUCCESS : RC::INVALID_ARGUMENT;
+    } else {
+      rc = RC::INVALID_ARGUMENT;
+    }
+
+    if (OB_FAIL(rc)) {
+      LOG_WARN("invalid vector index option. index=%s, option=%s, value=%s", index_name_.c_str(), name.c_str(), value.c_str());
+      return rc;
+    }
+  }
+
+  if (!has_type || !has_distance || index_type_ == IndexType::BPLUS_TREE) {
+    LOG_WARN("vector index requires type and distance options. index=%s", index_name_.c_str());
+    return RC::INVALID_ARGUMENT;
+  }
   return RC::SUCCESS;
 }
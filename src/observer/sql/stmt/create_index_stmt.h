@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 
 #include "sql/stmt/stmt.h"
+#include "storage/index/index_meta.h"
 
 struct CreateIndexSqlNode;
 class Table;
@@ -42,12 +43,22 @@ public:
   const std::string &index_name() const { return index_name_; }
   bool is_unique() const { return is_unique_; }
 
+  IndexType                index_type() const { return index_type_; }
+  const VectorIndexParams &vector_params() const { return vector_params_; }
+
 public:
   static RC create(Db *db, const CreateIndexSqlNode &create_index, Stmt *&stmt);
 
+private:
+  /// 解析向量索引 with 子句中的参数
+  RC init_vector_index(const CreateIndexSqlNode &create_index);
+
 private:
   Table           *table_      = nullptr;
   const vector<const FieldMeta*> field_meta_;
   std::string      index_name_;
   bool             is_unique_ = false;
+
+  IndexType         index_type_ = IndexType::BPLUS_TREE;
+  VectorIndexParams vector_params_;
 };
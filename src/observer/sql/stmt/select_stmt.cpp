@@ -115,6 +115,11 @@ RC SelectStmt::create(Db *db, SelectSqlNode &select_sql, Stmt *&stmt)
     return RC::INVALID_ARGUMENT;
   }
 
+  if (select_sql.limit < -1) {
+    LOG_WARN("invalid limit. limit=%d", select_sql.limit);
+    return RC::INVALID_ARGUMENT;
+  }
+
   BinderContext binder_context;
 
   // collect tables in `from` statement
@@ -231,6 +236,7 @@ RC SelectStmt::create(Db *db, SelectSqlNode &select_sql, Stmt *&stmt)
   select_stmt->filter_stmt_ = filter_stmt;
   select_stmt->group_by_.swap(group_by_expressions);
   select_stmt->order_by_.swap(order_by_expressions);
+  select_stmt->limit_ = select_sql.limit;
 //  select_stmt->having_ = having_condition[0].release();
   stmt                      = select_stmt;
   return RC::SUCCESS;
@@ -64,6 +64,7 @@ public:
   std::vector<std::unique_ptr<Expression>> &group_by() { return group_by_; }
   std::vector<std::pair<bool,std::unique_ptr<Expression>>> &order_by() { return order_by_; }
   Expression* having() { return having_; }
+  int         limit() const { return limit_; }
 
 private:
   std::vector<std::unique_ptr<Expression>> query_expressions_;
@@ -72,4 +73,5 @@ private:
   std::vector<std::unique_ptr<Expression>> group_by_;
   std::vector<std::pair<bool,std::unique_ptr<Expression>>> order_by_;
   Expression*                              having_;
+  int                                      limit_ = -1;  ///< -1 表示没有 limit
 };
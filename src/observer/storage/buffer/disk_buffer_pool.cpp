@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/io/io.h"
 #include "common/lang/mutex.h"
 #include "common/lang/algorithm.h"
+#include "common/lang/thread.h"
 #include "common/log/log.h"
 #include "common/math/crc.h"
 #include "storage/buffer/disk_buffer_pool.h"
@@ -38,38 +39,128 @@ string BPFileHeader::to_string() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
-BPFrameManager::BPFrameManager(const char *name) : allocator_(name) {}
+BPFrameManager::BPFrameManager(const char *name, int shard_num /* = DEFAULT_SHARD_NUM */) : allocator_(name)
+{
+  if (shard_num <= 0) {
+    shard_num = 1;
+  }
+
+  shards_.reserve(shard_num);
+  for (int i = 0; i < shard_num; i++) {
+    shards_.push_back(make_unique<FrameShard>());
+  }
+}
 
-RC BPFrameManager::init(int pool_num)
+RC BPFrameManager::init(int pool_num, const char *eviction_policy /* = nullptr */)
 {
   int ret = allocator_.init(false, pool_num);
-  if (ret == 0) {
-    return RC::SUCCESS;
+  if (ret != 0) {
+    return RC::NOMEM;
   }
-  return RC::NOMEM;
+
+  const size_t shard_capacity = max(static_cast<size_t>(allocator_.get_size()) / shards_.size(), static_cast<size_t>(1));
+
+  unique_ptr<FrameEvictionPolicy> policy;
+  RC rc = FrameEvictionPolicy::create(eviction_policy, shard_capacity, policy);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create frame eviction policy %s, use lru instead. rc=%s", eviction_policy, strrc(rc));
+    eviction_policy = "lru";
+  }
+
+  for (unique_ptr<FrameShard> &shard : shards_) {
+    (void)FrameEvictionPolicy::create(eviction_policy, shard_capacity, shard->policy);
+  }
+  LOG_INFO("frame manager init with %d shards, eviction policy=%s", shard_num(), shards_.front()->policy->name());
+  return RC::SUCCESS;
 }
 
 RC BPFrameManager::cleanup()
 {
-  if (frames_.count() > 0) {
+  if (frame_num() > 0) {
     return RC::INTERNAL;
   }
 
-  frames_.destroy();
+  for (unique_ptr<FrameShard> &shard : shards_) {
+    lock_guard<mutex> lock_guard(shard->lock);
+    shard->frames.clear();
+  }
   return RC::SUCCESS;
 }
 
-int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
+size_t BPFrameManager::frame_num() const
+{
+  size_t count = 0;
+  for (const unique_ptr<FrameShard> &shard : shards_) {
+    lock_guard<mutex> lock_guard(shard->lock);
+    count += shard->frames.size();
+  }
+  return count;
+}
+
+size_t BPFrameManager::dirty_frame_num() const
 {
-  lock_guard<mutex> lock_guard(lock_);
+  size_t count = 0;
+  for (const unique_ptr<FrameShard> &shard : shards_) {
+    lock_guard<mutex> lock_guard(shard->lock);
+    for (const auto &[frame_id, frame] : shard->frames) {
+      if (frame->dirty()) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
 
-  vector<Frame *> frames_can_purge;
+LSN BPFrameManager::min_rec_lsn() const
+{
+  LSN min_lsn = 0;
+  for (const unique_ptr<FrameShard> &shard : shards_) {
+    lock_guard<mutex> lock_guard(shard->lock);
+    for (const auto &[frame_id, frame] : shard->frames) {
+      const LSN rec_lsn = frame->rec_lsn();
+      if (rec_lsn > 0 && (min_lsn == 0 || rec_lsn < min_lsn)) {
+        min_lsn = rec_lsn;
+      }
+    }
+  }
+  return min_lsn;
+}
+
+BPFrameManager::FrameShard &BPFrameManager::shard_of(const FrameId &frame_id)
+{
+  // 同一个文件的连续页面分布在不同的分片上，不同文件的相同页号也尽量分散开
+  size_t hash = frame_id.hash();
+  hash ^= (hash >> 32);
+  return *shards_[hash % shards_.size()];
+}
+
+int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
+{
   if (count <= 0) {
     count = 1;
   }
+
+  const uint32_t shard_num   = static_cast<uint32_t>(shards_.size());
+  const uint32_t start_shard = purge_cursor_.fetch_add(1) % shard_num;
+
+  int freed_count = 0;
+  for (uint32_t i = 0; i < shard_num && freed_count < count; i++) {
+    FrameShard &shard = *shards_[(start_shard + i) % shard_num];
+    freed_count += purge_shard_frames(shard, count - freed_count, purger);
+  }
+
+  LOG_INFO("purge frame done. number=%d", freed_count);
+  return freed_count;
+}
+
+int BPFrameManager::purge_shard_frames(FrameShard &shard, int count, function<RC(Frame *frame)> &purger)
+{
+  lock_guard<mutex> lock_guard(shard.lock);
+
+  vector<Frame *> frames_can_purge;
   frames_can_purge.reserve(count);
 
-  auto purge_finder = [&frames_can_purge, count](const FrameId &frame_id, Frame *const frame) {
+  auto purge_finder = [&frames_can_purge, count](Frame *frame) {
     if (frame->can_purge()) {
       frame->pin();
       frames_can_purge.push_back(frame);
@@ -80,16 +171,16 @@ int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
     return true;  // true continue to look up
   };
 
-  frames_.foreach_reverse(purge_finder);
-  LOG_INFO("purge frames find %ld pages total", frames_can_purge.size());
+  shard.policy->foreach_victim(purge_finder);
+  LOG_DEBUG("purge frames find %ld pages in shard", frames_can_purge.size());
 
-  /// 当前还在frameManager的锁内，而 purger 是一个非常耗时的操作
-  /// 他需要把脏页数据刷新到磁盘上去，所以这里会极大地降低并发度
+  /// 当前还在分片的锁内，而 purger 是一个非常耗时的操作
+  /// 他需要把脏页数据刷新到磁盘上去，不过只会阻塞访问当前分片的线程
   int freed_count = 0;
   for (Frame *frame : frames_can_purge) {
     RC rc = purger(frame);
     if (RC::SUCCESS == rc) {
-      free_internal(frame->frame_id(), frame);
+      free_internal(shard, frame->frame_id(), frame, true /*evicted*/);
       freed_count++;
     } else {
       frame->unpin();
@@ -97,35 +188,39 @@ int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
                frame->frame_id().to_string().c_str(), strrc(rc));
     }
   }
-  LOG_INFO("purge frame done. number=%d", freed_count);
   return freed_count;
 }
 
 Frame *BPFrameManager::get(int buffer_pool_id, PageNum page_num)
 {
-  FrameId                     frame_id(buffer_pool_id, page_num);
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
-  return get_internal(frame_id);
+  lock_guard<mutex> lock_guard(shard.lock);
+  return get_internal(shard, frame_id);
 }
 
-Frame *BPFrameManager::get_internal(const FrameId &frame_id)
+Frame *BPFrameManager::get_internal(FrameShard &shard, const FrameId &frame_id)
 {
-  Frame *frame = nullptr;
-  (void)frames_.get(frame_id, frame);
-  if (frame != nullptr) {
-    frame->pin();
+  auto iter = shard.frames.find(frame_id);
+  if (iter == shard.frames.end()) {
+    return nullptr;
   }
+
+  Frame *frame = iter->second;
+  frame->pin();
+  shard.policy->access(frame);
   return frame;
 }
 
 Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num)
 {
-  FrameId frame_id(buffer_pool_id, page_num);
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
+  lock_guard<mutex> lock_guard(shard.lock);
 
-  Frame                      *frame = get_internal(frame_id);
+  Frame *frame = get_internal(shard, frame_id);
   if (frame != nullptr) {
     return frame;
   }
@@ -137,47 +232,68 @@ Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num)
     frame->set_buffer_pool_id(buffer_pool_id);
     frame->set_page_num(page_num);
     frame->pin();
-    frames_.put(frame_id, frame);
+    shard.frames.emplace(frame_id, frame);
+    shard.policy->admit(frame);
   }
   return frame;
 }
 
 RC BPFrameManager::free(int buffer_pool_id, PageNum page_num, Frame *frame)
 {
-  FrameId frame_id(buffer_pool_id, page_num);
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
+
+  lock_guard<mutex> lock_guard(shard.lock);
+  return free_internal(shard, frame_id, frame, false /*evicted*/);
+}
+
+RC BPFrameManager::free_after_unpinned(int buffer_pool_id, PageNum page_num, Frame *frame)
+{
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
-  return free_internal(frame_id, frame);
+  while (true) {
+    {
+      lock_guard<mutex> lock_guard(shard.lock);
+      if (frame->pin_count() == 1) {
+        return free_internal(shard, frame_id, frame, false /*evicted*/);
+      }
+    }
+    this_thread::yield();
+  }
 }
 
-RC BPFrameManager::free_internal(const FrameId &frame_id, Frame *frame)
+RC BPFrameManager::free_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame, bool evicted)
 {
-  Frame                *frame_source = nullptr;
-  [[maybe_unused]] bool found        = frames_.get(frame_id, frame_source);
+  auto   iter         = shard.frames.find(frame_id);
+  bool   found        = (iter != shard.frames.end());
+  Frame *frame_source = found ? iter->second : nullptr;
   ASSERT(found && frame == frame_source && frame->pin_count() == 1,
       "failed to free frame. found=%d, frameId=%s, frame_source=%p, frame=%p, pinCount=%d, lbt=%s",
       found, frame_id.to_string().c_str(), frame_source, frame, frame->pin_count(), lbt());
 
+  if (found) {
+    shard.policy->remove(frame, evicted);
+    shard.frames.erase(iter);
+  }
   frame->set_page_num(-1);
   frame->unpin();
-  frames_.remove(frame_id);
   allocator_.free(frame);
   return RC::SUCCESS;
 }
 
 list<Frame *> BPFrameManager::find_list(int buffer_pool_id)
 {
-  lock_guard<mutex> lock_guard(lock_);
-
   list<Frame *> frames;
-  auto               fetcher = [&frames, buffer_pool_id](const FrameId &frame_id, Frame *const frame) -> bool {
-    if (buffer_pool_id == frame_id.buffer_pool_id()) {
-      frame->pin();
-      frames.push_back(frame);
+  for (unique_ptr<FrameShard> &shard : shards_) {
+    lock_guard<mutex> lock_guard(shard->lock);
+    for (auto &[frame_id, frame] : shard->frames) {
+      if (buffer_pool_id == frame_id.buffer_pool_id()) {
+        frame->pin();
+        frames.push_back(frame);
+      }
     }
-    return true;
-  };
-  frames_.foreach (fetcher);
+  }
   return frames;
 }
 
@@ -237,7 +353,7 @@ RC DiskBufferPool::open_file(const char *file_name)
   file_desc_ = fd;
 
   Page header_page;
-  int ret = readn(file_desc_, &header_page, sizeof(header_page));
+  int ret = preadn(file_desc_, &header_page, sizeof(header_page), 0);
   if (ret != 0) {
     LOG_ERROR("Failed to read first page of %s, due to %s.", file_name, strerror(errno));
     close(fd);
@@ -266,6 +382,7 @@ RC DiskBufferPool::open_file(const char *file_name)
     file_desc_ = -1;
     return rc;
   }
+  hdr_frame_->mark_loaded();
 
   file_header_ = (BPFileHeader *)hdr_frame_->data();
 
@@ -281,6 +398,9 @@ RC DiskBufferPool::close_file()
     return rc;
   }
 
+  // 后台刷脏页线程可能正pin着这个文件的页面，等它结束后再淘汰页面
+  unique_lock<mutex> cleaner_guard(bp_manager_.page_cleaner_lock());
+
   hdr_frame_->unpin();
 
   // TODO: 理论上是在回放时回滚未提交事务，但目前没有undo log，因此不下刷数据page，只通过redo log回放
@@ -298,6 +418,10 @@ RC DiskBufferPool::close_file()
 
   disposed_pages_.clear();
 
+  if (read_ahead_pages_ > 0) {
+    LOG_INFO("read ahead stats of %s: %s", file_name_.c_str(), read_ahead_stats_.to_string().c_str());
+  }
+
   if (close(file_desc_) < 0) {
     LOG_ERROR("Failed to close fileId:%d, fileName:%s, error:%s", file_desc_, file_name_.c_str(), strerror(errno));
     return RC::IOERR_CLOSE;
@@ -305,6 +429,7 @@ RC DiskBufferPool::close_file()
   LOG_INFO("Successfully close file %d:%s.", file_desc_, file_name_.c_str());
   file_desc_ = -1;
 
+  cleaner_guard.unlock();
   bp_manager_.close_file(file_name_.c_str());
   return RC::SUCCESS;
 }
@@ -319,37 +444,152 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
   *frame = nullptr;
 
   Frame *used_match_frame = frame_manager_.get(id(), page_num);
-  if (used_match_frame != nullptr) {
+  if (used_match_frame != nullptr && used_match_frame->loaded()) {
     used_match_frame->access();
     *frame = used_match_frame;
+
+    if (used_match_frame->take_prefetched()) {
+      read_ahead_stats_.read_ahead_hits.fetch_add(1, memory_order_relaxed);
+      check_read_ahead(page_num);
+    }
     return RC::SUCCESS;
   }
 
-  scoped_lock lock_guard(lock_);  // 直接加了一把大锁，其实可以根据访问的页面来细化提高并行度
-
-  // Allocate one page and load the data into this page
-  Frame *allocated_frame = nullptr;
-
-  rc = allocate_frame(page_num, &allocated_frame);
-  if (rc != RC::SUCCESS) {
-    LOG_ERROR("Failed to alloc frame %s:%d, due to failed to alloc page.", file_name_.c_str(), page_num);
-    return rc;
+  // 这里不再加大锁，不同页面的加载可以并行进行。
+  // 页帧放入页帧表之后才开始加载数据，同一个页面只会有一个线程负责加载，其它线程等待加载完成
+  Frame *allocated_frame = used_match_frame;
+  if (allocated_frame == nullptr) {
+    rc = allocate_frame(page_num, &allocated_frame);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to alloc frame %s:%d, due to failed to alloc page.", file_name_.c_str(), page_num);
+      return rc;
+    }
   }
 
   allocated_frame->set_buffer_pool_id(id());
   // allocated_frame->pin(); // pined in manager::get
   allocated_frame->access();
 
-  if ((rc = load_page(page_num, allocated_frame)) != RC::SUCCESS) {
-    LOG_ERROR("Failed to load page %s:%d", file_name_.c_str(), page_num);
-    purge_frame(page_num, allocated_frame);
-    return rc;
+  while (!allocated_frame->loaded()) {
+    if (!allocated_frame->try_begin_load()) {
+      this_thread::yield();
+      continue;
+    }
+
+    rc = load_page(page_num, allocated_frame);
+    allocated_frame->finish_load(OB_SUCC(rc));
+    if (OB_FAIL(rc)) {
+      // 其它线程可能也拿到了这个页帧，所以不能直接释放，页帧会在之后被淘汰
+      LOG_ERROR("Failed to load page %s:%d", file_name_.c_str(), page_num);
+      allocated_frame->unpin();
+      return rc;
+    }
+
+    read_ahead_stats_.misses.fetch_add(1, memory_order_relaxed);
+    check_read_ahead(page_num);
+  }
+
+  if (allocated_frame->take_prefetched()) {
+    // 等待的是其它线程正在预读的页面
+    read_ahead_stats_.read_ahead_hits.fetch_add(1, memory_order_relaxed);
   }
 
   *frame = allocated_frame;
   return RC::SUCCESS;
 }
 
+void DiskBufferPool::check_read_ahead(PageNum page_num)
+{
+  if (read_ahead_pages_ <= 0) {
+    return;
+  }
+
+  PageNum start = BP_INVALID_PAGE_NUM;
+  int     count = 0;
+  {
+    lock_guard<mutex> guard(read_ahead_lock_);
+    if (!read_ahead_detector_.access(page_num, start, count)) {
+      return;
+    }
+  }
+
+  RC rc = read_ahead(start, count);
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to read ahead. file=%s, start=%d, count=%d, rc=%s", file_name_.c_str(), start, count, strrc(rc));
+  }
+}
+
+RC DiskBufferPool::read_ahead(PageNum start_page_num, int count)
+{
+  const PageNum end_page_num = min(start_page_num + count, static_cast<PageNum>(file_header_->page_count));
+
+  vector<Frame *> frames;
+  PageIoBatch     batch;
+  for (PageNum page_num = start_page_num; page_num < end_page_num; page_num++) {
+    if ((file_header_->bitmap[page_num / 8] & (1 << (page_num % 8))) == 0) {
+      continue;
+    }
+
+    Frame *frame = frame_manager_.get(id(), page_num);
+    if (frame != nullptr) {
+      frame->unpin();
+      continue;
+    }
+
+    RC rc = try_allocate_frame(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      // 内存不够，只预读已经分配到页帧的页面
+      break;
+    }
+
+    if (!frame->try_begin_load()) {
+      // 在我们分配页帧的时候，其它线程已经开始加载这个页面了
+      frame->unpin();
+      continue;
+    }
+
+    frame->set_buffer_pool_id(id());
+    frame->mark_prefetched();
+
+    // double write buffer 中的页面比磁盘上的新
+    rc = dblwr_manager_.read_page(this, page_num, frame->page());
+    if (OB_SUCC(rc)) {
+      frame->finish_load(true);
+      frame->unpin();
+      continue;
+    }
+
+    batch.add_read(file_desc_, ((int64_t)page_num) * BP_PAGE_SIZE, &frame->page(), BP_PAGE_SIZE);
+    frames.push_back(frame);
+  }
+
+  if (frames.empty()) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = batch.submit(io_engine());
+  for (Frame *frame : frames) {
+    frame->finish_load(OB_SUCC(rc));
+    frame->unpin();
+  }
+
+  read_ahead_stats_.read_ahead_ios.fetch_add(1, memory_order_relaxed);
+  if (OB_SUCC(rc)) {
+    read_ahead_stats_.read_ahead_pages.fetch_add(frames.size(), memory_order_relaxed);
+    LOG_TRACE("read ahead pages. file=%s, start=%d, count=%d", file_name_.c_str(), start_page_num, static_cast<int>(frames.size()));
+  }
+  return rc;
+}
+
+void DiskBufferPool::set_read_ahead_pages(int pages)
+{
+  read_ahead_pages_ = max(pages, 0);
+
+  lock_guard<mutex> guard(read_ahead_lock_);
+  read_ahead_detector_.set_window(read_ahead_pages_);
+  read_ahead_detector_.reset();
+}
+
 RC DiskBufferPool::allocate_page(Frame **frame)
 {
   RC rc = RC::SUCCESS;
@@ -420,6 +660,7 @@ RC DiskBufferPool::allocate_page(Frame **frame)
   allocated_frame->access();
   allocated_frame->clear_page();
   allocated_frame->set_page_num(file_header_->page_count - 1);
+  allocated_frame->mark_loaded();
 
   // Use flush operation to extension file
   if ((rc = flush_page_internal(*allocated_frame)) != RC::SUCCESS) {
@@ -441,15 +682,16 @@ RC DiskBufferPool::dispose_page(PageNum page_num)
     return RC::INTERNAL;
   }
   
-  scoped_lock lock_guard(lock_);
-  Frame           *used_frame = frame_manager_.get(id(), page_num);
+  // 不能加着大锁等待，pin着这个页面的线程可能正在加载其它页面
+  Frame *used_frame = frame_manager_.get(id(), page_num);
   if (used_frame != nullptr) {
-    ASSERT("the page try to dispose is in use. frame:%s", used_frame->to_string().c_str());
-    frame_manager_.free(id(), page_num, used_frame);
+    frame_manager_.free_after_unpinned(id(), page_num, used_frame);
   } else {
     LOG_DEBUG("page not found in memory while disposing it. pageNum=%d", page_num);
   }
 
+  scoped_lock lock_guard(lock_);
+
   LSN lsn = 0;
   RC rc = log_handler_.deallocate_page(page_num, lsn);
   if (OB_FAIL(rc)) {
@@ -547,6 +789,11 @@ RC DiskBufferPool::flush_page_internal(Frame &frame)
   // The better way is use mmap the block into memory,
   // so it is easier to flush data to file.
 
+  if (!frame.loaded()) {
+    // 页面数据还没有加载完成(或者加载失败)，内存中的数据是无效的
+    return RC::SUCCESS;
+  }
+
   RC rc = log_handler_.flush_page(frame.page());
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to log flush frame= %s, rc=%s", frame.to_string().c_str(), strrc(rc));
@@ -566,18 +813,118 @@ RC DiskBufferPool::flush_page_internal(Frame &frame)
   return RC::SUCCESS;
 }
 
+RC DiskBufferPool::flush_pages_internal(span<Frame *> frames)
+{
+  vector<Frame *> dirty_frames;
+  dirty_frames.reserve(frames.size());
+  for (Frame *frame : frames) {
+    if (!frame->dirty() || !frame->loaded()) {
+      continue;
+    }
+
+    RC rc = log_handler_.flush_page(frame->page());
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to log flush frame= %s, rc=%s", frame->to_string().c_str(), strrc(rc));
+      // ignore error handle
+    }
+
+    frame->set_check_sum(crc32(frame->page().data, BP_PAGE_DATA_SIZE));
+    dirty_frames.push_back(frame);
+  }
+
+  if (dirty_frames.empty()) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = dblwr_manager_.add_pages(this, dirty_frames);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  for (Frame *frame : dirty_frames) {
+    frame->clear_dirty();
+  }
+  LOG_DEBUG("Flush pages. file desc=%d, page count=%d", file_desc_, static_cast<int>(dirty_frames.size()));
+  return RC::SUCCESS;
+}
+
 RC DiskBufferPool::flush_all_pages()
 {
-  list<Frame *> used = frame_manager_.find_list(id());
-  for (Frame *frame : used) {
-    RC rc = flush_page(*frame);
+  list<Frame *>   used = frame_manager_.find_list(id());
+  vector<Frame *> frames(used.begin(), used.end());
+
+  RC rc = RC::SUCCESS;
+  {
+    scoped_lock lock_guard(lock_);
+    rc = flush_pages_internal(frames);
+  }
+
+  for (Frame *frame : frames) {
     frame->unpin();
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to flush all pages");
-      return rc;
+  }
+
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush all pages. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+RC DiskBufferPool::clean_dirty_pages(int max_pages, int &flushed_pages, LSN max_rec_lsn /* = 0 */)
+{
+  flushed_pages = 0;
+
+  list<Frame *>   used = frame_manager_.find_list(id());
+  vector<Frame *> dirty_frames;
+  dirty_frames.reserve(used.size());
+  for (Frame *frame : used) {
+    const bool old_enough = max_rec_lsn <= 0 || (frame->rec_lsn() > 0 && frame->rec_lsn() <= max_rec_lsn);
+    if (frame->dirty() && frame->loaded() && old_enough) {
+      dirty_frames.push_back(frame);
+    } else {
+      frame->unpin();
     }
   }
-  return RC::SUCCESS;
+
+  // 按照页号顺序写，double write buffer 写回数据文件时，连续的页面可以合并成一次IO
+  sort(dirty_frames.begin(), dirty_frames.end(), [](const Frame *lhs, const Frame *rhs) {
+    return lhs->page_num() < rhs->page_num();
+  });
+
+  RC rc = RC::SUCCESS;
+  {
+    scoped_lock lock_guard(lock_);
+
+    vector<Frame *> latched_frames;
+    latched_frames.reserve(min(dirty_frames.size(), static_cast<size_t>(max(max_pages, 0))));
+    for (Frame *frame : dirty_frames) {
+      if (static_cast<int>(latched_frames.size()) >= max_pages) {
+        break;
+      }
+
+      // 拿不到读锁说明有其它线程在修改页面，跳过
+      if (frame->try_read_latch()) {
+        latched_frames.push_back(frame);
+      }
+    }
+
+    rc = flush_pages_internal(latched_frames);
+    if (OB_SUCC(rc)) {
+      flushed_pages = static_cast<int>(latched_frames.size());
+    }
+
+    for (Frame *frame : latched_frames) {
+      frame->read_unlatch();
+    }
+  }
+
+  for (Frame *frame : dirty_frames) {
+    frame->unpin();
+  }
+
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to clean dirty pages. file=%s, rc=%s", file_name_.c_str(), strrc(rc));
+  }
+  return rc;
 }
 
 RC DiskBufferPool::recover_page(PageNum page_num)
@@ -598,19 +945,42 @@ RC DiskBufferPool::recover_page(PageNum page_num)
 
 RC DiskBufferPool::write_page(PageNum page_num, Page &page)
 {
-  scoped_lock lock_guard(wr_lock_);
   int64_t     offset = ((int64_t)page_num) * sizeof(Page);
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to write page %lld of %d due to failed to seek %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_SEEK;
+  PageIoBatch batch;
+  batch.add_write(file_desc_, offset, &page, sizeof(Page));
+  RC rc = batch.submit(io_engine());
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to write page %lld of %d. rc=%s", offset, file_desc_, strrc(rc));
+    return rc;
   }
 
-  if (writen(file_desc_, &page, sizeof(Page)) != 0) {
-    LOG_ERROR("Failed to write page %lld of %d due to %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_WRITE;
+  LOG_TRACE("write_page: buffer_pool_id:%d, page_num:%d, lsn=%d, check_sum=%d", id(), page_num, page.lsn, page.check_sum);
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::write_pages(PageNum start_page_num, span<Page *> pages)
+{
+  if (pages.empty()) {
+    return RC::SUCCESS;
   }
 
-  LOG_TRACE("write_page: buffer_pool_id:%d, page_num:%d, lsn=%d, check_sum=%d", id(), page_num, page.lsn, page.check_sum);
+  // 页面是连续的，PageIoBatch 会把它们合并成一个 pwritev 请求
+  PageIoBatch batch;
+  int64_t     offset = ((int64_t)start_page_num) * sizeof(Page);
+  for (Page *page : pages) {
+    batch.add_write(file_desc_, offset, page, sizeof(Page));
+    offset += sizeof(Page);
+  }
+
+  RC rc = batch.submit(io_engine());
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to write %d pages from %d of %d. rc=%s",
+              static_cast<int>(pages.size()), start_page_num, file_desc_, strrc(rc));
+    return rc;
+  }
+
+  LOG_TRACE("write_pages: buffer_pool_id:%d, start_page_num:%d, page_count:%d",
+            id(), start_page_num, static_cast<int>(pages.size()));
   return RC::SUCCESS;
 }
 
@@ -685,25 +1055,44 @@ RC DiskBufferPool::redo_deallocate_page(LSN lsn, PageNum page_num)
   return RC::SUCCESS;
 }
 
-RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
+RC DiskBufferPool::flush_frame_for_purge(Frame *frame)
 {
-  auto purger = [this](Frame *frame) {
-    if (!frame->dirty()) {
-      return RC::SUCCESS;
-    }
+  if (!frame->dirty()) {
+    return RC::SUCCESS;
+  }
 
-    RC rc = RC::SUCCESS;
-    if (frame->buffer_pool_id() == id()) {
-      rc = this->flush_page_internal(*frame);
-    } else {
-      rc = bp_manager_.flush_page(*frame);
-    }
+  RC rc = RC::SUCCESS;
+  if (frame->buffer_pool_id() == id()) {
+    rc = this->flush_page_internal(*frame);
+  } else {
+    rc = bp_manager_.flush_page(*frame);
+  }
 
-    if (rc != RC::SUCCESS) {
-      LOG_ERROR("Failed to aclloc block due to failed to flush old block. rc=%s", strrc(rc));
-    }
-    return rc;
-  };
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to aclloc block due to failed to flush old block. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+RC DiskBufferPool::try_allocate_frame(PageNum page_num, Frame **buffer)
+{
+  Frame *frame = frame_manager_.alloc(id(), page_num);
+  if (frame == nullptr) {
+    (void)frame_manager_.purge_frames(1 /*count*/, [this](Frame *frame) { return flush_frame_for_purge(frame); });
+    frame = frame_manager_.alloc(id(), page_num);
+  }
+
+  if (frame == nullptr) {
+    return RC::BUFFERPOOL_NOBUF;
+  }
+
+  *buffer = frame;
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
+{
+  auto purger = [this](Frame *frame) { return flush_frame_for_purge(frame); };
 
   while (true) {
     Frame *frame = frame_manager_.alloc(id(), page_num);
@@ -714,6 +1103,7 @@ RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
     }
 
     LOG_TRACE("frames are all allocated, so we should purge some frames to get one free frame");
+    bp_manager_.wakeup_page_cleaner();
     (void)frame_manager_.purge_frames(1 /*count*/, purger);
   }
   return RC::BUFFERPOOL_NOBUF;
@@ -740,19 +1130,14 @@ RC DiskBufferPool::load_page(PageNum page_num, Frame *frame)
     return rc;
   }
 
-  scoped_lock lock_guard(wr_lock_);
-  int64_t          offset = ((int64_t)page_num) * BP_PAGE_SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to load page %s:%d, due to failed to lseek:%s.", file_name_.c_str(), page_num, strerror(errno));
-
-    return RC::IOERR_SEEK;
-  }
-
-  int ret = readn(file_desc_, &page, BP_PAGE_SIZE);
-  if (ret != 0) {
-    LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, due to failed to read data:%s, ret=%d, page count=%d",
-              file_name_.c_str(), file_desc_, page_num, strerror(errno), ret, file_header_->allocated_pages);
-    return RC::IOERR_READ;
+  int64_t     offset = ((int64_t)page_num) * BP_PAGE_SIZE;
+  PageIoBatch batch;
+  batch.add_read(file_desc_, offset, &page, BP_PAGE_SIZE);
+  rc = batch.submit(io_engine());
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, due to failed to read data. rc=%s, page count=%d",
+              file_name_.c_str(), file_desc_, page_num, strrc(rc), file_header_->allocated_pages);
+    return rc;
   }
 
   frame->set_page_num(page_num);
@@ -764,20 +1149,32 @@ RC DiskBufferPool::load_page(PageNum page_num, Frame *frame)
 
 int DiskBufferPool::file_desc() const { return file_desc_; }
 
+PageIoEngine &DiskBufferPool::io_engine() { return bp_manager_.io_engine(); }
+
 ////////////////////////////////////////////////////////////////////////////////
-BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */)
+BufferPoolManager::BufferPoolManager(
+    int memory_size /* = 0 */, const char *eviction_policy /* = nullptr */, const char *io_engine /* = nullptr */)
 {
   if (memory_size <= 0) {
     memory_size = MEM_POOL_ITEM_NUM * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE;
   }
   const int pool_num = max(memory_size / BP_PAGE_SIZE / DEFAULT_ITEM_NUM_PER_POOL, 1);
-  frame_manager_.init(pool_num);
+  frame_manager_.init(pool_num, eviction_policy);
+
+  RC rc = PageIoEngine::create(io_engine, io_engine_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create page io engine %s, use sync instead. rc=%s", io_engine, strrc(rc));
+    PageIoEngine::create("sync", io_engine_);
+  }
+  LOG_INFO("buffer pool manager use page io engine %s", io_engine_->name());
   LOG_INFO("buffer pool manager init with memory size %d, page num: %d, pool num: %d",
            memory_size, pool_num * DEFAULT_ITEM_NUM_PER_POOL, pool_num);
 }
 
 BufferPoolManager::~BufferPoolManager()
 {
+  page_cleaner_.stop();
+
   unordered_map<string, DiskBufferPool *> tmp_bps;
   tmp_bps.swap(buffer_pools_);
 
@@ -821,13 +1218,7 @@ RC BufferPoolManager::create_file(const char *file_name)
 
   char *bitmap = file_header->bitmap;
   bitmap[0] |= 0x01;
-  if (lseek(fd, 0, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to seek file %s to position 0, due to %s .", file_name, strerror(errno));
-    close(fd);
-    return RC::IOERR_SEEK;
-  }
-
-  if (writen(fd, (char *)&page, BP_PAGE_SIZE) != 0) {
+  if (pwriten(fd, (char *)&page, BP_PAGE_SIZE, 0) != 0) {
     LOG_ERROR("Failed to write header to file %s, due to %s.", file_name, strerror(errno));
     close(fd);
     return RC::IOERR_WRITE;
@@ -856,6 +1247,8 @@ RC BufferPoolManager::open_file(LogHandler &log_handler, const char *_file_name,
     return rc;
   }
 
+  bp->set_read_ahead_pages(read_ahead_pages_);
+
   if (bp->id() >= next_buffer_pool_id_.load()) {
     next_buffer_pool_id_.store(bp->id() + 1);
   }
@@ -871,6 +1264,7 @@ RC BufferPoolManager::close_file(const char *_file_name)
 {
   string file_name(_file_name);
 
+  lock_guard<mutex> cleaner_guard(page_cleaner_lock_);
   lock_.lock();
 
   auto iter = buffer_pools_.find(file_name);
@@ -912,6 +1306,47 @@ RC BufferPoolManager::flush_page(Frame &frame)
   return bp->flush_page(frame);
 }
 
+RC BufferPoolManager::clean_dirty_pages(int max_pages, int &flushed_pages, LSN max_rec_lsn /* = 0 */)
+{
+  flushed_pages = 0;
+
+  vector<int32_t> buffer_pool_ids;
+  {
+    scoped_lock lock_guard(lock_);
+    buffer_pool_ids.reserve(id_to_buffer_pools_.size());
+    for (const auto &[id, bp] : id_to_buffer_pools_) {
+      buffer_pool_ids.push_back(id);
+    }
+  }
+
+  RC rc = RC::SUCCESS;
+  for (int32_t id : buffer_pool_ids) {
+    if (flushed_pages >= max_pages) {
+      break;
+    }
+
+    // 持有 page_cleaner_lock_ 时 buffer pool 不会被关闭
+    lock_guard<mutex> cleaner_guard(page_cleaner_lock_);
+    DiskBufferPool   *bp = nullptr;
+    {
+      scoped_lock lock_guard(lock_);
+      auto        iter = id_to_buffer_pools_.find(id);
+      if (iter == id_to_buffer_pools_.end() || iter->second->file_desc() < 0) {
+        continue;
+      }
+      bp = iter->second;
+    }
+
+    int bp_flushed_pages = 0;
+    rc = bp->clean_dirty_pages(max_pages - flushed_pages, bp_flushed_pages, max_rec_lsn);
+    flushed_pages += bp_flushed_pages;
+    if (OB_FAIL(rc)) {
+      break;
+    }
+  }
+  return rc;
+}
+
 RC BufferPoolManager::get_buffer_pool(int32_t id, DiskBufferPool *&bp)
 {
   bp = nullptr;
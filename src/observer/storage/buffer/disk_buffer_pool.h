@@ -25,16 +25,22 @@ See the Mulan PSL v2 for more details. */
 #include <time.h>
 #include <optional>
 
+#include "common/lang/atomic.h"
 #include "common/lang/bitmap.h"
-#include "common/lang/lru_cache.h"
 #include "common/lang/mutex.h"
 #include "common/lang/memory.h"
+#include "common/lang/span.h"
 #include "common/lang/unordered_map.h"
+#include "common/lang/vector.h"
 #include "common/mm/mem_pool.h"
 #include "common/rc.h"
 #include "common/types.h"
 #include "storage/buffer/frame.h"
+#include "storage/buffer/frame_eviction_policy.h"
 #include "storage/buffer/page.h"
+#include "storage/buffer/page_cleaner.h"
+#include "storage/buffer/page_io_engine.h"
+#include "storage/buffer/read_ahead.h"
 #include "storage/buffer/buffer_pool_log.h"
 
 class BufferPoolManager;
@@ -83,13 +89,26 @@ struct BPFileHeader
  * 当内存中的页帧不够用时，需要从内存中淘汰一些页帧，以便为新的页帧腾出空间。
  * 这个管理器负责为所有的BufferPool提供页帧管理服务，也就是所有的BufferPool磁盘文件
  * 在访问时都使用这个管理器映射到内存。
+ *
+ * 页帧表按照 FrameId 的哈希值划分为多个分片(shard)，每个分片有自己的锁和淘汰策略。
+ * 访问不同页面的线程通常会落在不同的分片上，不会再竞争同一把锁。
+ * 淘汰页面时，从上次淘汰的分片开始轮流在各个分片中查找可以淘汰的页面，
+ * 因此淘汰策略只在分片内部是精确的。淘汰策略参考 FrameEvictionPolicy。
  */
 class BPFrameManager
 {
 public:
-  BPFrameManager(const char *tag);
+  static constexpr int DEFAULT_SHARD_NUM = 16;
 
-  RC init(int pool_num);
+public:
+  BPFrameManager(const char *tag, int shard_num = DEFAULT_SHARD_NUM);
+
+  /**
+   * @brief 初始化页帧内存和每个分片的淘汰策略
+   * @param pool_num 页帧内存池个数，每个内存池有 DEFAULT_ITEM_NUM_PER_POOL 个页帧
+   * @param eviction_policy 淘汰策略名称，参考 FrameEvictionPolicy::create
+   */
+  RC init(int pool_num, const char *eviction_policy = nullptr);
   RC cleanup();
 
   /**
@@ -124,6 +143,13 @@ public:
    */
   RC free(int buffer_pool_id, PageNum page_num, Frame *frame);
 
+  /**
+   * @brief 等其它线程都不再使用这个页帧之后再释放它
+   * @details 调用方已经pin住了这个页帧。B+树的乐观读只pin页面不加锁，可能会短暂地pin住正在删除的页面，
+   * 这时候不能直接释放页帧，否则读线程就访问到了被其它页面复用的页帧。
+   */
+  RC free_after_unpinned(int buffer_pool_id, PageNum page_num, Frame *frame);
+
   /**
    * 如果不能从空闲链表中分配新的页面，就使用这个接口，
    * 尝试从pin count=0的页面中淘汰一些
@@ -133,16 +159,26 @@ public:
    */
   int purge_frames(int count, function<RC(Frame *frame)> purger);
 
-  size_t frame_num() const { return frames_.count(); }
+  size_t frame_num() const;
+
+  /**
+   * @brief 当前脏页的个数
+   * @details 没有加锁读取页帧的脏标识，只是一个近似值，给后台刷脏页线程使用
+   */
+  size_t dirty_frame_num() const;
+
+  /**
+   * @brief 所有脏页中最小的 rec_lsn，没有脏页时返回0
+   * @details 做检查点时使用，参考 Frame::rec_lsn
+   */
+  LSN min_rec_lsn() const;
 
   /**
    * 测试使用。返回已经从内存申请的个数
    */
   size_t total_frame_num() const { return allocator_.get_size(); }
 
-private:
-  Frame *get_internal(const FrameId &frame_id);
-  RC     free_internal(const FrameId &frame_id, Frame *frame);
+  int shard_num() const { return static_cast<int>(shards_.size()); }
 
 private:
   class BPFrameIdHasher
@@ -151,12 +187,35 @@ private:
     size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
   };
 
-  using FrameLruCache  = common::LruCache<FrameId, Frame *, BPFrameIdHasher>;
+  using FrameTable     = unordered_map<FrameId, Frame *, BPFrameIdHasher>;
   using FrameAllocator = common::MemPoolSimple<Frame>;
 
-  mutex          lock_;
-  FrameLruCache  frames_;
-  FrameAllocator allocator_;
+  /**
+   * @brief 页帧表的一个分片
+   * @details 分片内的页帧表和淘汰策略只能在持有分片锁时访问
+   */
+  struct FrameShard
+  {
+    mutable mutex                   lock;
+    FrameTable                      frames;
+    unique_ptr<FrameEvictionPolicy> policy;
+  };
+
+  FrameShard &shard_of(const FrameId &frame_id);
+
+  Frame *get_internal(FrameShard &shard, const FrameId &frame_id);
+  RC     free_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame, bool evicted);
+
+  /**
+   * @brief 在某一个分片中淘汰页面
+   * @return 返回在这个分片中清理了多少个页面
+   */
+  int purge_shard_frames(FrameShard &shard, int count, function<RC(Frame *frame)> &purger);
+
+private:
+  vector<unique_ptr<FrameShard>> shards_;
+  atomic<uint32_t>               purge_cursor_{0};  /// 下一次从哪个分片开始淘汰
+  FrameAllocator                 allocator_;
 };
 
 /**
@@ -246,6 +305,28 @@ public:
 
   int file_desc() const;
 
+  /**
+   * @brief 页面读写引擎，与 BufferPoolManager 中的是同一个
+   */
+  PageIoEngine &io_engine();
+
+  /**
+   * @brief 预读指定范围内的页面
+   * @details 已经在内存中的页面、没有分配的页面会跳过，其它的页面作为一批读请求一起提交。
+   * 预读的页面不会被pin住。访问时如果没有空闲的页帧，就停止预读。
+   * @param start_page_num 第一个页面
+   * @param count 最多预读的页面数
+   */
+  RC read_ahead(PageNum start_page_num, int count);
+
+  /**
+   * @brief 设置预读窗口的大小，0表示不预读
+   */
+  void set_read_ahead_pages(int pages);
+  int  read_ahead_pages() const { return read_ahead_pages_; }
+
+  const ReadAheadStats &read_ahead_stats() const { return read_ahead_stats_; }
+
   /**
    * 如果页面是脏的，就将数据刷新到double write buffer
    */
@@ -256,6 +337,15 @@ public:
    */
   RC flush_all_pages();
 
+  /**
+   * @brief 后台刷脏页线程使用，按照页号顺序刷新一批脏页到double write buffer
+   * @details 只对页帧加读锁，拿不到读锁的页面(正在被修改)会跳过
+   * @param max_pages 最多刷新多少个页面
+   * @param flushed_pages 实际刷新的页面数
+   * @param max_rec_lsn 大于0时，只刷新 rec_lsn 不超过这个值的页面，做检查点时使用
+   */
+  RC clean_dirty_pages(int max_pages, int &flushed_pages, LSN max_rec_lsn = 0);
+
   /**
    * 回放日志时处理page0中已被认定为不存在的page
    */
@@ -266,6 +356,12 @@ public:
    */
   RC write_page(PageNum page_num, Page &page);
 
+  /**
+   * 将一批连续的页面刷新到磁盘，只需要一次系统调用
+   * @param start_page_num 第一个页面的页号，后面的页面页号依次加一
+   */
+  RC write_pages(PageNum start_page_num, span<Page *> pages);
+
   RC redo_allocate_page(LSN lsn, PageNum page_num);
   RC redo_deallocate_page(LSN lsn, PageNum page_num);
 
@@ -277,6 +373,21 @@ public:
 protected:
   RC allocate_frame(PageNum page_num, Frame **buf);
 
+  /**
+   * @brief 分配页帧，最多尝试淘汰一次，不会一直等待。预读时使用
+   */
+  RC try_allocate_frame(PageNum page_num, Frame **buf);
+
+  /**
+   * @brief 淘汰页帧前，如果页帧是脏的，就刷新到磁盘
+   */
+  RC flush_frame_for_purge(Frame *frame);
+
+  /**
+   * @brief 访问一个页面后，检查是否是顺序访问，需要时发起预读
+   */
+  void check_read_ahead(PageNum page_num);
+
   /**
    * 刷新指定页面到磁盘(flush)，并且释放关联的Frame
    */
@@ -293,6 +404,11 @@ protected:
    */
   RC flush_page_internal(Frame &frame);
 
+  /**
+   * 将一批脏页刷新到磁盘，页面会一起交给 DoubleWriteBuffer，由它批量写入
+   */
+  RC flush_pages_internal(span<Frame *> frames);
+
 private:
   BufferPoolManager   &bp_manager_;     /// BufferPool 管理器
   BPFrameManager      &frame_manager_;  /// Frame 管理器
@@ -309,7 +425,11 @@ private:
   string file_name_;  /// 文件名
 
   common::Mutex lock_;
-  common::Mutex wr_lock_;
+
+  int               read_ahead_pages_ = 0;  /// 预读窗口大小
+  mutex             read_ahead_lock_;       /// 保护 read_ahead_detector_
+  ReadAheadDetector read_ahead_detector_;   /// 检测当前文件上的顺序访问
+  ReadAheadStats    read_ahead_stats_;      /// 预读统计信息
 
 private:
   friend class BufferPoolIterator;
@@ -322,7 +442,11 @@ private:
 class BufferPoolManager final
 {
 public:
-  BufferPoolManager(int memory_size = 0);
+  /**
+   * @param memory_size 页帧可以使用的内存大小，小于等于0时使用默认值
+   * @param eviction_policy 页帧淘汰策略名称，参考 FrameEvictionPolicy::create
+   */
+  BufferPoolManager(int memory_size = 0, const char *eviction_policy = nullptr, const char *io_engine = nullptr);
   ~BufferPoolManager();
 
   RC init(unique_ptr<DoubleWriteBuffer> dblwr_buffer);
@@ -336,6 +460,42 @@ public:
 
   BPFrameManager    &get_frame_manager() { return frame_manager_; }
   DoubleWriteBuffer *get_dblwr_buffer() { return dblwr_buffer_.get(); }
+  PageIoEngine      &io_engine() { return *io_engine_; }
+
+  /**
+   * @brief 设置之后打开的buffer pool的预读窗口大小
+   */
+  void set_read_ahead_pages(int pages) { read_ahead_pages_ = pages; }
+
+  /**
+   * @brief 启动后台刷脏页线程
+   * @details 应该在日志回放完成之后启动
+   */
+  RC start_page_cleaner(const PageCleanerOptions &options) { return page_cleaner_.start(options); }
+
+  /**
+   * @brief 停止后台刷脏页线程，析构时也会停止
+   */
+  void stop_page_cleaner() { page_cleaner_.stop(); }
+
+  /**
+   * @brief 没有空闲页帧时，唤醒后台刷脏页线程
+   */
+  void wakeup_page_cleaner() { page_cleaner_.wakeup(); }
+
+  /**
+   * @brief 刷新所有buffer pool中的脏页，直到刷新了 max_pages 个页面或者没有可以刷新的页面
+   * @details 后台刷脏页线程和检查点调用，参数参考 DiskBufferPool::clean_dirty_pages
+   */
+  RC clean_dirty_pages(int max_pages, int &flushed_pages, LSN max_rec_lsn = 0);
+
+  bool page_cleaner_running() const { return page_cleaner_.running(); }
+
+  /**
+   * @brief 后台刷脏页时，持有这个锁来保证 buffer pool 不会被关闭
+   * @details 关闭 buffer pool 淘汰所有页面时也要持有这个锁，否则后台线程pin住的页面不能被淘汰
+   */
+  mutex &page_cleaner_lock() { return page_cleaner_lock_; }
 
   /**
    * @brief 根据ID获取对应的BufferPool对象
@@ -349,6 +509,11 @@ private:
   BPFrameManager frame_manager_{"BufPool"};
 
   unique_ptr<DoubleWriteBuffer> dblwr_buffer_;
+  unique_ptr<PageIoEngine>      io_engine_;  ///< 所有buffer pool共用的页面读写引擎
+  int                           read_ahead_pages_ = 0;
+
+  mutex       page_cleaner_lock_;  ///< 参考 page_cleaner_lock()
+  PageCleaner page_cleaner_{*this};
 
   common::Mutex                            lock_;
   unordered_map<string, DiskBufferPool *>  buffer_pools_;
@@ -18,6 +18,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "storage/buffer/double_write_buffer.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/frame.h"
+#include "storage/buffer/page_io_engine.h"
 #include "common/io/io.h"
 #include "common/log/log.h"
 #include "common/math/crc.h"
@@ -47,6 +49,22 @@ const int32_t DoubleWritePage::SIZE = sizeof(DoubleWritePage);
 
 const int32_t DoubleWriteBufferHeader::SIZE = sizeof(DoubleWriteBufferHeader);
 
+static int64_t dblwr_page_offset(int32_t page_index)
+{
+  return ((int64_t)page_index) * DoubleWritePage::SIZE + DoubleWriteBufferHeader::SIZE;
+}
+
+RC DoubleWriteBuffer::add_pages(DiskBufferPool *bp, span<Frame *> frames)
+{
+  for (Frame *frame : frames) {
+    RC rc = add_page(bp, frame->page_num(), frame->page());
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 DiskDoubleWriteBuffer::DiskDoubleWriteBuffer(BufferPoolManager &bp_manager, int max_pages /*=16*/) 
   : max_pages_(max_pages), bp_manager_(bp_manager)
 {
@@ -79,16 +97,20 @@ RC DiskDoubleWriteBuffer::flush_page()
 {
   sync();
 
+  vector<DoubleWritePage *> pages;
+  pages.reserve(dblwr_pages_.size());
   for (const auto &pair : dblwr_pages_) {
-    RC rc = write_page(pair.second);
-    if (rc != RC::SUCCESS) {
-      return rc;
-    }
-    pair.second->valid = false;
-    write_page_internal(pair.second);
-    delete pair.second;
+    pages.push_back(pair.second);
+  }
+
+  RC rc = write_pages(pages);
+  if (OB_FAIL(rc)) {
+    return rc;
   }
 
+  invalidate_pages(pages);
+  for_each(pages.begin(), pages.end(), [](DoubleWritePage *dbl_page) { delete dbl_page; });
+
   dblwr_pages_.clear();
   header_.page_cnt = 0;
 
@@ -120,40 +142,86 @@ RC DiskDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page &p
     return rc;
   }
 
-  if (page_cnt + 1 > header_.page_cnt) {
-    header_.page_cnt = page_cnt + 1;
-    if (lseek(file_desc_, 0, SEEK_SET) == -1) {
-      LOG_ERROR("Failed to add page header due to failed to seek %s.", strerror(errno));
-      return RC::IOERR_SEEK;
+  rc = write_header_if_needed(page_cnt + 1);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  if (static_cast<int>(dblwr_pages_.size()) >= max_pages_) {
+    RC rc = flush_page();
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to flush pages in double write buffer");
+      return rc;
     }
+  }
+
+  return RC::SUCCESS;
+}
+
+RC DiskDoubleWriteBuffer::add_pages(DiskBufferPool *bp, span<Frame *> frames)
+{
+  scoped_lock lock_guard(lock_);
+
+  PageIoBatch batch;
+  for (Frame *frame : frames) {
+    DoubleWritePageKey key{bp->id(), frame->page_num()};
+    DoubleWritePage   *dblwr_page = nullptr;
 
-    if (writen(file_desc_, &header_, sizeof(header_)) != 0) {
-      LOG_ERROR("Failed to add page header due to %s.", strerror(errno));
-      return RC::IOERR_WRITE;
+    auto iter = dblwr_pages_.find(key);
+    if (iter != dblwr_pages_.end()) {
+      dblwr_page       = iter->second;
+      dblwr_page->page = frame->page();
+    } else {
+      int32_t page_index = static_cast<int32_t>(dblwr_pages_.size());
+      dblwr_page         = new DoubleWritePage(bp->id(), frame->page_num(), page_index, frame->page());
+      dblwr_pages_.insert(std::pair<DoubleWritePageKey, DoubleWritePage *>(key, dblwr_page));
     }
+
+    batch.add_write(file_desc_, dblwr_page_offset(dblwr_page->page_index), dblwr_page, DoubleWritePage::SIZE);
+  }
+
+  LOG_TRACE("add pages into double write buffer. buffer_pool_id:%d, page count=%d, dwb size=%d",
+            bp->id(), static_cast<int>(frames.size()), static_cast<int>(dblwr_pages_.size()));
+
+  RC rc = batch.submit(bp_manager_.io_engine());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to write pages into double write buffer. rc=%s buffer_pool_id:%d", strrc(rc), bp->id());
+    return rc;
+  }
+
+  rc = write_header_if_needed(static_cast<int64_t>(dblwr_pages_.size()));
+  if (OB_FAIL(rc)) {
+    return rc;
   }
 
   if (static_cast<int>(dblwr_pages_.size()) >= max_pages_) {
-    RC rc = flush_page();
+    rc = flush_page();
     if (rc != RC::SUCCESS) {
       LOG_ERROR("Failed to flush pages in double write buffer");
       return rc;
     }
   }
-
   return RC::SUCCESS;
 }
 
-RC DiskDoubleWriteBuffer::write_page_internal(DoubleWritePage *page)
+RC DiskDoubleWriteBuffer::write_header_if_needed(int64_t page_cnt)
 {
-  int32_t page_index = page->page_index;
-  int64_t offset = page_index * DoubleWritePage::SIZE + DoubleWriteBufferHeader::SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to add page %lld of %d due to failed to seek %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_SEEK;
+  if (page_cnt <= header_.page_cnt) {
+    return RC::SUCCESS;
+  }
+
+  header_.page_cnt = static_cast<int32_t>(page_cnt);
+  if (pwriten(file_desc_, &header_, sizeof(header_), 0) != 0) {
+    LOG_ERROR("Failed to add page header due to %s.", strerror(errno));
+    return RC::IOERR_WRITE;
   }
+  return RC::SUCCESS;
+}
 
-  if (writen(file_desc_, page, DoubleWritePage::SIZE) != 0) {
+RC DiskDoubleWriteBuffer::write_page_internal(DoubleWritePage *page)
+{
+  int64_t offset = dblwr_page_offset(page->page_index);
+  if (pwriten(file_desc_, page, DoubleWritePage::SIZE, offset) != 0) {
     LOG_ERROR("Failed to add page %lld of %d due to %s.", offset, file_desc_, strerror(errno));
     return RC::IOERR_WRITE;
   }
@@ -161,22 +229,66 @@ RC DiskDoubleWriteBuffer::write_page_internal(DoubleWritePage *page)
   return RC::SUCCESS;
 }
 
-RC DiskDoubleWriteBuffer::write_page(DoubleWritePage *dblwr_page)
+RC DiskDoubleWriteBuffer::write_pages(vector<DoubleWritePage *> &pages)
 {
+  // 按照页号排序，一方面可以把连续的页面合并成一次写入，另一方面防止出现小页面还没有写入，而页面编号更大的写入失败的情况
+  sort(pages.begin(), pages.end(), [](DoubleWritePage *a, DoubleWritePage *b) {
+    if (a->key.buffer_pool_id != b->key.buffer_pool_id) {
+      return a->key.buffer_pool_id < b->key.buffer_pool_id;
+    }
+    return a->key.page_num < b->key.page_num;
+  });
+
+  // 所有文件的页面作为一批请求一起提交
+  PageIoBatch     batch;
   DiskBufferPool *disk_buffer = nullptr;
-  // skip invalid page
-  if (!dblwr_page->valid) {
-    LOG_TRACE("double write buffer write page invalid. buffer_pool_id:%d,page_num:%d,lsn=%d",
+  for (DoubleWritePage *dblwr_page : pages) {
+    // skip invalid page
+    if (!dblwr_page->valid) {
+      LOG_TRACE("double write buffer write page invalid. buffer_pool_id:%d,page_num:%d,lsn=%d",
+                dblwr_page->key.buffer_pool_id, dblwr_page->key.page_num, dblwr_page->page.lsn);
+      continue;
+    }
+
+    if (disk_buffer == nullptr || disk_buffer->id() != dblwr_page->key.buffer_pool_id) {
+      RC rc = bp_manager_.get_buffer_pool(dblwr_page->key.buffer_pool_id, disk_buffer);
+      ASSERT(OB_SUCC(rc) && disk_buffer != nullptr, "failed to get disk buffer pool of %d", dblwr_page->key.buffer_pool_id);
+    }
+
+    LOG_TRACE("double write buffer write page. buffer_pool_id:%d,page_num:%d,lsn=%d",
               dblwr_page->key.buffer_pool_id, dblwr_page->key.page_num, dblwr_page->page.lsn);
-    return RC::SUCCESS;
+
+    int64_t offset = ((int64_t)dblwr_page->key.page_num) * sizeof(Page);
+    batch.add_write(disk_buffer->file_desc(), offset, &dblwr_page->page, sizeof(Page));
+  }
+
+  RC rc = batch.submit(bp_manager_.io_engine());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to write pages in double write buffer to disk buffer pool. rc=%s", strrc(rc));
+    return rc;
   }
-  RC rc = bp_manager_.get_buffer_pool(dblwr_page->key.buffer_pool_id, disk_buffer);
-  ASSERT(OB_SUCC(rc) && disk_buffer != nullptr, "failed to get disk buffer pool of %d", dblwr_page->key.buffer_pool_id);
+  return RC::SUCCESS;
+}
+
+RC DiskDoubleWriteBuffer::invalidate_pages(vector<DoubleWritePage *> &pages)
+{
+  sort(pages.begin(), pages.end(), [](DoubleWritePage *a, DoubleWritePage *b) {
+    return a->page_index < b->page_index;
+  });
 
-  LOG_TRACE("double write buffer write page. buffer_pool_id:%d,page_num:%d,lsn=%d",
-            dblwr_page->key.buffer_pool_id, dblwr_page->key.page_num, dblwr_page->page.lsn);
+  PageIoBatch batch;
+  for (DoubleWritePage *dblwr_page : pages) {
+    dblwr_page->valid = false;
+    batch.add_write(file_desc_, dblwr_page_offset(dblwr_page->page_index), dblwr_page, DoubleWritePage::SIZE);
+  }
 
-  return disk_buffer->write_page(dblwr_page->key.page_num, dblwr_page->page);
+  RC rc = batch.submit(bp_manager_.io_engine());
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to invalidate pages in double write buffer. page count=%d, rc=%s",
+              static_cast<int>(pages.size()), strrc(rc));
+    return rc;
+  }
+  return RC::SUCCESS;
 }
 
 RC DiskDoubleWriteBuffer::read_page(DiskBufferPool *bp, PageNum page_num, Page &page)
@@ -213,21 +325,11 @@ RC DiskDoubleWriteBuffer::clear_pages(DiskBufferPool *buffer_pool)
   LOG_INFO("clear pages in double write buffer. file name=%s, page count=%d",
            buffer_pool->filename(), spec_pages.size());
 
-  // 页面从小到大排序，防止出现小页面还没有写入，而页面编号更大的seek失败的情况
-  sort(spec_pages.begin(), spec_pages.end(), [](DoubleWritePage *a, DoubleWritePage *b) {
-    return a->key.page_num < b->key.page_num;
-  });
-
-  RC rc = RC::SUCCESS;
-  for (DoubleWritePage *dbl_page : spec_pages) {
-    rc = buffer_pool->write_page(dbl_page->key.page_num, dbl_page->page);
-    if (OB_FAIL(rc)) {
-      LOG_WARN("Failed to write page %s:%d to disk buffer pool. rc=%s",
-               buffer_pool->filename(), dbl_page->key.page_num, strrc(rc));
-      break;
-    }
-    dbl_page->valid = false;
-    write_page_internal(dbl_page);
+  RC rc = write_pages(spec_pages);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to write pages of %s to disk buffer pool. rc=%s", buffer_pool->filename(), strrc(rc));
+  } else {
+    invalidate_pages(spec_pages);
   }
 
   for_each(spec_pages.begin(), spec_pages.end(), [](DoubleWritePage *dbl_page) { delete dbl_page; });
@@ -247,12 +349,7 @@ RC DiskDoubleWriteBuffer::load_pages()
     return RC::BUFFERPOOL_OPEN;
   }
 
-  if (lseek(file_desc_, 0, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to load page header, due to failed to lseek:%s.", strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  int ret = readn(file_desc_, &header_, sizeof(header_));
+  int ret = preadn(file_desc_, &header_, sizeof(header_), 0);
   if (ret != 0 && ret != -1) {
     LOG_ERROR("Failed to load page header, file_desc:%d, due to failed to read data:%s, ret=%d",
                 file_desc_, strerror(errno), ret);
@@ -260,18 +357,13 @@ RC DiskDoubleWriteBuffer::load_pages()
   }
 
   for (int page_num = 0; page_num < header_.page_cnt; page_num++) {
-    int64_t offset = ((int64_t)page_num) * DoubleWritePage::SIZE + DoubleWriteBufferHeader::SIZE;
-
-    if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-      LOG_ERROR("Failed to load page %d, offset=%ld, due to failed to lseek:%s.", page_num, offset, strerror(errno));
-      return RC::IOERR_SEEK;
-    }
+    int64_t offset = dblwr_page_offset(page_num);
 
     auto dblwr_page = make_unique<DoubleWritePage>();
     Page &page     = dblwr_page->page;
     page.check_sum = (CheckSum)-1;
 
-    ret = readn(file_desc_, dblwr_page.get(), DoubleWritePage::SIZE);
+    ret = preadn(file_desc_, dblwr_page.get(), DoubleWritePage::SIZE, offset);
     if (ret != 0) {
       LOG_ERROR("Failed to load page, file_desc:%d, page num:%d, due to failed to read data:%s, ret=%d, page count=%d",
                 file_desc_, page_num, strerror(errno), ret, page_num);
@@ -302,3 +394,16 @@ RC VacuousDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page
   return bp->write_page(page_num, page);
 }
 
+RC VacuousDoubleWriteBuffer::add_pages(DiskBufferPool *bp, span<Frame *> frames)
+{
+  vector<Frame *> sorted_frames(frames.begin(), frames.end());
+  sort(sorted_frames.begin(), sorted_frames.end(), [](Frame *a, Frame *b) { return a->page_num() < b->page_num(); });
+
+  PageIoBatch batch;
+  for (Frame *frame : sorted_frames) {
+    int64_t offset = ((int64_t)frame->page_num()) * sizeof(Page);
+    batch.add_write(bp->file_desc(), offset, &frame->page(), sizeof(Page));
+  }
+  return batch.submit(bp->io_engine());
+}
+
@@ -15,7 +15,9 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/lang/mutex.h"
+#include "common/lang/span.h"
 #include "common/lang/unordered_map.h"
+#include "common/lang/vector.h"
 #include "common/types.h"
 #include "common/rc.h"
 #include "storage/buffer/page.h"
@@ -23,6 +25,7 @@ See the Mulan PSL v2 for more details. */
 class DiskBufferPool;
 struct DoubleWritePage;
 class BufferPoolManager;
+class Frame;
 
 class DoubleWriteBuffer
 {
@@ -35,6 +38,12 @@ public:
    */
   virtual RC add_page(DiskBufferPool *bp, PageNum page_num, Page &page) = 0;
 
+  /**
+   * @brief 将一批页面加入buffer
+   * @details 默认实现是逐个调用 add_page。子类可以把这些页面作为一批IO请求一起提交
+   */
+  virtual RC add_pages(DiskBufferPool *bp, span<Frame *> frames);
+
   virtual RC read_page(DiskBufferPool *bp, PageNum page_num, Page &page) = 0;
 
   /**
@@ -110,6 +119,11 @@ public:
    */
   RC add_page(DiskBufferPool *bp, PageNum page_num, Page &page) override;
 
+  /**
+   * 将一批页面加入buffer，所有页面一起写入磁盘中的共享表空间
+   */
+  RC add_pages(DiskBufferPool *bp, span<Frame *> frames) override;
+
   RC read_page(DiskBufferPool *bp, PageNum page_num, Page &page) override;
 
   /**
@@ -125,8 +139,15 @@ public:
 private:
   /**
    * 将buffer中的页面写入对应的磁盘
+   * @details 页面按照(buffer pool, 页号)排序，页号连续的页面只需要一次 pwritev 写入
    */
-  RC write_page(DoubleWritePage *page);
+  RC write_pages(vector<DoubleWritePage *> &pages);
+
+  /**
+   * 页面已经写入对应的磁盘后，在double write buffer文件中将它们标记为无效
+   * @details 按照页面在文件中的位置排序，位置连续的页面一起写入
+   */
+  RC invalidate_pages(vector<DoubleWritePage *> &pages);
 
   /**
    * 将页面写到当前double write buffer文件中
@@ -135,6 +156,11 @@ private:
    */
   RC write_page_internal(DoubleWritePage *page);
 
+  /**
+   * 需要更新页面数量时，把文件头写入磁盘
+   */
+  RC write_header_if_needed(int64_t page_cnt);
+
   /**
    * @brief 将磁盘文件中的内容加载到内存中。在启动时调用
    */
@@ -160,6 +186,11 @@ public:
    */
   RC add_page(DiskBufferPool *bp, PageNum page_num, Page &page) override;
 
+  /**
+   * 直接将页面写入buffer pool文件，所有页面一起提交
+   */
+  RC add_pages(DiskBufferPool *bp, span<Frame *> frames) override;
+
   RC read_page(DiskBufferPool *bp, PageNum page_num, Page &page) override { return RC::BUFFERPOOL_INVALID_PAGE_NUM; }
 
   /**
@@ -76,6 +76,10 @@ void Frame::write_latch(intptr_t xid)
 
   lock_.lock();
 
+  if (write_depth_++ == 0) {
+    version_.fetch_add(1, memory_order_acq_rel);
+  }
+
 #ifdef DEBUG
   write_locker_ = xid;
   ++write_recursive_count_;
@@ -110,6 +114,9 @@ void Frame::write_unlatch(intptr_t xid)
   }
   debug_lock_.unlock();
 
+  if (--write_depth_ == 0) {
+    version_.fetch_add(1, memory_order_release);
+  }
   lock_.unlock();
 }
 
@@ -75,7 +75,14 @@ public:
    * @details 在 MemPoolSimple 分配和释放一个Frame对象时，不会调用构造函数和析构函数，
    * 而是调用reinit和reset。
    */
-  void reinit() {}
+  void reinit()
+  {
+    // version_ 不能重置，乐观读的线程可能还拿着之前的版本号
+
+    load_state_.store(LoadState::EMPTY);
+    prefetched_.store(false, memory_order_relaxed);
+    rec_lsn_.store(0);
+  }
   void reset() {}
 
   void clear_page() { memset(&page_, 0, sizeof(page_)); }
@@ -104,7 +111,18 @@ public:
    * 序列号要小，那就可以从日志中读取这些更大序列号的日志，做重做操作，将页面恢复到最新状态，也就是redo。
    */
   LSN  lsn() const { return page_.lsn; }
-  void set_lsn(LSN lsn) { page_.lsn = lsn; }
+  void set_lsn(LSN lsn)
+  {
+    page_.lsn        = lsn;
+    LSN expected_lsn = 0;
+    rec_lsn_.compare_exchange_strong(expected_lsn, lsn);
+  }
+
+  /**
+   * @brief 页面上次刷盘之后，第一次修改对应的日志序列号，0表示页面刷盘后没有记录过日志
+   * @details 所有脏页中最小的 rec_lsn 之前的日志，对应的修改都已经刷到磁盘上了，做检查点时使用
+   */
+  LSN rec_lsn() const { return rec_lsn_.load(); }
 
   /**
    * @brief 页面校验和
@@ -132,11 +150,59 @@ public:
    * @brief 重置“脏”标记
    * @details 如果页面已经被写入磁盘文件，则应调用此函数。
    */
-  void clear_dirty() { dirty_ = false; }
+  void clear_dirty()
+  {
+    dirty_ = false;
+    rec_lsn_.store(0);
+  }
   bool dirty() const { return dirty_; }
 
   char *data() { return page_.data; }
 
+  /**
+   * @brief 页面数据是否已经加载到内存中
+   * @details 页帧先放入页帧表，然后才从磁盘读取数据，读取磁盘时不会持有任何大锁。
+   * 所以其他线程可能会在读取完成之前就拿到这个页帧，这时候需要等待读取完成才能访问页面数据。
+   */
+  bool loaded() const { return load_state_.load(memory_order_acquire) == LoadState::LOADED; }
+
+  /**
+   * @brief 尝试成为加载页面数据的线程
+   * @return 返回true时，调用方必须负责加载数据并调用 finish_load
+   */
+  bool try_begin_load()
+  {
+    LoadState expected = LoadState::EMPTY;
+    return load_state_.compare_exchange_strong(expected, LoadState::LOADING, memory_order_acq_rel);
+  }
+
+  /**
+   * @brief 页面数据加载完成
+   * @param success 加载失败时页帧恢复为空，后面访问这个页面的线程会重新加载
+   */
+  void finish_load(bool success)
+  {
+    load_state_.store(success ? LoadState::LOADED : LoadState::EMPTY, memory_order_release);
+  }
+
+  /**
+   * @brief 页帧的数据不需要从磁盘加载，比如新分配的页面
+   */
+  void mark_loaded() { load_state_.store(LoadState::LOADED, memory_order_release); }
+
+  /**
+   * @brief 页面是预读加载的，还没有被访问过
+   */
+  void mark_prefetched() { prefetched_.store(true, memory_order_relaxed); }
+
+  /**
+   * @brief 第一次访问预读的页面时返回true，之后都返回false
+   */
+  bool take_prefetched()
+  {
+    return prefetched_.load(memory_order_relaxed) && prefetched_.exchange(false, memory_order_relaxed);
+  }
+
   bool can_purge() { return pin_count_.load() == 0; }
 
   /**
@@ -163,6 +229,28 @@ public:
   void read_latch(intptr_t xid);
   bool try_read_latch();
 
+  /**
+   * @brief 页面的版本号，用于不加锁的乐观读
+   * @details 第一次加写锁和最后一次释放写锁时各加1，所以版本号是奇数时表示有线程正在修改页面。
+   * 乐观读先记下版本号，读完页面内容之后再校验版本号，如果有变化，读到的内容可能不一致，需要重新读。
+   * 乐观读时要pin住页面，防止页帧被淘汰后换成其它页面。
+   */
+  uint64_t version() const { return version_.load(memory_order_acquire); }
+
+  /**
+   * @brief 读取版本号时页面是否正在被修改
+   */
+  static bool is_write_latched(uint64_t version) { return (version & 1) != 0; }
+
+  /**
+   * @brief 校验从获取版本号到现在，页面没有被修改过
+   */
+  bool validate_version(uint64_t version) const
+  {
+    atomic_thread_fence(memory_order_acquire);
+    return version_.load(memory_order_relaxed) == version;
+  }
+
   void read_unlatch();
   void read_unlatch(intptr_t xid);
 
@@ -171,7 +259,19 @@ public:
 private:
   friend class BufferPool;
 
-  bool          dirty_ = false;
+  enum class LoadState
+  {
+    EMPTY,    ///< 还没有加载页面数据
+    LOADING,  ///< 某个线程正在加载页面数据
+    LOADED,   ///< 页面数据已经在内存中
+  };
+
+  atomic<bool>      dirty_{false};  ///< 后台刷脏页线程会在不加锁的情况下读取
+  atomic<LSN>       rec_lsn_{0};    ///< 参考 rec_lsn()
+  atomic<LoadState> load_state_{LoadState::EMPTY};
+  atomic<bool>      prefetched_{false};
+  atomic<uint64_t>  version_{0};     ///< 参考 version()
+  int               write_depth_ = 0;  ///< 写锁的重入次数，只有持有写锁的线程会访问
   atomic<int>   pin_count_{0};
   unsigned long acc_time_ = 0;
   FrameId       frame_id_;
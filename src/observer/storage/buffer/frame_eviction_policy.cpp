@@ -0,0 +1,214 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/21.
+//
+
+#include "storage/buffer/frame_eviction_policy.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+
+RC FrameEvictionPolicy::create(const char *name, size_t capacity, unique_ptr<FrameEvictionPolicy> &policy)
+{
+  if (name == nullptr || common::is_blank(name)) {
+    name = "lru";
+  }
+
+  if (strcasecmp(name, "lru") == 0) {
+    policy = make_unique<LruFrameEvictionPolicy>();
+  } else if (strcasecmp(name, "2q") == 0) {
+    policy = make_unique<TwoQueueFrameEvictionPolicy>(capacity);
+  } else if (strcasecmp(name, "clock") == 0) {
+    policy = make_unique<ClockFrameEvictionPolicy>();
+  } else {
+    LOG_WARN("unknown frame eviction policy: %s", name);
+    return RC::INVALID_ARGUMENT;
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LruFrameEvictionPolicy::admit(Frame *frame)
+{
+  lru_list_.push_front(frame);
+  positions_[frame] = lru_list_.begin();
+}
+
+void LruFrameEvictionPolicy::access(Frame *frame)
+{
+  auto iter = positions_.find(frame);
+  if (iter != positions_.end()) {
+    lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+  }
+}
+
+void LruFrameEvictionPolicy::remove(Frame *frame, bool /*evicted*/)
+{
+  auto iter = positions_.find(frame);
+  if (iter != positions_.end()) {
+    lru_list_.erase(iter->second);
+    positions_.erase(iter);
+  }
+}
+
+void LruFrameEvictionPolicy::foreach_victim(function<bool(Frame *)> visitor)
+{
+  for (auto iter = lru_list_.rbegin(); iter != lru_list_.rend(); ++iter) {
+    if (!visitor(*iter)) {
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TwoQueueFrameEvictionPolicy::TwoQueueFrameEvictionPolicy(size_t capacity)
+    : a1in_capacity_(max(capacity / 4, static_cast<size_t>(1))),
+      a1out_capacity_(max(capacity / 2, static_cast<size_t>(1)))
+{}
+
+void TwoQueueFrameEvictionPolicy::admit(Frame *frame)
+{
+  auto ghost_iter = a1out_positions_.find(frame->frame_id());
+  if (ghost_iter != a1out_positions_.end()) {
+    // 刚淘汰不久又被访问，是热点页面
+    a1out_.erase(ghost_iter->second);
+    a1out_positions_.erase(ghost_iter);
+
+    am_.push_front(frame);
+    positions_[frame] = Position{true, am_.begin()};
+  } else {
+    a1in_.push_front(frame);
+    positions_[frame] = Position{false, a1in_.begin()};
+  }
+}
+
+void TwoQueueFrameEvictionPolicy::access(Frame *frame)
+{
+  auto iter = positions_.find(frame);
+  if (iter != positions_.end() && iter->second.in_am) {
+    am_.splice(am_.begin(), am_, iter->second.iter);
+  }
+  // A1in 中的页面再次被访问时不做调整，这通常是同一个页面上的连续访问
+}
+
+void TwoQueueFrameEvictionPolicy::remove(Frame *frame, bool evicted)
+{
+  auto iter = positions_.find(frame);
+  if (iter == positions_.end()) {
+    return;
+  }
+
+  if (iter->second.in_am) {
+    am_.erase(iter->second.iter);
+  } else {
+    a1in_.erase(iter->second.iter);
+    if (evicted) {
+      remember_evicted(frame->frame_id());
+    }
+  }
+  positions_.erase(iter);
+}
+
+void TwoQueueFrameEvictionPolicy::remember_evicted(const FrameId &frame_id)
+{
+  if (a1out_positions_.find(frame_id) != a1out_positions_.end()) {
+    return;
+  }
+
+  a1out_.push_front(frame_id);
+  a1out_positions_[frame_id] = a1out_.begin();
+  if (a1out_.size() > a1out_capacity_) {
+    a1out_positions_.erase(a1out_.back());
+    a1out_.pop_back();
+  }
+}
+
+void TwoQueueFrameEvictionPolicy::foreach_victim(function<bool(Frame *)> visitor)
+{
+  list<Frame *> *queues[2] = {&am_, &a1in_};
+  if (a1in_.size() > a1in_capacity_) {
+    swap(queues[0], queues[1]);
+  }
+
+  for (list<Frame *> *queue : queues) {
+    for (auto iter = queue->rbegin(); iter != queue->rend(); ++iter) {
+      if (!visitor(*iter)) {
+        return;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ClockFrameEvictionPolicy::admit(Frame *frame)
+{
+  // 新页面放在时钟指针的后面，这样它会最后被检查到
+  auto iter = ring_.insert(hand_, ClockEntry{frame, true});
+  if (hand_ == ring_.end()) {
+    hand_ = iter;
+  }
+  positions_[frame] = iter;
+}
+
+void ClockFrameEvictionPolicy::access(Frame *frame)
+{
+  auto iter = positions_.find(frame);
+  if (iter != positions_.end()) {
+    iter->second->referenced = true;
+  }
+}
+
+void ClockFrameEvictionPolicy::remove(Frame *frame, bool /*evicted*/)
+{
+  auto iter = positions_.find(frame);
+  if (iter == positions_.end()) {
+    return;
+  }
+
+  if (iter->second == hand_) {
+    advance_hand();
+  }
+
+  ring_.erase(iter->second);
+  positions_.erase(iter);
+
+  if (ring_.empty()) {
+    hand_ = ring_.end();
+  }
+}
+
+void ClockFrameEvictionPolicy::advance_hand()
+{
+  ++hand_;
+  if (hand_ == ring_.end()) {
+    hand_ = ring_.begin();
+  }
+}
+
+void ClockFrameEvictionPolicy::foreach_victim(function<bool(Frame *)> visitor)
+{
+  // 最多转两圈：第一圈清除引用位，第二圈一定能看到所有没有被再次访问的页帧
+  const size_t max_steps = ring_.size() * 2;
+  for (size_t step = 0; step < max_steps; step++) {
+    ClockEntry &entry = *hand_;
+    advance_hand();
+
+    if (entry.referenced) {
+      entry.referenced = false;
+      continue;
+    }
+
+    if (!visitor(entry.frame)) {
+      break;
+    }
+  }
+}
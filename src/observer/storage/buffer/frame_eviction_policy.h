@@ -0,0 +1,177 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/21.
+//
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/functional.h"
+#include "common/lang/list.h"
+#include "common/lang/memory.h"
+#include "common/lang/unordered_map.h"
+#include "storage/buffer/frame.h"
+
+/**
+ * @brief 页帧淘汰策略
+ * @ingroup BufferPool
+ * @details BPFrameManager 的每个分片都有一个淘汰策略对象，记录分片内所有页帧的访问情况，
+ * 并在需要淘汰页面时，按照策略给出候选页帧的顺序。
+ * 策略对象本身不加锁，所有的接口都在持有分片锁时调用。
+ * 当前支持的策略：
+ * - lru: 最近最少使用，全表扫描会把热点页面全部挤出内存
+ * - 2q: 新页面先进入FIFO队列，只有在被淘汰后的短时间内再次访问才会进入LRU队列，可以抵御扫描
+ * - clock: 二次机会算法，访问时只设置引用位，开销比LRU更小
+ */
+class FrameEvictionPolicy
+{
+public:
+  FrameEvictionPolicy()          = default;
+  virtual ~FrameEvictionPolicy() = default;
+
+  /**
+   * @brief 新的页帧加入了分片
+   */
+  virtual void admit(Frame *frame) = 0;
+
+  /**
+   * @brief 访问了分片中已经存在的页帧
+   */
+  virtual void access(Frame *frame) = 0;
+
+  /**
+   * @brief 页帧从分片中移除
+   * @param evicted 是否是因为淘汰而移除的。主动释放的页面(比如删除页面、关闭文件)不是淘汰
+   */
+  virtual void remove(Frame *frame, bool evicted) = 0;
+
+  /**
+   * @brief 按照淘汰的优先顺序遍历页帧
+   * @param visitor 返回false时停止遍历
+   */
+  virtual void foreach_victim(function<bool(Frame *)> visitor) = 0;
+
+  virtual const char *name() const = 0;
+
+public:
+  /**
+   * @brief 根据名字创建淘汰策略
+   * @param name 策略名称，为空时使用lru
+   * @param capacity 当前分片预计能够容纳的页帧数
+   */
+  static RC create(const char *name, size_t capacity, unique_ptr<FrameEvictionPolicy> &policy);
+};
+
+/**
+ * @brief 最近最少使用淘汰策略
+ * @ingroup BufferPool
+ */
+class LruFrameEvictionPolicy final : public FrameEvictionPolicy
+{
+public:
+  LruFrameEvictionPolicy()          = default;
+  virtual ~LruFrameEvictionPolicy() = default;
+
+  void admit(Frame *frame) override;
+  void access(Frame *frame) override;
+  void remove(Frame *frame, bool evicted) override;
+  void foreach_victim(function<bool(Frame *)> visitor) override;
+
+  const char *name() const override { return "lru"; }
+
+private:
+  list<Frame *>                                 lru_list_;  ///< 头部是最近访问的页面
+  unordered_map<Frame *, list<Frame *>::iterator> positions_;
+};
+
+/**
+ * @brief 2Q淘汰策略
+ * @ingroup BufferPool
+ * @details 参考 Johnson & Shasha, "2Q: A Low Overhead High Performance Buffer Management Replacement Algorithm"。
+ * - A1in: 第一次进入内存的页面，按照FIFO淘汰，在这个队列中的重复访问不会提升页面
+ * - A1out: 从A1in中淘汰的页面编号(不占用页帧)，如果再次访问这些页面，说明它不是一次性扫描的页面
+ * - Am: 热点页面，按照LRU淘汰
+ * 全表扫描的页面都只会在A1in中流转，不会把Am中的页面挤出去。
+ */
+class TwoQueueFrameEvictionPolicy final : public FrameEvictionPolicy
+{
+public:
+  TwoQueueFrameEvictionPolicy(size_t capacity);
+  virtual ~TwoQueueFrameEvictionPolicy() = default;
+
+  void admit(Frame *frame) override;
+  void access(Frame *frame) override;
+  void remove(Frame *frame, bool evicted) override;
+  void foreach_victim(function<bool(Frame *)> visitor) override;
+
+  const char *name() const override { return "2q"; }
+
+private:
+  class FrameIdHasher
+  {
+  public:
+    size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
+  };
+
+  struct Position
+  {
+    bool                      in_am;
+    list<Frame *>::iterator iter;
+  };
+
+  void remember_evicted(const FrameId &frame_id);
+
+private:
+  size_t a1in_capacity_;   ///< A1in 队列的目标长度，超过后优先从A1in淘汰
+  size_t a1out_capacity_;  ///< A1out 最多记录多少个页面编号
+
+  list<Frame *>                    a1in_;  ///< 头部是最新加入的页面
+  list<Frame *>                    am_;    ///< 头部是最近访问的页面
+  unordered_map<Frame *, Position> positions_;
+
+  list<FrameId>                                                a1out_;  ///< 头部是最近淘汰的页面
+  unordered_map<FrameId, list<FrameId>::iterator, FrameIdHasher> a1out_positions_;
+};
+
+/**
+ * @brief CLOCK(二次机会)淘汰策略
+ * @ingroup BufferPool
+ * @details 所有页帧组成一个环，每个页帧有一个引用位。访问页面时设置引用位。
+ * 淘汰时时钟指针沿着环转动，遇到引用位被设置的页帧就清除引用位并跳过，否则就是候选页帧。
+ */
+class ClockFrameEvictionPolicy final : public FrameEvictionPolicy
+{
+public:
+  ClockFrameEvictionPolicy()          = default;
+  virtual ~ClockFrameEvictionPolicy() = default;
+
+  void admit(Frame *frame) override;
+  void access(Frame *frame) override;
+  void remove(Frame *frame, bool evicted) override;
+  void foreach_victim(function<bool(Frame *)> visitor) override;
+
+  const char *name() const override { return "clock"; }
+
+private:
+  struct ClockEntry
+  {
+    Frame *frame;
+    bool   referenced;
+  };
+
+  void advance_hand();
+
+private:
+  list<ClockEntry>                                   ring_;
+  list<ClockEntry>::iterator                         hand_ = ring_.end();
+  unordered_map<Frame *, list<ClockEntry>::iterator> positions_;
+};
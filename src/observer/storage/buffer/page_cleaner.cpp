@@ -0,0 +1,125 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/25.
+//
+
+#include "storage/buffer/page_cleaner.h"
+#include "common/lang/chrono.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+PageCleaner::PageCleaner(BufferPoolManager &bp_manager) : bp_manager_(bp_manager) {}
+
+PageCleaner::~PageCleaner() { stop(); }
+
+RC PageCleaner::start(const PageCleanerOptions &options)
+{
+  if (thread_) {
+    LOG_ERROR("page cleaner has been started");
+    return RC::INTERNAL;
+  }
+
+  if (options.high_watermark <= 0) {
+    LOG_INFO("page cleaner is disabled");
+    return RC::SUCCESS;
+  }
+
+#ifndef CONCURRENCY
+  LOG_INFO("page cleaner is disabled because frame latches do nothing without CONCURRENCY");
+  return RC::UNSUPPORTED;
+#endif
+
+  options_ = options;
+  if (options_.low_watermark < 0 || options_.low_watermark > options_.high_watermark) {
+    LOG_WARN("invalid page cleaner low watermark %d, use high watermark %d instead",
+             options_.low_watermark, options_.high_watermark);
+    options_.low_watermark = options_.high_watermark;
+  }
+  if (options_.interval_ms <= 0) {
+    options_.interval_ms = PageCleanerOptions().interval_ms;
+  }
+
+  running_.store(true);
+  thread_ = make_unique<thread>(&PageCleaner::thread_func, this);
+  LOG_INFO("page cleaner started. high watermark=%d%%, low watermark=%d%%, interval=%dms",
+           options_.high_watermark, options_.low_watermark, options_.interval_ms);
+  return RC::SUCCESS;
+}
+
+void PageCleaner::stop()
+{
+  if (!thread_) {
+    return;
+  }
+
+  {
+    lock_guard<mutex> guard(lock_);
+    running_.store(false);
+  }
+  cv_.notify_all();
+
+  thread_->join();
+  thread_.reset();
+  LOG_INFO("page cleaner stopped. clean rounds=%ld, flushed pages=%ld", clean_rounds_.load(), flushed_pages_.load());
+}
+
+void PageCleaner::wakeup()
+{
+  // 前台分配页帧时会频繁调用，已经有唤醒请求时就不再通知
+  if (running_.load() && !wakeup_.exchange(true)) {
+    cv_.notify_one();
+  }
+}
+
+int PageCleaner::clean_once()
+{
+  BPFrameManager &frame_manager = bp_manager_.get_frame_manager();
+
+  const int64_t total_frames = static_cast<int64_t>(frame_manager.total_frame_num());
+  const int64_t dirty_frames = static_cast<int64_t>(frame_manager.dirty_frame_num());
+  if (total_frames <= 0 || dirty_frames * 100 <= total_frames * options_.high_watermark) {
+    return 0;
+  }
+
+  const int64_t target = dirty_frames - total_frames * options_.low_watermark / 100;
+  int           flushed_pages = 0;
+  RC            rc = bp_manager_.clean_dirty_pages(static_cast<int>(target), flushed_pages);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to clean dirty pages. rc=%s", strrc(rc));
+  }
+
+  clean_rounds_.fetch_add(1);
+  flushed_pages_.fetch_add(flushed_pages);
+  LOG_DEBUG("page cleaner flushed %d pages. dirty frames=%ld, total frames=%ld", flushed_pages, dirty_frames, total_frames);
+  return flushed_pages;
+}
+
+void PageCleaner::thread_func()
+{
+  LOG_INFO("page cleaner thread started");
+  while (running_.load()) {
+    {
+      unique_lock<mutex> guard(lock_);
+      cv_.wait_for(guard, chrono::milliseconds(options_.interval_ms), [this]() {
+        return !running_.load() || wakeup_.load();
+      });
+    }
+    wakeup_.store(false);
+
+    if (!running_.load()) {
+      break;
+    }
+
+    clean_once();
+  }
+  LOG_INFO("page cleaner thread stopped");
+}
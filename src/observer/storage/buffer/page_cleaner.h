@@ -0,0 +1,91 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/25.
+//
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/atomic.h"
+#include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/thread.h"
+
+class BufferPoolManager;
+
+/**
+ * @brief 后台刷脏页的参数
+ * @ingroup BufferPool
+ * @details 水位线是脏页占全部页帧的百分比
+ */
+struct PageCleanerOptions
+{
+  int high_watermark = 50;   ///< 脏页比例超过这个值时开始刷脏页。小于等于0表示不启动后台刷脏
+  int low_watermark  = 30;   ///< 刷到脏页比例不超过这个值时停止
+  int interval_ms    = 100;  ///< 检查脏页比例的时间间隔
+};
+
+/**
+ * @brief 后台刷脏页线程
+ * @ingroup BufferPool
+ * @details 如果只在淘汰页帧的时候刷脏页，前台的查询就要等待脏页写回磁盘。
+ * 这个线程定期检查脏页比例，超过高水位线时，就把脏页刷到低水位线以下，这样淘汰的页帧大多是干净的。
+ * 页面按照页号的顺序交给 DoubleWriteBuffer 批量写入，写之前会等待页面对应的日志刷盘(LogHandler::wait_lsn)。
+ * 刷页面时只对页帧加读锁，正在被修改的页面会跳过，下次再刷。
+ * 非并发编译(没有定义CONCURRENCY)时页帧锁什么都不做，后台线程可能会读到修改了一半的页面，所以不会启动。
+ */
+class PageCleaner final
+{
+public:
+  explicit PageCleaner(BufferPoolManager &bp_manager);
+  ~PageCleaner();
+
+  /**
+   * @brief 启动后台线程
+   */
+  RC start(const PageCleanerOptions &options);
+
+  /**
+   * @brief 停止后台线程并等待线程结束
+   */
+  void stop();
+
+  /**
+   * @brief 唤醒后台线程，立即检查一次脏页比例
+   * @details 前台没有空闲页帧时调用
+   */
+  void wakeup();
+
+  bool running() const { return thread_ != nullptr; }
+
+  /**
+   * @brief 执行一轮刷脏，脏页比例超过高水位线时刷到低水位线
+   * @return 返回本轮刷新的页面数
+   */
+  int clean_once();
+
+private:
+  void thread_func();
+
+private:
+  BufferPoolManager &bp_manager_;
+  PageCleanerOptions options_;
+
+  unique_ptr<thread> thread_;
+  atomic_bool        running_{false};
+  atomic_bool        wakeup_{false};
+  mutex              lock_;
+  condition_variable cv_;
+
+  atomic<int64_t> flushed_pages_{0};  ///< 一共刷新了多少个页面
+  atomic<int64_t> clean_rounds_{0};   ///< 有多少轮检查需要刷脏页
+};
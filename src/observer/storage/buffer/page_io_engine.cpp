@@ -0,0 +1,443 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/23.
+//
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef WITH_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "storage/buffer/page_io_engine.h"
+#include "common/io/io.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+
+using namespace common;
+
+size_t PageIoRequest::total_size() const
+{
+  size_t size = 0;
+  for (int i = 0; i < iovcnt; i++) {
+    size += iov[i].iov_len;
+  }
+  return size;
+}
+
+/**
+ * @brief 使用 preadv/pwritev 同步执行一个请求
+ */
+static void execute_sync(PageIoRequest &request)
+{
+  if (request.type == PageIoRequest::Type::READ) {
+    request.result = preadvn(request.fd, request.iov, request.iovcnt, request.offset);
+  } else {
+    request.result = pwritevn(request.fd, request.iov, request.iovcnt, request.offset);
+  }
+}
+
+static RC result_to_rc(const PageIoRequest &request)
+{
+  if (request.result == 0) {
+    return RC::SUCCESS;
+  }
+
+  if (request.result == -1) {
+    LOG_WARN("page io touch the end of file. fd=%d, offset=%ld", request.fd, request.offset);
+  } else {
+    LOG_WARN("page io failed. fd=%d, offset=%ld, size=%lu, error=%s",
+             request.fd, request.offset, request.total_size(), strerror(request.result));
+  }
+  return request.type == PageIoRequest::Type::READ ? RC::IOERR_READ : RC::IOERR_WRITE;
+}
+
+static RC collect_results(span<PageIoRequest> requests)
+{
+  for (const PageIoRequest &request : requests) {
+    RC rc = result_to_rc(request);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC PageIoEngine::create(const char *name, unique_ptr<PageIoEngine> &engine)
+{
+  if (name == nullptr || common::is_blank(name)) {
+    name = "sync";
+  }
+
+  if (strcasecmp(name, "sync") == 0) {
+    engine = make_unique<SyncPageIoEngine>();
+    return RC::SUCCESS;
+  }
+
+  if (strcasecmp(name, "io_uring") == 0) {
+#ifdef WITH_IO_URING
+    auto io_uring_engine = make_unique<IoUringPageIoEngine>();
+    RC   rc              = io_uring_engine->init();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("io_uring is not available, use sync page io engine instead. rc=%s", strrc(rc));
+      engine = make_unique<SyncPageIoEngine>();
+      return RC::SUCCESS;
+    }
+    engine = std::move(io_uring_engine);
+    return RC::SUCCESS;
+#else
+    LOG_WARN("io_uring page io engine is not compiled, use sync page io engine instead");
+    engine = make_unique<SyncPageIoEngine>();
+    return RC::SUCCESS;
+#endif
+  }
+
+  LOG_WARN("unknown page io engine: %s", name);
+  return RC::INVALID_ARGUMENT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RC SyncPageIoEngine::execute(span<PageIoRequest> requests)
+{
+  for (PageIoRequest &request : requests) {
+    execute_sync(request);
+  }
+  return collect_results(requests);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+#ifdef WITH_IO_URING
+
+/**
+ * @brief 对 io_uring 系统调用的简单封装
+ * @details 参考 liburing 的实现。只有一个线程使用，所以提交队列的 tail 和完成队列的 head 不需要原子操作，
+ * 但是与内核共享的部分需要使用 acquire/release 语义。
+ */
+class IoUring
+{
+public:
+  IoUring() = default;
+  ~IoUring();
+
+  RC init(unsigned entries);
+
+  /**
+   * @brief 提交一批请求并等待全部完成
+   * @details 请求数超过队列长度时分多次提交。
+   * @param results 每个请求的原始结果，即传输的字节数或者负的错误码
+   */
+  RC run(span<PageIoRequest> requests, vector<int> &results);
+
+private:
+  RC submit_and_wait(span<PageIoRequest> requests, vector<int> &results, size_t base);
+
+private:
+  int ring_fd_ = -1;
+
+  void  *sq_ptr_      = nullptr;
+  size_t sq_map_size_ = 0;
+  void  *cq_ptr_      = nullptr;
+  size_t cq_map_size_ = 0;
+
+  struct io_uring_sqe *sqes_          = nullptr;
+  size_t               sqes_map_size_ = 0;
+
+  unsigned *sq_head_  = nullptr;
+  unsigned *sq_tail_  = nullptr;
+  unsigned *sq_mask_  = nullptr;
+  unsigned *sq_array_ = nullptr;
+  unsigned  sq_entries_ = 0;
+
+  unsigned            *cq_head_ = nullptr;
+  unsigned            *cq_tail_ = nullptr;
+  unsigned            *cq_mask_ = nullptr;
+  struct io_uring_cqe *cqes_    = nullptr;
+};
+
+IoUring::~IoUring()
+{
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_map_size_);
+  }
+  if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+    munmap(cq_ptr_, cq_map_size_);
+  }
+  if (sq_ptr_ != nullptr) {
+    munmap(sq_ptr_, sq_map_size_);
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+RC IoUring::init(unsigned entries)
+{
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+
+  ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (ring_fd_ < 0) {
+    LOG_WARN("failed to setup io_uring. entries=%u, error=%s", entries, strerror(errno));
+    return RC::UNSUPPORTED;
+  }
+
+  sq_map_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_map_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_map_size_ = cq_map_size_ = max(sq_map_size_, cq_map_size_);
+  }
+
+  sq_ptr_ = mmap(nullptr, sq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ptr_ == MAP_FAILED) {
+    sq_ptr_ = nullptr;
+    LOG_WARN("failed to mmap io_uring submission queue. error=%s", strerror(errno));
+    return RC::NOMEM;
+  }
+
+  if (single_mmap) {
+    cq_ptr_ = sq_ptr_;
+  } else {
+    cq_ptr_ = mmap(nullptr, cq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ptr_ == MAP_FAILED) {
+      cq_ptr_ = nullptr;
+      LOG_WARN("failed to mmap io_uring completion queue. error=%s", strerror(errno));
+      return RC::NOMEM;
+    }
+  }
+
+  sqes_map_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void *sqes     = mmap(nullptr, sqes_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    LOG_WARN("failed to mmap io_uring submission queue entries. error=%s", strerror(errno));
+    return RC::NOMEM;
+  }
+  sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+
+  char *sq_ptr = static_cast<char *>(sq_ptr_);
+  sq_head_     = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.head);
+  sq_tail_     = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.tail);
+  sq_mask_     = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.ring_mask);
+  sq_array_    = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.array);
+  sq_entries_  = params.sq_entries;
+
+  char *cq_ptr = static_cast<char *>(cq_ptr_);
+  cq_head_     = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.head);
+  cq_tail_     = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.tail);
+  cq_mask_     = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.ring_mask);
+  cqes_        = reinterpret_cast<struct io_uring_cqe *>(cq_ptr + params.cq_off.cqes);
+  return RC::SUCCESS;
+}
+
+RC IoUring::run(span<PageIoRequest> requests, vector<int> &results)
+{
+  results.assign(requests.size(), 0);
+  for (size_t start = 0; start < requests.size(); start += sq_entries_) {
+    size_t count = min(static_cast<size_t>(sq_entries_), requests.size() - start);
+    RC     rc    = submit_and_wait(requests.subspan(start, count), results, start);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC IoUring::submit_and_wait(span<PageIoRequest> requests, vector<int> &results, size_t base)
+{
+  const unsigned mask = *sq_mask_;
+  unsigned       tail = *sq_tail_;
+  for (size_t i = 0; i < requests.size(); i++) {
+    const PageIoRequest &request = requests[i];
+
+    const unsigned       index = tail & mask;
+    struct io_uring_sqe *sqe   = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode    = request.type == PageIoRequest::Type::READ ? IORING_OP_READV : IORING_OP_WRITEV;
+    sqe->fd        = request.fd;
+    sqe->addr      = reinterpret_cast<uint64_t>(request.iov);
+    sqe->len       = static_cast<uint32_t>(request.iovcnt);
+    sqe->off       = static_cast<uint64_t>(request.offset);
+    sqe->user_data = base + i;
+
+    sq_array_[index] = index;
+    tail++;
+  }
+  __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+  unsigned to_submit = static_cast<unsigned>(requests.size());
+  size_t   completed = 0;
+  while (completed < requests.size()) {
+    int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, 1 /*min_complete*/,
+                                       IORING_ENTER_GETEVENTS, nullptr, 0));
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_WARN("failed to enter io_uring. error=%s", strerror(errno));
+      return RC::IOERR_ACCESS;
+    }
+    to_submit -= min(static_cast<unsigned>(ret), to_submit);
+
+    unsigned head    = *cq_head_;
+    unsigned cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != cq_tail; head++) {
+      const struct io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+      results[cqe->user_data]        = cqe->res;
+      completed++;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+IoUringPageIoEngine::IoUringPageIoEngine() = default;
+
+IoUringPageIoEngine::~IoUringPageIoEngine() = default;
+
+RC IoUringPageIoEngine::init()
+{
+  unique_ptr<IoUring> ring;
+  RC                  rc = acquire_ring(ring);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  release_ring(std::move(ring));
+  return RC::SUCCESS;
+}
+
+RC IoUringPageIoEngine::acquire_ring(unique_ptr<IoUring> &ring)
+{
+  {
+    lock_guard<mutex> guard(lock_);
+    if (!idle_rings_.empty()) {
+      ring = std::move(idle_rings_.back());
+      idle_rings_.pop_back();
+      return RC::SUCCESS;
+    }
+  }
+
+  auto new_ring = make_unique<IoUring>();
+  RC   rc       = new_ring->init(RING_ENTRIES);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  ring = std::move(new_ring);
+  return RC::SUCCESS;
+}
+
+void IoUringPageIoEngine::release_ring(unique_ptr<IoUring> ring)
+{
+  lock_guard<mutex> guard(lock_);
+  idle_rings_.push_back(std::move(ring));
+}
+
+RC IoUringPageIoEngine::execute(span<PageIoRequest> requests)
+{
+  if (requests.empty()) {
+    return RC::SUCCESS;
+  }
+
+  unique_ptr<IoUring> ring;
+  RC                  rc = acquire_ring(ring);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get an io_uring, execute requests synchronously. rc=%s", strrc(rc));
+    for (PageIoRequest &request : requests) {
+      execute_sync(request);
+    }
+    return collect_results(requests);
+  }
+
+  vector<int> results;
+  rc = ring->run(requests, results);
+  if (OB_FAIL(rc)) {
+    // 这个 io_uring 中可能还有没有完成的请求，不能再给别人使用
+    return rc;
+  }
+  release_ring(std::move(ring));
+
+  for (size_t i = 0; i < requests.size(); i++) {
+    PageIoRequest &request = requests[i];
+    const int      res     = results[i];
+    if (res < 0) {
+      request.result = -res;
+    } else if (static_cast<size_t>(res) == request.total_size()) {
+      request.result = 0;
+    } else {
+      // 只完成了一部分(比如读到了文件尾，或者被信号打断)，剩下的部分同步执行一次，由它来判断具体的结果
+      execute_sync(request);
+    }
+  }
+  return collect_results(requests);
+}
+
+#endif  // WITH_IO_URING
+
+////////////////////////////////////////////////////////////////////////////////
+void PageIoBatch::add_read(int fd, off_t offset, void *buf, size_t size)
+{
+  add(PageIoRequest::Type::READ, fd, offset, buf, size);
+}
+
+void PageIoBatch::add_write(int fd, off_t offset, const void *buf, size_t size)
+{
+  add(PageIoRequest::Type::WRITE, fd, offset, const_cast<void *>(buf), size);
+}
+
+void PageIoBatch::add(PageIoRequest::Type type, int fd, off_t offset, void *buf, size_t size)
+{
+  iovs_.push_back({buf, size});
+
+  if (!requests_.empty()) {
+    Entry &last = requests_.back();
+    if (last.type == type && last.fd == fd && last.end == offset) {
+      last.end += size;
+      last.iovcnt++;
+      return;
+    }
+  }
+
+  requests_.push_back(Entry{type, fd, offset, static_cast<off_t>(offset + size), iovs_.size() - 1, 1});
+}
+
+RC PageIoBatch::submit(PageIoEngine &engine)
+{
+  if (requests_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  vector<PageIoRequest> requests(requests_.size());
+  for (size_t i = 0; i < requests_.size(); i++) {
+    const Entry   &entry   = requests_[i];
+    PageIoRequest &request = requests[i];
+    request.type           = entry.type;
+    request.fd             = entry.fd;
+    request.iov            = &iovs_[entry.iov_start];
+    request.iovcnt         = entry.iovcnt;
+    request.offset         = entry.offset;
+  }
+
+  RC rc = engine.execute(requests);
+  clear();
+  return rc;
+}
+
+void PageIoBatch::clear()
+{
+  requests_.clear();
+  iovs_.clear();
+}
@@ -0,0 +1,179 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/23.
+//
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "common/rc.h"
+#include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/span.h"
+#include "common/lang/vector.h"
+
+/**
+ * @brief 一个页面读写请求
+ * @ingroup BufferPool
+ * @details 从文件的offset位置开始，连续读写iov描述的多段内存
+ */
+struct PageIoRequest
+{
+  enum class Type
+  {
+    READ,
+    WRITE,
+  };
+
+  Type          type   = Type::READ;
+  int           fd     = -1;
+  struct iovec *iov    = nullptr;
+  int           iovcnt = 0;
+  off_t         offset = 0;
+
+  /// 执行结果。0表示成功，-1表示读到了文件尾，其它值是errno
+  int result = 0;
+
+  size_t total_size() const;
+};
+
+/**
+ * @brief 页面读写引擎
+ * @ingroup BufferPool
+ * @details 所有的页面读写(加载页面、刷新页面、double write buffer)都通过这个接口执行。
+ * 调用方一次提交一批请求，引擎返回时这批请求全部完成。
+ * - sync: 依次使用 preadv/pwritev 执行，与原来的行为相同
+ * - io_uring: 一批请求一次性提交给内核并发执行，只等待一次。仅在Linux上编译了 WITH_IO_URING 时可用，
+ *   如果当前内核不支持，会回退到sync。
+ */
+class PageIoEngine
+{
+public:
+  PageIoEngine()          = default;
+  virtual ~PageIoEngine() = default;
+
+  /**
+   * @brief 执行一批请求，全部完成后返回
+   * @details 每个请求的结果记录在 PageIoRequest::result 中。
+   * 请求中的iov可能会被修改
+   * @return 所有请求都成功时返回SUCCESS，否则返回第一个失败的请求对应的错误
+   */
+  virtual RC execute(span<PageIoRequest> requests) = 0;
+
+  virtual const char *name() const = 0;
+
+public:
+  /**
+   * @brief 根据名字创建页面读写引擎
+   * @param name sync 或 io_uring，为空时使用sync
+   */
+  static RC create(const char *name, unique_ptr<PageIoEngine> &engine);
+};
+
+/**
+ * @brief 同步执行页面读写
+ * @ingroup BufferPool
+ */
+class SyncPageIoEngine final : public PageIoEngine
+{
+public:
+  SyncPageIoEngine()          = default;
+  virtual ~SyncPageIoEngine() = default;
+
+  RC execute(span<PageIoRequest> requests) override;
+
+  const char *name() const override { return "sync"; }
+};
+
+#ifdef WITH_IO_URING
+
+class IoUring;
+
+/**
+ * @brief 使用 io_uring 执行页面读写
+ * @ingroup BufferPool
+ * @details 直接使用系统调用，不依赖liburing。
+ * 每个 io_uring 同一时刻只给一个线程使用，这样提交和收割都不需要加锁。
+ * 执行请求时从空闲列表中取一个，没有就创建一个，用完后放回空闲列表。
+ * 所以 io_uring 的个数不会超过同时执行读写的线程数。
+ */
+class IoUringPageIoEngine final : public PageIoEngine
+{
+public:
+  IoUringPageIoEngine();
+  virtual ~IoUringPageIoEngine();
+
+  /**
+   * @brief 检查当前系统是否支持 io_uring
+   */
+  RC init();
+
+  RC execute(span<PageIoRequest> requests) override;
+
+  const char *name() const override { return "io_uring"; }
+
+private:
+  RC   acquire_ring(unique_ptr<IoUring> &ring);
+  void release_ring(unique_ptr<IoUring> ring);
+
+private:
+  static constexpr unsigned RING_ENTRIES = 64;
+
+  mutex                      lock_;
+  vector<unique_ptr<IoUring>> idle_rings_;
+};
+
+#endif  // WITH_IO_URING
+
+/**
+ * @brief 收集一批页面读写请求
+ * @ingroup BufferPool
+ * @details 同一个文件中位置连续、类型相同的请求会合并成一个 preadv/pwritev 请求
+ */
+class PageIoBatch
+{
+public:
+  PageIoBatch()  = default;
+  ~PageIoBatch() = default;
+
+  void add_read(int fd, off_t offset, void *buf, size_t size);
+  void add_write(int fd, off_t offset, const void *buf, size_t size);
+
+  /**
+   * @brief 提交所有请求并等待完成
+   */
+  RC submit(PageIoEngine &engine);
+
+  bool   empty() const { return requests_.empty(); }
+  size_t request_num() const { return requests_.size(); }
+
+  void clear();
+
+private:
+  void add(PageIoRequest::Type type, int fd, off_t offset, void *buf, size_t size);
+
+private:
+  struct Entry
+  {
+    PageIoRequest::Type type;
+    int                 fd;
+    off_t               offset;
+    off_t               end;        ///< 请求的结束位置，用来判断后面的请求是否连续
+    size_t              iov_start;  ///< 在 iovs_ 中的起始位置
+    int                 iovcnt;
+  };
+
+  vector<Entry>         requests_;
+  vector<struct iovec>  iovs_;
+};
@@ -0,0 +1,66 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/24.
+//
+
+#include "storage/buffer/read_ahead.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/sstream.h"
+
+bool ReadAheadDetector::access(PageNum page_num, PageNum &start, int &count)
+{
+  if (window_ <= 0) {
+    return false;
+  }
+
+  if (last_page_ != BP_INVALID_PAGE_NUM && page_num > last_page_ && page_num - last_page_ <= MAX_GAP) {
+    sequential_count_++;
+  } else if (page_num != last_page_) {
+    sequential_count_ = 1;
+    read_ahead_end_   = BP_INVALID_PAGE_NUM;
+  }
+  last_page_ = page_num;
+
+  if (sequential_count_ < TRIGGER) {
+    return false;
+  }
+
+  PageNum end = page_num + 1 + window_;
+  start       = page_num + 1;
+  if (read_ahead_end_ != BP_INVALID_PAGE_NUM) {
+    start = max(start, read_ahead_end_);
+  }
+
+  // 已经预读的页面足够多，或者剩下的部分太小，等后面再一起读
+  if (end - start < max(window_ / 2, 1)) {
+    return false;
+  }
+
+  count           = end - start;
+  read_ahead_end_ = end;
+  return true;
+}
+
+void ReadAheadDetector::reset()
+{
+  last_page_        = BP_INVALID_PAGE_NUM;
+  sequential_count_ = 0;
+  read_ahead_end_   = BP_INVALID_PAGE_NUM;
+}
+
+string ReadAheadStats::to_string() const
+{
+  stringstream ss;
+  ss << "misses:" << misses.load() << ", read_ahead_ios:" << read_ahead_ios.load()
+     << ", read_ahead_pages:" << read_ahead_pages.load() << ", read_ahead_hits:" << read_ahead_hits.load();
+  return ss.str();
+}
@@ -0,0 +1,78 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/24.
+//
+
+#pragma once
+
+#include "common/lang/atomic.h"
+#include "common/lang/string.h"
+#include "storage/buffer/page.h"
+
+/**
+ * @brief 顺序访问检测
+ * @ingroup BufferPool
+ * @details 记录最近访问的页面，如果连续几次访问的页面编号是递增的，并且间隔很小，就认为是顺序访问，
+ * 给出需要预读的页面范围。
+ * 第一次检测到顺序访问时，预读后面的 window 个页面。之后访问预读过的页面时也要调用 access，
+ * 当访问位置离已经预读的末尾不足半个窗口时，再预读半个窗口，这样预读总是走在访问的前面，
+ * 并且每次IO都足够大。
+ * 这个类不是线程安全的。
+ */
+class ReadAheadDetector
+{
+public:
+  /// 两次访问的页面间隔不超过这个值时，认为是顺序访问。B+树的叶子节点中间可能夹杂着内部节点
+  static constexpr int MAX_GAP = 2;
+
+  /// 连续这么多次顺序访问后开始预读
+  static constexpr int TRIGGER = 2;
+
+public:
+  explicit ReadAheadDetector(int window = 0) : window_(window) {}
+
+  void set_window(int window) { window_ = window; }
+  int  window() const { return window_; }
+
+  /**
+   * @brief 记录一次页面访问
+   * @param page_num 访问的页面
+   * @param start 需要预读的第一个页面
+   * @param count 需要预读的页面数
+   * @return 需要预读时返回true
+   */
+  bool access(PageNum page_num, PageNum &start, int &count);
+
+  void reset();
+
+private:
+  int     window_           = 0;
+  PageNum last_page_        = BP_INVALID_PAGE_NUM;
+  int     sequential_count_ = 0;
+  PageNum read_ahead_end_   = BP_INVALID_PAGE_NUM;  ///< 已经预读的页面的下一个页面
+};
+
+/**
+ * @brief 预读相关的统计信息
+ * @ingroup BufferPool
+ * @details 可以根据这些数据调整预读窗口的大小。
+ * 预读的页面中没有被访问的页面数是 read_ahead_pages - read_ahead_hits
+ */
+struct ReadAheadStats
+{
+  atomic<int64_t> misses{0};            ///< 访问页面时同步从磁盘加载的次数
+  atomic<int64_t> read_ahead_ios{0};    ///< 预读的次数
+  atomic<int64_t> read_ahead_pages{0};  ///< 预读加载的页面数
+  atomic<int64_t> read_ahead_hits{0};   ///< 预读的页面后来被访问的次数
+
+  string to_string() const;
+};
@@ -17,9 +17,86 @@ See the Mulan PSL v2 for more details. */
 #include "storage/clog/log_file.h"
 #include "storage/clog/log_replayer.h"
 #include "common/lang/chrono.h"
+#include "common/lang/sstream.h"
 
 using namespace common;
 
+////////////////////////////////////////////////////////////////////////////////
+// Log2Histogram
+
+void Log2Histogram::record(int64_t value)
+{
+  if (value < 0) {
+    value = 0;
+  }
+
+  int bucket = 0;
+  if (value > 0) {
+    bucket = 64 - __builtin_clzll(static_cast<uint64_t>(value));
+    if (bucket >= BUCKET_NUM) {
+      bucket = BUCKET_NUM - 1;
+    }
+  }
+
+  buckets_[bucket].fetch_add(1, memory_order_relaxed);
+  count_.fetch_add(1, memory_order_relaxed);
+  sum_.fetch_add(value, memory_order_relaxed);
+
+  int64_t old_max = max_.load(memory_order_relaxed);
+  while (value > old_max && !max_.compare_exchange_weak(old_max, value, memory_order_relaxed)) {
+  }
+}
+
+int64_t Log2Histogram::percentile(double p) const
+{
+  const int64_t total = count();
+  if (total == 0) {
+    return 0;
+  }
+
+  const int64_t target = static_cast<int64_t>(total * p);
+  int64_t       seen   = 0;
+  for (int i = 0; i < BUCKET_NUM; i++) {
+    seen += buckets_[i].load(memory_order_relaxed);
+    if (seen > target) {
+      return i == 0 ? 0 : (1LL << i) - 1;
+    }
+  }
+  return max();
+}
+
+string Log2Histogram::to_string() const
+{
+  stringstream ss;
+  const int64_t total = count();
+  ss << "count:" << total << ", avg:" << (total == 0 ? 0 : sum() / total) << ", p50<=" << percentile(0.5)
+     << ", p99<=" << percentile(0.99) << ", max:" << max() << ", buckets:{";
+
+  bool first = true;
+  for (int i = 0; i < BUCKET_NUM; i++) {
+    int64_t n = buckets_[i].load(memory_order_relaxed);
+    if (n == 0) {
+      continue;
+    }
+    if (!first) {
+      ss << ", ";
+    }
+    first = false;
+    ss << "<" << (1LL << i) << ":" << n;
+  }
+  ss << "}";
+  return ss.str();
+}
+
+string GroupCommitStats::to_string() const
+{
+  stringstream ss;
+  ss << "syncs:" << syncs.load() << ", commit latency(us):[" << commit_latency_us.to_string() << "]"
+     << ", batch entries:[" << batch_entries.to_string() << "]"
+     << ", batch bytes:[" << batch_bytes.to_string() << "]";
+  return ss.str();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // LogHandler
 
@@ -37,6 +114,7 @@ RC DiskLogHandler::start()
   }
 
   running_.store(true);
+  flusher_exited_ = false;
   thread_ = make_unique<thread>(&DiskLogHandler::thread_func, this);
   LOG_INFO("log handler started");
   return RC::SUCCESS;
@@ -49,7 +127,11 @@ RC DiskLogHandler::stop()
     return RC::INTERNAL;
   }
 
-  running_.store(false);
+  {
+    lock_guard<mutex> guard(lock_);
+    running_.store(false);
+  }
+  flush_cv_.notify_all();
 
   LOG_INFO("log handler stopped");
   return RC::SUCCESS;
@@ -69,16 +151,17 @@ RC DiskLogHandler::await_termination()
 
   thread_->join();
   thread_.reset();
-  LOG_INFO("log handler joined");
+  LOG_INFO("log handler joined. %s", stats_.to_string().c_str());
   return RC::SUCCESS;
 }
 
 RC DiskLogHandler::replay(LogReplayer &replayer, LSN start_lsn)
 {
   LSN max_lsn = 0;
-  auto replay_callback = [&replayer, &max_lsn](LogEntry &entry) -> RC {
+  auto replay_callback = [this, &replayer, &max_lsn](LogEntry &entry) -> RC {
     if (entry.lsn() > max_lsn) {
       max_lsn = entry.lsn();
+      replayed_lsn_.store(max_lsn);
     }
     return replayer.replay(entry);
   };
@@ -133,12 +216,12 @@ RC DiskLogHandler::iterate(function<RC(LogEntry&)> consumer, LSN start_lsn)
   return RC::SUCCESS;
 }
 
-RC DiskLogHandler::_append(LSN &lsn, LogModule module, vector<char> &&data)
+RC DiskLogHandler::_append(LSN &lsn, LogModule module, span<const char> data)
 {
   ASSERT(running_.load(), "log handler is not running. lsn=%ld, module=%s, size=%d", 
         lsn, module.name(), data.size());
 
-  RC rc = entry_buffer_.append(lsn, module, std::move(data));
+  RC rc = entry_buffer_.append(lsn, module, data);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to append log entry to buffer. rc=%s", strrc(rc));
     return rc;
@@ -149,30 +232,67 @@ RC DiskLogHandler::_append(LSN &lsn, LogModule module, vector<char> &&data)
 
 RC DiskLogHandler::wait_lsn(LSN lsn)
 {
-  // 直接强制等待。在生产系统中，我们可能会使用条件变量来等待。
-  while (running_.load() && current_flushed_lsn() < lsn) {
-    this_thread::sleep_for(chrono::milliseconds(100));
+  if (current_flushed_lsn() >= lsn || replayed_lsn_.load() >= lsn) {
+    return RC::SUCCESS;
   }
 
+  auto begin_time = chrono::steady_clock::now();
+
+  Waiter waiter;
+  {
+    unique_lock<mutex> guard(lock_);
+    // 加锁后再检查一次，刷盘线程是在持有锁的时候唤醒等待者的，这样不会丢失通知
+    if (current_flushed_lsn() < lsn && !flusher_exited_) {
+      waiters_.emplace(lsn, &waiter);
+      if (!flush_requested_) {
+        flush_requested_ = true;
+        flush_cv_.notify_one();
+      }
+
+      // 刷盘线程在唤醒等待者时会把它从队列中删除
+      waiter.cv.wait(guard, [&waiter]() { return waiter.done; });
+    }
+  }
+
+  auto latency = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - begin_time);
+  stats_.commit_latency_us.record(latency.count());
+
   if (current_flushed_lsn() >= lsn) {
     return RC::SUCCESS;
   } else {
+    LOG_WARN("log handler stopped before lsn flushed. lsn=%ld, flushed lsn=%ld", lsn, current_flushed_lsn());
     return RC::INTERNAL;
   }
 }
 
+void DiskLogHandler::notify_waiters(bool all)
+{
+  const LSN flushed_lsn = current_flushed_lsn();
+
+  lock_guard<mutex> guard(lock_);
+  auto              end_iter = all ? waiters_.end() : waiters_.upper_bound(flushed_lsn);
+  for (auto iter = waiters_.begin(); iter != end_iter; ++iter) {
+    iter->second->done = true;
+    iter->second->cv.notify_one();
+  }
+  waiters_.erase(waiters_.begin(), end_iter);
+
+  // 还有人在等待的话，刷盘线程不要睡眠
+  flush_requested_ = !waiters_.empty();
+}
+
 void DiskLogHandler::thread_func()
 {
   /*
-  这个线程一直不停的循环，检查日志缓冲区中是否有日志在内存中，如果在内存中就刷新到磁盘。
-  这种做法很粗暴简单，与生产数据库的做法不同。生产数据库通常会在内存达到一定量，或者一定时间
-  之后，会刷新一下磁盘。这样做的好处是减少磁盘的IO次数，提高性能。
+  这个线程把缓冲区中的日志刷新到磁盘。
+  有事务在等待日志刷盘时，会通过条件变量唤醒这个线程，否则每隔 FLUSH_INTERVAL_MS 毫秒检查一次。
+  每次把缓冲区中所有的日志作为一批写入文件并刷盘，多个事务的提交就只需要一次刷盘(组提交)。
   */
   thread_set_name("LogHandler");
   LOG_INFO("log handler thread started");
 
   LogFileWriter file_writer;
-  
+
   RC rc = RC::SUCCESS;
   while (running_.load() || entry_buffer_.entry_number() > 0) {
     if (!file_writer.valid() || rc == RC::LOG_FILE_FULL) {
@@ -192,17 +312,41 @@ void DiskLogHandler::thread_func()
       LOG_INFO("open log file success. file=%s", file_writer.to_string().c_str());
     }
 
-    int flush_count = 0;
-    rc = entry_buffer_.flush(file_writer, flush_count);
+    int     flush_count = 0;
+    int64_t flush_bytes = 0;
+    rc = entry_buffer_.flush(file_writer, flush_count, flush_bytes);
     if (OB_FAIL(rc) && RC::LOG_FILE_FULL != rc) {
       LOG_WARN("failed to flush log entry buffer. rc=%s", strrc(rc));
     }
 
-    if (flush_count == 0 && rc == RC::SUCCESS) {
+    if (flush_count > 0) {
+      stats_.syncs.fetch_add(1);
+      stats_.batch_entries.record(flush_count);
+      stats_.batch_bytes.record(flush_bytes);
+      notify_waiters(false /*all*/);
+    }
+
+    if (rc == RC::LOG_FILE_FULL || (flush_count > 0 && entry_buffer_.entry_number() > 0)) {
+      continue;
+    }
+
+    if (OB_FAIL(rc)) {
+      // 写文件失败，等待一段时间再重试，避免空转
       this_thread::sleep_for(chrono::milliseconds(100));
       continue;
     }
+
+    unique_lock<mutex> guard(lock_);
+    flush_cv_.wait_for(guard, chrono::milliseconds(FLUSH_INTERVAL_MS), [this]() {
+      // 等待的日志可能还没有追加到缓冲区，这时不要空转
+      return !running_.load() || (flush_requested_ && entry_buffer_.entry_number() > 0);
+    });
   }
 
+  {
+    lock_guard<mutex> guard(lock_);
+    flusher_exited_ = true;
+  }
+  notify_waiters(true /*all*/);
   LOG_INFO("log handler thread stopped");
 }
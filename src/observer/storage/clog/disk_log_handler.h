@@ -18,7 +18,10 @@ See the Mulan PSL v2 for more details. */
 #include "common/rc.h"
 #include "common/lang/vector.h"
 #include "common/lang/deque.h"
+#include "common/lang/map.h"
 #include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
 #include "common/lang/thread.h"
 #include "storage/clog/log_module.h"
 #include "storage/clog/log_file.h"
@@ -27,11 +30,59 @@ See the Mulan PSL v2 for more details. */
 
 class LogReplayer;
 
+/**
+ * @brief 按照2的幂划分桶的直方图
+ * @ingroup CLog
+ * @details 第i个桶记录 [2^(i-1), 2^i) 范围内的数值，第0个桶记录0。
+ * 记录时只做几次原子加，可以在提交路径上使用。
+ */
+class Log2Histogram
+{
+public:
+  static constexpr int BUCKET_NUM = 40;
+
+public:
+  void record(int64_t value);
+
+  int64_t count() const { return count_.load(); }
+  int64_t sum() const { return sum_.load(); }
+  int64_t max() const { return max_.load(); }
+
+  /// @brief 估算分位数，返回分位数所在桶的上界
+  int64_t percentile(double p) const;
+
+  string to_string() const;
+
+private:
+  atomic<int64_t> buckets_[BUCKET_NUM] = {};
+  atomic<int64_t> count_{0};
+  atomic<int64_t> sum_{0};
+  atomic<int64_t> max_{0};
+};
+
+/**
+ * @brief 组提交相关的统计信息
+ * @ingroup CLog
+ */
+struct GroupCommitStats
+{
+  Log2Histogram   commit_latency_us;  ///< wait_lsn 需要等待时，等待日志刷盘的时间，单位微秒
+  Log2Histogram   batch_entries;      ///< 每次刷盘写入的日志条数
+  Log2Histogram   batch_bytes;        ///< 每次刷盘写入的字节数
+  atomic<int64_t> syncs{0};           ///< 刷盘的次数
+
+  string to_string() const;
+};
+
 /**
  * @brief 对外提供服务的CLog模块
  * @ingroup CLog
  * @details 该模块负责日志的写入、读取、回放等功能。
- * 会在后台开启一个线程，一直尝试刷新内存中的日志到磁盘。
+ * 会在后台开启一个线程刷新内存中的日志到磁盘。
+ * 提交事务时调用 wait_lsn 等待日志刷盘，等待者按照LSN排队并在条件变量上等待，
+ * 刷盘线程被唤醒后把缓冲区中所有的日志一次写入文件并刷盘(组提交)，
+ * 然后只唤醒LSN已经持久化的等待者。刷盘期间到来的提交请求会在下一批中一起刷盘。
+ * 没有人等待时，刷盘线程也会每隔 FLUSH_INTERVAL_MS 毫秒刷新一次。
  * 所有的CLog日志文件都存放在指定的目录下，每个日志文件按照日志条数来划分。
  * 调用的顺序应该是：
  * @code {.cpp}
@@ -102,6 +153,15 @@ public:
   /// @brief 当前刷新到哪个日志
   LSN current_flushed_lsn() const { return entry_buffer_.flushed_lsn(); }
 
+  /// @brief 组提交的统计信息
+  const GroupCommitStats &stats() const { return stats_; }
+
+  /**
+   * @brief 删除检查点之前的日志文件
+   * @details 正在写入的日志文件不会删除
+   */
+  RC remove_logs_before(LSN lsn) override { return file_manager_.remove_files_before(lsn); }
+
 private:
   /**
    * @brief 在缓存中增加一条日志
@@ -110,7 +170,7 @@ private:
    * @param[in] module  日志模块
    * @param[in] data    日志数据。具体的数据由各个模块自己定义
    */
-  RC _append(LSN &lsn, LogModule module, vector<char> &&data) override;
+  RC _append(LSN &lsn, LogModule module, span<const char> data) override;
 
 private:
   /**
@@ -118,10 +178,40 @@ private:
    */
   void thread_func();
 
+  /**
+   * @brief 唤醒LSN已经刷盘的等待者
+   * @param all 是否唤醒所有的等待者。刷盘线程退出时使用
+   */
+  void notify_waiters(bool all);
+
 private:
+  /// 没有等待者时，刷盘线程定期刷新日志的间隔
+  static constexpr int FLUSH_INTERVAL_MS = 10;
+
+  /**
+   * @brief 一个等待日志刷盘的线程
+   * @details 每个等待者有自己的条件变量，刷盘线程只唤醒日志已经持久化的等待者
+   */
+  struct Waiter
+  {
+    condition_variable cv;
+    bool               done = false;
+  };
+
   unique_ptr<thread> thread_;          /// 刷新日志的线程
   atomic_bool        running_{false};  /// 是否还要继续运行
 
+  mutex                   lock_;                     /// 保护下面的几个成员
+  condition_variable      flush_cv_;                 /// 唤醒刷盘线程
+  bool                    flush_requested_ = false;  /// 有人在等待日志刷盘
+  bool                    flusher_exited_  = true;   /// 刷盘线程没有启动或已经退出，不会再有日志刷盘
+  multimap<LSN, Waiter *> waiters_;                  /// 按照LSN排序的等待者
+
+  GroupCommitStats stats_;
+
+  /// 回放时从日志文件中读到的最大LSN。回放过程中淘汰页面时，页面上的日志已经在磁盘上了
+  atomic<LSN> replayed_lsn_{0};
+
   LogFileManager file_manager_;  /// 管理所有的日志文件
   LogEntryBuffer entry_buffer_;  /// 缓存日志
 
@@ -40,6 +40,18 @@ RC IntegratedLogReplayer::replay(const LogEntry &entry)
   }
 }
 
+LogReplayScope IntegratedLogReplayer::scope(const LogEntry &entry) const
+{
+  switch (entry.module().id()) {
+    case LogModule::Id::BUFFER_POOL: return buffer_pool_log_replayer_.scope(entry);
+    case LogModule::Id::RECORD_MANAGER: return record_log_replayer_.scope(entry);
+    case LogModule::Id::BPLUS_TREE: return bplus_tree_log_replayer_.scope(entry);
+    case LogModule::Id::TRANSACTION:
+      return trx_log_replayer_ ? trx_log_replayer_->scope(entry) : LogReplayScope::global();
+    default: return LogReplayScope::global();
+  }
+}
+
 RC IntegratedLogReplayer::on_done()
 {
   RC rc = buffer_pool_log_replayer_.on_done();
@@ -59,7 +71,7 @@ RC IntegratedLogReplayer::on_done()
     return rc;
   }
 
-  rc = trx_log_replayer_->on_done();
+  rc = trx_log_replayer_ ? trx_log_replayer_->on_done() : RC::SUCCESS;
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to do mvcc trx log replay. rc=%s", strrc(rc));
     return rc;
@@ -52,6 +52,9 @@ public:
   //! @copydoc LogReplayer::on_done
   RC on_done() override;
 
+  //! @copydoc LogReplayer::scope
+  LogReplayScope scope(const LogEntry &entry) const override;
+
 private:
   BufferPoolLogReplayer   buffer_pool_log_replayer_;  ///< 缓冲池日志回放器
   RecordLogReplayer       record_log_replayer_;       ///< record manager 日志回放器
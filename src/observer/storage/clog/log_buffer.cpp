@@ -12,95 +12,214 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2024/01/31
 //
 
+#include <sys/uio.h>
+
 #include "storage/clog/log_buffer.h"
 #include "storage/clog/log_file.h"
-#include "common/lang/chrono.h"
+#include "common/lang/algorithm.h"
 
 using namespace common;
 
-RC LogEntryBuffer::init(LSN lsn, int32_t max_bytes /*= 0*/)
+RC LogEntryBuffer::init(LSN lsn, int64_t max_bytes /*= 0*/)
 {
-  current_lsn_.store(lsn);
-  flushed_lsn_.store(lsn);
-
   if (max_bytes > 0) {
     max_bytes_ = max_bytes;
   }
+
+  // 至少能放下两条最大的日志，这样等待空间的日志只需要等待它前面的日志刷盘，不会死锁
+  const uint64_t min_capacity = max<uint64_t>(max_bytes_, 2 * static_cast<uint64_t>(LogEntry::max_size()));
+  uint64_t       capacity     = 1;
+  while (capacity < min_capacity) {
+    capacity <<= 1;
+  }
+
+  capacity_ = capacity;
+  data_     = make_unique<char[]>(capacity_);
+  // 一个槽位对应一条日志，日志通常不会小于64字节，槽位不够用时写日志的线程会等待
+  slot_num_ = capacity_ / 64;
+  slots_    = make_unique<Slot[]>(slot_num_);
+
+  base_lsn_ = lsn;
+  reserved_.store(0);
+  flushed_pos_.store(0);
+  flushed_lsn_.store(lsn);
   return RC::SUCCESS;
 }
 
-RC LogEntryBuffer::append(LSN &lsn, LogModule::Id module_id, vector<char> &&data)
+void LogEntryBuffer::decode(
+    uint64_t reserved, uint64_t flushed_pos, LSN flushed_lsn, uint64_t &count, uint64_t &pos) const
 {
-  return append(lsn, LogModule(module_id), std::move(data));
+  static constexpr uint64_t COUNT_MASK = (1ULL << (64 - POS_BITS)) - 1;
+
+  // 没有刷盘的日志不会太多，用已经刷盘的位置还原被截断的高位
+  const uint64_t flushed_count = static_cast<uint64_t>(flushed_lsn - base_lsn_);
+
+  pos   = flushed_pos + ((reserved - flushed_pos) & POS_MASK);
+  count = flushed_count + ((((reserved - pos) >> POS_BITS) - flushed_count) & COUNT_MASK);
 }
 
-RC LogEntryBuffer::append(LSN &lsn, LogModule module, vector<char> &&data)
+RC LogEntryBuffer::append(LSN &lsn, LogModule::Id module_id, span<const char> data)
 {
-  /// 控制当前buffer使用的内存
-  /// 简单粗暴，强制原地等待
-  /// 但是如果当前想要新插入的日志比较大，不会做控制。所以理论上容纳的最大buffer内存是2*max_bytes_
-  while (bytes_.load() >= max_bytes_) {
-    this_thread::sleep_for(chrono::milliseconds(10));
-  }
+  return append(lsn, LogModule(module_id), data);
+}
 
-  LogEntry entry;
-  RC rc = entry.init(lsn, module, std::move(data));
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to init log entry. rc=%s", strrc(rc));
-    return rc;
+RC LogEntryBuffer::append(LSN &lsn, LogModule module, span<const char> data)
+{
+  if (data.empty() || static_cast<int64_t>(data.size()) > LogEntry::max_payload_size()) {
+    LOG_WARN("invalid log entry size. size=%ld, max_payload_size=%d", data.size(), LogEntry::max_payload_size());
+    return RC::INVALID_ARGUMENT;
   }
 
-  lock_guard guard(mutex_);
-  lsn = ++current_lsn_;
-  entry.set_lsn(lsn);
+  ASSERT(data_ != nullptr, "log entry buffer is not initialized");
+
+  const uint64_t size = LogHeader::SIZE + data.size();
+
+  // 一次原子加同时申请LSN和空间
+  const uint64_t flushed_pos = flushed_pos_.load();
+  const LSN      flushed_lsn = flushed_lsn_.load();
+  const uint64_t reserved    = reserved_.fetch_add((1ULL << POS_BITS) + size);
+
+  uint64_t count = 0;
+  uint64_t pos   = 0;
+  decode(reserved, flushed_pos, flushed_lsn, count, pos);
 
-  entries_.push_back(std::move(entry));
-  bytes_ += entry.total_size();
+  lsn = base_lsn_ + static_cast<LSN>(count) + 1;
+  wait_for_space(lsn, pos + size);
+
+  LogHeader header;
+  header.lsn       = lsn;
+  header.size      = static_cast<int32_t>(data.size());
+  header.module_id = module.index();
+  copy_in(pos, &header, LogHeader::SIZE);
+  copy_in(pos + LogHeader::SIZE, data.data(), data.size());
+
+  // 发布这条日志，刷盘线程看到槽位中的LSN后，就可以写这条日志了
+  Slot &slot = slots_[lsn % slot_num_];
+  slot.end.store(pos + size, memory_order_relaxed);
+  slot.lsn.store(lsn, memory_order_release);
   return RC::SUCCESS;
 }
 
-RC LogEntryBuffer::flush(LogFileWriter &writer, int &count)
+void LogEntryBuffer::wait_for_space(LSN lsn, uint64_t end)
+{
+  auto has_space = [this, lsn, end]() {
+    return end - flushed_pos_.load() <= capacity_ && static_cast<uint64_t>(lsn - flushed_lsn_.load()) <= slot_num_;
+  };
+
+  if (has_space()) {
+    return;
+  }
+
+  // 先增加等待者的数量再检查，刷盘线程先修改刷盘位置再检查等待者，这样不会丢失通知
+  space_waiters_.fetch_add(1);
+  {
+    unique_lock<mutex> guard(space_lock_);
+    space_cv_.wait(guard, has_space);
+  }
+  space_waiters_.fetch_sub(1);
+}
+
+void LogEntryBuffer::copy_in(uint64_t pos, const void *src, uint64_t size)
+{
+  const uint64_t offset = pos & (capacity_ - 1);
+  const uint64_t first  = min(size, capacity_ - offset);
+  memcpy(data_.get() + offset, src, first);
+  if (first < size) {
+    memcpy(data_.get(), static_cast<const char *>(src) + first, size - first);
+  }
+}
+
+RC LogEntryBuffer::flush(LogFileWriter &writer, int &count, int64_t &bytes)
 {
   count = 0;
+  bytes = 0;
 
-  while (entry_number() > 0) {
-    LogEntry entry;
-    {
-      lock_guard guard(mutex_);
-      if (entries_.empty()) {
-        break;
-      }
-
-      LogEntry &front_entry = entries_.front();
-      ASSERT(front_entry.lsn() > 0 && front_entry.payload_size() > 0, "invalid log entry");
-      entry = std::move(entries_.front());
-      ASSERT(entry.payload_size() > 0 && entry.lsn() > 0, "invalid log entry");
-      entries_.pop_front();
-      bytes_ -= entry.total_size();
+  // 找到已经复制完成的连续的日志，并且都可以写入当前文件
+  const LSN      first_lsn = flushed_lsn_.load() + 1;
+  const uint64_t start     = flushed_pos_.load();
+  LSN            last_lsn  = first_lsn - 1;
+  uint64_t       end       = start;
+  bool           file_full = false;
+  while (true) {
+    const LSN   lsn  = last_lsn + 1;
+    const Slot &slot = slots_[lsn % slot_num_];
+    if (slot.lsn.load(memory_order_acquire) != lsn) {
+      break;
     }
-    
-    RC rc = writer.write(entry);
-    if (OB_FAIL(rc)) {
-      lock_guard guard(mutex_);
-      entries_.emplace_front(std::move(entry));
-      LogEntry &front_entry = entries_.front();
-      ASSERT(front_entry.lsn() > 0 && front_entry.payload_size() > 0, "invalid log entry");
-      return rc;
-    } else {
-      ++count;
-      flushed_lsn_ = entry.lsn();
+    if (lsn > writer.end_lsn()) {
+      file_full = true;
+      break;
     }
+    end      = slot.end.load(memory_order_relaxed);
+    last_lsn = lsn;
   }
-  
-  return RC::SUCCESS;
+
+  if (last_lsn < first_lsn) {
+    return file_full ? RC::LOG_FILE_FULL : RC::SUCCESS;
+  }
+
+  // 缓冲区是环形的，这段日志可能分成两部分
+  const uint64_t offset = start & (capacity_ - 1);
+  const uint64_t length = end - start;
+  const uint64_t first  = min(length, capacity_ - offset);
+
+  struct iovec iov[2];
+  int          iovcnt = 1;
+  iov[0].iov_base     = data_.get() + offset;
+  iov[0].iov_len      = first;
+  if (first < length) {
+    iov[1].iov_base = data_.get();
+    iov[1].iov_len  = length - first;
+    iovcnt          = 2;
+  }
+
+  RC rc = writer.write(iov, iovcnt, first_lsn, last_lsn);
+  if (OB_SUCC(rc)) {
+    rc = writer.sync();
+  }
+  if (OB_FAIL(rc)) {
+    // 日志还在缓冲区中，下次再写。与单条写入一样，没有处理只写入一部分的情况
+    return rc;
+  }
+
+  flushed_pos_.store(end);
+  flushed_lsn_.store(last_lsn);
+  if (space_waiters_.load() > 0) {
+    lock_guard<mutex> guard(space_lock_);
+    space_cv_.notify_all();
+  }
+
+  count = static_cast<int>(last_lsn - first_lsn + 1);
+  bytes = static_cast<int64_t>(length);
+  return file_full ? RC::LOG_FILE_FULL : RC::SUCCESS;
 }
 
 int64_t LogEntryBuffer::bytes() const
 {
-  return bytes_.load();
+  const uint64_t flushed_pos = flushed_pos_.load();
+  const LSN      flushed_lsn = flushed_lsn_.load();
+  uint64_t       count       = 0;
+  uint64_t       pos         = 0;
+  decode(reserved_.load(), flushed_pos, flushed_lsn, count, pos);
+  return static_cast<int64_t>(pos - flushed_pos);
 }
 
 int32_t LogEntryBuffer::entry_number() const
 {
-  return entries_.size();
+  const uint64_t flushed_pos = flushed_pos_.load();
+  const LSN      flushed_lsn = flushed_lsn_.load();
+  uint64_t       count       = 0;
+  uint64_t       pos         = 0;
+  decode(reserved_.load(), flushed_pos, flushed_lsn, count, pos);
+  return static_cast<int32_t>(base_lsn_ + static_cast<LSN>(count) - flushed_lsn);
+}
+
+LSN LogEntryBuffer::current_lsn() const
+{
+  const uint64_t flushed_pos = flushed_pos_.load();
+  const LSN      flushed_lsn = flushed_lsn_.load();
+  uint64_t       count       = 0;
+  uint64_t       pos         = 0;
+  decode(reserved_.load(), flushed_pos, flushed_lsn, count, pos);
+  return base_lsn_ + static_cast<LSN>(count);
 }
@@ -17,8 +17,9 @@ See the Mulan PSL v2 for more details. */
 #include "common/rc.h"
 #include "common/types.h"
 #include "common/lang/mutex.h"
+#include "common/lang/memory.h"
+#include "common/lang/span.h"
 #include "common/lang/vector.h"
-#include "common/lang/deque.h"
 #include "common/lang/atomic.h"
 #include "storage/clog/log_module.h"
 #include "storage/clog/log_entry.h"
@@ -29,8 +30,17 @@ class LogFileWriter;
  * @brief 日志数据缓冲区
  * @ingroup CLog
  * @details 缓存一部分日志在内存中而不是直接写入磁盘。
- * 这里的缓存没有考虑高性能操作，比如使用预分配内存、环形缓冲池等。
- * 在生产数据库中，通常会使用预分配内存形式的缓存来提高性能，并且可以减少内存碎片。
+ * 缓冲区是一块预先分配的环形内存，日志按照LSN的顺序依次存放，格式与日志文件中的格式相同(日志头+数据)。
+ * 写日志的线程通过一次原子加(fetch_add)同时申请LSN和缓冲区中的一段空间，然后直接把日志复制到缓冲区中，
+ * 不需要加锁，也不需要为每条日志分配内存。多个线程可以并行地复制日志。
+ * 复制完成后，在LSN对应的槽位中记录日志的结束位置。刷盘线程从已经刷盘的位置开始，
+ * 找到复制完成的最长的连续日志，作为一段连续的内存写入文件。
+ *
+ * 申请空间使用的原子变量是一个64位整数，高 64-POS_BITS 位是日志条数，低 POS_BITS 位是字节数，
+ * 每次加上 (1 << POS_BITS) + 日志大小。字节数会向日志条数进位，所以两部分都只能得到取模后的值，
+ * 需要借助已经刷盘的位置还原：没有刷盘的日志字节数不会超过 2^POS_BITS，条数也不会超过 2^(64-POS_BITS)。
+ *
+ * 缓冲区满时，写日志的线程需要等待刷盘线程腾出空间。
  */
 class LogEntryBuffer
 {
@@ -38,42 +48,82 @@ public:
   LogEntryBuffer()  = default;
   ~LogEntryBuffer() = default;
 
-  RC init(LSN lsn, int32_t max_bytes = 0);
+  /**
+   * @brief 初始化缓冲区
+   * @param lsn 当前最大的LSN，新的日志从 lsn+1 开始
+   * @param max_bytes 缓冲区大小，会向上取整到2的幂，并且至少能放下两条最大的日志
+   */
+  RC init(LSN lsn, int64_t max_bytes = 0);
 
   /**
    * @brief 在缓冲区中追加一条日志
    */
-  RC append(LSN &lsn, LogModule::Id module_id, vector<char> &&data);
-  RC append(LSN &lsn, LogModule module, vector<char> &&data);
+  RC append(LSN &lsn, LogModule::Id module_id, span<const char> data);
+  RC append(LSN &lsn, LogModule module, span<const char> data);
 
   /**
    * @brief 刷新缓冲区中的日志到磁盘
-   *
-   * @param file_handle 使用它来写文件
+   * @details 把缓冲区中所有能写入当前文件的日志作为一批，只写一次文件、刷一次盘。
+   * 如果还有日志需要写到下一个文件中，返回 LOG_FILE_FULL。
+   * 同一时间只能有一个线程调用。
+   * @param file_writer 使用它来写文件
    * @param count 刷了多少条日志
+   * @param bytes 刷了多少字节
    */
-  RC flush(LogFileWriter &file_writer, int &count);
+  RC flush(LogFileWriter &file_writer, int &count, int64_t &bytes);
 
   /**
-   * @brief 当前缓冲区中有多少字节的日志
+   * @brief 当前缓冲区中有多少字节的日志，包括正在复制的日志
    */
   int64_t bytes() const;
 
   /**
-   * @brief 当前缓冲区中有多少条日志
+   * @brief 当前缓冲区中有多少条日志，包括正在复制的日志
    */
   int32_t entry_number() const;
 
-  LSN current_lsn() const { return current_lsn_.load(); }
+  LSN current_lsn() const;
   LSN flushed_lsn() const { return flushed_lsn_.load(); }
 
 private:
-  mutex           mutex_;  /// 当前数据结构一定会在多线程中访问，所以强制使用有效的锁，而不是有条件生效的common::Mutex
-  deque<LogEntry> entries_;  /// 日志缓冲区
-  atomic<int64_t> bytes_;    /// 当前缓冲区中的日志数据大小
+  /// 申请空间的原子变量中，字节数占用的位数
+  static constexpr int      POS_BITS = 40;
+  static constexpr uint64_t POS_MASK = (1ULL << POS_BITS) - 1;
+
+  /**
+   * @brief 从申请空间的原子变量中还原出日志条数和字节数，都是相对于 init 时的值
+   * @details flushed_pos 和 flushed_lsn 必须在读取 reserved 之前读取，保证它们不会超过 reserved 中的值
+   */
+  void decode(uint64_t reserved, uint64_t flushed_pos, LSN flushed_lsn, uint64_t &count, uint64_t &pos) const;
+
+  /// @brief 等待缓冲区中有足够的空间存放这条日志，end 是日志的结束位置
+  void wait_for_space(LSN lsn, uint64_t end);
+
+  /// @brief 把数据复制到缓冲区的 pos 位置，可能会绕回到缓冲区开头
+  void copy_in(uint64_t pos, const void *src, uint64_t size);
+
+private:
+  unique_ptr<char[]> data_;           /// 环形缓冲区
+  uint64_t           capacity_ = 0;   /// 缓冲区大小，是2的幂
+  LSN                base_lsn_ = 0;   /// init 时的LSN
+
+  /// 每条日志复制完成后，在 lsn % slot_num_ 的位置记录LSN和结束位置
+  struct Slot
+  {
+    atomic<LSN>      lsn{0};
+    atomic<uint64_t> end{0};
+  };
+  unique_ptr<Slot[]> slots_;
+  uint64_t           slot_num_ = 0;
+
+  atomic<uint64_t> reserved_{0};     /// 已经申请的日志条数和字节数
+  atomic<uint64_t> flushed_pos_{0};  /// 已经刷盘的字节数
+  atomic<LSN>      flushed_lsn_{0};
 
-  atomic<LSN> current_lsn_{0};
-  atomic<LSN> flushed_lsn_{0};
+  /// 缓冲区满时，写日志的线程在这里等待
+  mutex              space_lock_;
+  condition_variable space_cv_;
+  atomic<int32_t>    space_waiters_{0};
 
-  int32_t max_bytes_ = 4 * 1024 * 1024;  /// 缓冲区最大字节数
+  int64_t max_bytes_ = 4 * 1024 * 1024;  /// 缓冲区最大字节数
 };
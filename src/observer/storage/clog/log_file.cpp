@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <fcntl.h>
+#include <sys/uio.h>
 
 #include "common/lang/string_view.h"
 #include "common/lang/charconv.h"
@@ -155,7 +156,8 @@ RC LogFileWriter::open(const char *filename, int end_lsn)
   filename_ = filename;
   end_lsn_ = end_lsn;
 
-  fd_ = ::open(filename, O_WRONLY | O_APPEND | O_CREAT | O_SYNC, 0644);
+  // 不使用O_SYNC，每批日志写完后统一调用sync，这样多个事务的提交只需要一次刷盘
+  fd_ = ::open(filename, O_WRONLY | O_APPEND | O_CREAT, 0644);
   if (fd_ < 0) {
     LOG_WARN("open file failed. filename=%s, error=%s", filename, strerror(errno));
     return RC::FILE_OPEN;
@@ -214,6 +216,48 @@ RC LogFileWriter::write(LogEntry &entry)
   return RC::SUCCESS;
 }
 
+RC LogFileWriter::write(struct iovec *iov, int iovcnt, LSN first_lsn, LSN last_lsn)
+{
+  if (fd_ < 0) {
+    return RC::FILE_NOT_OPENED;
+  }
+
+  if (last_lsn > end_lsn_) {
+    return RC::LOG_FILE_FULL;
+  }
+
+  if (first_lsn <= last_lsn_) {
+    LOG_WARN("write log entries failed. lsn is too small. filename=%s, last_lsn=%ld, first_lsn=%ld",
+             filename_.c_str(), last_lsn_, first_lsn);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  /// WARNING 与单条写入一样，这里也没有处理只写入一部分的情况
+  int ret = writevn(fd_, iov, iovcnt);
+  if (0 != ret) {
+    LOG_WARN("write log entries failed. filename=%s, ret = %d, error=%s, lsn=[%ld, %ld]",
+             filename_.c_str(), ret, strerror(ret), first_lsn, last_lsn);
+    return RC::IOERR_WRITE;
+  }
+
+  last_lsn_ = last_lsn;
+  LOG_TRACE("write log entries success. filename=%s, lsn=[%ld, %ld]", filename_.c_str(), first_lsn, last_lsn);
+  return RC::SUCCESS;
+}
+
+RC LogFileWriter::sync()
+{
+  if (fd_ < 0) {
+    return RC::FILE_NOT_OPENED;
+  }
+
+  if (0 != ::fdatasync(fd_)) {
+    LOG_WARN("sync log file failed. filename=%s, error=%s", filename_.c_str(), strerror(errno));
+    return RC::IOERR_SYNC;
+  }
+  return RC::SUCCESS;
+}
+
 bool LogFileWriter::valid() const
 {
   return fd_ >= 0;
@@ -298,6 +342,7 @@ RC LogFileManager::list_files(vector<string> &files, LSN start_lsn)
 {
   files.clear();
 
+  lock_guard<mutex> guard(lock_);
   // 这里的代码是AI自动生成的
   // 其实写的不好，我们只需要找到比start_lsn相等或者小的第一个日志文件就可以了
   for (auto &file : log_files_) {
@@ -311,7 +356,9 @@ RC LogFileManager::list_files(vector<string> &files, LSN start_lsn)
 
 RC LogFileManager::last_file(LogFileWriter &file_writer)
 {
+  unique_lock<mutex> guard(lock_);
   if (log_files_.empty()) {
+    guard.unlock();
     return next_file(file_writer);
   }
 
@@ -326,6 +373,7 @@ RC LogFileManager::next_file(LogFileWriter &file_writer)
 {
   file_writer.close();
 
+  lock_guard<mutex> guard(lock_);
   LSN lsn = 0;
   if (!log_files_.empty()) {
     lsn = log_files_.rbegin()->first + max_entry_number_per_file_;
@@ -337,3 +385,26 @@ RC LogFileManager::next_file(LogFileWriter &file_writer)
 
   return file_writer.open(file_path.c_str(), lsn + max_entry_number_per_file_ - 1);
 }
+
+RC LogFileManager::remove_files_before(LSN lsn)
+{
+  lock_guard<mutex> guard(lock_);
+
+  while (log_files_.size() > 1) {
+    auto iter = log_files_.begin();
+    if (iter->first + max_entry_number_per_file_ - 1 >= lsn) {
+      break;
+    }
+
+    error_code ec;
+    filesystem::remove(iter->second, ec);
+    if (ec) {
+      LOG_WARN("failed to remove clog file. file=%s, error=%s", iter->second.c_str(), ec.message().c_str());
+      return RC::IOERR_ACCESS;
+    }
+
+    LOG_INFO("remove clog file %s, checkpoint lsn=%ld", iter->second.c_str(), lsn);
+    log_files_.erase(iter);
+  }
+  return RC::SUCCESS;
+}
@@ -17,12 +17,14 @@ See the Mulan PSL v2 for more details. */
 #include "common/rc.h"
 #include "common/types.h"
 #include "common/lang/map.h"
+#include "common/lang/mutex.h"
 #include "common/lang/functional.h"
 #include "common/lang/filesystem.h"
 #include "common/lang/fstream.h"
 #include "common/lang/string.h"
 
 class LogEntry;
+struct iovec;
 
 /**
  * @brief 负责处理一个日志文件，包括读取和写入
@@ -76,6 +78,17 @@ public:
   /// @brief 写入一条日志
   RC write(LogEntry &entry);
 
+  /**
+   * @brief 写入一段连续的日志数据
+   * @details 数据由若干条完整的日志组成，LSN从first_lsn到last_lsn连续递增，并且都不超过end_lsn。
+   * 日志缓冲区是环形的，一段日志可能分成两部分，所以使用iovec。
+   * 写入后数据不一定已经持久化，需要调用sync。
+   */
+  RC write(struct iovec *iov, int iovcnt, LSN first_lsn, LSN last_lsn);
+
+  /// @brief 把写入的数据持久化到磁盘
+  RC sync();
+
   /**
    * @brief 当前文件是否已经打开
    */
@@ -90,11 +103,14 @@ public:
 
   const char *filename() const { return filename_.c_str(); }
 
+  /// @brief 当前文件允许写入的最大LSN
+  LSN end_lsn() const { return end_lsn_; }
+
 private:
   string filename_;       /// 日志文件名
   int    fd_       = -1;  /// 日志文件描述符
-  int    last_lsn_ = 0;   /// 写入的最后一条日志LSN
-  int    end_lsn_  = 0;   /// 当前日志文件中允许写入的最大的LSN，包括这条日志
+  LSN    last_lsn_ = 0;   /// 写入的最后一条日志LSN
+  LSN    end_lsn_  = 0;   /// 当前日志文件中允许写入的最大的LSN，包括这条日志
 };
 
 /**
@@ -137,6 +153,12 @@ public:
    */
   RC next_file(LogFileWriter &file_writer);
 
+  /**
+   * @brief 删除所有日志都小于 lsn 的日志文件
+   * @details 最后一个日志文件可能正在写入，不会删除
+   */
+  RC remove_files_before(LSN lsn);
+
 private:
   /**
    * @brief 从文件名称中获取LSN
@@ -151,5 +173,6 @@ private:
   filesystem::path directory_;                  /// 日志文件存放的目录
   int              max_entry_number_per_file_;  /// 一个文件最大允许存放多少条日志
 
+  mutex                      lock_;       /// 刷日志的线程和做检查点的线程都会访问 log_files_
   map<LSN, filesystem::path> log_files_;  /// 日志文件名和第一个LSN的映射
 };
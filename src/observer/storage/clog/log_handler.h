@@ -96,12 +96,19 @@ public:
 
   virtual LSN current_lsn() const = 0;
 
+  /**
+   * @brief 删除不再需要的日志
+   * @details 做完检查点后调用，回放时只会从检查点开始，所有日志都小于 lsn 的日志文件可以删除
+   * @param lsn 检查点的LSN
+   */
+  virtual RC remove_logs_before(LSN lsn) = 0;
+
   static RC create(const char *name, LogHandler *&handler);
 
 private:
   /**
    * @brief 写入一条日志
-   * @details 子类应该重现实现这个函数
+   * @details 子类应该重现实现这个函数。子类需要在返回前复制数据
    */
-  virtual RC _append(LSN &lsn, LogModule module, vector<char> &&data) = 0;
+  virtual RC _append(LSN &lsn, LogModule module, span<const char> data) = 0;
 };
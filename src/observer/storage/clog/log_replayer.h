@@ -16,9 +16,40 @@ See the Mulan PSL v2 for more details. */
 
 #include <string>
 #include "common/rc.h"
+#include "common/types.h"
 
 class LogEntry;
 
+/**
+ * @brief 并行回放时，一条日志的回放方式
+ * @ingroup CLog
+ * @details 并行回放时，日志按照 key 分配给不同的线程，相同 key 的日志由同一个线程按照LSN的顺序回放。
+ * key 通常由 buffer pool id 和页面编号组成，这样同一个页面上的修改顺序与原来是一样的。
+ */
+struct LogReplayScope
+{
+  enum class Type
+  {
+    GLOBAL,     ///< 可能访问任意的数据，需要等前面所有的日志都回放完成后再回放。这是默认的方式
+    PARTITION,  ///< 只访问 key 对应的数据，不同 key 的日志可以并行回放
+    LOCAL,      ///< 不访问页面，只修改回放器自己的内存状态，可以直接回放，不用等前面的日志
+  };
+
+  Type     type = Type::GLOBAL;
+  uint64_t key  = 0;
+
+  static LogReplayScope global() { return LogReplayScope{Type::GLOBAL, 0}; }
+  static LogReplayScope local() { return LogReplayScope{Type::LOCAL, 0}; }
+  static LogReplayScope partition(uint64_t key) { return LogReplayScope{Type::PARTITION, key}; }
+
+  /// @brief 使用 buffer pool id 和页面编号作为 key
+  static LogReplayScope page(int32_t buffer_pool_id, PageNum page_num)
+  {
+    return partition((static_cast<uint64_t>(static_cast<uint32_t>(buffer_pool_id)) << 32) |
+                     static_cast<uint32_t>(page_num));
+  }
+};
+
 /**
  * @brief 日志回放接口类
  * @ingroup CLog
@@ -36,6 +67,13 @@ public:
    */
   virtual RC replay(const LogEntry &entry) = 0;
 
+  /**
+   * @brief 并行回放时，这条日志的回放方式
+   * @details 默认等前面的日志都回放完再回放，是最安全的方式。
+   * 返回 PARTITION 或 LOCAL 时，replay 函数需要能够被多个线程同时调用。
+   */
+  virtual LogReplayScope scope(const LogEntry &entry) const { return LogReplayScope::global(); }
+
   /**
    * @brief 当所有日志回放完成时的回调函数
    */
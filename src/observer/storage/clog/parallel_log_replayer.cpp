@@ -0,0 +1,202 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/26.
+//
+
+#include "storage/clog/parallel_log_replayer.h"
+#include "common/log/log.h"
+#include "common/thread/thread_util.h"
+
+using namespace common;
+
+ParallelLogReplayer::ParallelLogReplayer(LogReplayer &replayer, int thread_num) : replayer_(replayer)
+{
+#ifndef CONCURRENCY
+  if (thread_num > 1) {
+    LOG_INFO("replay log serially because buffer pool latches do nothing without CONCURRENCY");
+  }
+  thread_num = 0;
+#endif
+
+  if (thread_num <= 1) {
+    return;
+  }
+
+  for (int i = 0; i < thread_num; i++) {
+    workers_.emplace_back(make_unique<Worker>());
+  }
+  for (auto &worker : workers_) {
+    worker->worker_thread = make_unique<thread>(&ParallelLogReplayer::worker_func, this, std::ref(*worker));
+  }
+  LOG_INFO("parallel log replayer started. threads=%d", thread_num);
+}
+
+ParallelLogReplayer::~ParallelLogReplayer() { stop(); }
+
+RC ParallelLogReplayer::replay(const LogEntry &entry)
+{
+  if (workers_.empty()) {
+    return replayer_.replay(entry);
+  }
+
+  RC rc = error();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  LogReplayScope scope = replayer_.scope(entry);
+  switch (scope.type) {
+    case LogReplayScope::Type::LOCAL: {
+      local_count_++;
+      return replayer_.replay(entry);
+    }
+
+    case LogReplayScope::Type::PARTITION: {
+      partition_count_++;
+      break;
+    }
+
+    default: {
+      global_count_++;
+      rc = wait_idle();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      return replayer_.replay(entry);
+    }
+  }
+
+  // 回放日志的时候，参数中的日志对象随时会被释放，所以复制一份
+  LogEntry entry_copy;
+  rc = entry_copy.init(entry.lsn(), entry.module(), vector<char>(entry.data(), entry.data() + entry.payload_size()));
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to copy log entry. entry=%s, rc=%s", entry.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  // key 通常是连续的页面编号，打散一下再分配给线程
+  const uint64_t hash   = (scope.key * 0x9E3779B97F4A7C15ULL) >> 32;
+  Worker        &worker = *workers_[hash % workers_.size()];
+
+  pending_.fetch_add(1);
+  worker.dispatching.emplace_back(std::move(entry_copy));
+  if (worker.dispatching.size() >= BATCH_SIZE) {
+    submit(worker);
+  }
+  return RC::SUCCESS;
+}
+
+void ParallelLogReplayer::submit(Worker &worker)
+{
+  if (worker.dispatching.empty()) {
+    return;
+  }
+
+  {
+    unique_lock<mutex> guard(worker.lock);
+    worker.not_full.wait(guard, [&worker]() { return worker.batches.size() < MAX_QUEUED_BATCHES; });
+    worker.batches.emplace_back(std::move(worker.dispatching));
+  }
+  worker.not_empty.notify_one();
+
+  worker.dispatching.clear();
+  worker.dispatching.reserve(BATCH_SIZE);
+}
+
+RC ParallelLogReplayer::on_done()
+{
+  const int thread_num = this->thread_num();
+
+  RC rc = wait_idle();
+  stop();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to replay logs in parallel. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (partition_count_ + global_count_ + local_count_ > 0) {
+    LOG_INFO("parallel log replay done. threads=%d, partition entries=%ld, global entries=%ld, local entries=%ld",
+             thread_num, partition_count_, global_count_, local_count_);
+  }
+  return replayer_.on_done();
+}
+
+void ParallelLogReplayer::worker_func(Worker &worker)
+{
+  thread_set_name("LogReplayer");
+
+  while (true) {
+    vector<LogEntry> batch;
+    {
+      unique_lock<mutex> guard(worker.lock);
+      worker.not_empty.wait(guard, [&worker]() { return worker.stopping || !worker.batches.empty(); });
+      if (worker.batches.empty()) {
+        break;
+      }
+      batch = std::move(worker.batches.front());
+      worker.batches.pop_front();
+    }
+    worker.not_full.notify_one();
+
+    // 出错后不再回放，但是还要继续取出日志，让等待的线程可以结束
+    for (LogEntry &entry : batch) {
+      if (OB_FAIL(error())) {
+        break;
+      }
+
+      RC rc = replayer_.replay(entry);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to replay log entry. entry=%s, rc=%s", entry.to_string().c_str(), strrc(rc));
+        RC expected = RC::SUCCESS;
+        error_.compare_exchange_strong(expected, rc);
+      }
+    }
+
+    const int64_t batch_size = static_cast<int64_t>(batch.size());
+    if (pending_.fetch_sub(batch_size) == batch_size) {
+      lock_guard<mutex> guard(idle_lock_);
+      idle_cv_.notify_all();
+    }
+  }
+}
+
+RC ParallelLogReplayer::wait_idle()
+{
+  for (auto &worker : workers_) {
+    submit(*worker);
+  }
+
+  if (pending_.load() > 0) {
+    unique_lock<mutex> guard(idle_lock_);
+    idle_cv_.wait(guard, [this]() { return pending_.load() == 0; });
+  }
+  return error();
+}
+
+void ParallelLogReplayer::stop()
+{
+  for (auto &worker : workers_) {
+    {
+      lock_guard<mutex> guard(worker->lock);
+      worker->stopping = true;
+    }
+    worker->not_empty.notify_all();
+  }
+
+  for (auto &worker : workers_) {
+    if (worker->worker_thread) {
+      worker->worker_thread->join();
+      worker->worker_thread.reset();
+    }
+  }
+  workers_.clear();
+}
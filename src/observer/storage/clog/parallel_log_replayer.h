@@ -0,0 +1,104 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/26.
+//
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/atomic.h"
+#include "common/lang/deque.h"
+#include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/thread.h"
+#include "common/lang/vector.h"
+#include "storage/clog/log_entry.h"
+#include "storage/clog/log_replayer.h"
+
+/**
+ * @brief 并行回放日志
+ * @ingroup CLog
+ * @details 包装另一个回放器，根据 LogReplayer::scope 把日志分给多个线程回放。
+ * - PARTITION 日志按照 key 分配到固定的线程，每个线程按照收到的顺序回放，所以同一个页面上的日志仍然按照LSN的顺序回放；
+ * - GLOBAL 日志等所有线程把前面的日志都回放完，再在调用 replay 的线程中回放；
+ * - LOCAL 日志直接在调用 replay 的线程中回放。
+ *
+ * 线程数不大于1时，所有日志都直接交给被包装的回放器，与串行回放完全相同。
+ * 非并发编译(没有定义CONCURRENCY)时缓冲池的锁不生效，总是串行回放。
+ */
+class ParallelLogReplayer final : public LogReplayer
+{
+public:
+  /// 分发日志时攒够这么多条再交给回放线程，减少线程间同步的次数
+  static constexpr int BATCH_SIZE = 64;
+
+  /// 每个线程最多缓存的批次数，超过时分发日志的线程需要等待
+  static constexpr int MAX_QUEUED_BATCHES = 64;
+
+public:
+  ParallelLogReplayer(LogReplayer &replayer, int thread_num);
+  virtual ~ParallelLogReplayer();
+
+  //! @copydoc LogReplayer::replay
+  RC replay(const LogEntry &entry) override;
+
+  /**
+   * @brief 等待所有日志回放完成并停止回放线程，然后调用被包装的回放器的 on_done
+   */
+  RC on_done() override;
+
+  int thread_num() const { return static_cast<int>(workers_.size()); }
+
+private:
+  /**
+   * @brief 一个回放线程
+   */
+  struct Worker
+  {
+    mutex                   lock;
+    condition_variable      not_empty;
+    condition_variable      not_full;
+    deque<vector<LogEntry>> batches;
+    bool                    stopping = false;
+    unique_ptr<thread>      worker_thread;
+
+    vector<LogEntry> dispatching;  ///< 分发线程正在攒的一批日志，只有分发线程访问
+  };
+
+  void worker_func(Worker &worker);
+
+  /// @brief 把攒的一批日志交给回放线程
+  void submit(Worker &worker);
+
+  /// @brief 等待已经分发的日志都回放完成
+  RC wait_idle();
+
+  /// @brief 停止所有回放线程
+  void stop();
+
+  /// @brief 第一个回放失败的错误码
+  RC error() const { return error_.load(); }
+
+private:
+  LogReplayer &replayer_;
+
+  vector<unique_ptr<Worker>> workers_;
+
+  atomic<int64_t>    pending_{0};  ///< 已经分发但是还没有回放完成的日志数
+  mutex              idle_lock_;
+  condition_variable idle_cv_;
+  atomic<RC>         error_{RC::SUCCESS};
+
+  int64_t partition_count_ = 0;  ///< 并行回放的日志数
+  int64_t global_count_    = 0;  ///< 需要等待前面的日志都回放完成的日志数
+  int64_t local_count_     = 0;  ///< 直接回放的日志数
+};
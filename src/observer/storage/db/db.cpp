@@ -19,21 +19,33 @@ See the Mulan PSL v2 for more details. */
 #include <vector>
 #include <filesystem>
 
+#include "common/conf/ini.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/chrono.h"
+#include "common/lang/limits.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/os/path.h"
 #include "common/global_context.h"
+#include "common/ini_setting.h"
 #include "storage/common/meta_util.h"
 #include "storage/table/table.h"
 #include "storage/table/table_meta.h"
 #include "storage/trx/trx.h"
 #include "storage/clog/disk_log_handler.h"
 #include "storage/clog/integrated_log_replayer.h"
+#include "storage/clog/parallel_log_replayer.h"
 
 using namespace common;
 
 Db::~Db()
 {
+  stop_checkpoint_thread();
+
+  if (buffer_pool_manager_) {
+    buffer_pool_manager_->stop_page_cleaner();
+  }
+
   for (auto &iter : opened_tables_) {
     delete iter.second;
   }
@@ -69,8 +81,19 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
 
   trx_kit_.reset(trx_kit);
 
-  buffer_pool_manager_ = make_unique<BufferPoolManager>();
-  auto dblwr_buffer    = make_unique<DiskDoubleWriteBuffer>(*buffer_pool_manager_);
+  string eviction_policy =
+      get_properties()->get(BUFFER_POOL_EVICTION_POLICY, BUFFER_POOL_EVICTION_POLICY_DEFAULT, BUFFER_POOL);
+  string io_engine = get_properties()->get(BUFFER_POOL_IO_ENGINE, BUFFER_POOL_IO_ENGINE_DEFAULT, BUFFER_POOL);
+  buffer_pool_manager_ =
+      make_unique<BufferPoolManager>(0 /*memory_size*/, eviction_policy.c_str(), io_engine.c_str());
+  int    read_ahead_pages     = BUFFER_POOL_READ_AHEAD_PAGES_DEFAULT;
+  string read_ahead_pages_str = get_properties()->get(BUFFER_POOL_READ_AHEAD_PAGES, "", BUFFER_POOL);
+  if (!read_ahead_pages_str.empty()) {
+    str_to_val(read_ahead_pages_str, read_ahead_pages);
+  }
+  buffer_pool_manager_->set_read_ahead_pages(read_ahead_pages);
+
+  auto dblwr_buffer = make_unique<DiskDoubleWriteBuffer>(*buffer_pool_manager_);
 
   const char      *double_write_buffer_filename  = "dblwr.db";
   filesystem::path double_write_buffer_file_path = filesystem::path(dbpath) / double_write_buffer_filename;
@@ -133,6 +156,40 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
     return rc;
   }
 
+  // 日志回放完成后再启动后台刷脏页，启动失败不影响数据库的使用
+  PageCleanerOptions page_cleaner_options;
+  auto load_page_cleaner_option = [](const char *key, int &value) {
+    string value_str = get_properties()->get(key, "", BUFFER_POOL);
+    if (!value_str.empty()) {
+      str_to_val(value_str, value);
+    }
+  };
+  load_page_cleaner_option(BUFFER_POOL_DIRTY_HIGH_WATERMARK, page_cleaner_options.high_watermark);
+  load_page_cleaner_option(BUFFER_POOL_DIRTY_LOW_WATERMARK, page_cleaner_options.low_watermark);
+  load_page_cleaner_option(BUFFER_POOL_PAGE_CLEANER_INTERVAL_MS, page_cleaner_options.interval_ms);
+  RC cleaner_rc = buffer_pool_manager_->start_page_cleaner(page_cleaner_options);
+  if (OB_FAIL(cleaner_rc)) {
+    LOG_INFO("page cleaner is not started. rc=%s", strrc(cleaner_rc));
+  }
+
+  string fill_factor_str = get_properties()->get(INDEX_BULK_LOAD_FILL_FACTOR, "", INDEX_SECTION);
+  if (!fill_factor_str.empty()) {
+    str_to_val(fill_factor_str, index_bulk_load_options_.fill_factor);
+  }
+  string sort_memory_mb_str = get_properties()->get(INDEX_BULK_LOAD_SORT_MEMORY_MB, "", INDEX_SECTION);
+  if (!sort_memory_mb_str.empty()) {
+    int64_t sort_memory_mb = 0;
+    str_to_val(sort_memory_mb_str, sort_memory_mb);
+    index_bulk_load_options_.sort_memory_bytes = max<int64_t>(sort_memory_mb, 1) * 1024 * 1024;
+  }
+
+  int    checkpoint_interval_sec     = CLOG_CHECKPOINT_INTERVAL_SEC_DEFAULT;
+  string checkpoint_interval_sec_str = get_properties()->get(CLOG_CHECKPOINT_INTERVAL_SEC, "", CLOG);
+  if (!checkpoint_interval_sec_str.empty()) {
+    str_to_val(checkpoint_interval_sec_str, checkpoint_interval_sec);
+  }
+  start_checkpoint_thread(checkpoint_interval_sec);
+
   return rc;
 }
 
@@ -285,8 +342,7 @@ RC Db::sync()
     return rc;
   }
 
-  check_point_lsn_ = current_lsn;
-  rc               = flush_meta();
+  rc = advance_check_point(current_lsn);
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to flush meta. db=%s, rc=%d:%s", name_.c_str(), rc, strrc(rc));
     return rc;
@@ -295,6 +351,117 @@ RC Db::sync()
   return rc;
 }
 
+RC Db::checkpoint()
+{
+  // 先取当前LSN，再看脏页和事务。之后才修改的页面和开始的事务，它们的日志一定比这个LSN大
+  LSN check_point_lsn = log_handler_->current_lsn();
+
+  // 有后台刷脏页时，把上次检查点之前就已经脏了的页面刷下去，否则一直不淘汰的热点页面会让检查点无法推进。
+  // 没有后台刷脏页时(非并发编译)，不能在这个线程中读页面，只能依靠淘汰页面或sync推进检查点
+  if (buffer_pool_manager_->page_cleaner_running() && last_checkpoint_current_lsn_ > 0) {
+    int flushed_pages = 0;
+    RC  rc            = buffer_pool_manager_->clean_dirty_pages(
+        numeric_limits<int>::max(), flushed_pages, last_checkpoint_current_lsn_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to flush old dirty pages before checkpoint. rc=%s", strrc(rc));
+    }
+  }
+  last_checkpoint_current_lsn_ = check_point_lsn;
+
+  const LSN page_lsn = buffer_pool_manager_->get_frame_manager().min_rec_lsn();
+  if (page_lsn > 0 && page_lsn < check_point_lsn) {
+    check_point_lsn = page_lsn;
+  }
+
+  const LSN trx_lsn = trx_kit_->min_active_trx_lsn();
+  if (trx_lsn > 0 && trx_lsn < check_point_lsn) {
+    check_point_lsn = trx_lsn;
+  }
+
+  if (check_point_lsn <= 0) {
+    return RC::SUCCESS;
+  }
+
+  // 回放时要从检查点这条日志开始，它必须已经在磁盘上
+  RC rc = log_handler_->wait_lsn(check_point_lsn);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to wait lsn. lsn=%ld, rc=%s", check_point_lsn, strrc(rc));
+    return rc;
+  }
+
+  return advance_check_point(check_point_lsn);
+}
+
+RC Db::advance_check_point(LSN lsn)
+{
+  lock_guard<mutex> guard(check_point_lock_);
+  if (lsn <= check_point_lsn_) {
+    return RC::SUCCESS;
+  }
+
+  const LSN old_check_point_lsn = check_point_lsn_;
+  check_point_lsn_              = lsn;
+  RC rc                         = flush_meta();
+  if (OB_FAIL(rc)) {
+    check_point_lsn_ = old_check_point_lsn;
+    return rc;
+  }
+
+  // 元数据落盘之后，检查点之前的日志就不会再用到了
+  rc = log_handler_->remove_logs_before(lsn);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to remove logs before checkpoint. lsn=%ld, rc=%s", lsn, strrc(rc));
+  }
+  return RC::SUCCESS;
+}
+
+void Db::start_checkpoint_thread(int interval_sec)
+{
+  if (interval_sec <= 0) {
+    LOG_INFO("periodic checkpoint is disabled. db=%s", name_.c_str());
+    return;
+  }
+
+  checkpoint_running_ = true;
+  checkpoint_thread_  = make_unique<thread>(&Db::checkpoint_thread_func, this, interval_sec);
+  LOG_INFO("checkpoint thread started. db=%s, interval=%ds", name_.c_str(), interval_sec);
+}
+
+void Db::stop_checkpoint_thread()
+{
+  if (!checkpoint_thread_) {
+    return;
+  }
+
+  {
+    lock_guard<mutex> guard(checkpoint_thread_lock_);
+    checkpoint_running_ = false;
+  }
+  checkpoint_thread_cv_.notify_all();
+
+  checkpoint_thread_->join();
+  checkpoint_thread_.reset();
+  LOG_INFO("checkpoint thread stopped. db=%s", name_.c_str());
+}
+
+void Db::checkpoint_thread_func(int interval_sec)
+{
+  while (true) {
+    {
+      unique_lock<mutex> guard(checkpoint_thread_lock_);
+      checkpoint_thread_cv_.wait_for(guard, chrono::seconds(interval_sec), [this]() { return !checkpoint_running_; });
+      if (!checkpoint_running_) {
+        break;
+      }
+    }
+
+    RC rc = checkpoint();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to do checkpoint. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    }
+  }
+}
+
 RC Db::recover()
 {
   LOG_TRACE("db recover begin. check_point_lsn=%d", check_point_lsn_);
@@ -305,7 +472,14 @@ RC Db::recover()
     return RC::INTERNAL;
   }
 
-  IntegratedLogReplayer log_replayer(*buffer_pool_manager_, unique_ptr<LogReplayer>(trx_log_replayer));
+  int    replay_thread_num     = CLOG_REPLAY_THREADS_DEFAULT;
+  string replay_thread_num_str = get_properties()->get(CLOG_REPLAY_THREADS, "", CLOG);
+  if (!replay_thread_num_str.empty()) {
+    str_to_val(replay_thread_num_str, replay_thread_num);
+  }
+
+  IntegratedLogReplayer integrated_replayer(*buffer_pool_manager_, unique_ptr<LogReplayer>(trx_log_replayer));
+  ParallelLogReplayer   log_replayer(integrated_replayer, replay_thread_num);
   RC                    rc = log_handler_->replay(log_replayer, check_point_lsn_ /*start_lsn*/);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to replay log. rc=%s", strrc(rc));
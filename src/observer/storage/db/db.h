@@ -19,11 +19,14 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "common/lang/unordered_map.h"
 #include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/thread.h"
 #include "common/lang/span.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/clog/disk_log_handler.h"
 #include "storage/buffer/double_write_buffer.h"
+#include "storage/index/bplus_tree_bulk_loader.h"
 
 class Table;
 class LogHandler;
@@ -88,6 +91,14 @@ public:
    */
   RC sync();
 
+  /**
+   * @brief 做一次模糊检查点
+   * @details 不需要刷新所有脏页，也不需要停止事务。检查点取所有脏页的 rec_lsn、所有活跃事务的第一条日志
+   * 以及当前LSN中最小的一个，恢复时从这里开始回放就可以了。检查点记录到元数据文件后，删除之前的日志文件。
+   * 检查点的位置取决于最老的脏页，开启后台刷脏页时，会先把上次检查点之前就脏了的页面刷下去。
+   */
+  RC checkpoint();
+
   /// @brief 获取当前数据库的日志处理器
   LogHandler &log_handler();
 
@@ -97,6 +108,9 @@ public:
   /// @brief 获取当前数据库的事务管理器
   TrxKit &trx_kit();
 
+  /// @brief 给已有数据的表创建索引时，批量构建B+树的参数
+  const BplusTreeBulkLoadOptions &index_bulk_load_options() const { return index_bulk_load_options_; }
+
 private:
   /// @brief 打开所有的表。在数据库初始化的时候会执行
   RC open_all_tables();
@@ -111,6 +125,17 @@ private:
   /// @brief 初始化数据库的double buffer pool
   RC init_dblwr_buffer();
 
+  /**
+   * @brief 记录新的检查点，并删除检查点之前的日志
+   * @details 检查点只会向前推进
+   */
+  RC advance_check_point(LSN lsn);
+
+  /// @brief 启动定期做检查点的线程
+  void start_checkpoint_thread(int interval_sec);
+  void stop_checkpoint_thread();
+  void checkpoint_thread_func(int interval_sec);
+
 private:
   string                         name_;                 ///< 数据库名称
   string                         path_;                 ///< 数据库文件存放的目录
@@ -118,9 +143,18 @@ private:
   unique_ptr<BufferPoolManager>  buffer_pool_manager_;  ///< 当前数据库的buffer pool管理器
   unique_ptr<LogHandler>         log_handler_;          ///< 当前数据库的日志处理器
   unique_ptr<TrxKit>             trx_kit_;              ///< 当前数据库的事务管理器
+  BplusTreeBulkLoadOptions       index_bulk_load_options_;  ///< 批量构建索引的参数
 
   /// 给每个table都分配一个ID，用来记录日志。这里假设所有的DDL都不会并发操作，所以相关的数据都不上锁
   int32_t next_table_id_ = 0;
 
-  LSN check_point_lsn_ = 0;  ///< 当前数据库的检查点LSN。会记录到磁盘中。
+  LSN   check_point_lsn_ = 0;  ///< 当前数据库的检查点LSN。会记录到磁盘中。
+  mutex check_point_lock_;     ///< sync 和检查点线程都会修改检查点
+
+  LSN last_checkpoint_current_lsn_ = 0;  ///< 上次做检查点时的当前LSN，只在 checkpoint 中访问
+
+  unique_ptr<thread> checkpoint_thread_;              ///< 定期做检查点的线程
+  bool               checkpoint_running_ = false;     ///< 由 checkpoint_thread_lock_ 保护
+  mutex              checkpoint_thread_lock_;
+  condition_variable checkpoint_thread_cv_;
 };
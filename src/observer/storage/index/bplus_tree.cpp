@@ -16,7 +16,7 @@ See the Mulan PSL v2 for more details. */
 #include <span>
 
 #include "storage/index/bplus_tree.h"
-#include "common/lang/lower_bound.h"
+#include "common/lang/algorithm.h"
 #include "common/log/log.h"
 #include "common/global_context.h"
 #include "sql/parser/parse_defs.h"
@@ -24,6 +24,48 @@ See the Mulan PSL v2 for more details. */
 
 using namespace common;
 
+void AttrComparator::init(int attr_num, const AttrType *attr_type, const int *attr_length, const int * /*offset*/)
+{
+  kind_        = Kind::NONE;
+  attr_length_ = 0;
+  attrs_.clear();
+
+  for (int i = 0; i < attr_num; i++) {
+    // 第一个属性是NULL位图，不参与比较
+    if (i > 0) {
+      attrs_.push_back(KeyAttr{attr_type[i], attr_length_, attr_length[i]});
+    }
+    attr_length_ += attr_length[i];
+  }
+
+  if (attrs_.empty()) {
+    return;
+  }
+
+  first_attr_ = attrs_[0];
+  kind_       = Kind::COMPOSITE;
+  if (attrs_.size() == 1) {
+    switch (first_attr_.type) {
+      case AttrType::INTS:
+      case AttrType::DATES: kind_ = Kind::INT; break;
+      case AttrType::FLOATS: kind_ = Kind::FLOAT; break;
+      case AttrType::CHARS: kind_ = Kind::CHARS; break;
+      default: break;
+    }
+  }
+}
+
+int AttrComparator::compare_value(const KeyAttr &attr, const char *v1, const char *v2)
+{
+  Value left;
+  left.set_type(attr.type);
+  left.set_data(v1 + attr.offset, attr.length);
+  Value right;
+  right.set_type(attr.type);
+  right.set_data(v2 + attr.offset, attr.length);
+  return DataType::type_instance(attr.type)->compare(left, right);
+}
+
 /**
  * @brief B+树的第一个页面存放的位置
  * @details B+树数据放到Buffer Pool中，Buffer Pool把文件按照固定大小的页面拆分。
@@ -31,18 +73,27 @@ using namespace common;
  */
 #define FIRST_INDEX_PAGE 1
 
+/**
+ * @brief 页面中最多存放的元素个数
+ * @details 省略公共前缀之后，一个页面能放下多少个元素与数据有关，页面是否放得下由实际占用的空间决定，
+ * 这里的个数只是一个上限。分裂时两边最多各留下 capacity - 1 个元素，新元素不管让前缀变成多短都能放下，
+ * 所以上限是没有前缀时页面容量的两倍左右。
+ * @param capacity 键值不省略前缀时页面能放下的元素个数
+ */
+static int max_size_with_prefix(int capacity) { return max(capacity, 2 * (capacity - 1)); }
+
 int calc_internal_page_capacity(int attr_length)
 {
   int item_size = attr_length + sizeof(RID) + sizeof(PageNum);
-  int capacity  = ((int)BP_PAGE_DATA_SIZE - InternalIndexNode::HEADER_SIZE) / item_size;
-  return capacity;
+  int capacity  = IndexNodeHandler::data_capacity(false /*leaf*/) / item_size;
+  return max_size_with_prefix(capacity);
 }
 
 int calc_leaf_page_capacity(int attr_length)
 {
   int item_size = attr_length + sizeof(RID) + sizeof(RID);
-  int capacity  = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / item_size;
-  return capacity;
+  int capacity  = IndexNodeHandler::data_capacity(true /*leaf*/) / item_size;
+  return max_size_with_prefix(capacity);
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -53,21 +104,30 @@ IndexNodeHandler::IndexNodeHandler(BplusTreeMiniTransaction &mtr, const IndexFil
 bool IndexNodeHandler::is_leaf() const { return node_->is_leaf; }
 void IndexNodeHandler::init_empty(bool leaf)
 {
-  node_->is_leaf = leaf;
-  node_->key_num = 0;
-  node_->parent  = BP_INVALID_PAGE_NUM;
+  node_->is_leaf       = leaf;
+  node_->prefix_length = 0;
+  node_->key_num       = 0;
+  node_->parent        = BP_INVALID_PAGE_NUM;
 }
 PageNum IndexNodeHandler::page_num() const { return frame_->page_num(); }
 
 int IndexNodeHandler::key_size() const { return header_.key_length; }
 
-int IndexNodeHandler::value_size() const
+int IndexNodeHandler::value_size() const { return is_leaf() ? sizeof(RID) : sizeof(PageNum); }
+
+int IndexNodeHandler::item_size() const { return key_size() + value_size(); }
+
+int IndexNodeHandler::prefix_length() const { return node_->prefix_length; }
+
+int IndexNodeHandler::data_capacity(bool leaf)
 {
-  // return header_.value_size;
-  return sizeof(RID);
+  return static_cast<int>(BP_PAGE_DATA_SIZE) - (leaf ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE);
 }
 
-int IndexNodeHandler::item_size() const { return key_size() + value_size(); }
+char *IndexNodeHandler::__array() const
+{
+  return reinterpret_cast<char *>(node_) + (is_leaf() ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE);
+}
 
 int IndexNodeHandler::size() const { return node_->key_num; }
 
@@ -75,7 +135,10 @@ int IndexNodeHandler::max_size() const { return is_leaf() ? header_.leaf_max_siz
 
 int IndexNodeHandler::min_size() const
 {
-  const int max = this->max_size();
+  // 按照当前前缀长度下页面能放下的元素个数计算，前缀越长，页面应该存放的元素就越多
+  const int prefix   = prefix_length();
+  const int capacity = (data_capacity(is_leaf()) - prefix) / (item_size() - prefix);
+  const int max      = min(this->max_size(), capacity);
   return max - max / 2;
 }
 
@@ -102,14 +165,19 @@ RC IndexNodeHandler::set_parent_page_num(PageNum page_num)
  * @return true 需要分裂或合并；
  *         false 不需要分裂或合并
  */
-bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
+bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node, const char *key /* = nullptr */)
 {
   switch (op) {
     case BplusTreeOperationType::READ: {
       return true;
     } break;
     case BplusTreeOperationType::INSERT: {
-      return size() < max_size();
+      if (size() >= max_size()) {
+        return false;
+      }
+      // 内部节点插入的是子节点分裂出来的键值，事先不知道是什么，按照前缀完全失效的情况判断
+      const int prefix = (key != nullptr && is_leaf()) ? prefix_length_after_insert(key, 1) : 0;
+      return space_needed(key_size(), value_size(), prefix, size() + 1) <= data_capacity(is_leaf());
     } break;
     case BplusTreeOperationType::DELETE: {
       if (is_root_node) {  // 参考adjust_root
@@ -131,12 +199,22 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
   return false;
 }
 
+bool IndexNodeHandler::can_insert(const char *items, int num) const
+{
+  if (size() + num > max_size()) {
+    return false;
+  }
+  const int prefix = prefix_length_after_insert(items, num);
+  return space_needed(key_size(), value_size(), prefix, size() + num) <= data_capacity(is_leaf());
+}
+
 string to_string(const IndexNodeHandler &handler)
 {
   stringstream ss;
 
   ss << "PageNum:" << handler.page_num() << ",is_leaf:" << handler.is_leaf() << ","
      << "key_num:" << handler.size() << ","
+     << "prefix_length:" << handler.prefix_length() << ","
      << "parent:" << handler.parent_page_num() << ",";
 
   return ss.str();
@@ -156,29 +234,219 @@ bool IndexNodeHandler::validate() const
       return false;
     }
   }
+
+  if (prefix_length() > key_size() ||
+      space_needed(key_size(), value_size(), prefix_length(), size()) > data_capacity(is_leaf())) {
+    LOG_WARN("page overflow. page num=%d, prefix length=%d, size=%d", page_num(), prefix_length(), size());
+    return false;
+  }
   return true;
 }
 
+void IndexNodeHandler::get_key(int index, char *key) const
+{
+  const int prefix = prefix_length();
+  memcpy(key, __array(), prefix);
+  memcpy(key + prefix, __key_at(index), stored_key_size());
+}
+
+void IndexNodeHandler::get_items(int index, int num, vector<char> &items) const
+{
+  const int prefix           = prefix_length();
+  const int item_size        = this->item_size();
+  const int stored_item_size = this->stored_item_size();
+
+  items.resize(static_cast<size_t>(num) * item_size);
+  for (int i = 0; i < num; i++) {
+    char *item = items.data() + static_cast<size_t>(i) * item_size;
+    memcpy(item, __array(), prefix);
+    memcpy(item + prefix, __item_at(index + i), stored_item_size);
+  }
+}
+
+int IndexNodeHandler::common_prefix_length(const char *key) const
+{
+  const char *prefix        = __array();
+  const int   prefix_length = this->prefix_length();
+
+  int i = 0;
+  while (i < prefix_length && prefix[i] == key[i]) {
+    i++;
+  }
+  return i;
+}
+
+int IndexNodeHandler::prefix_length_after_insert(const char *items, int num) const
+{
+  if (size() > 0) {
+    int prefix = prefix_length();
+    for (int i = 0; i < num && prefix > 0; i++) {
+      prefix = min(prefix, common_prefix_length(items + static_cast<size_t>(i) * item_size()));
+    }
+    return prefix;
+  }
+
+  // 空页面的前缀就是新元素之间的公共前缀
+  if (num <= 0) {
+    return 0;
+  }
+  int prefix = key_size();
+  for (int i = 1; i < num && prefix > 0; i++) {
+    const char *key = items + static_cast<size_t>(i) * item_size();
+    int         j   = 0;
+    while (j < prefix && items[j] == key[j]) {
+      j++;
+    }
+    prefix = j;
+  }
+  return prefix;
+}
+
+void IndexNodeHandler::shrink_prefix(int prefix_length)
+{
+  const int old_prefix_length = this->prefix_length();
+  ASSERT(prefix_length <= old_prefix_length, "prefix can only be shrinked. old=%d, new=%d",
+         old_prefix_length, prefix_length);
+  if (prefix_length == old_prefix_length) {
+    return;
+  }
+
+  // 前缀变短后每个元素都变长了delta个字节。第0个元素的新位置在旧前缀的后半部分，数据已经在那里了，
+  // 其它元素从后往前挪，新位置总是在旧位置之后，不会覆盖还没有挪动的元素和旧前缀
+  const int   delta            = old_prefix_length - prefix_length;
+  const int   old_item_size    = stored_item_size();
+  const int   new_item_size    = old_item_size + delta;
+  char       *array            = __array();
+  const char *prefix_remaining = array + prefix_length;
+  for (int i = size() - 1; i > 0; i--) {
+    char *new_item = array + prefix_length + static_cast<size_t>(i) * new_item_size;
+    memmove(new_item + delta, array + old_prefix_length + static_cast<size_t>(i) * old_item_size, old_item_size);
+    memcpy(new_item, prefix_remaining, delta);
+  }
+  node_->prefix_length = prefix_length;
+}
+
+int IndexNodeHandler::lower_bound(const KeyComparator &comparator, const char *key, int first, bool *found) const
+{
+  // 页面头只读取一次。乐观读时读到的数据可能是不一致的，只要保证不越界访问，版本号校验会发现问题
+  const bool  leaf     = node_->is_leaf;
+  const int   prefix   = node_->prefix_length;
+  const int   size     = node_->key_num;
+  const int   key_size = this->key_size();
+  const int   value_size = leaf ? sizeof(RID) : sizeof(PageNum);
+  const char *array    = reinterpret_cast<const char *>(node_) +
+                      (leaf ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE);
+  if (found) {
+    *found = false;
+  }
+  if (prefix > key_size || size < first || space_needed(key_size, value_size, prefix, size) > data_capacity(leaf)) {
+    return first;
+  }
+
+  char         stack_buffer[256];
+  vector<char> heap_buffer;
+  char        *full_key = stack_buffer;
+  if (key_size > static_cast<int>(sizeof(stack_buffer))) {
+    heap_buffer.resize(key_size);
+    full_key = heap_buffer.data();
+  }
+  memcpy(full_key, array, prefix);
+
+  const int stored_key_size  = key_size - prefix;
+  const int stored_item_size = stored_key_size + value_size;
+  int       low              = first;
+  int       high             = size;
+  int       high_result      = 1;
+  while (low < high) {
+    const int mid = low + (high - low) / 2;
+    memcpy(full_key + prefix, array + prefix + static_cast<size_t>(mid) * stored_item_size, stored_key_size);
+    const int result = comparator(full_key, key);
+    if (result < 0) {
+      low = mid + 1;
+    } else {
+      high        = mid;
+      high_result = result;
+    }
+  }
+
+  if (found) {
+    *found = (low < size && high_result == 0);
+  }
+  return low;
+}
+
+int IndexNodeHandler::split_index() const
+{
+  const int size          = this->size();
+  const int full_capacity = data_capacity(is_leaf()) / item_size();
+  const int low           = max(1, size - (full_capacity - 1));
+  const int high          = min(size - 1, full_capacity - 1);
+  const int middle        = clamp(size / 2, low, high);
+
+  // 在中间 1/4 的范围内，找相邻两个键值公共前缀最短的位置
+  const int   window          = size / 8;
+  const int   stored_key_size = this->stored_key_size();
+  int         best_index      = middle;
+  int         best_length     = stored_key_size + 1;
+  for (int distance = 0; distance <= window && best_length > 0; distance++) {
+    for (int index : {middle - distance, middle + distance}) {
+      if (index < low || index > high) {
+        continue;
+      }
+
+      const char *left  = __key_at(index - 1);
+      const char *right = __key_at(index);
+      int         length = 0;
+      while (length < stored_key_size && left[length] == right[length]) {
+        length++;
+      }
+      if (length < best_length) {
+        best_length = length;
+        best_index  = index;
+      }
+    }
+  }
+  return best_index;
+}
+
 RC IndexNodeHandler::recover_insert_items(int index, const char *items, int num)
 {
-  const int item_size = this->item_size();
+  const int prefix_length = prefix_length_after_insert(items, num);
+  if (size() == 0) {
+    node_->prefix_length = prefix_length;
+    memcpy(__array(), items, prefix_length);
+  } else {
+    shrink_prefix(prefix_length);
+  }
+
+  ASSERT(space_needed(key_size(), value_size(), prefix_length, size() + num) <= data_capacity(is_leaf()),
+         "page overflow. page num=%d, size=%d, insert num=%d, prefix length=%d",
+         page_num(), size(), num, prefix_length);
+
+  const int item_size        = this->item_size();
+  const int stored_item_size = this->stored_item_size();
   if (index < size()) {
-    memmove(__item_at(index + num), __item_at(index), (static_cast<size_t>(size()) - index) * item_size);
+    memmove(__item_at(index + num), __item_at(index), (static_cast<size_t>(size()) - index) * stored_item_size);
   }
 
-  memcpy(__item_at(index), items, static_cast<size_t>(num) * item_size);
+  for (int i = 0; i < num; i++) {
+    memcpy(__item_at(index + i), items + static_cast<size_t>(i) * item_size + prefix_length, stored_item_size);
+  }
   increase_size(num);
   return RC::SUCCESS;
 }
 
 RC IndexNodeHandler::recover_remove_items(int index, int num)
 {
-  const int item_size = this->item_size();
+  const int stored_item_size = this->stored_item_size();
   if (index < size() - num) {
-    memmove(__item_at(index), __item_at(index + num), (static_cast<size_t>(size()) - index - num) * item_size);
+    memmove(__item_at(index), __item_at(index + num), (static_cast<size_t>(size()) - index - num) * stored_item_size);
   }
 
   increase_size(-num);
+  if (size() == 0) {
+    node_->prefix_length = 0;
+  }
   return RC::SUCCESS;
 }
 
@@ -216,7 +484,9 @@ PageNum LeafIndexNodeHandler::next_page() const { return leaf_node_->next_brothe
 char *LeafIndexNodeHandler::key_at(int index)
 {
   assert(index >= 0 && index < size());
-  return __key_at(index);
+  key_buffer_.resize(key_size());
+  get_key(index, key_buffer_.data());
+  return key_buffer_.data();
 }
 
 char *LeafIndexNodeHandler::value_at(int index)
@@ -227,11 +497,7 @@ char *LeafIndexNodeHandler::value_at(int index)
 
 int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *key, bool *found /* = nullptr */) const
 {
-  const int                    size = this->size();
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  return iter - iter_begin;
+  return lower_bound(comparator, key, 0, found);
 }
 
 RC LeafIndexNodeHandler::insert(int index, const char *key, const char *value)
@@ -254,7 +520,9 @@ RC LeafIndexNodeHandler::remove(int index)
 {
   assert(index >= 0 && index < size());
 
-  RC rc = mtr_.logger().node_remove_items(*this, index, span<const char>(__item_at(index), item_size()), 1);
+  vector<char> item;
+  get_items(index, 1, item);
+  RC rc = mtr_.logger().node_remove_items(*this, index, item, 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log remove item. rc=%s", strrc(rc));
     return rc;
@@ -277,13 +545,15 @@ int LeafIndexNodeHandler::remove(const char *key, const KeyComparator &comparato
 
 RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other)
 {
-  const int size       = this->size();
-  const int move_index = size / 2;
+  const int size          = this->size();
+  const int move_index    = split_index();
   const int move_item_num = size - move_index;
 
-  other.append(__item_at(move_index), move_item_num);
+  vector<char> items;
+  get_items(move_index, move_item_num, items);
+  other.append(items.data(), move_item_num);
 
-  RC rc = mtr_.logger().node_remove_items(*this, move_index, span<const char>(__item_at(move_index), move_item_num * item_size()), move_item_num);
+  RC rc = mtr_.logger().node_remove_items(*this, move_index, items, move_item_num);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink leaf node. rc=%s", strrc(rc));
     return rc;
@@ -294,14 +564,18 @@ RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other)
 }
 RC LeafIndexNodeHandler::move_first_to_end(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0));
+  vector<char> item;
+  get_items(0, 1, item);
+  other.append(item.data());
 
   return this->remove(0);
 }
 
 RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other)
 {
-  other.preappend(__item_at(size() - 1));
+  vector<char> item;
+  get_items(size() - 1, 1, item);
+  other.preappend(item.data());
 
   this->remove(size() - 1);
   return RC::SUCCESS;
@@ -311,14 +585,16 @@ RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other)
  */
 RC LeafIndexNodeHandler::move_to(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0), this->size());
+  vector<char> items;
+  get_items(0, this->size(), items);
+  other.append(items.data(), this->size());
   other.set_next_page(this->next_page());
 
-  RC rc = mtr_.logger().node_remove_items(*this, 0, span<const char>(__item_at(0), this->size() * item_size()), this->size());
+  RC rc = mtr_.logger().node_remove_items(*this, 0, items, this->size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink leaf node. rc=%s", strrc(rc));
   }
-  this->increase_size(-this->size());
+  recover_remove_items(0, this->size());
 
   return RC::SUCCESS;
 }
@@ -345,15 +621,16 @@ RC LeafIndexNodeHandler::preappend(const char *item)
   return insert(0, item, item + key_size());
 }
 
-char *LeafIndexNodeHandler::__item_at(int index) const { return leaf_node_->array + (index * item_size()); }
-
 string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer)
 {
   stringstream ss;
   ss << to_string((const IndexNodeHandler &)handler) << ",next page:" << handler.next_page();
-  ss << ",values=[" << printer(handler.__key_at(0));
-  for (int i = 1; i < handler.size(); i++) {
-    ss << "," << printer(handler.__key_at(i));
+
+  vector<char> key(handler.key_size());
+  ss << ",values=[";
+  for (int i = 0; i < handler.size(); i++) {
+    handler.get_key(i, key.data());
+    ss << (i == 0 ? "" : ",") << printer(key.data());
   }
   ss << "]";
   return ss.str();
@@ -366,10 +643,14 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
     return false;
   }
 
-  const int node_size = size();
+  const int    node_size = size();
+  vector<char> prev_key(key_size());
+  vector<char> key(key_size());
   for (int i = 1; i < node_size; i++) {
     LOG_DEBUG("COMP4");
-    if (comparator(__key_at(i - 1), __key_at(i)) >= 0) {
+    get_key(i - 1, prev_key.data());
+    get_key(i, key.data());
+    if (comparator(prev_key.data(), key.data()) >= 0) {
       LOG_WARN("page number = %d, invalid key order. id1=%d,id2=%d, this=%s",
                page_num(), i - 1, i, to_string(*this).c_str());
       return false;
@@ -398,7 +679,8 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
   }
 
   if (0 != index_in_parent) {
-    int cmp_result = comparator(__key_at(0), parent_node.key_at(index_in_parent));
+    get_key(0, key.data());
+    int cmp_result = comparator(key.data(), parent_node.key_at(index_in_parent));
     if (cmp_result < 0) {
       LOG_WARN("invalid leaf node. first item should be greate than or equal to parent item. "
                "this page num=%d, parent page num=%d, index in parent=%d",
@@ -409,7 +691,8 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
   }
 
   if (index_in_parent < parent_node.size() - 1) {
-    int cmp_result = comparator(__key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
+    get_key(size() - 1, key.data());
+    int cmp_result = comparator(key.data(), parent_node.key_at(index_in_parent + 1));
     if (cmp_result >= 0) {
       LOG_WARN("invalid leaf node. last item should be less than the item at the first after item in parent."
                "this page num=%d, parent page num=%d, parent item to compare=%d",
@@ -431,12 +714,12 @@ string to_string(const InternalIndexNodeHandler &node, const KeyPrinter &printer
 {
   stringstream ss;
   ss << to_string((const IndexNodeHandler &)node);
-  ss << ",children:["
-     << "{key:" << printer(node.__key_at(0)) << ","
-     << "value:" << *(PageNum *)node.__value_at(0) << "}";
 
-  for (int i = 1; i < node.size(); i++) {
-    ss << ",{key:" << printer(node.__key_at(i)) << ",value:" << *(PageNum *)node.__value_at(i) << "}";
+  vector<char> key(node.key_size());
+  ss << ",children:[";
+  for (int i = 0; i < node.size(); i++) {
+    node.get_key(i, key.data());
+    ss << (i == 0 ? "" : ",") << "{key:" << printer(key.data()) << ",value:" << *(PageNum *)node.__value_at(i) << "}";
   }
   ss << "]";
   return ss.str();
@@ -458,12 +741,13 @@ RC InternalIndexNodeHandler::create_new_root(PageNum first_page_num, const char
     LOG_WARN("failed to log create new root. rc=%s", strrc(rc));
   }
 
-  memset(__key_at(0), 0, key_size());
-  memcpy(__value_at(0), &first_page_num, value_size());
-  memcpy(__item_at(1), key, key_size());
-  memcpy(__value_at(1), &page_num, value_size());
-  increase_size(2);
-  return RC::SUCCESS;
+  // 第一个键值不会被使用，这里与第二个键值相同，不会让页面的公共前缀变短
+  vector<char> items(item_size() * 2);
+  memcpy(items.data(), key, key_size());
+  memcpy(items.data() + key_size(), &first_page_num, value_size());
+  memcpy(items.data() + item_size(), key, key_size());
+  memcpy(items.data() + item_size() + key_size(), &page_num, value_size());
+  return recover_insert_items(0, items.data(), 2);
 }
 
 /**
@@ -495,16 +779,19 @@ RC InternalIndexNodeHandler::insert(const char *key, PageNum page_num, const Key
 RC InternalIndexNodeHandler::move_half_to(InternalIndexNodeHandler &other)
 {
   const int size       = this->size();
-  const int move_index = size / 2;
+  const int move_index = split_index();
   const int move_num   = size - move_index;
-  RC        rc         = other.append(this->__item_at(move_index), size - move_index);
+
+  vector<char> items;
+  get_items(move_index, move_num, items);
+  RC rc = other.append(items.data(), move_num);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to copy item to new node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
 
-  mtr_.logger().node_remove_items(*this, move_index, span<const char>(__item_at(move_index), move_num * item_size()), move_num);
-  increase_size(-(size - move_index));
+  mtr_.logger().node_remove_items(*this, move_index, items, move_num);
+  recover_remove_items(move_index, move_num);
   return rc;
 }
 
@@ -527,15 +814,16 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
     return 0;
   }
 
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(1));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  int                          ret  = static_cast<int>(iter - iter_begin) + 1;
+  bool equal = false;
+  int  ret   = lower_bound(comparator, key, 1, &equal);
   if (insert_position) {
     *insert_position = ret;
   }
+  if (found) {
+    *found = equal;
+  }
 
-  if (ret >= size || comparator(key, __key_at(ret)) < 0) {
+  if (ret >= size || !equal) {
     return ret - 1;
   }
   return ret;
@@ -544,15 +832,29 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
 char *InternalIndexNodeHandler::key_at(int index)
 {
   assert(index >= 0 && index < size());
-  return __key_at(index);
+  key_buffer_.resize(key_size());
+  get_key(index, key_buffer_.data());
+  return key_buffer_.data();
 }
 
 void InternalIndexNodeHandler::set_key_at(int index, const char *key)
 {
   assert(index >= 0 && index < size());
 
-  mtr_.logger().internal_update_key(*this, index, span<const char>(key, key_size()), span<const char>(__key_at(index), key_size()));
-  memcpy(__key_at(index), key, key_size());
+  vector<char> old_key(key_size());
+  get_key(index, old_key.data());
+  mtr_.logger().internal_update_key(*this, index, span<const char>(key, key_size()), old_key);
+
+  shrink_prefix(common_prefix_length(key));
+  ASSERT(space_needed(key_size(), value_size(), prefix_length(), size()) <= data_capacity(false /*leaf*/),
+         "page overflow. page num=%d, size=%d, prefix length=%d", page_num(), size(), prefix_length());
+  memcpy(__key_at(index), key + prefix_length(), stored_key_size());
+}
+
+bool InternalIndexNodeHandler::can_set_key_at(int index, const char *key) const
+{
+  const int prefix = common_prefix_length(key);
+  return space_needed(key_size(), value_size(), prefix, size()) <= data_capacity(false /*leaf*/);
 }
 
 PageNum InternalIndexNodeHandler::value_at(int index)
@@ -561,6 +863,25 @@ PageNum InternalIndexNodeHandler::value_at(int index)
   return *(PageNum *)__value_at(index);
 }
 
+PageNum InternalIndexNodeHandler::value_at_unchecked(int index) const
+{
+  const int prefix   = node_->prefix_length;
+  const int key_size = this->key_size();
+  if (index < 0 || prefix > key_size) {
+    return BP_INVALID_PAGE_NUM;
+  }
+
+  const int64_t offset = prefix + static_cast<int64_t>(index) * (key_size - prefix + sizeof(PageNum)) +
+                         (key_size - prefix);
+  if (offset + static_cast<int64_t>(sizeof(PageNum)) > data_capacity(false /*leaf*/)) {
+    return BP_INVALID_PAGE_NUM;
+  }
+
+  PageNum page_num = BP_INVALID_PAGE_NUM;
+  memcpy(&page_num, internal_node_->array + offset, sizeof(page_num));
+  return page_num;
+}
+
 int InternalIndexNodeHandler::value_index(PageNum page_num)
 {
   for (int i = 0; i < size(); i++) {
@@ -575,8 +896,10 @@ void InternalIndexNodeHandler::remove(int index)
 {
   assert(index >= 0 && index < size());
 
+  vector<char> item;
+  get_items(index, 1, item);
   BplusTreeLogger &logger = mtr_.logger();
-  RC rc = logger.node_remove_items(*this, index, span<const char>(__item_at(index), item_size()), 1);
+  RC rc = logger.node_remove_items(*this, index, item, 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log remove item. rc=%s. node=%s", strrc(rc), to_string(*this).c_str());
   }
@@ -586,13 +909,15 @@ void InternalIndexNodeHandler::remove(int index)
 
 RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other)
 {
-  RC rc = other.append(__item_at(0), size());
+  vector<char> items;
+  get_items(0, size(), items);
+  RC rc = other.append(items.data(), size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to copy items to other node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
 
-  rc = mtr_.logger().node_remove_items(*this, 0, span<const char>(__item_at(0), size() * item_size()), size());
+  rc = mtr_.logger().node_remove_items(*this, 0, items, size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink internal node. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -603,7 +928,9 @@ RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other)
 
 RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other)
 {
-  RC rc = other.append(__item_at(0));
+  vector<char> item;
+  get_items(0, 1, item);
+  RC rc = other.append(item.data());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to append item to others.");
     return rc;
@@ -615,18 +942,20 @@ RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other)
 
 RC InternalIndexNodeHandler::move_last_to_front(InternalIndexNodeHandler &other)
 {
-  RC rc = other.preappend(__item_at(size() - 1));
+  vector<char> item;
+  get_items(size() - 1, 1, item);
+  RC rc = other.preappend(item.data());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to preappend to others");
     return rc;
   }
 
-  rc = mtr_.logger().node_remove_items(*this, size() - 1, span<const char>(__item_at(size() - 1), item_size()), 1);
+  rc = mtr_.logger().node_remove_items(*this, size() - 1, item, 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink internal node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
-  increase_size(-1);
+  recover_remove_items(size() - 1, 1);
   return rc;
 }
 
@@ -677,12 +1006,6 @@ RC InternalIndexNodeHandler::preappend(const char *item)
   return this->insert_items(0, item, 1);
 }
 
-char *InternalIndexNodeHandler::__item_at(int index) const { return internal_node_->array + (index * item_size()); }
-
-int InternalIndexNodeHandler::value_size() const { return sizeof(PageNum); }
-
-int InternalIndexNodeHandler::item_size() const { return key_size() + this->value_size(); }
-
 bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferPool *bp) const
 {
   bool result = IndexNodeHandler::validate();
@@ -690,9 +1013,13 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBuf
     return false;
   }
 
-  const int node_size = size();
+  const int    node_size = size();
+  vector<char> prev_key(key_size());
+  vector<char> key(key_size());
   for (int i = 2; i < node_size; i++) {
-    if (comparator(__key_at(i - 1), __key_at(i)) >= 0) {
+    get_key(i - 1, prev_key.data());
+    get_key(i, key.data());
+    if (comparator(prev_key.data(), key.data()) >= 0) {
       LOG_WARN("page number = %d, invalid key order. id1=%d,id2=%d, this=%s",
           page_num(), i - 1, i, to_string(*this).c_str());
       return false;
@@ -748,7 +1075,8 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBuf
   }
 
   if (0 != index_in_parent) {
-    int cmp_result = comparator(__key_at(1), parent_node.key_at(index_in_parent));
+    get_key(1, key.data());
+    int cmp_result = comparator(key.data(), parent_node.key_at(index_in_parent));
     if (cmp_result < 0) {
       LOG_WARN("invalid internal node. the second item should be greate than or equal to parent item. "
                "this page num=%d, parent page num=%d, index in parent=%d",
@@ -759,7 +1087,8 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBuf
   }
 
   if (index_in_parent < parent_node.size() - 1) {
-    int cmp_result = comparator(__key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
+    get_key(size() - 1, key.data());
+    int cmp_result = comparator(key.data(), parent_node.key_at(index_in_parent + 1));
     if (cmp_result >= 0) {
       LOG_WARN("invalid internal node. last item should be less than the item at the first after item in parent."
                "this page num=%d, parent page num=%d, parent item to compare=%d",
@@ -839,10 +1168,11 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
     attr_length += field_meta->len();
   }
 
-  if (internal_max_size < 0) {
+  // 分裂后新元素一定能插入的前提是元素个数不超过这个上限，见 max_size_with_prefix
+  if (internal_max_size < 0 || internal_max_size > calc_internal_page_capacity(attr_length)) {
     internal_max_size = calc_internal_page_capacity(attr_length);
   }
-  if (leaf_max_size < 0) {
+  if (leaf_max_size < 0 || leaf_max_size > calc_leaf_page_capacity(attr_length)) {
     leaf_max_size = calc_leaf_page_capacity(attr_length);
   }
 
@@ -1208,20 +1538,88 @@ bool BplusTreeHandler::is_empty() const { return file_header_.root_page == BP_IN
 RC BplusTreeHandler::find_leaf(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame)
 {
   auto child_page_getter = [this, key](InternalIndexNodeHandler &internal_node) {
-    return internal_node.value_at(internal_node.lookup(key_comparator_, key));
+    return internal_node.value_at_unchecked(internal_node.lookup(key_comparator_, key));
   };
-  return find_leaf_internal(mtr, op, child_page_getter, frame);
+  return find_leaf_internal(mtr, op, child_page_getter, key, frame);
+}
+
+RC BplusTreeHandler::find_prev_entry(BplusTreeMiniTransaction &mtr, const char *key, Frame *&frame, int &index)
+{
+  LatchMemo &latch_memo = mtr.latch_memo();
+  const int  memo_point = latch_memo.memo_point();
+
+  latch_memo.slatch(&root_lock_);
+
+  RC rc = RC::RECORD_EOF;
+  if (!is_empty()) {
+    rc = find_prev_entry_in_subtree(mtr, file_header_.root_page, key, frame, index);
+  }
+
+  if (OB_SUCC(rc)) {
+    // 只保留叶子节点的 pin 和读锁
+    latch_memo.release_to(latch_memo.memo_point() - 2);
+  } else {
+    latch_memo.release_from(memo_point);
+  }
+  return rc;
+}
+
+RC BplusTreeHandler::find_prev_entry_in_subtree(
+    BplusTreeMiniTransaction &mtr, PageNum page_num, const char *key, Frame *&frame, int &index)
+{
+  LatchMemo &latch_memo = mtr.latch_memo();
+  const int  memo_point = latch_memo.memo_point();
+
+  Frame *node_frame = nullptr;
+  RC     rc         = latch_memo.get_page(page_num, node_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get frame. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+  latch_memo.slatch(node_frame);
+
+  if (IndexNodeHandler(mtr, file_header_, node_frame).is_leaf()) {
+    LeafIndexNodeHandler leaf_node(mtr, file_header_, node_frame);
+    const int position = (key == nullptr) ? leaf_node.size() : leaf_node.lookup(key_comparator_, key);
+    if (position > 0) {
+      frame = node_frame;
+      index = position - 1;
+      return RC::SUCCESS;
+    }
+  } else {
+    InternalIndexNodeHandler internal_node(mtr, file_header_, node_frame);
+    int child_index = (key == nullptr) ? internal_node.size() - 1 : internal_node.lookup(key_comparator_, key);
+    for (; child_index >= 0; child_index--) {
+      rc = find_prev_entry_in_subtree(mtr, internal_node.value_at(child_index), key, frame, index);
+      if (rc != RC::RECORD_EOF) {
+        return rc;
+      }
+    }
+  }
+
+  latch_memo.release_from(memo_point);
+  return RC::RECORD_EOF;
 }
 
 RC BplusTreeHandler::left_most_page(BplusTreeMiniTransaction &mtr, Frame *&frame)
 {
-  auto child_page_getter = [](InternalIndexNodeHandler &internal_node) { return internal_node.value_at(0); };
-  return find_leaf_internal(mtr, BplusTreeOperationType::READ, child_page_getter, frame);
+  auto child_page_getter = [](InternalIndexNodeHandler &internal_node) { return internal_node.value_at_unchecked(0); };
+  return find_leaf_internal(mtr, BplusTreeOperationType::READ, child_page_getter, nullptr /*key*/, frame);
 }
 
 RC BplusTreeHandler::find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op,
-    const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame)
+    const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, const char *key, Frame *&frame)
 {
+  if (op == BplusTreeOperationType::READ) {
+    for (int i = 0; i < OPTIMISTIC_READ_RETRY_TIMES; i++) {
+      RC rc = optimistic_find_leaf(mtr, child_page_getter, frame);
+      if (rc != RC::LOCKED_CONCURRENCY_CONFLICT) {
+        return rc;
+      }
+    }
+    LOG_TRACE("optimistic read conflicts too many times, fall back to crabing protocol");
+  }
+
   LatchMemo &latch_memo = mtr.latch_memo();
 
   // root locked
@@ -1235,7 +1633,7 @@ RC BplusTreeHandler::find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTree
     return RC::EMPTY;
   }
 
-  RC rc = crabing_protocal_fetch_page(mtr, op, file_header_.root_page, true /* is_root_node */, frame);
+  RC rc = crabing_protocal_fetch_page(mtr, op, file_header_.root_page, true /* is_root_node */, key, frame);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to fetch root page. page id=%d, rc=%d:%s", file_header_.root_page, rc, strrc(rc));
     return rc;
@@ -1246,7 +1644,7 @@ RC BplusTreeHandler::find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTree
   for (; !node->is_leaf;) {
     InternalIndexNodeHandler internal_node(mtr, file_header_, frame);
     next_page_id = child_page_getter(internal_node);
-    rc           = crabing_protocal_fetch_page(mtr, op, next_page_id, false /* is_root_node */, frame);
+    rc           = crabing_protocal_fetch_page(mtr, op, next_page_id, false /* is_root_node */, key, frame);
     if (OB_FAIL(rc)) {
       LOG_WARN("Failed to load page page_num:%d. rc=%s", next_page_id, strrc(rc));
       return rc;
@@ -1257,8 +1655,84 @@ RC BplusTreeHandler::find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTree
   return RC::SUCCESS;
 }
 
-RC BplusTreeHandler::crabing_protocal_fetch_page(
-    BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, PageNum page_num, bool is_root_node, Frame *&frame)
+RC BplusTreeHandler::optimistic_find_leaf(BplusTreeMiniTransaction &mtr,
+    const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame)
+{
+  LatchMemo &latch_memo = mtr.latch_memo();
+
+  auto restart = [&latch_memo]() {
+    latch_memo.release_to(latch_memo.memo_point());
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  };
+
+  // 根节点分裂或者降低高度时会替换根节点，读到根节点的版本号之后要确认根节点页号没有变化
+  const uint64_t root_version = root_version_.load(memory_order_acquire);
+  if (Frame::is_write_latched(root_version)) {
+    return restart();
+  }
+
+  const PageNum root_page = file_header_.root_page;
+  atomic_thread_fence(memory_order_acquire);
+  if (root_version_.load(memory_order_relaxed) != root_version) {
+    return restart();
+  }
+  if (root_page == BP_INVALID_PAGE_NUM) {
+    return RC::EMPTY;
+  }
+
+  Frame   *parent_frame   = nullptr;
+  uint64_t parent_version = 0;
+  PageNum  page_num       = root_page;
+  while (true) {
+    const int memo_point = latch_memo.memo_point();
+
+    RC rc = latch_memo.get_page(page_num, frame);
+    if (OB_FAIL(rc)) {
+      // 父节点被修改过的话，页号可能是无效的
+      if (parent_frame != nullptr && !parent_frame->validate_version(parent_version)) {
+        return restart();
+      }
+      LOG_WARN("failed to get frame. pageNum=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    const uint64_t version = frame->version();
+    const bool     parent_valid = (parent_frame == nullptr) ? (root_version_.load(memory_order_acquire) == root_version)
+                                                            : parent_frame->validate_version(parent_version);
+    if (!parent_valid || Frame::is_write_latched(version)) {
+      return restart();
+    }
+
+    IndexNode *node = reinterpret_cast<IndexNode *>(frame->data());
+    if (node->is_leaf) {
+      // 加上读锁之后版本号没有变化，说明从父节点的校验到现在，叶子节点没有分裂或合并
+      latch_memo.slatch(frame);
+      if (!frame->validate_version(version)) {
+        return restart();
+      }
+
+      latch_memo.release_to(memo_point);
+      return RC::SUCCESS;
+    }
+
+    InternalIndexNodeHandler internal_node(mtr, file_header_, frame);
+    if (internal_node.size() < 0 || internal_node.size() > internal_node.max_size()) {
+      return restart();
+    }
+
+    page_num = child_page_getter(internal_node);
+    if (!frame->validate_version(version)) {
+      return restart();
+    }
+
+    latch_memo.release_to(memo_point);  // 释放父节点
+    parent_frame   = frame;
+    parent_version = version;
+  }
+}
+
+RC BplusTreeHandler::crabing_protocal_fetch_page(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op,
+    PageNum page_num, bool is_root_node, const char *key, Frame *&frame)
 {
   LatchMemo &latch_memo = mtr.latch_memo();
   bool      readonly   = (op == BplusTreeOperationType::READ);
@@ -1273,7 +1747,7 @@ RC BplusTreeHandler::crabing_protocal_fetch_page(
   LatchMemoType latch_type = readonly ? LatchMemoType::SHARED : LatchMemoType::EXCLUSIVE;
   mtr.latch_memo().latch(frame, latch_type);
   IndexNodeHandler index_node(mtr, file_header_, frame);
-  if (index_node.is_safe(op, is_root_node)) {
+  if (index_node.is_safe(op, is_root_node, key)) {
     latch_memo.release_to(memo_point);  // 当前节点不会分裂或合并，可以将前面的锁都释放掉
   }
   return rc;
@@ -1289,7 +1763,7 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr,
     return RC::RECORD_DUPLICATE_KEY;
   }
 
-  if (leaf_node.size() < leaf_node.max_size()) {
+  if (leaf_node.can_insert(key, 1)) {
     leaf_node.insert(insert_position, key, (const char *)rid);
     frame->mark_dirty();
     // disk_buffer_pool_->unpin_page(frame); // unpin pages 由latch memo 来操作
@@ -1368,8 +1842,8 @@ RC BplusTreeHandler::insert_entry_into_parent(BplusTreeMiniTransaction &mtr, Fra
     // 在第一次遍历这个页面时，我们已经拿到parent frame的write latch，所以这里不再去加锁
     InternalIndexNodeHandler parent_node(mtr, file_header_, parent_frame);
 
-    /// 当前这个父节点还没有满，直接将新节点数据插进入就行了
-    if (parent_node.size() < parent_node.max_size()) {
+    /// 当前这个父节点还能放得下，直接将新节点数据插进入就行了
+    if (parent_node.can_insert(key, 1)) {
       parent_node.insert(key, new_frame->page_num(), key_comparator_);
       new_node_handler.set_parent_page_num(parent_page_num);
 
@@ -1472,7 +1946,9 @@ void BplusTreeHandler::update_root_page_num_locked(BplusTreeMiniTransaction &mtr
   IndexFileHeader *file_header = reinterpret_cast<IndexFileHeader *>(frame->data());
   mtr.logger().update_root_page(frame, root_page_num, file_header->root_page);
   file_header->root_page = root_page_num;
+  root_version_.fetch_add(1, memory_order_acq_rel);
   file_header_.root_page = root_page_num;
+  root_version_.fetch_add(1, memory_order_release);
   header_dirty_          = true;
   frame->mark_dirty();
   LOG_DEBUG("set root page to %d", root_page_num);
@@ -1512,13 +1988,18 @@ MemPoolItem::item_unique_ptr BplusTreeHandler::make_key(const char *user_key, co
     LOG_WARN("Failed to alloc memory for key.");
     return nullptr;
   }
+  make_key(user_key, rid, static_cast<char *>(key.get()));
+  return key;
+}
+
+void BplusTreeHandler::make_key(const char *user_key, const RID &rid, char *key) const
+{
   int offset = 0;
   for (int i = 0; i < file_header_.attr_num; i++) {
-    memcpy(static_cast<char *>(key.get()) + offset, user_key + file_header_.key_offset[i], file_header_.attr_length[i]);
+    memcpy(key + offset, user_key + file_header_.key_offset[i], file_header_.attr_length[i]);
     offset += file_header_.attr_length[i];
   }
-  memcpy(static_cast<char *>(key.get()) + offset, &rid, sizeof(rid));
-  return key;
+  memcpy(key + offset, &rid, sizeof(rid));
 }
 
 RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
@@ -1591,6 +2072,149 @@ RC BplusTreeHandler::get_entry(const char *user_key, int key_len, list<RID> &rid
   return rc;
 }
 
+RC BplusTreeHandler::get_entries(span<const char *const> user_keys, int key_len, vector<list<RID>> &rids)
+{
+  const int key_num = static_cast<int>(user_keys.size());
+  rids.clear();
+  rids.resize(key_num);
+
+  RC rc = RC::SUCCESS;
+  if (file_header_.attr_type[1] == AttrType::CHARS) {
+    // 字符串的查找值需要 BplusTreeScanner::fix_user_key 调整长度
+    for (int i = 0; i < key_num && OB_SUCC(rc); i++) {
+      rc = get_entry(user_keys[i], key_len, rids[i]);
+    }
+    return rc;
+  }
+
+  const int    key_length = file_header_.key_length;
+  vector<char> left_keys(static_cast<size_t>(key_num) * key_length);
+  vector<char> right_key(key_length);
+  vector<int>  order(key_num);
+  for (int i = 0; i < key_num; i++) {
+    make_key(user_keys[i], *RID::min(), left_keys.data() + static_cast<size_t>(i) * key_length);
+    order[i] = i;
+  }
+
+  auto left_key_of = [&left_keys, key_length](int i) { return left_keys.data() + static_cast<size_t>(i) * key_length; };
+  sort(order.begin(), order.end(), [this, &left_key_of](int a, int b) {
+    return key_comparator_(left_key_of(a), left_key_of(b)) < 0;
+  });
+
+  BplusTreeMiniTransaction mtr(*this);
+  LatchMemo               &latch_memo = mtr.latch_memo();
+  ReadAheadDetector        read_ahead_detector(buffer_pool().read_ahead_pages());
+
+  Frame *frame    = nullptr;  // 当前加了读锁的叶子节点
+  int    last_key = -1;       // 上一个查找的键值
+  for (int i : order) {
+    const char *left_key = left_key_of(i);
+    if (last_key >= 0 && key_comparator_(left_key, left_key_of(last_key)) == 0) {
+      rids[i] = rids[last_key];
+      continue;
+    }
+    last_key = i;
+    make_key(user_keys[i], *RID::max(), right_key.data());
+
+    // 要查找的键值不大于当前叶子节点的最后一个键值时，就在当前叶子节点上查找，否则从根节点重新查找。
+    // 不知道下一个叶子节点的键值范围，先去读下一个叶子节点在键值稀疏时反而更慢
+    bool found_leaf = false;
+    if (frame != nullptr) {
+      LeafIndexNodeHandler node(mtr, file_header_, frame);
+      found_leaf = node.size() > 0 && key_comparator_(left_key, node.key_at(node.size() - 1)) <= 0;
+    }
+
+    bool done = false;
+    while (!done) {
+      if (!found_leaf) {
+        latch_memo.release();
+        frame = nullptr;
+        rc    = find_leaf(mtr, BplusTreeOperationType::READ, left_key, frame);
+        if (rc == RC::EMPTY) {
+          return RC::SUCCESS;
+        } else if (OB_FAIL(rc)) {
+          LOG_WARN("failed to find leaf page. rc=%s", strrc(rc));
+          return rc;
+        }
+        found_leaf = true;
+
+        // 键值密集时，重新查找到的叶子节点也是顺序的，同样可以预读
+        PageNum read_ahead_start = BP_INVALID_PAGE_NUM;
+        int     read_ahead_count = 0;
+        if (read_ahead_detector.access(frame->page_num(), read_ahead_start, read_ahead_count)) {
+          (void)buffer_pool().read_ahead(read_ahead_start, read_ahead_count);
+        }
+      }
+
+      int index = LeafIndexNodeHandler(mtr, file_header_, frame).lookup(key_comparator_, left_key);
+      while (true) {
+        LeafIndexNodeHandler node(mtr, file_header_, frame);
+        for (; index < node.size(); index++) {
+          if (key_comparator_(node.key_at(index), right_key.data()) > 0) {
+            done = true;
+            break;
+          }
+          RID rid;
+          memcpy(&rid, node.value_at(index), sizeof(rid));
+          rids[i].push_back(rid);
+        }
+
+        if (done) {
+          break;
+        }
+
+        rc = next_leaf(mtr, read_ahead_detector, frame);
+        if (rc == RC::RECORD_EOF) {
+          done = true;
+          break;
+        } else if (rc == RC::LOCKED_NEED_WAIT) {
+          // 其它线程正在修改下一个叶子节点，放弃已经找到的结果，从根节点重新查找当前键值
+          rids[i].clear();
+          found_leaf = false;
+          break;
+        } else if (OB_FAIL(rc)) {
+          return rc;
+        }
+        index = 0;
+      }
+    }
+  }
+
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::next_leaf(BplusTreeMiniTransaction &mtr, ReadAheadDetector &read_ahead_detector, Frame *&frame)
+{
+  const PageNum next_page_num = LeafIndexNodeHandler(mtr, file_header_, frame).next_page();
+  if (BP_INVALID_PAGE_NUM == next_page_num) {
+    return RC::RECORD_EOF;
+  }
+
+  PageNum read_ahead_start = BP_INVALID_PAGE_NUM;
+  int     read_ahead_count = 0;
+  if (read_ahead_detector.access(next_page_num, read_ahead_start, read_ahead_count)) {
+    (void)buffer_pool().read_ahead(read_ahead_start, read_ahead_count);
+  }
+
+  LatchMemo &latch_memo = mtr.latch_memo();
+
+  const int memo_point = latch_memo.memo_point();
+  Frame    *next_frame = nullptr;
+  RC        rc         = latch_memo.get_page(next_page_num, next_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get next page. page num=%d, rc=%s", next_page_num, strrc(rc));
+    return rc;
+  }
+
+  if (!latch_memo.try_slatch(next_frame)) {
+    return RC::LOCKED_NEED_WAIT;
+  }
+
+  latch_memo.release_to(memo_point);
+  frame = next_frame;
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::adjust_root(BplusTreeMiniTransaction &mtr, Frame *root_frame)
 {
   LatchMemo &latch_memo = mtr.latch_memo();
@@ -1620,6 +2244,7 @@ RC BplusTreeHandler::adjust_root(BplusTreeMiniTransaction &mtr, Frame *root_fram
 
     IndexNodeHandler child_node(mtr, file_header_, child_frame);
     child_node.set_parent_page_num(BP_INVALID_PAGE_NUM);
+    child_frame->mark_dirty();
 
     // file_header_.root_page = child_page_num;
     new_root_page_num = child_page_num;
@@ -1663,10 +2288,9 @@ RC BplusTreeHandler::coalesce_or_redistribute(BplusTreeMiniTransaction &mtr, Fra
 
   InternalIndexNodeHandler parent_index_node(mtr, file_header_, parent_frame);
 
-  int index = parent_index_node.lookup(key_comparator_, index_node.key_at(index_node.size() - 1));
-  ASSERT(parent_index_node.value_at(index) == frame->page_num(),
-         "lookup return an invalid value. index=%d, this page num=%d, but got %d",
-         index, frame->page_num(), parent_index_node.value_at(index));
+  // 合并或重新分配受页面实际空间限制，可能没有做，节点中的元素可以少到0个，所以按照页号找节点在父节点中的位置
+  int index = parent_index_node.value_index(frame->page_num());
+  ASSERT(index >= 0, "cannot find page in parent. page num=%d, parent page num=%d", frame->page_num(), parent_page_num);
 
   PageNum neighbor_page_num;
   if (index == 0) {
@@ -1688,10 +2312,16 @@ RC BplusTreeHandler::coalesce_or_redistribute(BplusTreeMiniTransaction &mtr, Fra
   latch_memo.xlatch(neighbor_frame);
 
   IndexNodeHandlerType neighbor_node(mtr, file_header_, neighbor_frame);
-  if (index_node.size() + neighbor_node.size() > index_node.max_size()) {
-    rc = redistribute<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
-  } else {
+
+  // 合并时右边节点的元素都追加到左边节点上，公共前缀可能会变短，要按照实际的数据判断能不能放下
+  IndexNodeHandlerType &left_node  = (index == 0) ? index_node : neighbor_node;
+  IndexNodeHandlerType &right_node = (index == 0) ? neighbor_node : index_node;
+  vector<char>          right_items;
+  right_node.get_items(0, right_node.size(), right_items);
+  if (left_node.can_insert(right_items.data(), right_node.size())) {
     rc = coalesce<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
+  } else {
+    rc = redistribute<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
   }
 
   return rc;
@@ -1748,6 +2378,9 @@ RC BplusTreeHandler::coalesce(
     left_leaf_node.set_next_page(right_leaf_node.next_page());
   }
 
+  left_frame->mark_dirty();
+  parent_frame->mark_dirty();
+
   // 释放右边节点
   mtr.latch_memo().dispose_page(right_frame->page_num());
 
@@ -1761,9 +2394,27 @@ RC BplusTreeHandler::redistribute(BplusTreeMiniTransaction &mtr, Frame *neighbor
   InternalIndexNodeHandler parent_node(mtr, file_header_, parent_frame);
   IndexNodeHandlerType     neighbor_node(mtr, file_header_, neighbor_frame);
   IndexNodeHandlerType     node(mtr, file_header_, frame);
-  if (neighbor_node.size() < node.size()) {
-    LOG_ERROR("got invalid nodes. neighbor node size %d, this node size %d", neighbor_node.size(), node.size());
+  // 挪过来的元素和父节点中新的键值都可能让页面的公共前缀变短，放不下时就不做调整，
+  // 节点中的元素少一些不影响正确性
+  if (neighbor_node.size() <= node.size()) {
+    LOG_TRACE("neighbor node is too small to redistribute. neighbor node size %d, this node size %d",
+              neighbor_node.size(), node.size());
+    return RC::SUCCESS;
   }
+
+  vector<char> item;
+  if (index == 0) {
+    neighbor_node.get_items(0, 1, item);
+  } else {
+    neighbor_node.get_items(neighbor_node.size() - 1, 1, item);
+  }
+  const int   key_index_in_parent = (index == 0) ? index + 1 : index;
+  const char *new_parent_key      = (index == 0) ? neighbor_node.key_at(1) : item.data();
+  if (!node.can_insert(item.data(), 1) || !parent_node.can_set_key_at(key_index_in_parent, new_parent_key)) {
+    LOG_TRACE("no space to redistribute nodes. page num=%d, neighbor page num=%d", node.page_num(), neighbor_node.page_num());
+    return RC::SUCCESS;
+  }
+
   if (index == 0) {
     // the neighbor is at right
     neighbor_node.move_first_to_end(node);
@@ -1856,7 +2507,7 @@ BplusTreeScanner::BplusTreeScanner(BplusTreeHandler &tree_handler)
 BplusTreeScanner::~BplusTreeScanner() { close(); }
 
 RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key,
-    int right_len, bool right_inclusive)
+    int right_len, bool right_inclusive, bool reverse /* = false */)
 {
   RC rc = RC::SUCCESS;
   if (inited_) {
@@ -1866,6 +2517,10 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
 
   inited_        = true;
   first_emitted_ = false;
+  reverse_       = reverse;
+
+  read_ahead_detector_.set_window(tree_handler_.buffer_pool().read_ahead_pages());
+  read_ahead_detector_.reset();
 
   LatchMemo &latch_memo = mtr_.latch_memo();
 
@@ -1880,6 +2535,10 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
     }
   }
 
+  if (reverse_) {
+    return open_reverse(left_user_key, left_len, left_inclusive, right_user_key, right_len, right_inclusive);
+  }
+
   if (nullptr == left_user_key) {
     rc = tree_handler_.left_most_page(mtr_, current_frame_);
     if (OB_FAIL(rc)) {
@@ -1993,6 +2652,113 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
   return RC::SUCCESS;
 }
 
+RC BplusTreeScanner::open_reverse(const char *left_user_key, int left_len, bool left_inclusive,
+    const char *right_user_key, int right_len, bool right_inclusive)
+{
+  RC rc = RC::SUCCESS;
+
+  // 从比 right_limit 小的最后一个键值开始向左扫描
+  MemPoolItem::item_unique_ptr right_limit;
+  if (right_user_key != nullptr) {
+    char *fixed_right_key = const_cast<char *>(right_user_key);
+    if (tree_handler_.file_header_.attr_type[1] == AttrType::CHARS) {
+      bool should_inclusive_after_fix = false;
+      rc = fix_user_key(right_user_key, right_len, false /*want_greater*/, &fixed_right_key, &should_inclusive_after_fix);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to fix right user key. rc=%s", strrc(rc));
+        return rc;
+      }
+
+      if (should_inclusive_after_fix) {
+        right_inclusive = true;
+      }
+    }
+
+    right_limit = tree_handler_.make_key(fixed_right_key, right_inclusive ? *RID::max() : *RID::min());
+
+    if (fixed_right_key != right_user_key) {
+      delete[] fixed_right_key;
+    }
+  }
+
+  // 比 left_key_ 小时结束扫描
+  if (left_user_key != nullptr) {
+    char *fixed_left_key = const_cast<char *>(left_user_key);
+    if (tree_handler_.file_header_.attr_type[1] == AttrType::CHARS) {
+      bool should_inclusive_after_fix = false;
+      rc = fix_user_key(left_user_key, left_len, true /*want_greater*/, &fixed_left_key, &should_inclusive_after_fix);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to fix left user key. rc=%s", strrc(rc));
+        return rc;
+      }
+
+      if (should_inclusive_after_fix) {
+        left_inclusive = true;
+      }
+    }
+
+    left_key_ = tree_handler_.make_key(fixed_left_key, left_inclusive ? *RID::min() : *RID::max());
+
+    if (fixed_left_key != left_user_key) {
+      delete[] fixed_left_key;
+    }
+  }
+
+  rc = tree_handler_.find_prev_entry(mtr_, static_cast<const char *>(right_limit.get()), current_frame_, iter_index_);
+  if (rc == RC::RECORD_EOF) {
+    current_frame_ = nullptr;
+    return RC::SUCCESS;
+  } else if (OB_FAIL(rc)) {
+    LOG_WARN("failed to find the last entry to scan. rc=%s", strrc(rc));
+    current_frame_ = nullptr;
+    return rc;
+  }
+
+  if (touch_end()) {
+    mtr_.latch_memo().release();
+    current_frame_ = nullptr;
+  }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeScanner::prev_entry(RID &rid)
+{
+  iter_index_--;
+  if (iter_index_ >= 0) {
+    if (touch_end()) {
+      return RC::RECORD_EOF;
+    }
+
+    fetch_item(rid);
+    return RC::SUCCESS;
+  }
+
+  // 当前叶子节点已经遍历完，记下它的第一个键值，从根节点重新查找比这个键值小的最后一个键值。
+  // 先释放当前叶子节点的锁再从根节点加锁，避免与插入删除的加锁顺序相反
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  const char          *first_key = node.key_at(0);
+  key_buffer_.assign(first_key, first_key + tree_handler_.file_header_.key_length);
+
+  mtr_.latch_memo().release();
+  current_frame_ = nullptr;
+
+  RC rc = tree_handler_.find_prev_entry(mtr_, key_buffer_.data(), current_frame_, iter_index_);
+  if (OB_FAIL(rc)) {
+    current_frame_ = nullptr;
+    if (rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to find previous entry. rc=%s", strrc(rc));
+    }
+    return rc;
+  }
+
+  if (touch_end()) {
+    return RC::RECORD_EOF;
+  }
+
+  fetch_item(rid);
+  return RC::SUCCESS;
+}
+
 void BplusTreeScanner::fetch_item(RID &rid)
 {
   LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
@@ -2001,6 +2767,15 @@ void BplusTreeScanner::fetch_item(RID &rid)
 
 bool BplusTreeScanner::touch_end()
 {
+  if (reverse_) {
+    if (left_key_ == nullptr) {
+      return false;
+    }
+
+    LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+    return tree_handler_.key_comparator_(node.key_at(iter_index_), static_cast<char *>(left_key_.get())) < 0;
+  }
+
   if (right_key_ == nullptr) {
     return false;
   }
@@ -2025,6 +2800,10 @@ RC BplusTreeScanner::next_entry(RID &rid)
     return RC::SUCCESS;
   }
 
+  if (reverse_) {
+    return prev_entry(rid);
+  }
+
   iter_index_++;
 
   LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
@@ -2043,6 +2822,13 @@ RC BplusTreeScanner::next_entry(RID &rid)
     return RC::RECORD_EOF;
   }
 
+  // 叶子节点通常是按照顺序分配的，沿着叶子链表遍历时也可以预读
+  PageNum read_ahead_start = BP_INVALID_PAGE_NUM;
+  int     read_ahead_count = 0;
+  if (read_ahead_detector_.access(next_page_num, read_ahead_start, read_ahead_count)) {
+    (void)tree_handler_.buffer_pool().read_ahead(read_ahead_start, read_ahead_count);
+  }
+
   LatchMemo &latch_memo = mtr_.latch_memo();
 
   const int memo_point = latch_memo.memo_point();
@@ -2067,6 +2853,20 @@ RC BplusTreeScanner::next_entry(RID &rid)
   return next_entry(rid);
 }
 
+RC BplusTreeScanner::next_entry(RID &rid, const char *&key)
+{
+  RC rc = next_entry(rid);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  const char          *this_key = node.key_at(iter_index_);
+  key_buffer_.assign(this_key, this_key + tree_handler_.file_header_.key_length);
+  key = key_buffer_.data();
+  return RC::SUCCESS;
+}
+
 RC BplusTreeScanner::close()
 {
   inited_ = false;
@@ -19,9 +19,14 @@ See the Mulan PSL v2 for more details. */
 
 #include <string.h>
 
+#include "common/defs.h"
+#include "common/lang/atomic.h"
 #include "common/lang/comparator.h"
+#include "common/lang/list.h"
 #include "common/lang/memory.h"
+#include "common/lang/span.h"
 #include "common/lang/sstream.h"
+#include "common/lang/vector.h"
 #include "common/lang/functional.h"
 #include "common/log/log.h"
 #include "sql/parser/parse_defs.h"
@@ -53,52 +58,98 @@ enum class BplusTreeOperationType
 /**
  * @brief 属性比较(BplusTree)
  * @ingroup BPlusTree
+ * @details 键值中的第一个属性是记录的NULL位图(__my_null_field__)，不参与比较，后面的属性依次排列。
+ * 比较是B+树查找、插入最内层的循环，所以在 init 时就根据属性类型选好比较方式，比较时直接读取键值中的原始字节，
+ * 不构造 Value，也没有虚函数调用。只有一个 INTS/DATES/FLOATS/CHARS 属性时走专门的分支，
+ * 多个属性时逐个按照类型比较。TEXT、VECTORS 这类不能直接比较字节的类型，仍然使用 DataType::compare。
+ * 比较的结果与 DataType::compare 一致，比如浮点数使用 EPSILON 判断相等，字符串遇到'\0'结束。
  */
 class AttrComparator
 {
 public:
-  void init(int attr_num, const AttrType *attr_type, const int *attr_length, const int *offset)
+  void init(int attr_num, const AttrType *attr_type, const int *attr_length, const int *offset);
+
+  int attr_length() const { return attr_length_; }
+
+  int operator()(const char *v1, const char *v2) const
   {
-    for (int i = 0; i < attr_num; i++) {
-      attr_type_.emplace_back(attr_type[i]);
-      attr_length_.emplace_back(attr_length[i]);
-      offset_.emplace_back(offset[i]);
+    switch (kind_) {
+      case Kind::INT: return compare_int_key(v1 + first_attr_.offset, v2 + first_attr_.offset);
+      case Kind::FLOAT: return compare_float_key(v1 + first_attr_.offset, v2 + first_attr_.offset);
+      case Kind::CHARS: return compare_chars_key(v1 + first_attr_.offset, v2 + first_attr_.offset, first_attr_.length);
+      case Kind::NONE: return 0;
+      default: return compare_composite(v1, v2);
     }
   }
 
-  int attr_length() const {
-    int length = 0;
-    for (int i = 0; i < attr_length_.size(); i++) {
-      length += attr_length_[i];
-    }
-    return length;
+private:
+  /// 键值中的一个属性，offset 是属性在键值中的偏移
+  struct KeyAttr
+  {
+    AttrType type   = AttrType::UNDEFINED;
+    int      offset = 0;
+    int      length = 0;
+  };
+
+  enum class Kind
+  {
+    NONE,       ///< 没有需要比较的属性
+    INT,        ///< 一个 INTS 或 DATES 属性
+    FLOAT,      ///< 一个 FLOATS 属性
+    CHARS,      ///< 一个定长的 CHARS 属性
+    COMPOSITE,  ///< 多个属性，或者其它类型的属性
+  };
+
+  /// 键值在页面中不一定是对齐的，使用 memcpy 读取
+  static int compare_int_key(const char *v1, const char *v2)
+  {
+    int32_t left, right;
+    memcpy(&left, v1, sizeof(left));
+    memcpy(&right, v2, sizeof(right));
+    return (left > right) - (left < right);
   }
 
-  int operator()(const char *v1, const char *v2) const
+  static int compare_float_key(const char *v1, const char *v2)
   {
-    // TODO: optimized the comparison
-    int offset=attr_length_[0];
-    for(int i=1;i<attr_length_.size();i++){
-      Value left;
-      left.set_type(attr_type_[i]);
-      left.set_data(v1+offset, attr_length_[i]);
-      Value right;
-      right.set_type(attr_type_[i]);
-      right.set_data(v2+offset, attr_length_[i]);
-      LOG_INFO("%s",attr_type_to_string(attr_type_[i]));
-      int res = DataType::type_instance(attr_type_[i])->compare(left, right);
-      if(res != 0){
-        return res;
+    float left, right;
+    memcpy(&left, v1, sizeof(left));
+    memcpy(&right, v2, sizeof(right));
+    const float cmp = left - right;
+    return (cmp > EPSILON) - (cmp < -EPSILON);
+  }
+
+  static int compare_chars_key(const char *v1, const char *v2, int length)
+  {
+    const int result = strncmp(v1, v2, length);
+    return (result > 0) - (result < 0);
+  }
+
+  int compare_composite(const char *v1, const char *v2) const
+  {
+    for (const KeyAttr &attr : attrs_) {
+      int result = 0;
+      switch (attr.type) {
+        case AttrType::INTS:
+        case AttrType::DATES: result = compare_int_key(v1 + attr.offset, v2 + attr.offset); break;
+        case AttrType::FLOATS: result = compare_float_key(v1 + attr.offset, v2 + attr.offset); break;
+        case AttrType::CHARS: result = compare_chars_key(v1 + attr.offset, v2 + attr.offset, attr.length); break;
+        default: result = compare_value(attr, v1, v2); break;
+      }
+      if (result != 0) {
+        return result;
       }
-      offset+=attr_length_[i];
     }
     return 0;
   }
 
+  /// 其它类型使用 DataType::compare 比较
+  static int compare_value(const KeyAttr &attr, const char *v1, const char *v2);
+
 private:
-  std::vector<AttrType> attr_type_;
-  std::vector<int>      attr_length_;
-  std::vector<int>      offset_;
+  Kind            kind_        = Kind::NONE;
+  int             attr_length_ = 0;  ///< 所有属性的长度之和，包括NULL位图
+  KeyAttr         first_attr_;       ///< 第一个参与比较的属性
+  vector<KeyAttr> attrs_;            ///< 所有参与比较的属性
 };
 
 /**
@@ -118,7 +169,6 @@ public:
 
   int operator()(const char *v1, const char *v2) const
   {
-    LOG_DEBUG("KeyComparator::operator()");
     int result = attr_comparator_(v1, v2);
     if (result != 0 || is_unique) {
       return result;
@@ -131,7 +181,7 @@ public:
 
 private:
   AttrComparator attr_comparator_;
-  bool is_unique;
+  bool is_unique = false;
 };
 
 /**
@@ -249,16 +299,19 @@ struct IndexFileHeader
  * @ingroup BPlusTree
  * @code
  * storage format:
- * | page type | item number | parent page id |
+ * | page type | prefix length | item number | parent page id |
  * @endcode
+ * 页面中所有的键值都有一段相同的前缀，前缀只在页面数据的开头存储一份，每个元素只存储前缀之后的部分。
+ * 同一个页面中的元素依然是定长的，可以直接按照下标做二分查找。
  */
 struct IndexNode
 {
   static constexpr int HEADER_SIZE = 12;
 
-  bool    is_leaf;  /// 当前是叶子节点还是内部节点
-  int     key_num;  /// 当前页面上一共有多少个键值对
-  PageNum parent;   /// 父节点页面编号
+  bool     is_leaf;        /// 当前是叶子节点还是内部节点
+  uint16_t prefix_length;  /// 页面中所有键值共同的前缀长度
+  int      key_num;        /// 当前页面上一共有多少个键值对
+  PageNum  parent;         /// 父节点页面编号
 };
 
 /**
@@ -266,8 +319,8 @@ struct IndexNode
  * @ingroup BPlusTree
  * @code
  * storage format:
- * | common header | prev page id | next page id |
- * | key0, rid0 | key1, rid1 | ... | keyn, ridn |
+ * | common header | next page id |
+ * | key prefix | key0 suffix, rid0 | key1 suffix, rid1 | ... | keyn suffix, ridn |
  * @endcode
  * the key is in format: the key value of record and rid.
  * so the key in leaf page must be unique.
@@ -291,7 +344,7 @@ struct LeafIndexNode : public IndexNode
  * @code
  * storage format:
  * | common header |
- * | key(0),page_id(0) | key(1), page_id(1) | ... | key(n), page_id(n) |
+ * | key prefix | key(0) suffix,page_id(0) | key(1) suffix, page_id(1) | ... | key(n) suffix, page_id(n) |
  * @endcode
  * the first key is ignored(key0).
  * so it will waste space, can you fix this?
@@ -325,12 +378,15 @@ public:
   /// 是否叶子节点
   bool is_leaf() const;
 
-  /// @brief 存储的键值大小
-  virtual int key_size() const;
-  /// @brief 存储的值的大小。内部节点和叶子节点是不一样的，但是这里返回的是叶子节点存储的大小
-  virtual int value_size() const;
-  /// @brief 存储的键值对的大小。值是指叶子节点中存放的数据
-  virtual int item_size() const;
+  /// @brief 完整的键值大小，包括前缀
+  int key_size() const;
+  /// @brief 存储的值的大小。叶子节点是RID，内部节点是子节点的页号
+  int value_size() const;
+  /// @brief 完整的键值对的大小。对外提供或者记录日志的元素都是完整的，不会省略前缀
+  int item_size() const;
+
+  /// @brief 当前页面所有键值共同的前缀长度
+  int prefix_length() const;
 
   void    increase_size(int n);
   int     size() const;
@@ -345,14 +401,27 @@ public:
    * @details 安全是指在操作执行后，节点不需要调整，比如分裂、合并或重新分配
    * @param op 将要执行的操作
    * @param is_root_node 是否根节点
+   * @param key 将要插入的键值。叶子节点可以根据键值判断插入后前缀是否会变短，为空时按照最坏的情况判断
    */
-  bool is_safe(BplusTreeOperationType op, bool is_root_node);
+  bool is_safe(BplusTreeOperationType op, bool is_root_node, const char *key = nullptr);
+
+  /**
+   * @brief 插入这些元素后，当前页面是否还能放得下
+   * @details 新的键值可能会让公共前缀变短，所有元素存储的部分都会变长，所以不能只看元素个数
+   * @param items 完整的元素
+   */
+  bool can_insert(const char *items, int num) const;
 
   /**
    * @brief 验证当前节点是否有问题
    */
   bool validate() const;
 
+  /// @brief 把第 index 个完整的键值复制到 key 中
+  void get_key(int index, char *key) const;
+  /// @brief 把从 index 开始的 num 个完整的元素复制到 items 中
+  void get_items(int index, int num, vector<char> &items) const;
+
   Frame *frame() const { return frame_; }
 
   friend string to_string(const IndexNodeHandler &handler);
@@ -360,21 +429,55 @@ public:
   RC recover_insert_items(int index, const char *items, int num);
   RC recover_remove_items(int index, int num);
 
+  /// @brief 页面上可以存放前缀和元素的空间
+  static int data_capacity(bool leaf);
+
+  /// @brief 前缀长度是 prefix_length 时，存放 num 个元素需要的空间
+  static int space_needed(int key_size, int value_size, int prefix_length, int num)
+  {
+    return prefix_length + num * (key_size - prefix_length + value_size);
+  }
+
 protected:
+  /// @brief 第 index 个元素在页面中的位置，这里只存储了键值去掉前缀之后的部分
+  char *__item_at(int index) const { return __array() + prefix_length() + index * stored_item_size(); }
+  char *__key_at(int index) const { return __item_at(index); }
+  char *__value_at(int index) const { return __item_at(index) + stored_key_size(); };
+  /// @brief 页面数据开始的位置，最前面是公共前缀
+  char *__array() const;
+
+  int stored_key_size() const { return key_size() - prefix_length(); }
+  int stored_item_size() const { return stored_key_size() + value_size(); }
+
+  /// @brief 把键值的前缀换成 prefix_length 这么长，已有的元素都挪到新的位置上。前缀只会变短
+  void shrink_prefix(int prefix_length);
+  /// @brief 当前页面的前缀与 key 的公共前缀长度
+  int common_prefix_length(const char *key) const;
+  /// @brief 插入这些元素后，当前页面公共前缀的长度
+  int prefix_length_after_insert(const char *items, int num) const;
+
+  /**
+   * @brief 在 [first, last) 范围内查找第一个不小于 key 的位置
+   * @details 每次比较时把前缀和元素中存储的部分拼成完整的键值，再使用 comparator 比较。
+   * 乐观读时页面可能正在被修改，这里只读取一次页面头，并且保证不会访问页面之外的内存。
+   */
+  int lower_bound(const KeyComparator &comparator, const char *key, int first, bool *found) const;
+
   /**
-   * @brief 获取指定元素的开始内存位置
-   * @note 这并不是一个纯虚函数，是为了可以直接使用 IndexNodeHandler 类。
-   * 但是使用这个类时，注意不能使用与这个函数相关的函数。
+   * @brief 分裂时从哪个位置开始把元素移到新节点上
+   * @details 在中间位置附近找相邻两个键值公共前缀最短的位置分开，分裂后两边页面的公共前缀都尽量长，
+   * 推到父节点上的分隔键值也是这个范围内区分度最高的键值。
+   * 分裂后两边的元素个数都不超过页面在没有前缀时能放下的个数，保证新元素一定能插入。
    */
-  virtual char *__item_at(int index) const { return nullptr; }
-  char         *__key_at(int index) const { return __item_at(index); }
-  char         *__value_at(int index) const { return __item_at(index) + key_size(); };
+  int split_index() const;
 
 protected:
   BplusTreeMiniTransaction &mtr_;
   const IndexFileHeader    &header_;
   Frame                    *frame_ = nullptr;
   IndexNode                *node_  = nullptr;
+
+  vector<char> key_buffer_;  ///< key_at 返回的完整键值
 };
 
 /**
@@ -391,6 +494,7 @@ public:
   RC      set_next_page(PageNum page_num);
   PageNum next_page() const;
 
+  /// @brief 返回完整的键值。键值存放在当前对象的缓存中，下次调用 key_at 之前有效
   char *key_at(int index);
   char *value_at(int index);
 
@@ -414,10 +518,9 @@ public:
   bool validate(const KeyComparator &comparator, DiskBufferPool *bp) const;
 
   friend string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer);
+  friend class BplusTreeBulkLoader;
 
 protected:
-  char *__item_at(int index) const override;
-
   RC append(const char *items, int num);
   RC append(const char *item);
   RC preappend(const char *item);
@@ -439,15 +542,27 @@ public:
   RC init_empty();
   RC create_new_root(PageNum first_page_num, const char *key, PageNum page_num);
 
-  RC      insert(const char *key, PageNum page_num, const KeyComparator &comparator);
+  RC insert(const char *key, PageNum page_num, const KeyComparator &comparator);
+  /// @brief 返回完整的键值。键值存放在当前对象的缓存中，下次调用 key_at 之前有效
   char   *key_at(int index);
   PageNum value_at(int index);
 
+  /**
+   * @brief 不检查下标的 value_at
+   * @details 乐观读时节点可能正在被修改，lookup 和这里读到的 size、前缀长度可能不一样。
+   * 计算出来的位置超出页面时返回 BP_INVALID_PAGE_NUM，调用方校验版本号时会发现页面被修改过
+   */
+  PageNum value_at_unchecked(int index) const;
+
   /**
    * 返回指定子节点在当前节点中的索引
    */
-  int  value_index(PageNum page_num);
+  int value_index(PageNum page_num);
+
+  /// @brief 修改指定位置的键值。调用前需要使用 can_set_key_at 确认页面放得下
   void set_key_at(int index, const char *key);
+  /// @brief 把指定位置的键值换成 key 之后，页面是否还能放得下
+  bool can_set_key_at(int index, const char *key) const;
   void remove(int index);
 
   /**
@@ -474,6 +589,7 @@ public:
   bool validate(const KeyComparator &comparator, DiskBufferPool *bp) const;
 
   friend string to_string(const InternalIndexNodeHandler &handler, const KeyPrinter &printer);
+  friend class BplusTreeBulkLoader;
 
 private:
   RC insert_items(int index, const char *items, int num);
@@ -481,12 +597,6 @@ private:
   RC append(const char *item);
   RC preappend(const char *item);
 
-private:
-  char *__item_at(int index) const override;
-
-  int value_size() const override;
-  int item_size() const override;
-
 private:
   InternalIndexNode *internal_node_ = nullptr;
 };
@@ -552,6 +662,18 @@ public:
    */
   RC get_entry(const char *user_key, int key_len, list<RID> &rids);
 
+  /**
+   * @brief 批量获取多个值的record
+   * @details 先把要查找的键值排序，然后按顺序在叶子节点上查找。下一个键值还在当前叶子节点或者下一个叶子节点
+   * 上时，就不用再从根节点开始查找，沿着叶子链表向后走时与扫描器一样做预读。这样连接、IN (...) 等一次查找
+   * 多个值的场景，就是对B+树的一次有序遍历，而不是多次随机查找。
+   * 索引的第一个字段是CHARS类型时，逐个调用 get_entry。
+   * @param user_keys 要查找的值，格式与 get_entry 的 user_key 一样，可以有重复的值
+   * @param key_len user_key的长度
+   * @param[out] rids 与 user_keys 一一对应的查找结果
+   */
+  RC get_entries(span<const char *const> user_keys, int key_len, vector<list<RID>> &rids);
+
   RC sync();
 
   /**
@@ -604,6 +726,31 @@ protected:
    */
   RC find_leaf(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame);
 
+  /**
+   * @brief 沿着叶子链表移动到下一个叶子节点
+   * @details 与 BplusTreeScanner::next_entry 一样，先给下一个页面加读锁再释放当前页面。
+   * 为了避免死锁，只尝试加锁，加锁失败时返回 LOCKED_NEED_WAIT，由调用方从根节点重新查找。
+   * @param[in,out] frame 当前的叶子节点，成功时返回下一个叶子节点
+   * @return 已经是最后一个叶子节点时返回 RECORD_EOF
+   */
+  RC next_leaf(BplusTreeMiniTransaction &mtr, ReadAheadDetector &read_ahead_detector, Frame *&frame);
+
+  /**
+   * @brief 查找比 key 小的最后一个键值，逆序扫描时使用
+   * @details 叶子节点只有指向下一个叶子节点的指针，逆序扫描移动到前一个叶子节点时需要从根节点重新查找。
+   * 从根节点开始加读锁，先在 key 所在的子树中查找，找不到时(叶子节点可能是空的)再依次查找左边的子树。
+   * 返回的叶子节点加了读锁，路径上的锁都会释放，包括调用之前 mtr 中已经有的锁。
+   * @param key 为空时查找整棵树的最后一个键值
+   * @param[out] frame 找到的键值所在的叶子节点
+   * @param[out] index 找到的键值在叶子节点中的位置
+   * @return 没有比 key 小的键值时返回 RECORD_EOF
+   */
+  RC find_prev_entry(BplusTreeMiniTransaction &mtr, const char *key, Frame *&frame, int &index);
+
+  /// @brief 在 page_num 这棵子树中查找比 key 小的最后一个键值。找不到时释放在这棵子树上加的锁
+  RC find_prev_entry_in_subtree(
+      BplusTreeMiniTransaction &mtr, PageNum page_num, const char *key, Frame *&frame, int &index);
+
   /**
    * @brief 找到最左边的叶子节点
    */
@@ -613,16 +760,26 @@ protected:
    * @brief 查找指定的叶子节点
    * @param op 当前想要执行的操作。操作类型不同会在查找的过程中加不同类型的锁
    * @param child_page_getter 用于获取子节点的函数
+   * @param key 查找的键值，插入时用来判断叶子节点是否安全，可以为空
    * @param[out] frame 返回找到的叶子节点
    */
   RC find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op,
+      const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, const char *key, Frame *&frame);
+
+  /**
+   * @brief 使用乐观锁耦合(optimistic lock coupling)查找叶子节点
+   * @details 内部节点不加锁，只记下页面的版本号，读出子节点的页号并拿到子节点的版本号后，再校验父节点的版本号。
+   * 版本号有变化说明读的过程中节点被修改了，返回 LOCKED_CONCURRENCY_CONFLICT，由调用方重新查找。
+   * 叶子节点加读锁后返回，与 crabing protocol 的结果一样。
+   */
+  RC optimistic_find_leaf(BplusTreeMiniTransaction &mtr,
       const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame);
 
   /**
    * @brief 使用crabing protocol 获取页面
    */
-  RC crabing_protocal_fetch_page(
-      BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, PageNum page_num, bool is_root_page, Frame *&frame);
+  RC crabing_protocal_fetch_page(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, PageNum page_num,
+      bool is_root_page, const char *key, Frame *&frame);
 
   /**
    * @brief 从叶子节点中删除指定的键值对
@@ -685,6 +842,9 @@ protected:
 private:
   common::MemPoolItem::item_unique_ptr make_key(const char *user_key, const RID &rid);
 
+  /// @brief 把记录中的索引字段和RID拼成键值，写到 key 中。key 的长度是 file_header_.key_length
+  void make_key(const char *user_key, const RID &rid, char *key) const;
+
 protected:
   LogHandler     *log_handler_      = nullptr;  /// 日志处理器
   DiskBufferPool *disk_buffer_pool_ = nullptr;  /// 磁盘缓冲池
@@ -695,6 +855,12 @@ protected:
   // 这个锁可以使用递归读写锁，但是这里偷懒先不改
   common::SharedMutex root_lock_;
 
+  /// 根节点页号的版本号，更新根节点页号时加1。乐观读使用它确认读到的根节点没有被替换
+  atomic<uint64_t> root_version_{0};
+
+  /// 乐观读冲突多次之后，改为加锁的方式查找
+  static constexpr int OPTIMISTIC_READ_RETRY_TIMES = 8;
+
   KeyComparator key_comparator_;
   KeyPrinter    key_printer_;
 
@@ -703,6 +869,7 @@ protected:
 private:
   friend class BplusTreeScanner;
   friend class BplusTreeTester;
+  friend class BplusTreeBulkLoader;
 };
 
 /**
@@ -723,22 +890,30 @@ public:
    * @param right_user_key 扫描范围的右边界。如果是null，则没有右边界
    * @param right_len right_user_key 的内存大小(只有在变长字段中才会关注)
    * @param right_inclusive 右边界的值是否包含在内
+   * @param reverse 是否从右边界向左边界逆序扫描
    * TODO 重构参数表示方法
    */
   RC open(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key, int right_len,
-      bool right_inclusive);
+      bool right_inclusive, bool reverse = false);
 
   /**
    * @brief 获取下一条记录
    *
    * @param rid 当前默认所有值都是RID类型。对B+树来说并不是一个好的抽象
    * @return RC RECORD_EOF 表示遍历完成
-   * TODO 需要增加返回 key 的接口
    * @warning 不要在遍历时删除数据。删除数据会导致遍历器失效。
    * 当前默认的走索引删除的逻辑就是这样做的，所以删除逻辑有BUG。
    */
   RC next_entry(RID &rid);
 
+  /**
+   * @brief 获取下一条记录和它在索引中的键值
+   * @details 只用到索引字段时，可以直接从键值中取字段的值，不需要再去读记录。
+   * @param[out] key 索引字段的值按照创建索引时的顺序依次排列，最后是RID，长度是 file_header().key_length。
+   * 下次调用 next_entry 之前有效
+   */
+  RC next_entry(RID &rid, const char *&key);
+
   /**
    * @brief 关闭当前扫描器
    * @details 可以不调用，在析构函数时会自动执行
@@ -751,6 +926,13 @@ private:
    */
   RC fix_user_key(const char *user_key, int key_len, bool want_greater, char **fixed_key, bool *should_inclusive);
 
+  /// @brief 逆序扫描时定位到右边界
+  RC open_reverse(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key,
+      int right_len, bool right_inclusive);
+
+  /// @brief 逆序扫描时获取下一条记录
+  RC prev_entry(RID &rid);
+
   void fetch_item(RID &rid);
 
   /**
@@ -768,6 +950,12 @@ private:
   Frame *current_frame_ = nullptr;
 
   common::MemPoolItem::item_unique_ptr right_key_;
+  common::MemPoolItem::item_unique_ptr left_key_;  ///< 逆序扫描时使用左边界判断是否结束
   int                                  iter_index_    = -1;
   bool                                 first_emitted_ = false;
+  bool                                 reverse_       = false;
+
+  vector<char> key_buffer_;  ///< next_entry 返回的键值
+
+  ReadAheadDetector read_ahead_detector_;  /// 检测叶子节点是否是顺序分配的
 };
@@ -0,0 +1,496 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "storage/index/bplus_tree_bulk_loader.h"
+#include "common/io/io.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/memory.h"
+#include "common/lang/queue.h"
+#include "common/log/log.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace common;
+
+namespace {
+
+/// 每次读写临时文件的大小
+constexpr int RUN_IO_SIZE = 64 * 1024;
+
+/**
+ * @brief 顺序读取一个排好序的临时文件
+ */
+class SortedRunReader
+{
+public:
+  SortedRunReader(int key_length, int64_t key_num) : key_length_(key_length), remain_keys_(key_num)
+  {
+    buffer_.resize(static_cast<size_t>(max(1, RUN_IO_SIZE / key_length_)) * key_length_);
+  }
+
+  ~SortedRunReader()
+  {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  RC open(const string &file_name)
+  {
+    fd_ = ::open(file_name.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      LOG_WARN("failed to open sort run file. file=%s, error=%s", file_name.c_str(), strerror(errno));
+      return RC::IOERR_OPEN;
+    }
+    return RC::SUCCESS;
+  }
+
+  /// @brief 移动到下一个键值，读完时返回 RECORD_EOF
+  RC next()
+  {
+    pos_ += key_length_;
+    if (pos_ < buffered_) {
+      return RC::SUCCESS;
+    }
+
+    if (remain_keys_ <= 0) {
+      return RC::RECORD_EOF;
+    }
+
+    const int64_t read_keys = min<int64_t>(remain_keys_, buffer_.size() / key_length_);
+    const int     size      = static_cast<int>(read_keys * key_length_);
+    int           ret       = readn(fd_, buffer_.data(), size);
+    if (ret != 0) {
+      LOG_WARN("failed to read sort run file. ret=%d, error=%s", ret, strerror(errno));
+      return RC::IOERR_READ;
+    }
+
+    remain_keys_ -= read_keys;
+    buffered_ = size;
+    pos_      = 0;
+    return RC::SUCCESS;
+  }
+
+  const char *current() const { return buffer_.data() + pos_; }
+
+private:
+  int          fd_          = -1;
+  int          key_length_  = 0;
+  int64_t      remain_keys_ = 0;
+  vector<char> buffer_;
+  int          buffered_ = 0;
+  int          pos_      = -key_length_;
+};
+
+}  // namespace
+
+BplusTreeBulkLoader::BplusTreeBulkLoader(BplusTreeHandler &tree_handler, const BplusTreeBulkLoadOptions &options)
+    : tree_handler_(tree_handler), options_(options), key_length_(tree_handler.file_header().key_length)
+{}
+
+BplusTreeBulkLoader::~BplusTreeBulkLoader() { remove_run_files(); }
+
+RC BplusTreeBulkLoader::add(const char *user_key, const RID &rid)
+{
+  const int64_t memory_used =
+      static_cast<int64_t>(keys_.size()) + static_cast<int64_t>(keys_.size() / key_length_) * sizeof(const char *);
+  if (!keys_.empty() && memory_used + key_length_ > options_.sort_memory_bytes) {
+    RC rc = spill_run();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  const size_t offset = keys_.size();
+  keys_.resize(offset + key_length_);
+  tree_handler_.make_key(user_key, rid, keys_.data() + offset);
+  entry_num_++;
+  return RC::SUCCESS;
+}
+
+void BplusTreeBulkLoader::sort_memory_keys()
+{
+  sorted_keys_.clear();
+  sorted_keys_.reserve(keys_.size() / key_length_);
+  for (size_t offset = 0; offset < keys_.size(); offset += key_length_) {
+    sorted_keys_.push_back(keys_.data() + offset);
+  }
+
+  const KeyComparator &comparator = tree_handler_.key_comparator_;
+  sort(sorted_keys_.begin(), sorted_keys_.end(), [&comparator](const char *left, const char *right) {
+    return comparator(left, right) < 0;
+  });
+}
+
+RC BplusTreeBulkLoader::spill_run()
+{
+  sort_memory_keys();
+
+  string file_name = options_.temp_file_prefix + ".sort." + std::to_string(run_files_.size());
+  int    fd        = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IREAD | S_IWRITE);
+  if (fd < 0) {
+    LOG_WARN("failed to create sort run file. file=%s, error=%s", file_name.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  run_files_.push_back(file_name);
+  run_key_nums_.push_back(static_cast<int64_t>(sorted_keys_.size()));
+
+  RC           rc = RC::SUCCESS;
+  vector<char> buffer;
+  buffer.reserve(RUN_IO_SIZE + key_length_);
+  for (size_t i = 0; i <= sorted_keys_.size() && OB_SUCC(rc); i++) {
+    if (i < sorted_keys_.size()) {
+      buffer.insert(buffer.end(), sorted_keys_[i], sorted_keys_[i] + key_length_);
+    }
+
+    if (!buffer.empty() && (buffer.size() >= RUN_IO_SIZE || i == sorted_keys_.size())) {
+      int ret = writen(fd, buffer.data(), static_cast<int>(buffer.size()));
+      if (ret != 0) {
+        LOG_WARN("failed to write sort run file. file=%s, error=%s", file_name.c_str(), strerror(ret));
+        rc = RC::IOERR_WRITE;
+      }
+      buffer.clear();
+    }
+  }
+  ::close(fd);
+
+  LOG_INFO("spilled a sorted run of bplus tree bulk load. file=%s, keys=%ld", file_name.c_str(), sorted_keys_.size());
+  sorted_keys_.clear();
+  keys_.clear();
+  return rc;
+}
+
+RC BplusTreeBulkLoader::finish()
+{
+  if (!tree_handler_.is_empty()) {
+    LOG_WARN("cannot bulk load into a non-empty bplus tree");
+    return RC::INTERNAL;
+  }
+
+  RC rc = RC::SUCCESS;
+  if (run_files_.empty()) {
+    sort_memory_keys();
+
+    size_t index = 0;
+    rc = build([this, &index](const char *&key) {
+      if (index >= sorted_keys_.size()) {
+        return RC::RECORD_EOF;
+      }
+      key = sorted_keys_[index++];
+      return RC::SUCCESS;
+    });
+  } else {
+    if (!keys_.empty()) {
+      rc = spill_run();
+    }
+    if (OB_SUCC(rc)) {
+      rc = merge_runs_and_build();
+    }
+  }
+
+  keys_.clear();
+  sorted_keys_.clear();
+  remove_run_files();
+  return rc;
+}
+
+RC BplusTreeBulkLoader::merge_runs_and_build()
+{
+  vector<unique_ptr<SortedRunReader>> readers;
+
+  const KeyComparator &comparator = tree_handler_.key_comparator_;
+  auto                 greater    = [&comparator](SortedRunReader *left, SortedRunReader *right) {
+    return comparator(left->current(), right->current()) > 0;
+  };
+  priority_queue<SortedRunReader *, vector<SortedRunReader *>, decltype(greater)> heap(greater);
+
+  for (size_t i = 0; i < run_files_.size(); i++) {
+    auto reader = make_unique<SortedRunReader>(key_length_, run_key_nums_[i]);
+    RC   rc     = reader->open(run_files_[i]);
+    if (OB_SUCC(rc)) {
+      rc = reader->next();
+    }
+    if (OB_SUCC(rc)) {
+      heap.push(reader.get());
+    } else if (rc != RC::RECORD_EOF) {
+      return rc;
+    }
+    readers.push_back(std::move(reader));
+  }
+
+  LOG_INFO("merging %ld sorted runs of bplus tree bulk load. keys=%ld", run_files_.size(), entry_num_);
+
+  // 读取下一个文件的数据时，当前键值所在的缓存会被覆盖，所以复制一份
+  vector<char> current_key(key_length_);
+  return build([&heap, &current_key](const char *&key) {
+    if (heap.empty()) {
+      return RC::RECORD_EOF;
+    }
+
+    SortedRunReader *reader = heap.top();
+    heap.pop();
+    memcpy(current_key.data(), reader->current(), current_key.size());
+    key = current_key.data();
+
+    RC rc = reader->next();
+    if (OB_SUCC(rc)) {
+      heap.push(reader);
+    } else if (rc != RC::RECORD_EOF) {
+      return rc;
+    }
+    return RC::SUCCESS;
+  });
+}
+
+RC BplusTreeBulkLoader::build(const KeyStream &stream)
+{
+  vector<char> level_items;
+  int64_t      level_num = 0;
+
+  RC rc = build_leaves(stream, level_items, level_num);
+  if (OB_FAIL(rc) || level_num == 0) {
+    return rc;
+  }
+
+  int level = 1;
+  while (level_num > 1) {
+    vector<char> parent_items;
+    int64_t      parent_num = 0;
+    rc = build_internal_level(level_items, level_num, parent_items, parent_num);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    level_items.swap(parent_items);
+    level_num = parent_num;
+    level++;
+  }
+
+  PageNum root_page_num = BP_INVALID_PAGE_NUM;
+  memcpy(&root_page_num, level_items.data() + key_length_, sizeof(root_page_num));
+
+  BplusTreeMiniTransaction mtr(tree_handler_, &rc);
+  tree_handler_.update_root_page_num_locked(mtr, root_page_num);
+
+  LOG_INFO("bplus tree bulk loaded. entries=%ld, levels=%d, root page=%d", entry_num_, level, root_page_num);
+  return rc;
+}
+
+RC BplusTreeBulkLoader::build_leaves(const KeyStream &stream, vector<char> &parent_items, int64_t &leaf_num)
+{
+  const IndexFileHeader &header     = tree_handler_.file_header();
+  const KeyComparator   &comparator = tree_handler_.key_comparator_;
+  const int              item_size  = key_length_ + sizeof(RID);
+  const int              rid_offset = key_length_ - sizeof(RID);
+
+  leaf_num = 0;
+  parent_items.clear();
+
+  // 缓存最多一个节点能放下的元素，每次从前面取出一个节点的元素
+  vector<char> items(static_cast<size_t>(header.leaf_max_size) * item_size);
+  int          buffered_num = 0;
+  bool         eof          = false;
+  int64_t      key_num      = 0;
+  vector<char> last_key(key_length_);
+  PageNum      last_page_num = BP_INVALID_PAGE_NUM;
+
+  RC rc = RC::SUCCESS;
+  while (true) {
+    while (!eof && buffered_num < header.leaf_max_size) {
+      const char *key = nullptr;
+      rc              = stream(key);
+      if (rc == RC::RECORD_EOF) {
+        eof = true;
+        break;
+      }
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get next sorted key. rc=%s", strrc(rc));
+        return rc;
+      }
+
+      if (key_num > 0) {
+        const int result = comparator(last_key.data(), key);
+        if (result == 0) {
+          LOG_TRACE("duplicate key found while bulk loading bplus tree");
+          return RC::RECORD_DUPLICATE_KEY;
+        }
+        ASSERT(result < 0, "keys are not sorted while bulk loading bplus tree");
+      }
+      memcpy(last_key.data(), key, key_length_);
+      key_num++;
+
+      char *item = items.data() + static_cast<size_t>(buffered_num) * item_size;
+      memcpy(item, key, key_length_);
+      memcpy(item + key_length_, key + rid_offset, sizeof(RID));
+      buffered_num++;
+    }
+
+    if (buffered_num == 0) {
+      break;
+    }
+
+    const int item_num = fill_node(items.data(), buffered_num, true /*leaf*/, eof);
+
+    BplusTreeMiniTransaction mtr(tree_handler_, &rc);
+
+    Frame *frame = nullptr;
+    rc           = mtr.latch_memo().allocate_page(frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate leaf page. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    LeafIndexNodeHandler leaf_node(mtr, header, frame);
+    rc = leaf_node.init_empty();
+    if (OB_SUCC(rc)) {
+      rc = leaf_node.append(items.data(), item_num);
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init leaf page. rc=%s", strrc(rc));
+      return rc;
+    }
+    frame->mark_dirty();
+
+    if (last_page_num != BP_INVALID_PAGE_NUM) {
+      Frame *last_frame = nullptr;
+      rc                = mtr.latch_memo().get_page(last_page_num, last_frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get last leaf page. page num=%d, rc=%s", last_page_num, strrc(rc));
+        return rc;
+      }
+      mtr.latch_memo().xlatch(last_frame);
+
+      LeafIndexNodeHandler last_leaf_node(mtr, header, last_frame);
+      rc = last_leaf_node.set_next_page(frame->page_num());
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      last_frame->mark_dirty();
+    }
+    last_page_num = frame->page_num();
+    leaf_num++;
+
+    const PageNum page_num = frame->page_num();
+    parent_items.insert(parent_items.end(), items.data(), items.data() + key_length_);
+    parent_items.insert(parent_items.end(), (const char *)&page_num, (const char *)&page_num + sizeof(page_num));
+
+    buffered_num -= item_num;
+    memmove(items.data(), items.data() + static_cast<size_t>(item_num) * item_size,
+        static_cast<size_t>(buffered_num) * item_size);
+  }
+
+  if (key_num != entry_num_) {
+    LOG_WARN("key number mismatch while bulk loading bplus tree. expect=%ld, got=%ld", entry_num_, key_num);
+    return RC::INTERNAL;
+  }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkLoader::build_internal_level(
+    const vector<char> &child_items, int64_t child_num, vector<char> &parent_items, int64_t &parent_num)
+{
+  const IndexFileHeader &header    = tree_handler_.file_header();
+  const int              item_size = key_length_ + sizeof(PageNum);
+
+  parent_num = 0;
+  parent_items.clear();
+
+  RC          rc          = RC::SUCCESS;
+  const char *items       = child_items.data();
+  int64_t     remain_num  = child_num;
+  while (remain_num > 0) {
+    const int item_num = fill_node(items, remain_num, false /*leaf*/, true /*is_last*/);
+
+    BplusTreeMiniTransaction mtr(tree_handler_, &rc);
+
+    Frame *frame = nullptr;
+    rc           = mtr.latch_memo().allocate_page(frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate internal page. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    // append 会把所有子节点的父节点设置为当前节点。第一个键值不会被使用
+    InternalIndexNodeHandler internal_node(mtr, header, frame);
+    rc = internal_node.init_empty();
+    if (OB_SUCC(rc)) {
+      rc = internal_node.append(items, item_num);
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init internal page. rc=%s", strrc(rc));
+      return rc;
+    }
+    frame->mark_dirty();
+    parent_num++;
+
+    const PageNum page_num = frame->page_num();
+    parent_items.insert(parent_items.end(), items, items + key_length_);
+    parent_items.insert(parent_items.end(), (const char *)&page_num, (const char *)&page_num + sizeof(page_num));
+
+    items += static_cast<size_t>(item_num) * item_size;
+    remain_num -= item_num;
+  }
+  return RC::SUCCESS;
+}
+
+int BplusTreeBulkLoader::fill_node(const char *items, int64_t item_num, bool leaf, bool is_last) const
+{
+  const IndexFileHeader &header     = tree_handler_.file_header();
+  const int              value_size = leaf ? sizeof(RID) : sizeof(PageNum);
+  const int              item_size  = key_length_ + value_size;
+  const int              fill       = clamp(options_.fill_factor, 50, 100);
+  const int              max_size   = leaf ? header.leaf_max_size : header.internal_max_size;
+  const int              max_num    = static_cast<int>(min<int64_t>(item_num, max(2, max_size * fill / 100)));
+  const int              capacity   = IndexNodeHandler::data_capacity(leaf) * fill / 100;
+
+  auto node_item_num = [&](const char *node_items, int64_t num) {
+    int prefix_length = key_length_;
+    int result        = 1;
+    for (; result < min<int64_t>(num, max_num); result++) {
+      const char *item = node_items + static_cast<size_t>(result) * item_size;
+
+      int length = 0;
+      while (length < prefix_length && node_items[length] == item[length]) {
+        length++;
+      }
+      if (IndexNodeHandler::space_needed(key_length_, value_size, length, result + 1) > capacity) {
+        break;
+      }
+      prefix_length = length;
+    }
+    return result;
+  };
+
+  const int num = node_item_num(items, item_num);
+  if (is_last && num < item_num && item_num <= 2L * num) {
+    // 剩下的元素正好还能放一个节点，两个节点平分。前一半是 num 个元素的一部分，一定能放下
+    const int half = static_cast<int>((item_num + 1) / 2);
+    if (node_item_num(items + static_cast<size_t>(half) * item_size, item_num - half) == item_num - half) {
+      return half;
+    }
+  }
+  return num;
+}
+
+void BplusTreeBulkLoader::remove_run_files()
+{
+  for (const string &file_name : run_files_) {
+    ::unlink(file_name.c_str());
+  }
+  run_files_.clear();
+  run_key_nums_.clear();
+}
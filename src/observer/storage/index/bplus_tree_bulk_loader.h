@@ -0,0 +1,116 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/types.h"
+#include "common/lang/functional.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+
+class BplusTreeHandler;
+struct RID;
+
+/**
+ * @brief 批量构建B+树的参数
+ * @ingroup BPlusTree
+ */
+struct BplusTreeBulkLoadOptions
+{
+  int     fill_factor       = 90;                ///< 节点填充的百分比，低于50%时按照50%处理
+  int64_t sort_memory_bytes = 64L * 1024 * 1024;  ///< 排序使用的内存，超过时先把排好序的数据写到临时文件
+  string  temp_file_prefix;                      ///< 排序临时文件的前缀，通常使用索引文件名
+};
+
+/**
+ * @brief 自底向上批量构建B+树
+ * @ingroup BPlusTree
+ * @details 给已经有数据的表创建索引时，如果一条一条插入，页面会不停地分裂，分裂出来的页面都只有一半的数据。
+ * 这里先收集所有的键值(属性值+RID)并排序，使用的内存超过 sort_memory_bytes 时，把排好序的部分写到临时文件中，
+ * 最后多路归并。然后按照填充比例从左到右填满叶子节点，再一层一层向上构建内部节点，最后更新根节点。
+ * 页面中的键值会省略公共前缀，所以填充比例是按照页面实际占用的空间计算的。
+ * 每构建一个页面就提交一次B+树的 mini transaction，页面的初始化、所有的键值、兄弟节点和子节点的修改
+ * 都合在一条日志中，恢复时按照普通的B+树日志回放。
+ * 只能在空的B+树上构建，并且构建时不能有其它线程访问这棵树。
+ */
+class BplusTreeBulkLoader
+{
+public:
+  BplusTreeBulkLoader(BplusTreeHandler &tree_handler, const BplusTreeBulkLoadOptions &options);
+  ~BplusTreeBulkLoader();
+
+  /**
+   * @brief 添加一个索引项
+   * @param user_key 与 BplusTreeHandler::insert_entry 的参数一样，是整条记录
+   */
+  RC add(const char *user_key, const RID &rid);
+
+  /**
+   * @brief 排序并构建B+树
+   * @return 唯一索引中有重复的键值时返回 RECORD_DUPLICATE_KEY
+   */
+  RC finish();
+
+  int64_t entry_num() const { return entry_num_; }
+
+private:
+  /// 有序的键值流。每次返回下一个键值，没有数据时返回 RECORD_EOF
+  using KeyStream = function<RC(const char *&key)>;
+
+  /// 把内存中的键值排序
+  void sort_memory_keys();
+
+  /// 把内存中的键值排序后写到一个临时文件中
+  RC spill_run();
+
+  /// 多路归并所有的临时文件并构建B+树
+  RC merge_runs_and_build();
+
+  /// 使用有序的键值流构建B+树
+  RC build(const KeyStream &stream);
+
+  /// 构建叶子节点，并把每个叶子节点的第一个键值和页号作为上一层的数据
+  RC build_leaves(const KeyStream &stream, vector<char> &parent_items, int64_t &leaf_num);
+
+  /// 构建一层内部节点
+  RC build_internal_level(const vector<char> &child_items, int64_t child_num, vector<char> &parent_items,
+      int64_t &parent_num);
+
+  /**
+   * @brief 计算下一个节点放多少个元素
+   * @details 页面中的键值省略公共前缀后，一个页面能放下多少个元素与数据有关。这里从第一个元素开始逐个累加，
+   * 直到占用的空间超过填充比例或者元素个数到达上限。最后剩下的元素放不满一个节点时，与前一个节点平分，
+   * 避免最后出现一个很小的节点。
+   * @param items 还没有放到节点上的元素，都是完整的元素
+   * @param item_num 元素个数。is_last 为 true 时就是剩下的所有元素
+   * @param leaf 是否叶子节点
+   * @param is_last items 之后是否已经没有其它元素了
+   */
+  int fill_node(const char *items, int64_t item_num, bool leaf, bool is_last) const;
+
+  void remove_run_files();
+
+private:
+  BplusTreeHandler        &tree_handler_;
+  BplusTreeBulkLoadOptions options_;
+
+  int key_length_ = 0;  ///< 键值长度，包括属性和RID
+
+  vector<char>         keys_;         ///< 内存中还没有排序的键值
+  vector<const char *> sorted_keys_;  ///< 排好序的键值
+  vector<string>       run_files_;    ///< 写到磁盘上的有序临时文件
+  vector<int64_t>      run_key_nums_; ///< 每个临时文件中的键值个数
+  int64_t              entry_num_ = 0;
+};
@@ -115,21 +115,33 @@ IndexScanner *BplusTreeIndex::create_scanner(
   return index_scanner;
 }
 
+RC BplusTreeIndex::get_entries(span<const char *const> keys, int key_len, vector<list<RID>> &rids)
+{
+  return index_handler_.get_entries(keys, key_len, rids);
+}
+
 RC BplusTreeIndex::sync() { return index_handler_.sync(); }
 
+unique_ptr<BplusTreeBulkLoader> BplusTreeIndex::create_bulk_loader(const BplusTreeBulkLoadOptions &options)
+{
+  return make_unique<BplusTreeBulkLoader>(index_handler_, options);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 BplusTreeIndexScanner::BplusTreeIndexScanner(BplusTreeHandler &tree_handler) : tree_scanner_(tree_handler) {}
 
 BplusTreeIndexScanner::~BplusTreeIndexScanner() noexcept { tree_scanner_.close(); }
 
-RC BplusTreeIndexScanner::open(
-    const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
+RC BplusTreeIndexScanner::open(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+    int right_len, bool right_inclusive, bool reverse /* = false */)
 {
-  return tree_scanner_.open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+  return tree_scanner_.open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive, reverse);
 }
 
 RC BplusTreeIndexScanner::next_entry(RID *rid) { return tree_scanner_.next_entry(*rid); }
 
+RC BplusTreeIndexScanner::next_entry(RID *rid, const char *&key) { return tree_scanner_.next_entry(*rid, key); }
+
 RC BplusTreeIndexScanner::destroy()
 {
   delete this;
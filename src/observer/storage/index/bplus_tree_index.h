@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_bulk_loader.h"
 #include "storage/index/index.h"
 
 /**
@@ -41,8 +42,19 @@ public:
   IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
       int right_len, bool right_inclusive) override;
 
+  /**
+   * 批量查找多个值，参考 BplusTreeHandler::get_entries
+   */
+  RC get_entries(span<const char *const> keys, int key_len, vector<list<RID>> &rids) override;
+
   RC sync() override;
 
+  /**
+   * @brief 创建批量构建索引的工具
+   * @details 只能在刚创建的空索引上使用，参考 BplusTreeBulkLoader
+   */
+  unique_ptr<BplusTreeBulkLoader> create_bulk_loader(const BplusTreeBulkLoadOptions &options);
+
 private:
   bool             inited_ = false;
   Table           *table_  = nullptr;
@@ -60,10 +72,12 @@ public:
   ~BplusTreeIndexScanner() noexcept override;
 
   RC next_entry(RID *rid) override;
+  /// 键值的格式参考 BplusTreeScanner::next_entry
+  RC next_entry(RID *rid, const char *&key) override;
   RC destroy() override;
 
   RC open(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
-      bool right_inclusive);
+      bool right_inclusive, bool reverse = false);
 
 private:
   BplusTreeScanner tree_scanner_;
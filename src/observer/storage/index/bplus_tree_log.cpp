@@ -290,3 +290,13 @@ RC BplusTreeMiniTransaction::rollback() { return logger_.rollback(*this, tree_ha
 BplusTreeLogReplayer::BplusTreeLogReplayer(BufferPoolManager &bpm) : buffer_pool_manager_(bpm) {}
 
 RC BplusTreeLogReplayer::replay(const LogEntry &entry) { return BplusTreeLogger::redo(buffer_pool_manager_, entry); }
+
+LogReplayScope BplusTreeLogReplayer::scope(const LogEntry &entry) const
+{
+  Deserializer buffer(entry.data(), entry.payload_size());
+  int32_t      buffer_pool_id = -1;
+  if (buffer.read_int32(buffer_pool_id) != 0) {
+    return LogReplayScope::global();
+  }
+  return LogReplayScope::page(buffer_pool_id, BP_INVALID_PAGE_NUM);
+}
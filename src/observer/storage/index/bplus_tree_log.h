@@ -203,6 +203,11 @@ public:
   /// @copydoc LogReplayer::replay
   virtual RC replay(const LogEntry &entry) override;
 
+  /**
+   * @brief 一条日志会修改同一个索引文件的多个页面，包括文件头，所以同一个索引文件的日志在一个线程中回放
+   */
+  LogReplayScope scope(const LogEntry &entry) const override;
+
 private:
   BufferPoolManager &buffer_pool_manager_;
 };
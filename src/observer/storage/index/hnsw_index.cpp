@@ -0,0 +1,827 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include <math.h>
+
+#include "storage/index/hnsw_index.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/limits.h"
+#include "common/lang/queue.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+
+/// hnsw 索引文件头所在的页面，第0页是缓冲池的文件头
+static constexpr PageNum HNSW_HEADER_PAGE = 1;
+
+/// 节点最高的层数，按照 m=2 计算，百万个节点也只需要20层
+static constexpr int HNSW_MAX_LEVEL = 16;
+
+HnswIndex::~HnswIndex() noexcept { close(); }
+
+RC HnswIndex::create(Table *table, const char *file_name, const IndexMeta &index_meta,
+    const std::vector<const FieldMeta *> &fields, bool is_unique)
+{
+  RC rc = create(table->db()->log_handler(), table->db()->buffer_pool_manager(), file_name, index_meta, fields);
+  if (OB_SUCC(rc)) {
+    table_ = table;
+  }
+  return rc;
+}
+
+RC HnswIndex::open(
+    Table *table, const char *file_name, const IndexMeta &index_meta, const std::vector<const FieldMeta *> &fields)
+{
+  RC rc = open(table->db()->log_handler(), table->db()->buffer_pool_manager(), file_name, index_meta, fields);
+  if (OB_SUCC(rc)) {
+    table_ = table;
+  }
+  return rc;
+}
+
+RC HnswIndex::create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name,
+    const IndexMeta &index_meta, const std::vector<const FieldMeta *> &fields)
+{
+  if (inited_) {
+    LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s",
+        file_name, index_meta.name());
+    return RC::RECORD_OPENNED;
+  }
+
+  if (fields.size() != 2 || fields[1]->type() != AttrType::VECTORS) {
+    LOG_WARN("hnsw index can only be created on one vector field. file_name:%s, index:%s, fields:%s",
+        file_name, index_meta.name(), index_meta.fields().c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  Index::init(index_meta, fields);
+
+  const VectorIndexParams &params = index_meta.vector_params();
+
+  file_header_                 = HnswFileHeader();
+  file_header_.dimension       = fields[1]->len() / sizeof(float);
+  file_header_.distance        = static_cast<int32_t>(params.distance);
+  file_header_.m               = max(2, params.m);
+  file_header_.ef_construction = max(file_header_.m, params.ef_construction);
+  file_header_.max_level       = -1;
+  file_header_.entry_point     = -1;
+  file_header_.node_num        = 0;
+  file_header_.link_num        = 0;
+  file_header_.entry_num       = 0;
+  file_header_.node_page       = BP_INVALID_PAGE_NUM;
+  file_header_.link_page       = BP_INVALID_PAGE_NUM;
+
+  if (nodes_per_page() < 1 || links_per_page() < 1) {
+    LOG_WARN("vector is too large for hnsw index. dimension=%d, m=%d, index:%s",
+        dimension(), file_header_.m, index_meta.name());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  RC rc = bpm.create_file(file_name);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to create file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  rc = bpm.open_file(log_handler, file_name, buffer_pool_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to open file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  Frame *header_frame = nullptr;
+  rc                  = buffer_pool_->allocate_page(&header_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate header page for hnsw index. rc=%s", strrc(rc));
+    bpm.close_file(file_name);
+    return rc;
+  }
+
+  if (header_frame->page_num() != HNSW_HEADER_PAGE) {
+    LOG_WARN("header page num should be %d but got %d. is it a new file", HNSW_HEADER_PAGE, header_frame->page_num());
+    buffer_pool_->unpin_page(header_frame);
+    bpm.close_file(file_name);
+    return RC::INTERNAL;
+  }
+
+  header_frame->write_latch();
+  memcpy(header_frame->data(), &file_header_, sizeof(file_header_));
+  header_frame->mark_dirty();
+  header_frame->write_unlatch();
+  buffer_pool_->unpin_page(header_frame);
+
+  node_pages_.clear();
+  link_pages_.clear();
+  rid_nodes_.clear();
+
+  ef_search_ = max(1, params.ef_search);
+  distance_  = params.distance;
+  inited_    = true;
+  LOG_INFO("Successfully create hnsw index. file_name:%s, index:%s, dimension:%d, m:%d, ef_construction:%d, ef_search:%d",
+      file_name, index_meta.name(), dimension(), file_header_.m, file_header_.ef_construction, ef_search_);
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name,
+    const IndexMeta &index_meta, const std::vector<const FieldMeta *> &fields)
+{
+  if (inited_) {
+    LOG_WARN("Failed to open index due to the index has been inited before. file_name:%s, index:%s",
+        file_name, index_meta.name());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, fields);
+
+  RC rc = bpm.open_file(log_handler, file_name, buffer_pool_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to open file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  Frame *frame = nullptr;
+  rc           = buffer_pool_->get_this_page(HNSW_HEADER_PAGE, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to get header page of hnsw index. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  frame->read_latch();
+  memcpy(&file_header_, frame->data(), sizeof(file_header_));
+  frame->read_unlatch();
+  buffer_pool_->unpin_page(frame);
+
+  // m 和 ef_construction 决定了文件的布局，以文件头为准；ef_search 只影响查询，使用索引元数据中的值
+  ef_search_ = max(1, index_meta.vector_params().ef_search);
+  distance_  = static_cast<VectorDistanceType>(file_header_.distance);
+
+  rc = load_pages(file_header_.node_page, node_pages_);
+  if (OB_SUCC(rc)) {
+    rc = load_pages(file_header_.link_page, link_pages_);
+  }
+  if (OB_SUCC(rc)) {
+    rc = load_rids();
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to load hnsw index. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  LOG_INFO("Successfully open hnsw index. file_name:%s, index:%s, dimension:%d, nodes:%d, max_level:%d, entries:%ld",
+      file_name, index_meta.name(), dimension(), file_header_.node_num, max_level(), file_header_.entry_num);
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::close()
+{
+  if (inited_) {
+    LOG_INFO("Begin to close index, index:%s", index_meta_.name());
+    buffer_pool_->close_file();
+    buffer_pool_ = nullptr;
+    inited_      = false;
+  }
+  return RC::SUCCESS;
+}
+
+void HnswIndex::destroy()
+{
+  if (inited_) {
+    LOG_INFO("Begin to destroy index, index:%s", index_meta_.name());
+    buffer_pool_->remove_file();
+    buffer_pool_ = nullptr;
+    inited_      = false;
+  }
+}
+
+int HnswIndex::node_size() const
+{
+  return sizeof(HnswNode) + dimension() * sizeof(float) + max_neighbors(0) * sizeof(int32_t);
+}
+
+int HnswIndex::link_size() const { return sizeof(int32_t) + max_neighbors(1) * sizeof(int32_t); }
+
+int HnswIndex::nodes_per_page() const
+{
+  return (BP_PAGE_DATA_SIZE - static_cast<int>(sizeof(HnswPageHeader))) / node_size();
+}
+
+int HnswIndex::links_per_page() const
+{
+  return (BP_PAGE_DATA_SIZE - static_cast<int>(sizeof(HnswPageHeader))) / link_size();
+}
+
+float HnswIndex::distance(const float *left, const float *right) const
+{
+  const float d = vector_rank_distance(distance_, left, right, dimension());
+  // 比如零向量的余弦距离，放到最后
+  return isnan(d) ? numeric_limits<float>::max() : d;
+}
+
+int HnswIndex::random_level()
+{
+  // 层数服从几何分布，每高一层节点的个数约为下一层的 1/m
+  const double random = 1.0 - std::uniform_real_distribution<double>(0, 1)(random_);
+  const int    level  = static_cast<int>(-log(random) / log(static_cast<double>(file_header_.m)));
+  return min(level, HNSW_MAX_LEVEL);
+}
+
+RC HnswIndex::fetch_node(int32_t node, bool write, Frame *&frame, HnswNode *&node_data)
+{
+  const int per_page = nodes_per_page();
+  RC        rc       = buffer_pool_->get_this_page(node_pages_[node / per_page], &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get node page of hnsw index. node=%d, rc=%s", node, strrc(rc));
+    return rc;
+  }
+
+  write ? frame->write_latch() : frame->read_latch();
+  node_data = reinterpret_cast<HnswNode *>(frame->data() + sizeof(HnswPageHeader) + (node % per_page) * node_size());
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::fetch_link(int32_t link, bool write, Frame *&frame, int32_t *&link_data)
+{
+  const int per_page = links_per_page();
+  RC        rc       = buffer_pool_->get_this_page(link_pages_[link / per_page], &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get link page of hnsw index. link=%d, rc=%s", link, strrc(rc));
+    return rc;
+  }
+
+  write ? frame->write_latch() : frame->read_latch();
+  link_data = reinterpret_cast<int32_t *>(frame->data() + sizeof(HnswPageHeader) + (link % per_page) * link_size());
+  return RC::SUCCESS;
+}
+
+void HnswIndex::release_frame(Frame *frame, bool write)
+{
+  if (write) {
+    frame->mark_dirty();
+    frame->write_unlatch();
+  } else {
+    frame->read_unlatch();
+  }
+  buffer_pool_->unpin_page(frame);
+}
+
+RC HnswIndex::node_distance(const float *query, int32_t node, float &result)
+{
+  Frame    *frame     = nullptr;
+  HnswNode *node_data = nullptr;
+  RC        rc        = fetch_node(node, false /*write*/, frame, node_data);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  result = distance(query, node_vector(node_data));
+  release_frame(frame, false /*write*/);
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::get_node_vector(int32_t node, vector<float> &vec)
+{
+  Frame    *frame     = nullptr;
+  HnswNode *node_data = nullptr;
+  RC        rc        = fetch_node(node, false /*write*/, frame, node_data);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const float *values = node_vector(node_data);
+  vec.assign(values, values + dimension());
+  release_frame(frame, false /*write*/);
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::get_neighbors(int32_t node, int level, vector<int32_t> &neighbors)
+{
+  Frame    *frame     = nullptr;
+  HnswNode *node_data = nullptr;
+  RC        rc        = fetch_node(node, false /*write*/, frame, node_data);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  if (level == 0) {
+    const int32_t *ids = node_neighbors(node_data);
+    neighbors.assign(ids, ids + node_data->neighbor_num);
+    release_frame(frame, false /*write*/);
+    return RC::SUCCESS;
+  }
+
+  const int32_t link = node_data->first_link + level - 1;
+  release_frame(frame, false /*write*/);
+
+  int32_t *link_data = nullptr;
+  rc                 = fetch_link(link, false /*write*/, frame, link_data);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  neighbors.assign(link_data + 1, link_data + 1 + link_data[0]);
+  release_frame(frame, false /*write*/);
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::set_neighbors(int32_t node, int level, const vector<int32_t> &neighbors)
+{
+  ASSERT(static_cast<int>(neighbors.size()) <= max_neighbors(level), "too many neighbors");
+
+  Frame    *frame     = nullptr;
+  HnswNode *node_data = nullptr;
+  RC        rc        = fetch_node(node, level == 0 /*write*/, frame, node_data);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  if (level == 0) {
+    memcpy(node_neighbors(node_data), neighbors.data(), neighbors.size() * sizeof(int32_t));
+    node_data->neighbor_num = static_cast<int32_t>(neighbors.size());
+    release_frame(frame, true /*write*/);
+    return RC::SUCCESS;
+  }
+
+  const int32_t link = node_data->first_link + level - 1;
+  release_frame(frame, false /*write*/);
+
+  int32_t *link_data = nullptr;
+  rc                 = fetch_link(link, true /*write*/, frame, link_data);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  link_data[0] = static_cast<int32_t>(neighbors.size());
+  memcpy(link_data + 1, neighbors.data(), neighbors.size() * sizeof(int32_t));
+  release_frame(frame, true /*write*/);
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::append_page(vector<PageNum> &pages, PageNum &first_page)
+{
+  Frame *frame = nullptr;
+  RC     rc    = buffer_pool_->allocate_page(&frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate page for hnsw index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  frame->write_latch();
+  HnswPageHeader *page_header = reinterpret_cast<HnswPageHeader *>(frame->data());
+  page_header->next_page      = BP_INVALID_PAGE_NUM;
+  page_header->count          = 0;
+  const PageNum page_num      = frame->page_num();
+  release_frame(frame, true /*write*/);
+
+  if (pages.empty()) {
+    first_page = page_num;
+  } else {
+    rc = buffer_pool_->get_this_page(pages.back(), &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get page of hnsw index. page=%d, rc=%s", pages.back(), strrc(rc));
+      return rc;
+    }
+    frame->write_latch();
+    reinterpret_cast<HnswPageHeader *>(frame->data())->next_page = page_num;
+    release_frame(frame, true /*write*/);
+  }
+
+  pages.push_back(page_num);
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::append_node(const RID &rid, const float *vec, int level, int32_t &node)
+{
+  RC rc = RC::SUCCESS;
+
+  // 先分配第1层及以上的链接槽
+  const int32_t first_link = file_header_.link_num;
+  for (int i = 0; i < level; i++) {
+    const int32_t link = file_header_.link_num;
+    if (link % links_per_page() == 0) {
+      rc = append_page(link_pages_, file_header_.link_page);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+
+    Frame   *frame     = nullptr;
+    int32_t *link_data = nullptr;
+    rc                 = fetch_link(link, true /*write*/, frame, link_data);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    link_data[0] = 0;
+    reinterpret_cast<HnswPageHeader *>(frame->data())->count++;
+    release_frame(frame, true /*write*/);
+    file_header_.link_num++;
+  }
+
+  node = file_header_.node_num;
+  if (node % nodes_per_page() == 0) {
+    rc = append_page(node_pages_, file_header_.node_page);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  Frame    *frame     = nullptr;
+  HnswNode *node_data = nullptr;
+  rc                  = fetch_node(node, true /*write*/, frame, node_data);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  node_data->rid          = rid;
+  node_data->level        = level;
+  node_data->deleted      = 0;
+  node_data->first_link   = first_link;
+  node_data->neighbor_num = 0;
+  memcpy(node_data + 1, vec, dimension() * sizeof(float));
+  reinterpret_cast<HnswPageHeader *>(frame->data())->count++;
+  release_frame(frame, true /*write*/);
+
+  file_header_.node_num++;
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::save_header()
+{
+  Frame *frame = nullptr;
+  RC     rc    = buffer_pool_->get_this_page(HNSW_HEADER_PAGE, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get header page of hnsw index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  frame->write_latch();
+  memcpy(frame->data(), &file_header_, sizeof(file_header_));
+  release_frame(frame, true /*write*/);
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::load_pages(PageNum first_page, vector<PageNum> &pages)
+{
+  pages.clear();
+  for (PageNum page_num = first_page; page_num != BP_INVALID_PAGE_NUM;) {
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get page of hnsw index. page=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    frame->read_latch();
+    pages.push_back(page_num);
+    page_num = reinterpret_cast<const HnswPageHeader *>(frame->data())->next_page;
+    release_frame(frame, false /*write*/);
+  }
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::load_rids()
+{
+  rid_nodes_.clear();
+
+  const int node_pages = (file_header_.node_num + nodes_per_page() - 1) / nodes_per_page();
+  const int link_pages = (file_header_.link_num + links_per_page() - 1) / links_per_page();
+  if (node_pages != static_cast<int>(node_pages_.size()) || link_pages != static_cast<int>(link_pages_.size())) {
+    LOG_WARN("hnsw index is corrupted. nodes=%d, node pages=%d, links=%d, link pages=%d",
+        file_header_.node_num, (int)node_pages_.size(), file_header_.link_num, (int)link_pages_.size());
+    return RC::INTERNAL;
+  }
+
+  for (int32_t node = 0; node < file_header_.node_num; node++) {
+    Frame    *frame     = nullptr;
+    HnswNode *node_data = nullptr;
+    RC        rc        = fetch_node(node, false /*write*/, frame, node_data);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (!node_data->deleted) {
+      rid_nodes_[node_data->rid] = node;
+    }
+    release_frame(frame, false /*write*/);
+  }
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::greedy_search(const float *query, int level, Candidate &nearest)
+{
+  vector<int32_t> neighbors;
+  for (bool changed = true; changed;) {
+    changed = false;
+
+    RC rc = get_neighbors(nearest.second, level, neighbors);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    for (int32_t neighbor : neighbors) {
+      float d = 0;
+      rc      = node_distance(query, neighbor, d);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      if (d < nearest.first) {
+        nearest = {d, neighbor};
+        changed = true;
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::search_layer(const float *query, int level, int ef, vector<Candidate> &candidates)
+{
+  vector<char> visited(file_header_.node_num, 0);
+
+  // to_visit 是小顶堆，先访问离查询向量最近的候选节点；nearest 是大顶堆，堆顶是结果中最远的节点
+  priority_queue<Candidate, vector<Candidate>, std::greater<Candidate>> to_visit;
+  priority_queue<Candidate>                                             nearest;
+  for (const Candidate &candidate : candidates) {
+    visited[candidate.second] = 1;
+    to_visit.push(candidate);
+    nearest.push(candidate);
+  }
+  while (static_cast<int>(nearest.size()) > ef) {
+    nearest.pop();
+  }
+
+  vector<int32_t> neighbors;
+  while (!to_visit.empty()) {
+    const Candidate current = to_visit.top();
+    if (current.first > nearest.top().first && static_cast<int>(nearest.size()) >= ef) {
+      break;  // 剩下的候选节点都比结果中最远的还要远
+    }
+    to_visit.pop();
+
+    RC rc = get_neighbors(current.second, level, neighbors);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    for (int32_t neighbor : neighbors) {
+      if (visited[neighbor]) {
+        continue;
+      }
+      visited[neighbor] = 1;
+
+      float d = 0;
+      rc      = node_distance(query, neighbor, d);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+
+      if (static_cast<int>(nearest.size()) < ef || d < nearest.top().first) {
+        to_visit.emplace(d, neighbor);
+        nearest.emplace(d, neighbor);
+        if (static_cast<int>(nearest.size()) > ef) {
+          nearest.pop();
+        }
+      }
+    }
+  }
+
+  candidates.resize(nearest.size());
+  for (int i = static_cast<int>(nearest.size()) - 1; i >= 0; i--) {
+    candidates[i] = nearest.top();
+    nearest.pop();
+  }
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::select_neighbors(const vector<Candidate> &candidates, int max_num, vector<int32_t> &selected)
+{
+  selected.clear();
+
+  vector<vector<float>> selected_vectors;
+  vector<int32_t>       pruned;
+  vector<float>         vec;
+  for (const Candidate &candidate : candidates) {
+    if (static_cast<int>(selected.size()) >= max_num) {
+      break;
+    }
+
+    RC rc = get_node_vector(candidate.second, vec);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    bool closer_to_selected = false;
+    for (const vector<float> &selected_vector : selected_vectors) {
+      if (distance(vec.data(), selected_vector.data()) < candidate.first) {
+        closer_to_selected = true;
+        break;
+      }
+    }
+
+    if (closer_to_selected) {
+      pruned.push_back(candidate.second);
+    } else {
+      selected.push_back(candidate.second);
+      selected_vectors.push_back(vec);
+    }
+  }
+
+  // 数据比较少或者很集中时，启发式选出的邻居可能不够，用淘汰的节点补齐，保证图的连通性
+  for (size_t i = 0; i < pruned.size() && static_cast<int>(selected.size()) < max_num; i++) {
+    selected.push_back(pruned[i]);
+  }
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::add_neighbor(int32_t node, int level, int32_t new_node)
+{
+  vector<int32_t> neighbors;
+  RC              rc = get_neighbors(node, level, neighbors);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  neighbors.push_back(new_node);
+  if (static_cast<int>(neighbors.size()) <= max_neighbors(level)) {
+    return set_neighbors(node, level, neighbors);
+  }
+
+  // 邻居满了，在原来的邻居和新节点中重新选择
+  vector<float> base;
+  rc = get_node_vector(node, base);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  vector<Candidate> candidates;
+  candidates.reserve(neighbors.size());
+  for (int32_t neighbor : neighbors) {
+    float d = 0;
+    rc      = node_distance(base.data(), neighbor, d);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    candidates.emplace_back(d, neighbor);
+  }
+  sort(candidates.begin(), candidates.end());
+
+  rc = select_neighbors(candidates, max_neighbors(level), neighbors);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  return set_neighbors(node, level, neighbors);
+}
+
+RC HnswIndex::insert_entry(const char *record, const RID *rid)
+{
+  const float *vec = record_vector(record);
+  if (nullptr == vec) {
+    return RC::SUCCESS;  // NULL 不放到索引中
+  }
+
+  lock_guard<common::SharedMutex> guard(lock_);
+
+  const int level = random_level();
+  int32_t   node  = -1;
+  RC        rc    = append_node(*rid, vec, level, node);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to insert vector into hnsw index. rid=%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  if (file_header_.max_level >= 0) {
+    // 在新节点所在的最高层之上只需要找到最近的节点，作为下一层的入口
+    Candidate entry{0, file_header_.entry_point};
+    rc = node_distance(vec, entry.second, entry.first);
+    for (int lc = file_header_.max_level; lc > level && OB_SUCC(rc); lc--) {
+      rc = greedy_search(vec, lc, entry);
+    }
+
+    vector<Candidate> candidates{entry};
+    vector<int32_t>   neighbors;
+    for (int lc = min(level, file_header_.max_level); lc >= 0 && OB_SUCC(rc); lc--) {
+      rc = search_layer(vec, lc, file_header_.ef_construction, candidates);
+      if (OB_SUCC(rc)) {
+        rc = select_neighbors(candidates, file_header_.m, neighbors);
+      }
+      if (OB_SUCC(rc)) {
+        rc = set_neighbors(node, lc, neighbors);
+      }
+      for (size_t i = 0; i < neighbors.size() && OB_SUCC(rc); i++) {
+        rc = add_neighbor(neighbors[i], lc, node);
+      }
+    }
+
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to link vector in hnsw index. rid=%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+
+  if (level > file_header_.max_level) {
+    file_header_.max_level   = level;
+    file_header_.entry_point = node;
+  }
+  file_header_.entry_num++;
+  rid_nodes_[*rid] = node;
+  return save_header();
+}
+
+RC HnswIndex::delete_entry(const char *record, const RID *rid)
+{
+  if (nullptr == record_vector(record)) {
+    return RC::SUCCESS;
+  }
+
+  lock_guard<common::SharedMutex> guard(lock_);
+
+  auto iter = rid_nodes_.find(*rid);
+  if (iter == rid_nodes_.end()) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  // 只打上删除标记，节点还要作为其它节点的邻居参与遍历
+  Frame    *frame     = nullptr;
+  HnswNode *node_data = nullptr;
+  RC        rc        = fetch_node(iter->second, true /*write*/, frame, node_data);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to delete vector from hnsw index. rid=%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+    return rc;
+  }
+  node_data->deleted = 1;
+  release_frame(frame, true /*write*/);
+
+  rid_nodes_.erase(iter);
+  file_header_.entry_num--;
+  return save_header();
+}
+
+RC HnswIndex::ann_search(const vector<float> &query, size_t limit, vector<RID> &rids)
+{
+  rids.clear();
+  if (static_cast<int>(query.size()) != dimension()) {
+    LOG_WARN("dimension of query vector does not match the index. query=%d, index=%d", (int)query.size(), dimension());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  std::shared_lock<common::SharedMutex> guard(lock_);
+
+  if (limit == 0 || file_header_.max_level < 0) {
+    return RC::SUCCESS;
+  }
+
+  Candidate entry{0, file_header_.entry_point};
+  RC        rc = node_distance(query.data(), entry.second, entry.first);
+  for (int lc = file_header_.max_level; lc > 0 && OB_SUCC(rc); lc--) {
+    rc = greedy_search(query.data(), lc, entry);
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 删除的节点不能作为结果，结果不够时扩大候选的范围重新查找
+  const int         limit_num = static_cast<int>(min<size_t>(limit, file_header_.node_num));
+  int               ef        = max(ef_search_, limit_num);
+  vector<Candidate> candidates;
+  while (true) {
+    candidates.assign(1, entry);
+    rc = search_layer(query.data(), 0, ef, candidates);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    rids.clear();
+    for (size_t i = 0; i < candidates.size() && rids.size() < limit; i++) {
+      Frame    *frame     = nullptr;
+      HnswNode *node_data = nullptr;
+      rc                  = fetch_node(candidates[i].second, false /*write*/, frame, node_data);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      if (!node_data->deleted) {
+        rids.push_back(node_data->rid);
+      }
+      release_frame(frame, false /*write*/);
+    }
+
+    if (rids.size() >= limit || static_cast<int64_t>(rids.size()) >= file_header_.entry_num ||
+        ef >= file_header_.node_num) {
+      break;
+    }
+    ef = min(ef * 2, file_header_.node_num);
+  }
+  return RC::SUCCESS;
+}
+
+RC HnswIndex::sync()
+{
+  lock_guard<common::SharedMutex> guard(lock_);
+  return buffer_pool_->flush_all_pages();
+}
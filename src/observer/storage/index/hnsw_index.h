@@ -0,0 +1,191 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#pragma once
+
+#include "common/lang/mutex.h"
+#include "common/lang/random.h"
+#include "common/lang/unordered_map.h"
+#include "common/lang/utility.h"
+#include "common/lang/vector.h"
+#include "storage/buffer/page.h"
+#include "storage/index/vector_index.h"
+
+class BufferPoolManager;
+class DiskBufferPool;
+class Frame;
+class LogHandler;
+
+/**
+ * @brief hnsw 索引文件的第一个页面
+ * @ingroup Index
+ */
+struct HnswFileHeader
+{
+  int32_t dimension;        ///< 向量的维度
+  int32_t distance;         ///< VectorDistanceType
+  int32_t m;                ///< 每个节点在第1层及以上的最大邻居个数，第0层是 2*m
+  int32_t ef_construction;  ///< 插入时候选邻居的个数
+  int32_t max_level;        ///< 图的最高层，-1表示图是空的
+  int32_t entry_point;      ///< 查询的入口节点，在最高层上
+  int32_t node_num;         ///< 分配的节点个数，包括已经删除的
+  int32_t link_num;         ///< 分配的链接槽个数
+  int64_t entry_num;        ///< 索引中有效向量的个数
+  PageNum node_page;        ///< 第一个节点页面
+  PageNum link_page;        ///< 第一个链接页面
+};
+
+/**
+ * @brief hnsw 向量索引
+ * @ingroup Index
+ * @details Hierarchical Navigable Small World 图。每个向量是一个节点，随机分配一个最高层，层数越高节点越少。
+ * 查询时从最高层的入口节点开始，每一层贪心地走向离查询向量更近的邻居，到第0层时保留 ef_search 个候选，
+ * 召回率比 IVF 高，查询的延迟也更稳定。
+ *
+ * 节点和邻居都保存在缓冲池的页面中，页面之间用 next_page 串起来：
+ * - 节点页面：HnswPageHeader，后面是若干个 [HnswNode, float[dimension], int32[2*m]]，最后是第0层的邻居；
+ * - 链接页面：HnswPageHeader，后面是若干个 [int32 个数, int32[m]]，是节点在第1层及以上的邻居。
+ *   最高层是 L 的节点占用从 first_link 开始连续的 L 个链接槽。
+ * 节点和链接槽按照分配的顺序编号，根据编号可以直接算出所在的页面。
+ * 删除只是给节点打上标记，节点仍然参与图的遍历，但不会出现在查询结果中。
+ * 与 IvfflatIndex 一样，页面的修改不记录日志，依赖 sync 刷盘。
+ */
+class HnswIndex : public VectorIndex
+{
+public:
+  HnswIndex() = default;
+  virtual ~HnswIndex() noexcept;
+
+  /**
+   * @brief 创建索引文件
+   * @param fields 第一个字段是NULL位图，第二个是向量字段
+   */
+  RC create(Table *table, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &fields, bool is_unique) override;
+  RC open(Table *table, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &fields) override;
+
+  /// 不依赖表的创建和打开，方便单独测试
+  RC create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &fields);
+  RC open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &fields);
+
+  RC   close();
+  void destroy() override;
+
+  RC ann_search(const vector<float> &query, size_t limit, vector<RID> &rids) override;
+
+  RC insert_entry(const char *record, const RID *rid) override;
+  RC delete_entry(const char *record, const RID *rid) override;
+
+  RC sync() override;
+
+  int  dimension() const override { return file_header_.dimension; }
+  int  max_level() const { return file_header_.max_level; }
+  void set_ef_search(int ef_search) { ef_search_ = ef_search; }
+
+private:
+  /// 每个页面开头的信息
+  struct HnswPageHeader
+  {
+    PageNum next_page;
+    int32_t count;
+  };
+
+  /// 节点在页面中的固定部分，后面跟着向量和第0层的邻居
+  struct HnswNode
+  {
+    RID     rid;
+    int32_t level;         ///< 节点所在的最高层
+    int32_t deleted;       ///< 是否已经删除
+    int32_t first_link;    ///< 第1层及以上的邻居所在的第一个链接槽
+    int32_t neighbor_num;  ///< 第0层邻居的个数
+  };
+
+  /// 距离和节点编号
+  using Candidate = pair<float, int32_t>;
+
+  int max_neighbors(int level) const { return level == 0 ? 2 * file_header_.m : file_header_.m; }
+  int node_size() const;
+  int link_size() const;
+  int nodes_per_page() const;
+  int links_per_page() const;
+
+  float distance(const float *left, const float *right) const;
+
+  /// 随机生成新节点的最高层
+  int random_level();
+
+  /**
+   * @brief 固定节点所在的页面
+   * @details 返回的页面已经加了读锁或写锁，调用者使用 release_frame 释放
+   */
+  RC fetch_node(int32_t node, bool write, Frame *&frame, HnswNode *&node_data);
+  RC fetch_link(int32_t link, bool write, Frame *&frame, int32_t *&link_data);
+  void release_frame(Frame *frame, bool write);
+
+  const float *node_vector(const HnswNode *node) const { return reinterpret_cast<const float *>(node + 1); }
+  int32_t     *node_neighbors(HnswNode *node) const
+  {
+    return reinterpret_cast<int32_t *>(reinterpret_cast<char *>(node + 1) + dimension() * sizeof(float));
+  }
+
+  RC node_distance(const float *query, int32_t node, float &result);
+  RC get_node_vector(int32_t node, vector<float> &vec);
+  RC get_neighbors(int32_t node, int level, vector<int32_t> &neighbors);
+  RC set_neighbors(int32_t node, int level, const vector<int32_t> &neighbors);
+
+  /// 在链表的末尾追加一个页面
+  RC append_page(vector<PageNum> &pages, PageNum &first_page);
+  RC append_node(const RID &rid, const float *vec, int level, int32_t &node);
+  RC save_header();
+  RC load_pages(PageNum first_page, vector<PageNum> &pages);
+  RC load_rids();
+
+  /// 在一层上贪心地找离查询向量最近的节点
+  RC greedy_search(const float *query, int level, Candidate &nearest);
+
+  /**
+   * @brief 在一层上查找离查询向量最近的 ef 个节点
+   * @param[in,out] candidates 输入是入口节点，输出是按照距离从近到远排列的结果
+   */
+  RC search_layer(const float *query, int level, int ef, vector<Candidate> &candidates);
+
+  /**
+   * @brief 使用启发式的方法选择邻居
+   * @details 按照距离从近到远考虑每个候选节点，如果它离已经选中的某个邻居比离 base 更近，就跳过它，
+   * 这样邻居会分布在不同的方向上
+   * @param candidates 按照距离从近到远排列
+   */
+  RC select_neighbors(const vector<Candidate> &candidates, int max_num, vector<int32_t> &selected);
+
+  /// 把 new_node 加到 node 的邻居中，邻居满了以后重新选择
+  RC add_neighbor(int32_t node, int level, int32_t new_node);
+
+private:
+  bool               inited_      = false;
+  DiskBufferPool    *buffer_pool_ = nullptr;
+  int                ef_search_   = 40;
+  VectorDistanceType distance_    = VectorDistanceType::L2;
+
+  HnswFileHeader  file_header_;
+  vector<PageNum> node_pages_;  ///< 所有的节点页面
+  vector<PageNum> link_pages_;  ///< 所有的链接页面
+
+  unordered_map<RID, int32_t, RIDHash> rid_nodes_;  ///< 有效的向量所在的节点，删除时使用
+  mt19937                              random_;
+
+  common::SharedMutex lock_;  ///< 查询共享，修改独占
+};
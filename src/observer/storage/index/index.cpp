@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/index/index.h"
+#include "common/log/log.h"
 
 RC Index::init(const IndexMeta &index_meta, const std::vector<const FieldMeta*> &fields)
 {
@@ -22,3 +23,29 @@ RC Index::init(const IndexMeta &index_meta, const std::vector<const FieldMeta*>
   }
   return RC::SUCCESS;
 }
+
+RC Index::get_entries(span<const char *const> keys, int key_len, vector<list<RID>> &rids)
+{
+  rids.clear();
+  rids.resize(keys.size());
+
+  RC rc = RC::SUCCESS;
+  for (size_t i = 0; i < keys.size() && OB_SUCC(rc); i++) {
+    IndexScanner *scanner = create_scanner(keys[i], key_len, true /*left_inclusive*/, keys[i], key_len, true /*right_inclusive*/);
+    if (nullptr == scanner) {
+      LOG_WARN("failed to create index scanner");
+      return RC::INTERNAL;
+    }
+
+    RID rid;
+    while (OB_SUCC(rc = scanner->next_entry(&rid))) {
+      rids[i].push_back(rid);
+    }
+    scanner->destroy();
+
+    if (rc == RC::RECORD_EOF) {
+      rc = RC::SUCCESS;
+    }
+  }
+  return rc;
+}
@@ -18,6 +18,8 @@ See the Mulan PSL v2 for more details. */
 #include <vector>
 
 #include "common/rc.h"
+#include "common/lang/list.h"
+#include "common/lang/span.h"
 #include "storage/field/field_meta.h"
 #include "storage/index/index_meta.h"
 #include "storage/record/record_manager.h"
@@ -84,6 +86,15 @@ public:
   virtual IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
       int right_len, bool right_inclusive) = 0;
 
+  /**
+   * @brief 批量查找多个值
+   * @details 默认实现是对每个值创建一个扫描器。有序的索引可以先把要查找的值排序，一次遍历找到所有的值。
+   * @param keys 要查找的值，格式与 create_scanner 的 left_key 一样
+   * @param key_len 值的长度
+   * @param[out] rids 与 keys 一一对应的查找结果
+   */
+  virtual RC get_entries(span<const char *const> keys, int key_len, vector<list<RID>> &rids);
+
   /**
    * @brief 同步索引数据到磁盘
    *
@@ -114,4 +125,11 @@ public:
    */
   virtual RC next_entry(RID *rid) = 0;
   virtual RC destroy()            = 0;
+
+  /**
+   * @brief 遍历元素数据，同时返回元素在索引中的键值
+   * @details 键值中包含索引字段的值，只需要索引字段时不用再去读记录。键值的格式由具体的索引决定。
+   * @param[out] key 下次调用 next_entry 之前有效
+   */
+  virtual RC next_entry(RID *rid, const char *&key) { return RC::UNSUPPORTED; }
 };
@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai.wyl on 2021/5/18.
 //
 
+#include <strings.h>
+
 #include "storage/index/index_meta.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
@@ -23,6 +25,34 @@ const static Json::StaticString FIELD_NAME("name");
 const static Json::StaticString FIELD_FIELD_NAME("field_name");
 const static Json::StaticString FIELD_UNIQUE("unique");
 const static Json::StaticString FIELD_NUM("field_num");
+const static Json::StaticString FIELD_TYPE("type");
+const static Json::StaticString FIELD_DISTANCE("distance");
+const static Json::StaticString FIELD_LISTS("lists");
+const static Json::StaticString FIELD_PROBES("probes");
+const static Json::StaticString FIELD_M("m");
+const static Json::StaticString FIELD_EF_CONSTRUCTION("ef_construction");
+const static Json::StaticString FIELD_EF_SEARCH("ef_search");
+
+const char *index_type_name(IndexType type)
+{
+  switch (type) {
+    case IndexType::BPLUS_TREE: return "bplus_tree";
+    case IndexType::IVFFLAT: return "ivfflat";
+    case IndexType::HNSW: return "hnsw";
+  }
+  return "unknown";
+}
+
+RC index_type_from_string(const string &name, IndexType &type)
+{
+  for (IndexType candidate : {IndexType::BPLUS_TREE, IndexType::IVFFLAT, IndexType::HNSW}) {
+    if (0 == strcasecmp(name.c_str(), index_type_name(candidate))) {
+      type = candidate;
+      return RC::SUCCESS;
+    }
+  }
+  return RC::INVALID_ARGUMENT;
+}
 
 RC IndexMeta::init(const char *name, const std::vector<const FieldMeta*> &fields, bool is_unique)
 {
@@ -39,6 +69,12 @@ RC IndexMeta::init(const char *name, const std::vector<const FieldMeta*> &fields
   return RC::SUCCESS;
 }
 
+void IndexMeta::set_vector_index(IndexType type, const VectorIndexParams &params)
+{
+  type_          = type;
+  vector_params_ = params;
+}
+
 void IndexMeta::to_json(Json::Value &json_value) const
 {
   json_value[FIELD_NAME] = name_;
@@ -49,6 +85,19 @@ void IndexMeta::to_json(Json::Value &json_value) const
     my_fields[i] = field_[i];
   }
   json_value[FIELD_FIELD_NAME] = my_fields;
+
+  if (is_vector_index()) {
+    json_value[FIELD_TYPE]     = index_type_name(type_);
+    json_value[FIELD_DISTANCE] = vector_distance_name(vector_params_.distance);
+    if (type_ == IndexType::HNSW) {
+      json_value[FIELD_M]               = vector_params_.m;
+      json_value[FIELD_EF_CONSTRUCTION] = vector_params_.ef_construction;
+      json_value[FIELD_EF_SEARCH]       = vector_params_.ef_search;
+    } else {
+      json_value[FIELD_LISTS]  = vector_params_.lists;
+      json_value[FIELD_PROBES] = vector_params_.probes;
+    }
+  }
 }
 
 RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, IndexMeta &index)
@@ -77,7 +126,36 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     }
     fields.push_back(field);
   }
-  return index.init(name_value.asCString(), fields, unique.asBool());
+  RC rc = index.init(name_value.asCString(), fields, unique.asBool());
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 没有记录类型的是B+树索引
+  const Json::Value &type_value = json_value[FIELD_TYPE];
+  if (type_value.isString()) {
+    IndexType         type;
+    VectorIndexParams params;
+    rc = index_type_from_string(type_value.asString(), type);
+    if (OB_SUCC(rc)) {
+      rc = vector_distance_from_string(json_value[FIELD_DISTANCE].asString(), params.distance);
+    }
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Deserialize index [%s]: invalid index type or distance. json value=%s",
+          name_value.asCString(), json_value.toStyledString().c_str());
+      return RC::INTERNAL;
+    }
+    if (type == IndexType::HNSW) {
+      params.m               = json_value[FIELD_M].asInt();
+      params.ef_construction = json_value[FIELD_EF_CONSTRUCTION].asInt();
+      params.ef_search       = json_value[FIELD_EF_SEARCH].asInt();
+    } else {
+      params.lists  = json_value[FIELD_LISTS].asInt();
+      params.probes = json_value[FIELD_PROBES].asInt();
+    }
+    index.set_vector_index(type, params);
+  }
+  return RC::SUCCESS;
 }
 
 const char *IndexMeta::name() const { return name_.c_str(); }
@@ -85,4 +163,13 @@ const char *IndexMeta::name() const { return name_.c_str(); }
 
 void IndexMeta::desc(ostream &os) const {
   os << "index name=" << name_ << ", field=" << fields();
+  if (is_vector_index()) {
+    os << ", type=" << index_type_name(type_) << ", distance=" << vector_distance_name(vector_params_.distance);
+    if (type_ == IndexType::HNSW) {
+      os << ", m=" << vector_params_.m << ", ef_construction=" << vector_params_.ef_construction
+         << ", ef_search=" << vector_params_.ef_search;
+    } else {
+      os << ", lists=" << vector_params_.lists << ", probes=" << vector_params_.probes;
+    }
+  }
 }
\ No newline at end of file
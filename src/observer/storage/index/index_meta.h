@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/rc.h"
 #include "common/lang/string.h"
+#include "storage/index/vector_distance.h"
 
 class TableMeta;
 class FieldMeta;
@@ -24,11 +25,39 @@ namespace Json {
 class Value;
 }  // namespace Json
 
+/**
+ * @brief 索引的类型
+ * @ingroup Index
+ */
+enum class IndexType
+{
+  BPLUS_TREE,  ///< B+树索引
+  IVFFLAT,     ///< IVF-Flat 向量索引
+  HNSW,        ///< HNSW 图向量索引
+};
+
+const char *index_type_name(IndexType type);
+RC          index_type_from_string(const string &name, IndexType &type);
+
+/**
+ * @brief 向量索引的参数
+ * @ingroup Index
+ */
+struct VectorIndexParams
+{
+  VectorDistanceType distance = VectorDistanceType::L2;
+  int                lists    = 1;  ///< IVF 聚类中心的个数
+  int                probes   = 1;  ///< 查询时扫描最近的几个聚类
+
+  int m               = 16;  ///< HNSW 每个节点在每一层的邻居个数，第0层是它的两倍
+  int ef_construction = 64;  ///< HNSW 插入时候选邻居的个数
+  int ef_search       = 40;  ///< HNSW 查询时候选结果的个数，越大召回率越高，查询越慢
+};
+
 /**
  * @brief 描述一个索引
  * @ingroup Index
- * @details 一个索引包含了表的哪些字段，索引的名称等。
- * 如果以后实现了多种类型的索引，还需要记录索引的类型，对应类型的一些元数据等
+ * @details 一个索引包含了表的哪些字段，索引的名称，索引的类型等。向量索引还会记录距离函数等参数。
  */
 class IndexMeta
 {
@@ -37,6 +66,9 @@ public:
 
   RC init(const char *name, const std::vector<const FieldMeta*> &fields, bool is_unique);
 
+  /// 设置为向量索引。需要先调用 init
+  void set_vector_index(IndexType type, const VectorIndexParams &params);
+
 public:
   const char *name() const;
   std::vector<std::string> field() const { return field_; }
@@ -49,6 +81,10 @@ public:
   }
   const bool unique() const { return unique_; }
 
+  IndexType                index_type() const { return type_; }
+  bool                     is_vector_index() const { return type_ != IndexType::BPLUS_TREE; }
+  const VectorIndexParams &vector_params() const { return vector_params_; }
+
   void desc(ostream &os) const;
 
 public:
@@ -59,4 +95,7 @@ protected:
   bool unique_;
   string name_;   // index's name
   vector<string> field_;  // field's name
+
+  IndexType         type_ = IndexType::BPLUS_TREE;
+  VectorIndexParams vector_params_;
 };
@@ -0,0 +1,762 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include <math.h>
+
+#include "storage/index/ivfflat_index.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/limits.h"
+#include "common/lang/random.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+
+/// ivfflat 索引文件头所在的页面，第0页是缓冲池的文件头
+static constexpr PageNum IVFFLAT_HEADER_PAGE = 1;
+
+/// 训练时每个聚类最多抽取的样本个数
+static constexpr int SAMPLES_PER_LIST = 50;
+
+/// k-means 最多迭代的次数
+static constexpr int KMEANS_MAX_ITERATIONS = 10;
+
+IvfflatIndex::~IvfflatIndex() noexcept { close(); }
+
+RC IvfflatIndex::create(Table *table, const char *file_name, const IndexMeta &index_meta,
+    const std::vector<const FieldMeta *> &fields, bool is_unique)
+{
+  RC rc = create(table->db()->log_handler(), table->db()->buffer_pool_manager(), file_name, index_meta, fields);
+  if (OB_SUCC(rc)) {
+    table_ = table;
+  }
+  return rc;
+}
+
+RC IvfflatIndex::open(
+    Table *table, const char *file_name, const IndexMeta &index_meta, const std::vector<const FieldMeta *> &fields)
+{
+  RC rc = open(table->db()->log_handler(), table->db()->buffer_pool_manager(), file_name, index_meta, fields);
+  if (OB_SUCC(rc)) {
+    table_ = table;
+  }
+  return rc;
+}
+
+RC IvfflatIndex::create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name,
+    const IndexMeta &index_meta, const std::vector<const FieldMeta *> &fields)
+{
+  if (inited_) {
+    LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s",
+        file_name, index_meta.name());
+    return RC::RECORD_OPENNED;
+  }
+
+  if (fields.size() != 2 || fields[1]->type() != AttrType::VECTORS) {
+    LOG_WARN("ivfflat index can only be created on one vector field. file_name:%s, index:%s, fields:%s",
+        file_name, index_meta.name(), index_meta.fields().c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  Index::init(index_meta, fields);
+
+  const VectorIndexParams &params = index_meta.vector_params();
+
+  file_header_                 = IvfflatFileHeader();
+  file_header_.dimension       = fields[1]->len() / sizeof(float);
+  file_header_.distance        = static_cast<int32_t>(params.distance);
+  file_header_.list_num        = 0;
+  file_header_.centroid_page   = BP_INVALID_PAGE_NUM;
+  file_header_.entry_num       = 0;
+  file_header_.unassigned_list = IvfflatListPages();
+
+  if (entries_per_page() < 1 || centroids_per_page() < 1) {
+    LOG_WARN("vector is too large for ivfflat index. dimension=%d, index:%s", dimension(), index_meta.name());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  RC rc = bpm.create_file(file_name);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to create file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  rc = bpm.open_file(log_handler, file_name, buffer_pool_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to open file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  Frame *header_frame = nullptr;
+  rc                  = allocate_page(header_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate header page for ivfflat index. rc=%s", strrc(rc));
+    bpm.close_file(file_name);
+    return rc;
+  }
+
+  if (header_frame->page_num() != IVFFLAT_HEADER_PAGE) {
+    LOG_WARN("header page num should be %d but got %d. is it a new file", IVFFLAT_HEADER_PAGE, header_frame->page_num());
+    header_frame->write_unlatch();
+    buffer_pool_->unpin_page(header_frame);
+    bpm.close_file(file_name);
+    return RC::INTERNAL;
+  }
+
+  memcpy(header_frame->data(), &file_header_, sizeof(file_header_));
+  header_frame->write_unlatch();
+  buffer_pool_->unpin_page(header_frame);
+
+  lists_    = max(1, params.lists);
+  probes_   = max(1, params.probes);
+  distance_ = params.distance;
+  inited_   = true;
+  LOG_INFO("Successfully create ivfflat index. file_name:%s, index:%s, dimension:%d, lists:%d, probes:%d",
+      file_name, index_meta.name(), dimension(), lists_, probes_);
+  return RC::SUCCESS;
+}
+
+RC IvfflatIndex::open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name,
+    const IndexMeta &index_meta, const std::vector<const FieldMeta *> &fields)
+{
+  if (inited_) {
+    LOG_WARN("Failed to open index due to the index has been inited before. file_name:%s, index:%s",
+        file_name, index_meta.name());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, fields);
+
+  RC rc = bpm.open_file(log_handler, file_name, buffer_pool_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to open file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  Frame *frame = nullptr;
+  rc           = buffer_pool_->get_this_page(IVFFLAT_HEADER_PAGE, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to get header page of ivfflat index. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  frame->read_latch();
+  memcpy(&file_header_, frame->data(), sizeof(file_header_));
+  frame->read_unlatch();
+  buffer_pool_->unpin_page(frame);
+
+  const VectorIndexParams &params = index_meta.vector_params();
+
+  lists_    = max(1, params.lists);
+  probes_   = max(1, params.probes);
+  distance_ = static_cast<VectorDistanceType>(file_header_.distance);
+
+  rc = load_centroids();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to load centroids of ivfflat index. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  LOG_INFO("Successfully open ivfflat index. file_name:%s, index:%s, dimension:%d, list_num:%d, entries:%ld",
+      file_name, index_meta.name(), dimension(), list_num(), file_header_.entry_num);
+  return RC::SUCCESS;
+}
+
+RC IvfflatIndex::close()
+{
+  if (inited_) {
+    LOG_INFO("Begin to close index, index:%s", index_meta_.name());
+    buffer_pool_->close_file();
+    buffer_pool_ = nullptr;
+    inited_      = false;
+  }
+  return RC::SUCCESS;
+}
+
+void IvfflatIndex::destroy()
+{
+  if (inited_) {
+    LOG_INFO("Begin to destroy index, index:%s", index_meta_.name());
+    buffer_pool_->remove_file();
+    buffer_pool_ = nullptr;
+    inited_      = false;
+  }
+}
+
+int IvfflatIndex::entries_per_page() const
+{
+  return (BP_PAGE_DATA_SIZE - static_cast<int>(sizeof(IvfflatPageHeader))) / entry_size();
+}
+
+int IvfflatIndex::centroids_per_page() const
+{
+  return (BP_PAGE_DATA_SIZE - static_cast<int>(sizeof(IvfflatPageHeader))) / centroid_slot_size();
+}
+
+float IvfflatIndex::distance(const float *left, const float *right) const
+{
+  return vector_rank_distance(distance_, left, right, dimension());
+}
+
+int IvfflatIndex::nearest_list(const float *vec) const
+{
+  int   nearest          = -1;
+  float nearest_distance = numeric_limits<float>::max();
+  for (int list = 0; list < list_num(); list++) {
+    const float d = distance(vec, centroid(list));
+    if (nearest < 0 || d < nearest_distance) {
+      nearest          = list;
+      nearest_distance = d;
+    }
+  }
+  return nearest;
+}
+
+RC IvfflatIndex::allocate_page(Frame *&frame)
+{
+  RC rc = buffer_pool_->allocate_page(&frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate page for ivfflat index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  frame->write_latch();
+  IvfflatPageHeader *page_header = reinterpret_cast<IvfflatPageHeader *>(frame->data());
+  page_header->next_page         = BP_INVALID_PAGE_NUM;
+  page_header->count             = 0;
+  frame->mark_dirty();
+  return RC::SUCCESS;
+}
+
+RC IvfflatIndex::save_header()
+{
+  Frame *frame = nullptr;
+  RC     rc    = buffer_pool_->get_this_page(IVFFLAT_HEADER_PAGE, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get header page of ivfflat index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  frame->write_latch();
+  memcpy(frame->data(), &file_header_, sizeof(file_header_));
+  frame->mark_dirty();
+  frame->write_unlatch();
+  buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+RC IvfflatIndex::save_list_pages(int list)
+{
+  if (list < 0) {
+    return save_header();
+  }
+
+  Frame *frame = nullptr;
+  RC     rc    = buffer_pool_->get_this_page(centroid_pages_[list / centroids_per_page()], &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get centroid page of ivfflat index. list=%d, rc=%s", list, strrc(rc));
+    return rc;
+  }
+
+  char *slot = frame->data() + sizeof(IvfflatPageHeader) + (list % centroids_per_page()) * centroid_slot_size();
+  frame->write_latch();
+  memcpy(slot, &list_pages_[list], sizeof(IvfflatListPages));
+  frame->mark_dirty();
+  frame->write_unlatch();
+  buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+RC IvfflatIndex::load_centroids()
+{
+  centroids_.clear();
+  list_pages_.clear();
+  centroid_pages_.clear();
+
+  RC rc = RC::SUCCESS;
+  for (PageNum page_num = file_header_.centroid_page; page_num != BP_INVALID_PAGE_NUM;) {
+    Frame *frame = nullptr;
+    rc           = buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get centroid page of ivfflat index. page=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    frame->read_latch();
+    const IvfflatPageHeader *page_header = reinterpret_cast<const IvfflatPageHeader *>(frame->data());
+    const char              *slot        = frame->data() + sizeof(IvfflatPageHeader);
+    for (int i = 0; i < page_header->count; i++, slot += centroid_slot_size()) {
+      IvfflatListPages pages;
+      memcpy(&pages, slot, sizeof(pages));
+      list_pages_.push_back(pages);
+
+      const float *values = reinterpret_cast<const float *>(slot + sizeof(IvfflatListPages));
+      centroids_.insert(centroids_.end(), values, values + dimension());
+    }
+    centroid_pages_.push_back(page_num);
+    page_num = page_header->next_page;
+    frame->read_unlatch();
+    buffer_pool_->unpin_page(frame);
+  }
+
+  if (static_cast<int>(list_pages_.size()) != list_num()) {
+    LOG_WARN("ivfflat index is corrupted. list num in header=%d, centroids=%d", list_num(), (int)list_pages_.size());
+    return RC::INTERNAL;
+  }
+  return rc;
+}
+
+RC IvfflatIndex::train(const float *vectors, int vector_num)
+{
+  lock_guard<common::SharedMutex> guard(lock_);
+
+  if (list_num() > 0 || file_header_.entry_num > 0) {
+    LOG_WARN("ivfflat index can only be trained when it is empty. index=%s", index_meta_.name());
+    return RC::INTERNAL;
+  }
+
+  const int dim = dimension();
+  const int k   = min(lists_, vector_num);
+  if (k <= 0) {
+    LOG_INFO("no vector to train ivfflat index. index=%s", index_meta_.name());
+    return RC::SUCCESS;
+  }
+
+  auto sample = [&](int i) { return vectors + static_cast<size_t>(i) * dim; };
+
+  // k-means++ 选择初始的聚类中心：离已有中心越远的样本，被选中的概率越大
+  mt19937       random(0);
+  vector<float> centroids(static_cast<size_t>(k) * dim);
+  vector<float> min_distance(vector_num, numeric_limits<float>::max());
+
+  int chosen = uniform_int_distribution<int>(0, vector_num - 1)(random);
+  memcpy(centroids.data(), sample(chosen), dim * sizeof(float));
+  for (int c = 1; c < k; c++) {
+    double sum = 0;
+    for (int i = 0; i < vector_num; i++) {
+      const float d = vector_rank_distance(VectorDistanceType::L2, sample(i), &centroids[(c - 1) * dim], dim);
+      min_distance[i] = min(min_distance[i], d);
+      sum += min_distance[i];
+    }
+
+    chosen = uniform_int_distribution<int>(0, vector_num - 1)(random);
+    if (sum > 0) {
+      double target = std::uniform_real_distribution<double>(0, sum)(random);
+      for (int i = 0; i < vector_num; i++) {
+        target -= min_distance[i];
+        if (target <= 0) {
+          chosen = i;
+          break;
+        }
+      }
+    }
+    memcpy(&centroids[c * dim], sample(chosen), dim * sizeof(float));
+  }
+
+  // Lloyd 迭代：把样本分配到最近的中心，再用每个类的均值作为新的中心
+  vector<int>    assignment(vector_num, -1);
+  vector<double> sums(static_cast<size_t>(k) * dim);
+  vector<int>    counts(k);
+  for (int iteration = 0; iteration < KMEANS_MAX_ITERATIONS; iteration++) {
+    int changed = 0;
+    for (int i = 0; i < vector_num; i++) {
+      int   nearest          = 0;
+      float nearest_distance = numeric_limits<float>::max();
+      for (int c = 0; c < k; c++) {
+        const float d = vector_rank_distance(distance_, sample(i), &centroids[c * dim], dim);
+        if (d < nearest_distance) {
+          nearest          = c;
+          nearest_distance = d;
+        }
+      }
+      if (assignment[i] != nearest) {
+        assignment[i] = nearest;
+        changed++;
+      }
+    }
+
+    if (changed == 0) {
+      break;
+    }
+
+    fill(sums.begin(), sums.end(), 0);
+    fill(counts.begin(), counts.end(), 0);
+    for (int i = 0; i < vector_num; i++) {
+      const float *values = sample(i);
+      double      *sum    = &sums[assignment[i] * dim];
+      for (int d = 0; d < dim; d++) {
+        sum[d] += values[d];
+      }
+      counts[assignment[i]]++;
+    }
+
+    for (int c = 0; c < k; c++) {
+      if (counts[c] == 0) {
+        continue;  // 没有样本的聚类保留原来的中心
+      }
+
+      float *center = &centroids[c * dim];
+      double norm   = 0;
+      for (int d = 0; d < dim; d++) {
+        center[d] = static_cast<float>(sums[c * dim + d] / counts[c]);
+        norm += center[d] * center[d];
+      }
+
+      if (distance_ == VectorDistanceType::COSINE && norm > 0) {
+        norm = sqrt(norm);
+        for (int d = 0; d < dim; d++) {
+          center[d] = static_cast<float>(center[d] / norm);
+        }
+      }
+    }
+  }
+
+  // 写到聚类中心页面中
+  RC     rc         = RC::SUCCESS;
+  Frame *last_frame = nullptr;
+  for (int c = 0; c < k && OB_SUCC(rc); c++) {
+    if (c % centroids_per_page() == 0) {
+      Frame *frame = nullptr;
+      rc           = allocate_page(frame);
+      if (OB_FAIL(rc)) {
+        break;
+      }
+
+      if (last_frame != nullptr) {
+        reinterpret_cast<IvfflatPageHeader *>(last_frame->data())->next_page = frame->page_num();
+        last_frame->write_unlatch();
+        buffer_pool_->unpin_page(last_frame);
+      } else {
+        file_header_.centroid_page = frame->page_num();
+      }
+      centroid_pages_.push_back(frame->page_num());
+      last_frame = frame;
+    }
+
+    IvfflatPageHeader *page_header = reinterpret_cast<IvfflatPageHeader *>(last_frame->data());
+    char *slot = last_frame->data() + sizeof(IvfflatPageHeader) + page_header->count * centroid_slot_size();
+    IvfflatListPages pages;
+    memcpy(slot, &pages, sizeof(pages));
+    memcpy(slot + sizeof(pages), &centroids[c * dim], dim * sizeof(float));
+    page_header->count++;
+  }
+
+  if (last_frame != nullptr) {
+    last_frame->write_unlatch();
+    buffer_pool_->unpin_page(last_frame);
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to save centroids of ivfflat index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  centroids_.swap(centroids);
+  list_pages_.assign(k, IvfflatListPages());
+  file_header_.list_num = k;
+  LOG_INFO("trained ivfflat index. index=%s, samples=%d, lists=%d", index_meta_.name(), vector_num, k);
+  return save_header();
+}
+
+RC IvfflatIndex::build(Trx *trx)
+{
+  if (nullptr == table_) {
+    LOG_WARN("ivfflat index is not created on a table");
+    return RC::INTERNAL;
+  }
+
+  // 蓄水池抽样，每个向量被抽中的概率相同
+  const int     sample_limit = lists_ * SAMPLES_PER_LIST;
+  vector<float> samples;
+  int           sample_num = 0;
+  int64_t       seen       = 0;
+  mt19937       random(0);
+
+  RecordFileScanner scanner;
+  RC                rc = table_->get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create scanner while building ivfflat index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  Record record;
+  while (OB_SUCC(rc = scanner.next(record))) {
+    const float *vec = record_vector(record.data());
+    if (nullptr == vec) {
+      continue;
+    }
+
+    seen++;
+    if (sample_num < sample_limit) {
+      samples.insert(samples.end(), vec, vec + dimension());
+      sample_num++;
+    } else {
+      const int64_t slot = std::uniform_int_distribution<int64_t>(0, seen - 1)(random);
+      if (slot < sample_limit) {
+        memcpy(&samples[slot * dimension()], vec, dimension() * sizeof(float));
+      }
+    }
+  }
+  scanner.close_scan();
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to scan records while building ivfflat index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = train(samples.data(), sample_num);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 训练好之后把所有的向量放到最近的聚类中
+  rc = VectorIndex::build(trx);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  LOG_INFO("built ivfflat index. index=%s, vectors=%ld, lists=%d", index_meta_.name(), seen, list_num());
+  return RC::SUCCESS;
+}
+
+RC IvfflatIndex::append_entry(int list, const RID &rid, const float *vec)
+{
+  IvfflatListPages &pages = list_pages(list);
+
+  Frame *frame = nullptr;
+  RC     rc    = RC::SUCCESS;
+  if (pages.tail_page != BP_INVALID_PAGE_NUM) {
+    rc = buffer_pool_->get_this_page(pages.tail_page, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get page of ivfflat index. page=%d, rc=%s", pages.tail_page, strrc(rc));
+      return rc;
+    }
+    frame->write_latch();
+
+    IvfflatPageHeader *page_header = reinterpret_cast<IvfflatPageHeader *>(frame->data());
+    if (page_header->count >= entries_per_page()) {
+      // 最后一个页面满了，在链表的末尾追加一个页面
+      Frame *new_frame = nullptr;
+      rc               = allocate_page(new_frame);
+      if (OB_FAIL(rc)) {
+        frame->write_unlatch();
+        buffer_pool_->unpin_page(frame);
+        return rc;
+      }
+
+      page_header->next_page = new_frame->page_num();
+      frame->mark_dirty();
+      frame->write_unlatch();
+      buffer_pool_->unpin_page(frame);
+      frame = new_frame;
+    }
+  } else {
+    rc = allocate_page(frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    pages.head_page = frame->page_num();
+  }
+
+  const bool new_tail = pages.tail_page != frame->page_num();
+  pages.tail_page     = frame->page_num();
+
+  IvfflatPageHeader *page_header = reinterpret_cast<IvfflatPageHeader *>(frame->data());
+  char              *entry       = frame->data() + sizeof(IvfflatPageHeader) + page_header->count * entry_size();
+  memcpy(entry, &rid, sizeof(RID));
+  memcpy(entry + sizeof(RID), vec, dimension() * sizeof(float));
+  page_header->count++;
+  frame->mark_dirty();
+  frame->write_unlatch();
+  buffer_pool_->unpin_page(frame);
+
+  return new_tail ? save_list_pages(list) : RC::SUCCESS;
+}
+
+RC IvfflatIndex::remove_entry(int list, const RID &rid, bool &found)
+{
+  found = false;
+
+  RC rc = RC::SUCCESS;
+  for (PageNum page_num = list_pages(list).head_page; page_num != BP_INVALID_PAGE_NUM && !found;) {
+    Frame *frame = nullptr;
+    rc           = buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get page of ivfflat index. page=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    frame->write_latch();
+    IvfflatPageHeader *page_header = reinterpret_cast<IvfflatPageHeader *>(frame->data());
+    char              *entries     = frame->data() + sizeof(IvfflatPageHeader);
+    for (int i = 0; i < page_header->count; i++) {
+      if (0 != memcmp(entries + i * entry_size(), &rid, sizeof(RID))) {
+        continue;
+      }
+
+      // 用页面中最后一个向量填补删除的位置
+      const int last = page_header->count - 1;
+      if (i != last) {
+        memcpy(entries + i * entry_size(), entries + last * entry_size(), entry_size());
+      }
+      page_header->count--;
+      frame->mark_dirty();
+      found = true;
+      break;
+    }
+    page_num = page_header->next_page;
+    frame->write_unlatch();
+    buffer_pool_->unpin_page(frame);
+  }
+  return rc;
+}
+
+template <typename Visitor>
+RC IvfflatIndex::scan_list(int list, Visitor &&visitor)
+{
+  RC rc = RC::SUCCESS;
+  for (PageNum page_num = list_pages(list).head_page; page_num != BP_INVALID_PAGE_NUM;) {
+    Frame *frame = nullptr;
+    rc           = buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get page of ivfflat index. page=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    frame->read_latch();
+    const IvfflatPageHeader *page_header = reinterpret_cast<const IvfflatPageHeader *>(frame->data());
+    const char              *entry       = frame->data() + sizeof(IvfflatPageHeader);
+    for (int i = 0; i < page_header->count; i++, entry += entry_size()) {
+      RID rid;
+      memcpy(&rid, entry, sizeof(RID));
+      visitor(rid, reinterpret_cast<const float *>(entry + sizeof(RID)));
+    }
+    page_num = page_header->next_page;
+    frame->read_unlatch();
+    buffer_pool_->unpin_page(frame);
+  }
+  return rc;
+}
+
+RC IvfflatIndex::insert_entry(const char *record, const RID *rid)
+{
+  const float *vec = record_vector(record);
+  if (nullptr == vec) {
+    return RC::SUCCESS;  // NULL 不放到索引中
+  }
+
+  lock_guard<common::SharedMutex> guard(lock_);
+
+  RC rc = append_entry(nearest_list(vec), *rid, vec);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to insert vector into ivfflat index. rid=%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  file_header_.entry_num++;
+  return save_header();
+}
+
+RC IvfflatIndex::delete_entry(const char *record, const RID *rid)
+{
+  const float *vec = record_vector(record);
+  if (nullptr == vec) {
+    return RC::SUCCESS;
+  }
+
+  lock_guard<common::SharedMutex> guard(lock_);
+
+  // 插入时放在最近的聚类中，先找这个聚类。找不到时再找其它的聚类
+  const int nearest = nearest_list(vec);
+  bool      found   = false;
+  RC        rc      = remove_entry(nearest, *rid, found);
+  for (int list = -1; OB_SUCC(rc) && !found && list < list_num(); list++) {
+    if (list != nearest) {
+      rc = remove_entry(list, *rid, found);
+    }
+  }
+
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to delete vector from ivfflat index. rid=%s, rc=%s", rid->to_string().c_str(), strrc(rc));
+    return rc;
+  }
+  if (!found) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  file_header_.entry_num--;
+  return save_header();
+}
+
+RC IvfflatIndex::ann_search(const vector<float> &query, size_t limit, vector<RID> &rids)
+{
+  rids.clear();
+  if (static_cast<int>(query.size()) != dimension()) {
+    LOG_WARN("dimension of query vector does not match the index. query=%d, index=%d", (int)query.size(), dimension());
+    return RC::INVALID_ARGUMENT;
+  }
+  if (limit == 0) {
+    return RC::SUCCESS;
+  }
+
+  std::shared_lock<common::SharedMutex> guard(lock_);
+
+  // 选出离查询向量最近的 probes 个聚类
+  vector<pair<float, int>> centroid_distances;
+  centroid_distances.reserve(list_num());
+  for (int list = 0; list < list_num(); list++) {
+    centroid_distances.emplace_back(distance(query.data(), centroid(list)), list);
+  }
+  const int probes = min(probes_, list_num());
+  partial_sort(centroid_distances.begin(), centroid_distances.begin() + probes, centroid_distances.end());
+
+  // 大顶堆保存当前最近的 limit 个向量，堆顶是其中最远的
+  vector<pair<float, RID>> heap;
+  heap.reserve(min<size_t>(limit, file_header_.entry_num));
+  auto farther = [](const pair<float, RID> &left, const pair<float, RID> &right) { return left.first < right.first; };
+  auto visitor = [&](const RID &rid, const float *vec) {
+    const float d = distance(query.data(), vec);
+    if (isnan(d)) {
+      return;
+    }
+    if (heap.size() < limit) {
+      heap.emplace_back(d, rid);
+      push_heap(heap.begin(), heap.end(), farther);
+    } else if (d < heap.front().first) {
+      pop_heap(heap.begin(), heap.end(), farther);
+      heap.back() = {d, rid};
+      push_heap(heap.begin(), heap.end(), farther);
+    }
+  };
+
+  RC rc = scan_list(-1, visitor);
+  for (int i = 0; i < probes && OB_SUCC(rc); i++) {
+    rc = scan_list(centroid_distances[i].second, visitor);
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  sort_heap(heap.begin(), heap.end(), farther);
+  rids.reserve(heap.size());
+  for (const pair<float, RID> &item : heap) {
+    rids.push_back(item.second);
+  }
+  return RC::SUCCESS;
+}
+
+RC IvfflatIndex::sync()
+{
+  lock_guard<common::SharedMutex> guard(lock_);
+  return buffer_pool_->flush_all_pages();
+}
@@ -10,40 +10,153 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
-#include "storage/index/index.h"
+#include "common/lang/mutex.h"
+#include "common/lang/vector.h"
+#include "storage/buffer/page.h"
+#include "storage/index/vector_index.h"
+
+class BufferPoolManager;
+class DiskBufferPool;
+class Frame;
+class LogHandler;
+class Trx;
+
+/**
+ * @brief 一个倒排链表在文件中的位置
+ * @ingroup Index
+ */
+struct IvfflatListPages
+{
+  PageNum head_page = BP_INVALID_PAGE_NUM;  ///< 第一个数据页
+  PageNum tail_page = BP_INVALID_PAGE_NUM;  ///< 最后一个数据页，新的向量追加到这个页面上
+};
+
+/**
+ * @brief ivfflat 索引文件的第一个页面
+ * @ingroup Index
+ */
+struct IvfflatFileHeader
+{
+  int32_t          dimension;         ///< 向量的维度
+  int32_t          distance;          ///< VectorDistanceType
+  int32_t          list_num;          ///< 训练出来的聚类个数，0表示还没有训练
+  PageNum          centroid_page;     ///< 第一个聚类中心页面
+  int64_t          entry_num;         ///< 索引中向量的个数
+  IvfflatListPages unassigned_list;   ///< 训练之前插入的向量
+};
 
 /**
  * @brief ivfflat 向量索引
  * @ingroup Index
+ * @details 先用 k-means 把向量聚成 lists 个类，每个类有一个倒排链表，保存这个类中所有向量的RID和原始数据(flat)。
+ * 插入时放到最近的聚类中，查询时只扫描离查询向量最近的 probes 个聚类，所以结果是近似的。
+ * 文件的第一页是 IvfflatFileHeader，聚类中心和倒排链表都保存在缓冲池的页面中，页面之间用 next_page 串起来：
+ * - 聚类中心页面：IvfflatPageHeader，后面是若干个 [IvfflatListPages, float[dimension]]；
+ * - 数据页面：IvfflatPageHeader，后面是若干个 [RID, float[dimension]]。
+ * 创建索引时使用表中已有的数据训练聚类中心。表是空的时候不训练，向量都放在 unassigned_list 中，
+ * 查询时这个链表总会被完整扫描，结果是精确的，但是需要重建索引才能使用聚类。
+ * 索引页面的修改不记录日志，与B+树的头页面一样依赖 sync 刷盘。
  */
-class IvfflatIndex : public Index
+class IvfflatIndex : public VectorIndex
 {
 public:
-  IvfflatIndex(){};
-  virtual ~IvfflatIndex() noexcept {};
+  IvfflatIndex() = default;
+  virtual ~IvfflatIndex() noexcept;
+
+  /**
+   * @brief 创建索引文件
+   * @param fields 第一个字段是NULL位图，第二个是向量字段
+   */
+  RC create(Table *table, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &fields, bool is_unique) override;
+  RC open(Table *table, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &fields) override;
 
-  RC create(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
+  /// 不依赖表的创建和打开，方便单独测试
+  RC create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &fields);
+  RC open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &fields);
+
+  RC   close();
+  void destroy() override;
+
+  /**
+   * @brief 使用表中已有的数据构建索引
+   * @details 第一遍扫描随机抽取一部分向量训练聚类中心，第二遍把所有的向量插入到最近的聚类中。
+   * 只能在刚创建的索引上调用。
+   */
+  RC build(Trx *trx) override;
+
+  /**
+   * @brief 使用 k-means 训练聚类中心
+   * @details 只能在空的索引上调用。聚类的个数是 lists 与样本数的较小值。
+   * @param vectors 连续存放的样本向量
+   * @param vector_num 样本的个数
+   */
+  RC train(const float *vectors, int vector_num);
+
+  /**
+   * @brief 查找最近的 limit 个向量
+   * @param[out] rids 按照距离从近到远排列
+   */
+  RC ann_search(const vector<float> &query, size_t limit, vector<RID> &rids) override;
+
+  RC insert_entry(const char *record, const RID *rid) override;
+  RC delete_entry(const char *record, const RID *rid) override;
+
+  RC sync() override;
+
+  int  dimension() const override { return file_header_.dimension; }
+  int  list_num() const { return file_header_.list_num; }
+  void set_probes(int probes) { probes_ = probes; }
+
+private:
+  /// 每个页面开头的信息
+  struct IvfflatPageHeader
   {
-    return RC::UNIMPLEMENTED;
+    PageNum next_page;
+    int32_t count;
   };
-  RC open(Table *table, const char *file_name, const IndexMeta &index_meta, const FieldMeta &field_meta)
-  {
 
-    return RC::UNIMPLEMENTED;
-  };
+  int entry_size() const { return sizeof(RID) + dimension() * sizeof(float); }
+  int centroid_slot_size() const { return sizeof(IvfflatListPages) + dimension() * sizeof(float); }
+  int entries_per_page() const;
+  int centroids_per_page() const;
 
-  vector<RID> ann_search(const vector<float> &base_vector, size_t limit) { return vector<RID>(); }
+  const float *centroid(int list) const { return centroids_.data() + static_cast<size_t>(list) * dimension(); }
+  float        distance(const float *left, const float *right) const;
 
-  RC close() { return RC::UNIMPLEMENTED; }
+  /// 离向量最近的聚类。还没有训练时返回 -1，表示 unassigned_list
+  int nearest_list(const float *vec) const;
 
-  RC insert_entry(const char *record, const RID *rid) override { return RC::UNIMPLEMENTED; };
-  RC delete_entry(const char *record, const RID *rid) override { return RC::UNIMPLEMENTED; };
+  IvfflatListPages &list_pages(int list) { return list < 0 ? file_header_.unassigned_list : list_pages_[list]; }
 
-  RC sync() override { return RC::UNIMPLEMENTED; };
+  RC append_entry(int list, const RID &rid, const float *vec);
+  RC remove_entry(int list, const RID &rid, bool &found);
+  RC save_list_pages(int list);
+  RC save_header();
+  RC load_centroids();
+  RC allocate_page(Frame *&frame);
+
+  /**
+   * @brief 扫描一个倒排链表
+   * @param visitor 参数是RID和向量
+   */
+  template <typename Visitor>
+  RC scan_list(int list, Visitor &&visitor);
 
 private:
-  bool   inited_ = false;
-  Table *table_  = nullptr;
-  int    lists_  = 1;
-  int    probes_ = 1;
+  bool              inited_      = false;
+  DiskBufferPool   *buffer_pool_ = nullptr;
+  int               lists_       = 1;  ///< 创建索引时指定的聚类个数
+  int               probes_      = 1;
+  VectorDistanceType distance_   = VectorDistanceType::L2;
+
+  IvfflatFileHeader        file_header_;
+  vector<float>            centroids_;       ///< 所有的聚类中心
+  vector<IvfflatListPages> list_pages_;      ///< 每个聚类的倒排链表
+  vector<PageNum>          centroid_pages_;  ///< 保存聚类中心的页面
+
+  common::SharedMutex lock_;  ///< 查询共享，修改独占
 };
@@ -0,0 +1,50 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include <strings.h>
+
+#include "common/math/simd_util.h"
+#include "storage/index/vector_distance.h"
+
+const char *vector_distance_name(VectorDistanceType type)
+{
+  switch (type) {
+    case VectorDistanceType::L2: return "l2_distance";
+    case VectorDistanceType::COSINE: return "cosine_distance";
+    case VectorDistanceType::INNER_PRODUCT: return "inner_product";
+  }
+  return "unknown";
+}
+
+RC vector_distance_from_string(const string &name, VectorDistanceType &type)
+{
+  for (VectorDistanceType candidate :
+      {VectorDistanceType::L2, VectorDistanceType::COSINE, VectorDistanceType::INNER_PRODUCT}) {
+    if (0 == strcasecmp(name.c_str(), vector_distance_name(candidate))) {
+      type = candidate;
+      return RC::SUCCESS;
+    }
+  }
+  return RC::INVALID_ARGUMENT;
+}
+
+float vector_rank_distance(VectorDistanceType type, const float *left, const float *right, int dim)
+{
+  switch (type) {
+    case VectorDistanceType::L2: return vector_l2_squared_distance(left, right, dim);
+    case VectorDistanceType::COSINE: return vector_cosine_distance(left, right, dim);
+    case VectorDistanceType::INNER_PRODUCT: return -vector_inner_product(left, right, dim);
+  }
+  return 0;
+}
@@ -0,0 +1,41 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/string.h"
+
+/**
+ * @brief 向量索引使用的距离函数
+ * @ingroup Index
+ * @details 与 SQL 中的 l2_distance、cosine_distance、inner_product 函数对应
+ */
+enum class VectorDistanceType
+{
+  L2,             ///< 欧氏距离
+  COSINE,         ///< 余弦距离
+  INNER_PRODUCT,  ///< 内积，内积越大越相似
+};
+
+const char *vector_distance_name(VectorDistanceType type);
+RC          vector_distance_from_string(const string &name, VectorDistanceType &type);
+
+/**
+ * @brief 计算用于排序的向量距离，值越小越相似
+ * @details 只用来比较远近，不是 SQL 函数返回的值：L2 返回距离的平方，省掉开方；
+ * 余弦距离与 cosine_distance 一致；内积返回内积的相反数。
+ * @param dim 向量的维度
+ */
+float vector_rank_distance(VectorDistanceType type, const float *left, const float *right, int dim);
@@ -0,0 +1,64 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#include "storage/index/vector_index.h"
+#include "common/lang/bitmap.h"
+#include "common/log/log.h"
+#include "storage/table/table.h"
+
+IndexScanner *VectorIndex::create_scanner(
+    const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
+{
+  LOG_WARN("vector index does not support range scan. index=%s", index_meta_.name());
+  return nullptr;
+}
+
+RC VectorIndex::build(Trx *trx)
+{
+  if (nullptr == table_) {
+    LOG_WARN("vector index is not created on a table. index=%s", index_meta_.name());
+    return RC::INTERNAL;
+  }
+
+  RecordFileScanner scanner;
+  RC                rc = table_->get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create scanner while building vector index. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+    return rc;
+  }
+
+  Record record;
+  while (OB_SUCC(rc = scanner.next(record))) {
+    rc = insert_entry(record.data(), &record.rid());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to insert vector into index. index=%s, rid=%s, rc=%s",
+          index_meta_.name(), record.rid().to_string().c_str(), strrc(rc));
+      break;
+    }
+  }
+  scanner.close_scan();
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
+const float *VectorIndex::record_vector(const char *record) const
+{
+  const FieldMeta &null_field   = field_metas_[0];
+  const FieldMeta &vector_field = field_metas_[1];
+
+  common::Bitmap null_bitmap(const_cast<char *>(record) + null_field.offset(), null_field.len() * 8);
+  if (null_bitmap.get_bit(vector_field.field_id())) {
+    return nullptr;
+  }
+  return reinterpret_cast<const float *>(record + vector_field.offset());
+}
@@ -0,0 +1,59 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/27.
+//
+
+#pragma once
+
+#include "common/lang/vector.h"
+#include "storage/index/index.h"
+
+class Trx;
+
+/**
+ * @brief 向量索引的基类
+ * @ingroup Index
+ * @details 向量索引只能按照距离查找最近的若干个向量，结果是近似的，不支持按范围扫描。
+ * 索引的字段与B+树一样，第一个是NULL位图，第二个是向量字段。NULL值不放到索引中。
+ */
+class VectorIndex : public Index
+{
+public:
+  VectorIndex()          = default;
+  virtual ~VectorIndex() = default;
+
+  bool is_vector_index() override { return true; }
+
+  IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+      int right_len, bool right_inclusive) override;
+
+  /**
+   * @brief 使用表中已有的数据构建索引
+   * @details 默认实现是把每条记录插入到索引中。只能在刚创建的索引上调用。
+   */
+  virtual RC build(Trx *trx);
+
+  /**
+   * @brief 查找最近的 limit 个向量
+   * @param[out] rids 按照距离从近到远排列
+   */
+  virtual RC ann_search(const vector<float> &query, size_t limit, vector<RID> &rids) = 0;
+
+  virtual int dimension() const = 0;
+
+protected:
+  /// 记录中的向量，NULL时返回nullptr
+  const float *record_vector(const char *record) const;
+
+protected:
+  Table *table_ = nullptr;
+};
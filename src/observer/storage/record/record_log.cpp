@@ -173,6 +173,16 @@ RC RecordLogHandler::delete_record(Frame *frame, const RID &rid)
 
 RecordLogReplayer::RecordLogReplayer(BufferPoolManager &bpm) : bpm_(bpm) {}
 
+LogReplayScope RecordLogReplayer::scope(const LogEntry &entry) const
+{
+  if (entry.payload_size() < RecordLogHeader::SIZE) {
+    return LogReplayScope::global();
+  }
+
+  auto log_header = reinterpret_cast<const RecordLogHeader *>(entry.data());
+  return LogReplayScope::page(log_header->buffer_pool_id, log_header->page_num);
+}
+
 RC RecordLogReplayer::replay(const LogEntry &entry)
 {
   LOG_TRACE("replaying record manager log: %s", entry.to_string().c_str());
@@ -144,6 +144,9 @@ public:
 
   virtual RC replay(const LogEntry &entry) override;
 
+  /// @brief 每条日志只修改一个页面，按照页面并行回放
+  LogReplayScope scope(const LogEntry &entry) const override;
+
 private:
   RC replay_init_page(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
   RC replay_insert(DiskBufferPool &buffer_pool, const RecordLogHeader &log_header);
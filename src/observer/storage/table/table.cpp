@@ -27,6 +27,8 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/meta_util.h"
 #include "storage/index/bplus_tree_index.h"
 #include "storage/index/index.h"
+#include "storage/index/hnsw_index.h"
+#include "storage/index/ivfflat_index.h"
 #include "storage/record/record_manager.h"
 #include "storage/table/table.h"
 #include "storage/trx/trx.h"
@@ -201,8 +203,15 @@ RC Table::open(Db *db, const char *meta_file, const char *base_dir)
     }
     
 
-    BplusTreeIndex *index      = new BplusTreeIndex();
-    string          index_file = table_index_file(base_dir, name(), index_meta->name());
+    Index *index = nullptr;
+    if (index_meta->index_type() == IndexType::IVFFLAT) {
+      index = new IvfflatIndex();
+    } else if (index_meta->index_type() == IndexType::HNSW) {
+      index = new HnswIndex();
+    } else {
+      index = new BplusTreeIndex();
+    }
+    string index_file = table_index_file(base_dir, name(), index_meta->name());
 
     rc = index->open(this, index_file.c_str(), *index_meta, fields);
     if (rc != RC::SUCCESS) {
@@ -503,7 +512,11 @@ RC Table::create_index(Trx *trx, const std::vector<const FieldMeta*> &fields, co
     return rc;
   }
 
-  // 遍历当前的所有数据，插入这个索引
+  // 遍历当前的所有数据，排序后自底向上批量构建索引
+  BplusTreeBulkLoadOptions bulk_load_options = db_->index_bulk_load_options();
+  bulk_load_options.temp_file_prefix         = index_file;
+  unique_ptr<BplusTreeBulkLoader> bulk_loader = index->create_bulk_loader(bulk_load_options);
+
   RecordFileScanner scanner;
   rc = get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY);
   if (rc != RC::SUCCESS) {
@@ -514,9 +527,9 @@ RC Table::create_index(Trx *trx, const std::vector<const FieldMeta*> &fields, co
 
   Record record;
   while (OB_SUCC(rc = scanner.next(record))) {
-    rc = index->insert_entry(record.data(), &record.rid());
+    rc = bulk_loader->add(record.data(), record.rid());
     if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
+      LOG_WARN("failed to add record into index while creating index. table=%s, index=%s, rc=%s",
                name(), index_name, strrc(rc));
       return rc;
     }
@@ -529,13 +542,76 @@ RC Table::create_index(Trx *trx, const std::vector<const FieldMeta*> &fields, co
     return rc;
   }
   scanner.close_scan();
-  LOG_INFO("inserted all records into new index. table=%s, index=%s", name(), index_name);
+
+  rc = bulk_loader->finish();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to build index while creating index. table=%s, index=%s, rc=%s", name(), index_name, strrc(rc));
+    return rc;
+  }
+  LOG_INFO("inserted all records into new index. table=%s, index=%s, entries=%ld",
+           name(), index_name, bulk_loader->entry_num());
+
+  indexes_.push_back(index);
+
+  return add_index_meta(new_index_meta);
+}
+
+RC Table::create_vector_index(Trx *trx, const std::vector<const FieldMeta *> &fields, const char *index_name,
+    IndexType index_type, const VectorIndexParams &params)
+{
+  if (common::is_blank(index_name) || fields.size() != 2 ||
+      (index_type != IndexType::IVFFLAT && index_type != IndexType::HNSW)) {
+    LOG_INFO("Invalid input arguments, table name is %s, index_name=%s, field num=%d, index type=%s",
+             name(), index_name, (int)fields.size(), index_type_name(index_type));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  IndexMeta new_index_meta;
+
+  RC rc = new_index_meta.init(index_name, fields, false /*is_unique*/);
+  if (rc != RC::SUCCESS) {
+    LOG_INFO("Failed to init IndexMeta in table:%s, index_name:%s, rc=%d:%s", name(), index_name, rc, strrc(rc));
+    return rc;
+  }
+  new_index_meta.set_vector_index(index_type, params);
+
+  VectorIndex *index = nullptr;
+  if (index_type == IndexType::HNSW) {
+    index = new HnswIndex();
+  } else {
+    index = new IvfflatIndex();
+  }
+  string index_file = table_index_file(base_dir_.c_str(), name(), index_name);
+
+  rc = index->create(this, index_file.c_str(), new_index_meta, fields, false /*is_unique*/);
+  if (rc != RC::SUCCESS) {
+    delete index;
+    LOG_ERROR("Failed to create %s index. file name=%s, rc=%d:%s",
+              index_type_name(index_type), index_file.c_str(), rc, strrc(rc));
+    return rc;
+  }
+
+  // 把表中已有的向量放到索引中，ivfflat 还会先用这些数据训练聚类中心
+  rc = index->build(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to build %s index. table=%s, index=%s, rc=%s", index_type_name(index_type), name(), index_name, strrc(rc));
+    index->destroy();
+    delete index;
+    return rc;
+  }
 
   indexes_.push_back(index);
 
+  return add_index_meta(new_index_meta);
+}
+
+RC Table::add_index_meta(const IndexMeta &new_index_meta)
+{
+  const char *index_name = new_index_meta.name();
+
   /// 接下来将这个索引放到表的元数据中
   TableMeta new_table_meta(table_meta_);
-  rc = new_table_meta.add_index(new_index_meta);
+  RC rc = new_table_meta.add_index(new_index_meta);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to add index (%s) on table (%s). error=%d:%s", index_name, name(), rc, strrc(rc));
     return rc;
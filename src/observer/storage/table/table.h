@@ -90,6 +90,13 @@ public:
   // TODO refactor
   RC create_index(Trx *trx, const std::vector<const FieldMeta*> &fields, const char *index_name,bool is_unique);
 
+  /**
+   * @brief 创建向量索引
+   * @param fields 与 create_index 一样，第一个字段是NULL位图，第二个是向量字段
+   */
+  RC create_vector_index(Trx *trx, const std::vector<const FieldMeta *> &fields, const char *index_name,
+      IndexType index_type, const VectorIndexParams &params);
+
   RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode);
 
   RC get_chunk_scanner(ChunkFileScanner &scanner, Trx *trx, ReadWriteMode mode);
@@ -120,6 +127,9 @@ private:
   RC delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists);
   RC set_value_to_record(char *record_data, const Value &value, const FieldMeta *field);
 
+  /// 把新的索引加到元数据中，并写到元数据文件
+  RC add_index_meta(const IndexMeta &new_index_meta);
+
 private:
   RC init_record_handler(const char *base_dir);
 
@@ -157,7 +157,8 @@ const IndexMeta *TableMeta::find_index_by_field(const char *field) const
 {
   for (const IndexMeta &index : indexes_) {
     std::vector<std::string> fields = index.field();
-    if (0 == strcmp(fields[0].c_str(), field)) {
+    // 索引的第一个字段是NULL位图，后面才是创建索引时指定的字段
+    if (fields.size() > 1 && 0 == strcmp(fields[1].c_str(), field)) {
       return &index;
     }
   }
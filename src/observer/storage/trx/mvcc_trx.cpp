@@ -111,6 +111,27 @@ LogReplayer *MvccTrxKit::create_log_replayer(Db &db, LogHandler &log_handler)
   return new MvccTrxLogReplayer(db, *this, log_handler);
 }
 
+LSN MvccTrxKit::min_active_trx_lsn()
+{
+  lock_guard<mutex> guard(active_trx_lsn_lock_);
+  return active_trx_lsns_.empty() ? 0 : *active_trx_lsns_.begin();
+}
+
+void MvccTrxKit::add_active_trx_lsn(LSN lsn)
+{
+  lock_guard<mutex> guard(active_trx_lsn_lock_);
+  active_trx_lsns_.insert(lsn);
+}
+
+void MvccTrxKit::remove_active_trx_lsn(LSN lsn)
+{
+  lock_guard<mutex> guard(active_trx_lsn_lock_);
+  auto iter = active_trx_lsns_.find(lsn);
+  if (iter != active_trx_lsns_.end()) {
+    active_trx_lsns_.erase(iter);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MvccTrx::MvccTrx(MvccTrxKit &kit, LogHandler &log_handler) : trx_kit_(kit), log_handler_(log_handler)
@@ -123,10 +144,31 @@ MvccTrx::MvccTrx(MvccTrxKit &kit, LogHandler &log_handler, int32_t trx_id)
   recovering_ = true;
 }
 
-MvccTrx::~MvccTrx() {}
+MvccTrx::~MvccTrx() { end_logging(); }
+
+void MvccTrx::begin_logging()
+{
+  if (recovering_ || log_start_lsn_ > 0) {
+    return;
+  }
+
+  // 后面写的日志LSN都会比当前的大
+  log_start_lsn_ = log_handler_.current_lsn() + 1;
+  trx_kit_.add_active_trx_lsn(log_start_lsn_);
+}
+
+void MvccTrx::end_logging()
+{
+  if (log_start_lsn_ > 0) {
+    trx_kit_.remove_active_trx_lsn(log_start_lsn_);
+    log_start_lsn_ = 0;
+  }
+}
 
 RC MvccTrx::insert_record(Table *table, Record &record)
 {
+  begin_logging();
+
   Field begin_field;
   Field end_field;
   trx_fields(table, begin_field, end_field);
@@ -150,6 +192,8 @@ RC MvccTrx::insert_record(Table *table, Record &record)
 
 RC MvccTrx::delete_record(Table *table, Record &record)
 {
+  begin_logging();
+
   Field begin_field;
   Field end_field;
   trx_fields(table, begin_field, end_field);
@@ -338,6 +382,7 @@ RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
   if (!recovering_) {
     rc = log_handler_.commit(trx_id_, commit_xid);
   }
+  end_logging();
 
   operations_.clear();
 
@@ -419,6 +464,7 @@ RC MvccTrx::rollback()
   if (!recovering_) {
     rc = log_handler_.rollback(trx_id_);
   }
+  end_logging();
   LOG_TRACE("append trx rollback log. trx id=%d, rc=%s", trx_id_, strrc(rc));
   return rc;
 }
@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/set.h"
 #include "common/lang/vector.h"
 #include "storage/trx/trx.h"
 #include "storage/trx/mvcc_trx_log.h"
@@ -44,6 +45,14 @@ public:
 
   LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) override;
 
+  LSN min_active_trx_lsn() override;
+
+  /**
+   * @brief 事务开始修改数据时，记录它的第一条日志不会小于这个LSN
+   */
+  void add_active_trx_lsn(LSN lsn);
+  void remove_active_trx_lsn(LSN lsn);
+
 public:
   int32_t next_trx_id();
 
@@ -57,6 +66,10 @@ private:
 
   common::Mutex lock_;
   vector<Trx *> trxes_;
+
+  /// 检查点线程也会访问，所以不能使用 common::Mutex
+  mutex         active_trx_lsn_lock_;
+  multiset<LSN> active_trx_lsns_;  ///< 活跃事务的第一条日志LSN的下界
 };
 
 /**
@@ -101,6 +114,13 @@ public:
 
 private:
   RC   commit_with_trx_id(int32_t commit_id);
+
+  /**
+   * @brief 第一次修改数据前，在 MvccTrxKit 中登记当前的LSN，事务结束时取消
+   */
+  void begin_logging();
+  void end_logging();
+
   void trx_fields(Table *table, Field &begin_xid_field, Field &end_xid_field) const;
 
 private:
@@ -115,5 +135,6 @@ private:
   int32_t           trx_id_     = -1;
   bool              started_    = false;
   bool              recovering_ = false;
+  LSN               log_start_lsn_ = 0;  ///< 参考 begin_logging
   OperationSet      operations_;
 };
@@ -68,6 +68,8 @@ MvccTrxLogHandler::MvccTrxLogHandler(LogHandler &log_handler) : log_handler_(log
 
 MvccTrxLogHandler::~MvccTrxLogHandler() {}
 
+LSN MvccTrxLogHandler::current_lsn() const { return log_handler_.current_lsn(); }
+
 RC MvccTrxLogHandler::insert_record(int32_t trx_id, Table *table, const RID &rid)
 {
   ASSERT(trx_id > 0, "invalid trx_id:%d", trx_id);
@@ -174,6 +176,20 @@ RC MvccTrxLogReplayer::replay(const LogEntry &entry)
   return rc;
 }
 
+LogReplayScope MvccTrxLogReplayer::scope(const LogEntry &entry) const
+{
+  if (entry.payload_size() < MvccTrxLogHeader::SIZE) {
+    return LogReplayScope::global();
+  }
+
+  auto *header = reinterpret_cast<const MvccTrxLogHeader *>(entry.data());
+  switch (MvccTrxLogOperation(header->operation_type).type()) {
+    case MvccTrxLogOperation::Type::INSERT_RECORD:
+    case MvccTrxLogOperation::Type::DELETE_RECORD: return LogReplayScope::local();
+    default: return LogReplayScope::global();
+  }
+}
+
 RC MvccTrxLogReplayer::on_done()
 {
   /// 日志回放已经完成，需要把没有提交的事务，回滚掉
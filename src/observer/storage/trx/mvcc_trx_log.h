@@ -134,6 +134,8 @@ public:
    */
   RC rollback(int32_t trx_id);
 
+  LSN current_lsn() const;
+
 private:
   LogHandler &log_handler_;
 };
@@ -154,6 +156,11 @@ public:
   //! @copydoc LogReplayer::on_done
   RC on_done() override;
 
+  /**
+   * @brief 插入和删除日志只是把操作记录在事务中，不访问页面。提交和回滚时会修改记录，需要等前面的日志回放完成
+   */
+  LogReplayScope scope(const LogEntry &entry) const override;
+
 private:
   Db         &db_;           ///< 所属数据库
   MvccTrxKit &trx_kit_;      ///< 事务管理器
@@ -129,6 +129,13 @@ public:
 
   virtual LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) = 0;
 
+  /**
+   * @brief 还没有结束的事务中，最小的日志序列号
+   * @details 检查点不能超过这个位置，否则恢复时看不到这些事务之前的日志，没办法提交或回滚。
+   * 没有活跃事务时返回0
+   */
+  virtual LSN min_active_trx_lsn() { return 0; }
+
 public:
   static TrxKit *create(const char *name);
 };
@@ -147,6 +154,12 @@ public:
   virtual RC delete_record(Table *table, Record &record)                    = 0;
   virtual RC visit_record(Table *table, Record &record, ReadWriteMode mode) = 0;
 
+  /**
+   * @brief 判断记录是否可见时是否需要记录的数据
+   * @details 比如MVCC需要读取记录中的事务版本号。不需要时，只扫描索引的算子可以不去读取记录
+   */
+  virtual bool need_record_for_visibility() const { return true; }
+
   virtual RC start_if_need() = 0;
   virtual RC commit()        = 0;
   virtual RC rollback()      = 0;
@@ -47,6 +47,7 @@ public:
   RC insert_record(Table *table, Record &record) override;
   RC delete_record(Table *table, Record &record) override;
   RC visit_record(Table *table, Record &record, ReadWriteMode mode) override;
+  bool need_record_for_visibility() const override { return false; }
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
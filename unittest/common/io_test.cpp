@@ -0,0 +1,138 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// Created by Wangyunlai on 2024/10/22.
+//
+
+#include <fcntl.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include "common/io/io.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+static const char *TEST_FILE = "io_test.data";
+
+TEST(test_io, test_pwriten_preadn)
+{
+  ::remove(TEST_FILE);
+  int fd = ::open(TEST_FILE, O_CREAT | O_RDWR, 0644);
+  ASSERT_GE(fd, 0);
+
+  char buf[128];
+  memset(buf, 'a', sizeof(buf));
+  ASSERT_EQ(0, pwriten(fd, buf, sizeof(buf), 256));
+
+  // 文件偏移量不会被修改
+  ASSERT_EQ(0, lseek(fd, 0, SEEK_CUR));
+
+  char read_buf[128];
+  ASSERT_EQ(0, preadn(fd, read_buf, sizeof(read_buf), 256));
+  ASSERT_EQ(0, memcmp(buf, read_buf, sizeof(buf)));
+
+  // 空洞部分读出来是0
+  ASSERT_EQ(0, preadn(fd, read_buf, sizeof(read_buf), 0));
+  for (char c : read_buf) {
+    ASSERT_EQ(0, c);
+  }
+
+  // 读到文件尾
+  ASSERT_EQ(-1, preadn(fd, read_buf, sizeof(read_buf), 300));
+
+  ::close(fd);
+  ::remove(TEST_FILE);
+}
+
+TEST(test_io, test_pwritevn_preadvn)
+{
+  ::remove(TEST_FILE);
+  int fd = ::open(TEST_FILE, O_CREAT | O_RDWR, 0644);
+  ASSERT_GE(fd, 0);
+
+  // 超过IOV_MAX段，需要拆分成多次系统调用
+  const int         segment_num  = IOV_MAX + 10;
+  const int         segment_size = 16;
+  std::vector<char> data(segment_num * segment_size);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i % 251);
+  }
+
+  std::vector<struct iovec> iov(segment_num);
+  for (int i = 0; i < segment_num; i++) {
+    iov[i].iov_base = data.data() + i * segment_size;
+    iov[i].iov_len  = segment_size;
+  }
+  ASSERT_EQ(0, pwritevn(fd, iov.data(), segment_num, 100));
+
+  std::vector<char> read_data(data.size());
+  ASSERT_EQ(0, preadn(fd, read_data.data(), static_cast<int>(read_data.size()), 100));
+  ASSERT_EQ(0, memcmp(data.data(), read_data.data(), data.size()));
+
+  read_data.assign(read_data.size(), 0);
+  for (int i = 0; i < segment_num; i++) {
+    iov[i].iov_base = read_data.data() + i * segment_size;
+    iov[i].iov_len  = segment_size;
+  }
+  ASSERT_EQ(0, preadvn(fd, iov.data(), segment_num, 100));
+  ASSERT_EQ(0, memcmp(data.data(), read_data.data(), data.size()));
+
+  // 读到文件尾
+  for (int i = 0; i < segment_num; i++) {
+    iov[i].iov_base = read_data.data() + i * segment_size;
+    iov[i].iov_len  = segment_size;
+  }
+  ASSERT_EQ(-1, preadvn(fd, iov.data(), segment_num, 200));
+
+  ::close(fd);
+  ::remove(TEST_FILE);
+}
+
+TEST(test_io, test_writevn)
+{
+  ::remove(TEST_FILE);
+  int fd = ::open(TEST_FILE, O_CREAT | O_RDWR | O_APPEND, 0644);
+  ASSERT_GE(fd, 0);
+
+  const int         segment_num  = IOV_MAX + 10;
+  const int         segment_size = 16;
+  std::vector<char> data(segment_num * segment_size);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i % 251);
+  }
+
+  std::vector<struct iovec> iov(segment_num);
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < segment_num; j++) {
+      iov[j].iov_base = data.data() + j * segment_size;
+      iov[j].iov_len  = segment_size;
+    }
+    ASSERT_EQ(0, writevn(fd, iov.data(), segment_num));
+  }
+
+  // 两次写入的数据都追加在文件末尾
+  std::vector<char> read_data(data.size());
+  ASSERT_EQ(0, preadn(fd, read_data.data(), static_cast<int>(read_data.size()), 0));
+  ASSERT_EQ(0, memcmp(data.data(), read_data.data(), data.size()));
+  ASSERT_EQ(0, preadn(fd, read_data.data(), static_cast<int>(read_data.size()), data.size()));
+  ASSERT_EQ(0, memcmp(data.data(), read_data.data(), data.size()));
+
+  ::close(fd);
+  ::remove(TEST_FILE);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}